@@ -41,12 +41,9 @@ vpic_simulation** restore_main(void)
 }
 
 /**
- * @brief Main checkpoint function to trigger a full checkpointing
- *
- * @param fbase File name base for dumping
- * @param tag File tag to label what this checkpoint is (often used: time step)
+ * @brief Pull the checkpointed state back from the device
  */
-void checkpt(const char* fbase, int tag)
+static void checkpt_copy_to_host(void)
 {
 
     ////////// Pull Kokkos data back from the device
@@ -65,12 +62,43 @@ void checkpt(const char* fbase, int tag)
     //std::cout << "Copying data back to host for checkpointing.." << std::endl;
 
     ///// End Kokkos Copy Data /////
+}
+
+/**
+ * @brief Main checkpoint function to trigger a full checkpointing
+ *
+ * @param fbase File name base for dumping
+ * @param tag File tag to label what this checkpoint is (often used: time step)
+ */
+void checkpt(const char* fbase, int tag)
+{
+    checkpt_copy_to_host();
 
     char fname[256];
     if( !fbase ) ERROR(( "NULL filename base" ));
     sprintf( fname, "%s.%i.%i", fbase, tag, world_rank );
     if( world_rank==0 ) log_printf( "*** Checkpointing to \"%s\"\n", fbase );
-    checkpt_objects( fname );
+
+    // An asynchronous checkpt returns once the objects are snapshotted
+    // to host memory; the file is written in the background (outside
+    // any turnstile the deck wraps this call in).
+    if( simulation->checkpt_async ) checkpt_objects_async( fname );
+    else                            checkpt_objects( fname );
+}
+
+/**
+ * @brief Buddy checkpoint to node local storage, mirrored on the next
+ * rank, restored with --restore-buddy
+ *
+ * @param name File name base on node local storage (e.g. in /dev/shm)
+ */
+void checkpt_buddy(const char* name)
+{
+    checkpt_copy_to_host();
+
+    if( !name ) ERROR(( "NULL filename base" ));
+    if( world_rank==0 ) log_printf( "*** Buddy checkpointing to \"%s\"\n", name );
+    checkpt_objects_buddy( name );
 }
 
 /**
@@ -96,8 +124,43 @@ int main(int argc, char** argv)
     // TODO: this would be better if it was bool-like in nature
     const char * fbase = strip_cmdline_string(&argc, &argv, "--restore", NULL);
 
+    // A portable restart dump (dump_portable_restart) can be restored on
+    // any number of ranks
+    const char * portable = strip_cmdline_string(&argc, &argv, "--restart", NULL);
+
+    // A buddy checkpt (checkpt_buddy) is tried first; the checkpt given
+    // by --restore, if any, is the fallback.  --buddy-lost simulates the
+    // replacement of a rank by ignoring its buddy images.
+    const char * buddy = strip_cmdline_string(&argc, &argv, "--restore-buddy", NULL);
+    const int buddy_lost = strip_cmdline_int(&argc, &argv, "--buddy-lost", -1);
+
+    if( buddy )
+    {
+        if( world_rank==0 ) log_printf( "*** Restoring from buddy \"%s\"\n", buddy );
+        if( restore_objects_buddy( buddy, buddy_lost ) )
+        {
+            mp_barrier();
+            reanimate_objects();
+            mp_barrier();
+
+            restore_kokkos(*simulation);
+        }
+        else if( !fbase )
+        {
+            ERROR(( "Unable to restore from buddy \"%s\" and no --restore given", buddy ));
+        }
+        else
+        {
+            buddy = NULL;
+        }
+    }
+
     // Detect if we should perform a restore as per the user request
-    if( fbase )
+    if( buddy )
+    {
+        // Restored above
+    }
+    else if( fbase )
     {
 
         // We are restoring from a checkpoint.  Determine checkpt file
@@ -117,6 +180,15 @@ int main(int argc, char** argv)
         restore_kokkos(*simulation);
 
     }
+    else if( portable )
+    {
+        // The deck builds the new decomposition and the dump is
+        // redistributed onto it
+        if( world_rank==0 ) log_printf( "*** Restarting from \"%s\"\n", portable );
+        simulation = new vpic_simulation();
+        simulation->restore_portable_restart( argc, argv, portable );
+        REGISTER_OBJECT( &simulation, checkpt_main, restore_main, NULL );
+    }
     else // We are initializing from scratch.
     {
         // Perform basic initialization
@@ -409,4 +409,7 @@ void
 checkpt( const char * fbase,
          int tag );
 
+void
+checkpt_buddy( const char * name );
+
 //-----------------------------------------------------------------------------
@@ -302,6 +302,7 @@ int main( int argc, char *argv[] ) {
 
       /* Version and dump type */
       READ(int,n,fparr[ifile]); /* Version */ 
+      if (n!=0) ERROR(("Compressed dump; expand it with post/vpic_decompress first."));
       READ(int,n,fparr[ifile]); 
       /* Check #2 for file consistency */ 
       if (    n==1 /* field */ && infile_type==INFILE_TYPE_HYDRO 
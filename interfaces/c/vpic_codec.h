@@ -0,0 +1,166 @@
+/*
+   Decoder for compressed VPIC field and hydro dumps.
+
+   Dumps written with a DumpParameters compression codec carry header
+   version 1 and store every array payload as a frame (see
+   src/util/io/CompressedIOPolicy.h):
+
+     uint32 magic "VPZ1", uint32 codec, uint32 element size, uint32 0,
+     uint64 elements, uint64 elements per block, uint64 blocks,
+     then per block: uint32 kind, uint32 payload bytes, payload.
+
+   Block kinds are 0 (raw), 1 (byte-shuffle + LZ) and 2 (quantized: a
+   double step followed by byte-shuffled, LZ coded, zigzag delta coded
+   int32 values).  This header is self contained C99 so the join and post
+   processing tools can use it without linking VPIC.
+
+   Usage:
+     void *data; uint64_t n; uint32_t size;
+     if ( vpic_read_frame( fp, &data, &n, &size ) ) ... free( data );
+*/
+
+#ifndef vpic_codec_h
+#define vpic_codec_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VPIC_FRAME_MAGIC 0x315a5056u
+#define VPIC_LZ_MIN_MATCH 4
+
+static int
+vpic_lz_decompress( const uint8_t *in, size_t in_bytes,
+                    uint8_t *out, size_t n ) {
+  const uint8_t *ip = in, *iend = in + in_bytes;
+  size_t op = 0;
+
+  while ( ip < iend ) {
+    uint8_t token = *ip++, s;
+    size_t literals = token >> 4, match, offset, m;
+
+    if ( literals == 15 ) do {
+      if ( ip >= iend ) return 0;
+      s = *ip++; literals += s;
+    } while ( s == 255 );
+
+    if ( (size_t)(iend - ip) < literals || n - op < literals ) return 0;
+    memcpy( out + op, ip, literals );
+    ip += literals; op += literals;
+
+    if ( op == n ) return ip == iend;
+    if ( iend - ip < 2 ) return 0;
+
+    offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+
+    match = token & 0x0f;
+    if ( match == 15 ) do {
+      if ( ip >= iend ) return 0;
+      s = *ip++; match += s;
+    } while ( s == 255 );
+    match += VPIC_LZ_MIN_MATCH;
+
+    if ( offset == 0 || offset > op || n - op < match ) return 0;
+    for ( m=0; m<match; m++, op++ ) out[op] = out[op - offset];
+  }
+
+  return op == n;
+}
+
+static int
+vpic_decode_lossless( const uint8_t *in, size_t in_bytes,
+                      uint8_t *out, size_t n, size_t elem_size ) {
+  size_t b, i;
+  uint8_t *shuffled = (uint8_t *)malloc( n*elem_size + 1 );
+  if ( !shuffled ) return 0;
+  if ( !vpic_lz_decompress( in, in_bytes, shuffled, n*elem_size ) ) {
+    free( shuffled );
+    return 0;
+  }
+  for ( b=0; b<elem_size; b++ )
+    for ( i=0; i<n; i++ ) out[i*elem_size + b] = shuffled[b*n + i];
+  free( shuffled );
+  return 1;
+}
+
+static int
+vpic_decode_block( uint32_t kind, const uint8_t *in, size_t in_bytes,
+                   uint8_t *out, size_t n, size_t elem_size ) {
+  double step;
+  uint32_t *q;
+  int64_t previous = 0;
+  size_t i;
+
+  switch ( kind ) {
+  case 0:
+    if ( in_bytes != n*elem_size ) return 0;
+    memcpy( out, in, in_bytes );
+    return 1;
+  case 1:
+    return vpic_decode_lossless( in, in_bytes, out, n, elem_size );
+  case 2:
+    if ( elem_size != sizeof(float) || in_bytes < sizeof(double) ) return 0;
+    memcpy( &step, in, sizeof(double) );
+    q = (uint32_t *)malloc( n*sizeof(uint32_t) + 1 );
+    if ( !q ) return 0;
+    if ( !vpic_decode_lossless( in + sizeof(double), in_bytes - sizeof(double),
+                                (uint8_t *)q, n, sizeof(uint32_t) ) ) {
+      free( q );
+      return 0;
+    }
+    for ( i=0; i<n; i++ ) {
+      previous += (int32_t)(q[i] >> 1) ^ -(int32_t)(q[i] & 1);
+      ((float *)out)[i] = (float)( (double)previous*step );
+    }
+    free( q );
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/* Read one frame from fp.  On success *data holds *elements values of
+   *elem_size bytes each (caller frees) and 1 is returned.  Returns 0 at
+   end of file or on a malformed frame. */
+
+static int
+vpic_read_frame( FILE *fp, void **data, uint64_t *elements,
+                 uint32_t *elem_size ) {
+  uint32_t head[4], block[2];
+  uint64_t sizes[3], b, first, n;
+  uint8_t *out, *payload = NULL;
+
+  if ( fread( head, sizeof(uint32_t), 4, fp ) != 4 ) return 0;
+  if ( fread( sizes, sizeof(uint64_t), 3, fp ) != 3 ) return 0;
+  if ( head[0] != VPIC_FRAME_MAGIC || head[2] == 0 || sizes[1] == 0 ) return 0;
+
+  out = (uint8_t *)malloc( sizes[0]*head[2] + 1 );
+  if ( !out ) return 0;
+
+  for ( b=0; b<sizes[2]; b++ ) {
+    if ( fread( block, sizeof(uint32_t), 2, fp ) != 2 ) goto fail;
+    payload = (uint8_t *)realloc( payload, (size_t)block[1] + 1 );
+    if ( !payload ) goto fail;
+    if ( fread( payload, 1, block[1], fp ) != block[1] ) goto fail;
+    first = b*sizes[1];
+    if ( first >= sizes[0] ) goto fail;
+    n = sizes[0] - first < sizes[1] ? sizes[0] - first : sizes[1];
+    if ( !vpic_decode_block( block[0], payload, block[1],
+                             out + first*head[2], n, head[2] ) ) goto fail;
+  }
+
+  free( payload );
+  *data = out;
+  *elements = sizes[0];
+  *elem_size = head[2];
+  return 1;
+
+fail:
+  free( payload );
+  free( out );
+  return 0;
+}
+
+#endif /* vpic_codec_h */
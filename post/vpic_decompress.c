@@ -0,0 +1,77 @@
+
+// Utility to expand compressed field and hydro dumps back into the raw
+// (header version 0) layout, so existing readers and the .vpc based
+// visualization path can consume them unchanged.
+//
+// Usage:
+//     ./vpic_decompress [input dump] [output dump]
+//
+// gcc -O2 -o vpic_decompress vpic_decompress.c
+//
+// Uncompressed (version 0) inputs are copied through as is.  The frame
+// decoder lives in interfaces/c/vpic_codec.h.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "../interfaces/c/vpic_codec.h"
+
+// WRITE_HEADER_V0 plus WRITE_ARRAY_HEADER for a 3-d array
+#define HEADER_BYTES   123
+#define VERSION_OFFSET 23
+
+int main( int argc, char **argv ) {
+  FILE *in, *out;
+  unsigned char header[HEADER_BYTES];
+  int32_t version, zero = 0;
+  void *data;
+  uint64_t elements;
+  uint32_t elem_size;
+  int frames = 0;
+  size_t n;
+  char buf[65536];
+
+  if ( argc != 3 ) {
+    fprintf( stderr, "Usage: %s [input dump] [output dump]\n", argv[0] );
+    return 1;
+  }
+
+  if ( !(in = fopen( argv[1], "rb" )) ) {
+    fprintf( stderr, "Cannot open %s\n", argv[1] );
+    return 1;
+  }
+  if ( !(out = fopen( argv[2], "wb" )) ) {
+    fprintf( stderr, "Cannot open %s\n", argv[2] );
+    return 1;
+  }
+
+  if ( fread( header, 1, HEADER_BYTES, in ) != HEADER_BYTES ) {
+    fprintf( stderr, "%s: truncated header\n", argv[1] );
+    return 1;
+  }
+
+  memcpy( &version, header + VERSION_OFFSET, sizeof(int32_t) );
+  if ( version != 0 ) memcpy( header + VERSION_OFFSET, &zero, sizeof(int32_t) );
+  fwrite( header, 1, HEADER_BYTES, out );
+
+  if ( version == 0 ) {
+    while ( (n = fread( buf, 1, sizeof(buf), in )) > 0 ) fwrite( buf, 1, n, out );
+  } else {
+    // One frame per banded variable, or one for interleaved output
+    while ( vpic_read_frame( in, &data, &elements, &elem_size ) ) {
+      fwrite( data, elem_size, elements, out );
+      free( data );
+      frames++;
+    }
+    if ( !feof( in ) || !frames ) {
+      fprintf( stderr, "%s: malformed compressed frame %d\n", argv[1], frames );
+      return 1;
+    }
+  }
+
+  fclose( in );
+  fclose( out );
+  return 0;
+}
@@ -0,0 +1,256 @@
+// Knobs, decomposition and reporting shared by the benchmark decks
+// (thermal, beam, weibel, harris; messages only uses the knobs and the
+// grid)
+//
+// A deck calls bench_begin first thing in its initialization, builds
+// its grid with bench_grid, loads bench_ppc particles per cell of each
+// species in the cells of its rank and calls bench_step in its
+// diagnostics.  The run is bench_warmup untimed steps followed by
+// bench_steps timed ones; after the last, rank 0 writes the results as
+// JSON.  run_bench.sh builds and runs the decks over a list of rank
+// counts.
+//
+// Command line knobs (all optional):
+//   --scaling weak|strong  Cells given per rank (weak, default) or for
+//                          the whole box (strong)
+//   --cells n              Cells along each axis (default 32)
+//   --nx n, --ny n, --nz n Cells along one axis
+//   --ppc n                Macro particles per cell per species (default 32)
+//   --steps n              Timed steps (default 100)
+//   --warmup n             Untimed steps before them (default 10)
+//   --sort n               Particle sort interval (default 20)
+//   --seed n               Random seed (default 0)
+//   --json file            Output (default <deck>.json)
+
+#include <string>
+#include <vector>
+
+typedef struct bench {
+  const char * deck;
+  std::string json;
+  int weak;
+  int gnx, gny, gnz; // Global cells
+  int px, py, pz;    // Ranks along each axis
+  int nx, ny, nz;    // Cells per rank
+  double ppc;
+  int n_step, n_warm, sort, seed;
+
+  // Measured since the end of the warmup
+  double t0, pushed;
+  std::vector<double> base; // Timers and communication counters then
+} bench_t;
+
+static bench_t bench;
+
+#define bench_ppc    bench.ppc
+#define bench_sort   bench.sort
+#define bench_steps  bench.n_step
+#define bench_warmup bench.n_warm
+
+// Cumulative profile timers and communication counters of this rank
+
+static std::vector<double>
+bench_counters( void ) {
+  std::vector<double> c;
+  for( profile_internal_use_only_timer_t * p=profile_internal_use_only; p->name; p++ )
+    c.push_back( p->t_total + p->t );
+  for( int s=0; s<n_comm_stat; s++ )
+    c.push_back( comm_stat_total[s] + comm_stat[s] );
+  return c;
+}
+
+// The ranks along each axis giving the smallest local domain surface
+// (strong) or the most cubic box (weak)
+
+static void
+bench_decompose( void ) {
+  const int n = world_size;
+  double best = -1;
+  for( int px=1; px<=n; px++ ) {
+    if( n%px ) continue;
+    for( int py=1; py<=n/px; py++ ) {
+      if( (n/px)%py ) continue;
+      const int pz = n/(px*py);
+      double lx, ly, lz;
+      if( bench.weak ) lx = bench.nx*px, ly = bench.ny*py, lz = bench.nz*pz;
+      else {
+        if( bench.gnx%px || bench.gny%py || bench.gnz%pz ) continue;
+        lx = bench.gnx/px, ly = bench.gny/py, lz = bench.gnz/pz;
+      }
+      const double cost = lx*ly + ly*lz + lz*lx;
+      if( best<0 || cost<best ) best = cost, bench.px = px, bench.py = py, bench.pz = pz;
+    }
+  }
+  if( best<0 )
+    ERROR(( "%i ranks can't split %ix%ix%i cells evenly",
+            n, bench.gnx, bench.gny, bench.gnz ));
+  if( bench.weak ) {
+    bench.gnx = bench.nx*bench.px;
+    bench.gny = bench.ny*bench.py;
+    bench.gnz = bench.nz*bench.pz;
+  } else {
+    bench.nx = bench.gnx/bench.px;
+    bench.ny = bench.gny/bench.py;
+    bench.nz = bench.gnz/bench.pz;
+  }
+}
+
+static void
+bench_begin( vpic_simulation * sim,
+             const char * deck,
+             int argc,
+             char ** argv ) {
+  bench.deck = deck;
+  const char * scaling = strip_cmdline_string( &argc, &argv, "--scaling", "weak" );
+  const int cells = strip_cmdline_int( &argc, &argv, "--cells", 32 );
+  const int nx    = strip_cmdline_int( &argc, &argv, "--nx", cells );
+  const int ny    = strip_cmdline_int( &argc, &argv, "--ny", cells );
+  const int nz    = strip_cmdline_int( &argc, &argv, "--nz", cells );
+  bench.ppc    = strip_cmdline_double( &argc, &argv, "--ppc", 32 );
+  bench.n_step = strip_cmdline_int( &argc, &argv, "--steps", 100 );
+  bench.n_warm = strip_cmdline_int( &argc, &argv, "--warmup", 10 );
+  bench.sort   = strip_cmdline_int( &argc, &argv, "--sort", 20 );
+  bench.seed   = strip_cmdline_int( &argc, &argv, "--seed", 0 );
+  const char * json = strip_cmdline_string( &argc, &argv, "--json", NULL );
+  bench.json = json ? json : std::string( deck ) + ".json";
+  if( argc>1 ) ERROR(( "Unknown argument \"%s\" (see sample/bench/bench.h)", argv[1] ));
+
+  if(      !strcmp( scaling, "weak"   ) ) bench.weak = 1;
+  else if( !strcmp( scaling, "strong" ) ) bench.weak = 0;
+  else ERROR(( "--scaling is weak or strong" ));
+  if( nx<1 || ny<1 || nz<1 || bench.ppc<1 || bench.n_step<1 || bench.n_warm<0 )
+    ERROR(( "Bad benchmark knobs" ));
+  bench.nx = bench.gnx = nx;
+  bench.ny = bench.gny = ny;
+  bench.nz = bench.gnz = nz;
+  bench_decompose();
+
+  sim->seed_entropy( bench.seed );
+  sim->num_step        = bench.n_warm + bench.n_step;
+  sim->status_interval = 0; // The profile is reported in the JSON
+  bench.t0 = 0, bench.pushed = 0;
+
+  if( world_rank==0 )
+    log_printf( "*** %s: %s scaling on %i ranks (%ix%ix%i), %ix%ix%i cells, "
+                "%g per cell per species, %i+%i steps\n",
+                bench.deck, scaling, world_size, bench.px, bench.py, bench.pz,
+                bench.gnx, bench.gny, bench.gnz, bench.ppc,
+                bench.n_warm, bench.n_step );
+}
+
+// A periodic box of cells of size d with the low corner at (xl,yl,zl)
+
+static void
+bench_grid( vpic_simulation * sim,
+            double xl, double yl, double zl,
+            double dx, double dy, double dz ) {
+  sim->define_periodic_grid( xl, yl, zl,
+                             xl + dx*bench.gnx, yl + dy*bench.gny, zl + dz*bench.gnz,
+                             bench.gnx, bench.gny, bench.gnz,
+                             bench.px, bench.py, bench.pz );
+}
+
+static void
+bench_report( vpic_simulation * sim,
+              double elapsed ) {
+  std::vector<double> loc = bench_counters();
+  for( size_t i=0; i<loc.size(); i++ ) loc[i] -= bench.base[i];
+  int64_t np = 0;
+  for( species_t * sp=sim->species_list; sp; sp=sp->next ) np += sp->np;
+  loc.push_back( bench.pushed );
+  loc.push_back( (double)np );
+  const int n = loc.size();
+  std::vector<double> all( world_rank==0 ? n*world_size : 0 );
+  mp_gather_uc( (unsigned char *)loc.data(), (unsigned char *)all.data(),
+                n*sizeof(double) );
+  if( world_rank ) return;
+
+  std::vector<double> sum( n, 0 ), max( n, 0 );
+  for( int r=0; r<world_size; r++ )
+    for( int i=0; i<n; i++ ) {
+      const double v = all[ r*n+i ];
+      sum[i] += v;
+      if( v>max[i] ) max[i] = v;
+    }
+  const double rn = 1./world_size;
+
+  FILE * f = fopen( bench.json.c_str(), "w" );
+  if( !f ) ERROR(( "Could not open \"%s\"", bench.json.c_str() ));
+  fprintf( f, "{\n"
+              "  \"deck\": \"%s\",\n"
+              "  \"scaling\": \"%s\",\n"
+              "  \"ranks\": %i,\n"
+              "  \"topology\": [%i, %i, %i],\n"
+              "  \"cells\": [%i, %i, %i],\n"
+              "  \"local_cells\": [%i, %i, %i],\n"
+              "  \"ppc\": %g,\n"
+              "  \"sort_interval\": %i,\n"
+              "  \"seed\": %i,\n"
+              "  \"warmup_steps\": %i,\n"
+              "  \"steps\": %i,\n"
+              "  \"elapsed_s\": %.6e,\n"
+              "  \"step_s\": %.6e,\n"
+              "  \"particles\": %.6e,\n"
+              "  \"particles_pushed\": %.6e,\n"
+              "  \"pushes_per_s\": %.6e,\n",
+           bench.deck, bench.weak ? "weak" : "strong", world_size,
+           bench.px, bench.py, bench.pz,
+           bench.gnx, bench.gny, bench.gnz,
+           bench.nx, bench.ny, bench.nz,
+           bench.ppc, bench.sort, bench.seed, bench.n_warm, bench.n_step,
+           elapsed, elapsed/bench.n_step, sum[n-1],
+           sum[n-2], sum[n-2]/elapsed );
+
+  // Communication: totals over ranks and the mean / max per rank
+
+  int i = 0;
+  for( profile_internal_use_only_timer_t * p=profile_internal_use_only; p->name; p++ ) i++;
+  const int n_timer = i;
+  static const char * comm_name[] = {
+#   define BENCH_COMM_NAME( stat, label ) #stat,
+    COMM_STATS( BENCH_COMM_NAME )
+#   undef BENCH_COMM_NAME
+  };
+  fprintf( f, "  \"comm\": {" );
+  for( int s=0; s<n_comm_stat; s++ )
+    fprintf( f, "%s\n    \"%s\": { \"total\": %.6e, \"mean\": %.6e, \"max\": %.6e }",
+             s ? "," : "", comm_name[s],
+             sum[n_timer+s], rn*sum[n_timer+s], max[n_timer+s] );
+  fprintf( f, "\n  },\n" );
+
+  // Timers: the mean and max per rank of the time and the count
+
+  fprintf( f, "  \"timers\": {" );
+  i = 0;
+  int first = 1;
+  for( profile_internal_use_only_timer_t * p=profile_internal_use_only; p->name; p++, i++ ) {
+    if( max[i]==0 ) continue;
+    fprintf( f, "%s\n    \"%s\": { \"mean_s\": %.6e, \"max_s\": %.6e, \"per_step_s\": %.6e }",
+             first ? "" : ",", p->name, rn*sum[i], max[i], rn*sum[i]/bench.n_step );
+    first = 0;
+  }
+  fprintf( f, "\n  }\n}\n" );
+  fclose( f );
+
+  log_printf( "*** %s: %.3e s per step, %.3e particle pushes per s (%s)\n",
+              bench.deck, elapsed/bench.n_step, sum[n-2]/elapsed,
+              bench.json.c_str() );
+}
+
+// Call in the diagnostics every step
+
+static void
+bench_step( vpic_simulation * sim ) {
+  const int64_t step = sim->step();
+  if( step>bench.n_warm )
+    for( species_t * sp=sim->species_list; sp; sp=sp->next ) bench.pushed += sp->np;
+  if( step==bench.n_warm ) {
+    mp_barrier();
+    bench.base = bench_counters();
+    bench.t0   = wallclock();
+  }
+  if( step==bench.n_warm + bench.n_step ) {
+    mp_barrier();
+    bench_report( sim, wallclock() - bench.t0 );
+  }
+}
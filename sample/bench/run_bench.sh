@@ -0,0 +1,87 @@
+#!/bin/bash
+#
+# Builds the benchmark decks and runs each on every rank count given,
+# for a fixed number of steps.  Each run writes <deck>.<scaling>.<ranks>.json
+# (and .log) in the output directory; summary.json collects them all.
+#
+# Usage: run_bench.sh -v <build>/bin/vpic [options] [-- deck knobs]
+#   -v script  The deck compiler script of a build (bin/vpic)
+#   -l cmd     Launcher, followed by the rank count (default "mpirun -np")
+#   -r list    Rank counts (default "1")
+#   -m mode    weak or strong scaling (default weak)
+#   -d list    Decks (default "thermal beam weibel harris messages")
+#   -s n       Timed steps (default 100)
+#   -w n       Warmup steps (default 10)
+#   -o dir     Output directory (default bench_results)
+#
+# The knobs after "--" go to every deck (e.g. -- --cells 64 --ppc 64;
+# see bench.h).  Compare the JSON of two builds run with the same
+# arguments to measure a change.
+
+here=$(cd "$(dirname "$0")" && pwd)
+vpic=""
+launch="mpirun -np"
+ranks="1"
+mode="weak"
+decks="thermal beam weibel harris messages"
+steps=100
+warmup=10
+out="bench_results"
+
+while getopts "v:l:r:m:d:s:w:o:h" opt; do
+  case $opt in
+    v) vpic=$OPTARG ;;
+    l) launch=$OPTARG ;;
+    r) ranks=$OPTARG ;;
+    m) mode=$OPTARG ;;
+    d) decks=$OPTARG ;;
+    s) steps=$OPTARG ;;
+    w) warmup=$OPTARG ;;
+    o) out=$OPTARG ;;
+    *) sed -n '2,22p' "$0" | sed 's/^# \{0,1\}//'; exit 1 ;;
+  esac
+done
+shift $((OPTIND-1))
+
+if [ -z "$vpic" ] || [ ! -x "$vpic" ]; then
+  echo "run_bench.sh: give the bin/vpic script of a build with -v" >&2
+  exit 1
+fi
+vpic=$(cd "$(dirname "$vpic")" && pwd)/$(basename "$vpic")
+
+mkdir -p "$out" && cd "$out" || exit 1
+
+status=0
+for deck in $decks; do
+  echo "Building $deck"
+  if ! "$vpic" "$here/$deck" > "$deck.build.log" 2>&1; then
+    echo "  failed (see $out/$deck.build.log)" >&2
+    status=1
+    continue
+  fi
+  exe=./$deck.$(uname -s)
+  for n in $ranks; do
+    name=$deck.$mode.$n
+    echo "Running $deck on $n ranks"
+    if ! $launch $n $exe --scaling $mode --steps $steps --warmup $warmup \
+           --json $name.json "$@" > $name.log 2>&1; then
+      echo "  failed (see $out/$name.log)" >&2
+      status=1
+    fi
+  done
+done
+
+# All the results in one array
+
+first=1
+echo "[" > summary.json
+for f in *.$mode.*.json; do
+  [ -f "$f" ] || continue
+  [ $first = 1 ] || echo "," >> summary.json
+  cat "$f" >> summary.json
+  first=0
+done
+echo "]" >> summary.json
+echo "Results in $out/summary.json"
+
+exit $status
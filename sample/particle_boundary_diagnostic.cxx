@@ -800,6 +800,23 @@ begin_initialization {
   *   global->fdParams.stride_x = 8; // illegal!!! -> 150/8 = 18.75
   *------------------------------------------------------------------------*/
 
+ /*--------------------------------------------------------------------------
+  * Set compression (optional)
+  *
+  * Field and hydro payloads can be compressed blockwise on worker threads.
+  * codec_lossless is exact; codec_quantize bounds the pointwise error by
+  * an absolute tolerance, or by a tolerance relative to the largest value
+  * in each block:
+  *
+  *   global->fdParams.compression.codec = codec_lossless;
+  *
+  *   global->hedParams.compression.codec = codec_quantize;
+  *   global->hedParams.compression.rel_tolerance = 1e-4;
+  *
+  * Compressed files carry header version 1; post/vpic_decompress expands
+  * them back to the raw layout for older readers.
+  *------------------------------------------------------------------------*/
+
   // Strides for field and hydro arrays.  Note that here we have defined them
   // the same for fields and all hydro species; if desired, we could use
   // different strides for each.   Also note that strides must divide evenly
@@ -1175,36 +1175,24 @@ begin_field_injection {
     double rl     = M_PI*global->waist*global->waist/global->lambda;
     double h = global->xfocus/rl;                 // distance/Rayleigh length
 
-// Kokkos Port
+    // Device source on the ey mesh points of the ix=1 plane
     int ny = grid->ny;
-    int nz = grid->nz;
-    float dy = grid->dy;
-    float dz = grid->dz;
-    float y0 = grid->y0;
-    float z0 = grid->z0;
     float ycenter = global->ycenter;
     float zcenter = global->zcenter;
     float width = global->width;
     float mask = global->mask;
-    float omega_0 = global->omega_0;
-    float dy_offset = y0 - ycenter;
-    float dz_offset = z0 - zcenter;
-    int sy = grid->sy;
-    int sz = grid->sz;
-    //printf("Injecting\n");
-
-    k_field_t& kfield = field_array->k_f_d;
-
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> left_edge({1, 1}, {nz+2, ny+1});
-    Kokkos::parallel_for("Field injection", left_edge, KOKKOS_LAMBDA(const int iz, const int iy) {
-        auto DY =( (iy-0.5)*dy + dy_offset );
+    double omega_0 = global->omega_0;
+
+    inject_field_plane( field_var::ey, 0, 1,
+      KOKKOS_LAMBDA( float x, float y, float z, double t ) {
+        auto DY =( y - ycenter );
         if(ny==1) DY = 0.;
-        auto DZ =( (iz-1  )*dz + dz_offset );
+        auto DZ =( z - zcenter );
         auto R2   =( DY*DY + DZ*DZ );
         auto PHASE=( omega_0*t + h*R2/(width*width) );
         auto MASK =( R2<=pow(mask*width,2) ? 1 : 0 );
-        kfield(1+sy*iy+sz*iz, field_var::ey) += (prefactor * cos(PHASE) * exp(-R2/(width*width)) * MASK * pulse_shape_factor);
-    });
+        return float(prefactor * cos(PHASE) * exp(-R2/(width*width)) * MASK * pulse_shape_factor);
+      }, t );
 
   }
 
@@ -1,5 +1,5 @@
 #define IN_boundary
-#include "boundary_private.h"
+#include "boundary_device.h"
 
 // Special absorbing boundary condition that tallies the number of
 // particles absorbed of each species.
@@ -28,6 +28,45 @@ interact_absorb_tally( absorb_tally_t      * RESTRICT at,
   return 0;
 }
 
+// Device form of interact_absorb_tally.  The tally is the count of
+// absorbed movers reduced by apply_particle_bc_device.
+
+struct absorb_tally_device {
+
+  typedef Kokkos::View<float*, Kokkos::LayoutStride,
+                       Kokkos::MemoryTraits<Kokkos::Atomic> > rhob_view_t;
+
+  absorb_tally_device( const field_array_t * fa, const species_t * sp ) :
+    rhob( Kokkos::subview( fa->k_f_d, Kokkos::ALL(), int(field_var::rhob) ) ),
+    qsp( sp->q ), r8V( fa->g->r8V ),
+    nx( fa->g->nx ), ny( fa->g->ny ), nz( fa->g->nz ),
+    sy( fa->g->sy ), sz( fa->g->sz ) {}
+
+  rhob_view_t rhob;
+  float qsp, r8V;
+  int nx, ny, nz, sy, sz;
+
+  KOKKOS_INLINE_FUNCTION int
+  operator()( particle_t & p, particle_mover_t & pm, int face,
+              counter_rng & rng ) const {
+    k_accumulate_rhob_single( rhob, p, qsp, r8V, nx, ny, nz, sy, sz );
+    return 0;
+  }
+
+};
+
+int
+interact_absorb_tally_device( const particle_bc_t * RESTRICT pbc,
+                              species_t           * RESTRICT sp,
+                              field_array_t       * RESTRICT fa,
+                              int                            pass ) {
+  absorb_tally_t * RESTRICT at = (absorb_tally_t *)pbc->params;
+  const particle_bc_device_count c =
+    apply_particle_bc_device( absorb_tally_device( at->fa, sp ), pbc, sp, fa, 0, pass );
+  at->tally[ sp->id ] += c.absorbed;
+  return c.rerouted;
+}
+
 void
 checkpt_absorb_tally( const particle_bc_t * RESTRICT pbc ) {
   const absorb_tally_t * RESTRICT at = (const absorb_tally_t *)pbc->params;
@@ -68,12 +107,15 @@ absorb_tally( /**/  species_t      * RESTRICT sp_list,
   at->fa      = fa;
   MALLOC( at->tally, num_species( sp_list ) );
   CLEAR( at->tally, num_species( sp_list ) );  
-  return new_particle_bc_internal( at,
-                                   (particle_bc_func_t)interact_absorb_tally,
-                                   delete_absorb_tally,
-                                   (checkpt_func_t)checkpt_absorb_tally,
-                                   (restore_func_t)restore_absorb_tally,
-                                   NULL );
+  particle_bc_t * pbc =
+    new_particle_bc_internal( at,
+                              (particle_bc_func_t)interact_absorb_tally,
+                              delete_absorb_tally,
+                              (checkpt_func_t)checkpt_absorb_tally,
+                              (restore_func_t)restore_absorb_tally,
+                              NULL );
+  pbc->interact_device = interact_absorb_tally_device;
+  return pbc;
 }
 
 int *
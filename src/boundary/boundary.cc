@@ -7,6 +7,7 @@ void
 checkpt_particle_bc_internal( const particle_bc_t * RESTRICT pbc ) {
   CHECKPT( pbc, 1 );
   CHECKPT_SYM( pbc->interact );
+  CHECKPT_SYM( pbc->interact_device );
   CHECKPT_SYM( pbc->delete_pbc );
   CHECKPT_PTR( pbc->next );
 }
@@ -17,6 +18,7 @@ restore_particle_bc_internal( void * params ) {
   RESTORE( pbc );
   pbc->params = params;
   RESTORE_SYM( pbc->interact );
+  RESTORE_SYM( pbc->interact_device );
   RESTORE_SYM( pbc->delete_pbc );
   RESTORE_PTR( pbc->next );
   return pbc;
@@ -35,7 +37,8 @@ new_particle_bc_internal( void * params,
   pbc->params     = params;
   pbc->interact   = interact;
   pbc->delete_pbc = delete_pbc;
-  /* id, next set by append_particle_bc */
+  /* interact_device set by device capable boundaries, id, next set by
+     append_particle_bc */
   REGISTER_OBJECT( pbc, checkpt, restore, reanimate );
   return pbc;
 }
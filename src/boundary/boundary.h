@@ -118,12 +118,24 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
             field_array_t       * RESTRICT fa,
             accumulator_array_t * RESTRICT aa );
 
+// With diagonal set, movers crossing an edge or corner of the local
+// domain are sent straight to the edge or corner neighbor (needs a grid
+// built by a partition_*_box function)
+
 void
 boundary_p_kokkos( particle_bc_t       * RESTRICT pbc_list,
             species_t           * RESTRICT sp_list,
-            field_array_t       * RESTRICT fa
+            field_array_t       * RESTRICT fa,
+            int                            diagonal
         );
 
+/* In boundary_p_device.cc */
+
+void
+boundary_p_device( particle_bc_t * RESTRICT pbc_list,
+                   species_t     * RESTRICT sp_list,
+                   field_array_t * RESTRICT fa );
+
 /* In maxwellian_reflux.c */
 
 particle_bc_t *
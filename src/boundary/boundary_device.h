@@ -0,0 +1,171 @@
+#ifndef _boundary_device_h_
+#define _boundary_device_h_
+
+#ifndef IN_boundary
+#error "Do not include boundary_device.h; use boundary.h"
+#endif
+
+#include "boundary_private.h"
+#include "../util/rng/philox.h"
+
+/* Device particle boundary conditions.
+
+   After advance_p, mover n of a species is the particle k_pm_i_d(n)
+   that stopped on face k_pc_i_d(n)&7 of voxel k_pc_i_d(n)>>3 with
+   k_pm_d(n) displacement remaining.  A device boundary is a functor
+   Interact applied in parallel to every mover that stopped on one of
+   its faces:
+
+     KOKKOS_INLINE_FUNCTION int
+     operator()( particle_t & p, particle_mover_t & pm, int face,
+                 counter_rng & rng ) const;
+
+   p is the particle at the hit (position on the face, p.i its voxel,
+   momentum at the time of the hit) and pm its remaining displacement,
+   as an interact function sees them.  It returns 0 if the particle is
+   absorbed or 1 if p and pm have been rewritten with the particle to
+   reinject (at most one per incident particle, in the same voxel).  As
+   on the host, the functor is responsible for rhob.  rng is keyed by
+   the particle index, the step, the species and the pass.
+
+   Reinjected particles are written back in place and finish their move
+   on the device.  Those that come to rest are dropped from the mover
+   list so compress keeps them; those that hit another face stay on it
+   for the next pass (another custom boundary) or boundary_p_kokkos.
+   Absorbed movers are flagged with a negative voxel so boundary_p_kokkos
+   skips them and compress removes them. */
+
+enum particle_bc_device_mark {
+  particle_bc_device_absorbed = -1, /* Remove the particle */
+  particle_bc_device_kept     = -2  /* Drop the mover, keep the particle */
+};
+
+/* Movers absorbed and handed to another custom boundary by one
+   application of a device boundary */
+
+struct particle_bc_device_count {
+  int absorbed, rerouted;
+
+  KOKKOS_INLINE_FUNCTION
+  particle_bc_device_count() : absorbed(0), rerouted(0) {}
+
+  KOKKOS_INLINE_FUNCTION particle_bc_device_count &
+  operator+=( const particle_bc_device_count & rhs ) {
+    absorbed += rhs.absorbed;
+    rerouted += rhs.rerouted;
+    return *this;
+  }
+};
+
+namespace Kokkos {
+template<>
+struct reduction_identity<particle_bc_device_count> {
+  KOKKOS_FORCEINLINE_FUNCTION static particle_bc_device_count
+  sum() { return particle_bc_device_count(); }
+};
+}
+
+template<class Interact>
+particle_bc_device_count
+apply_particle_bc_device( const Interact              &          interact,
+                          const particle_bc_t         * RESTRICT pbc,
+                          /**/  species_t             * RESTRICT sp,
+                          /**/  field_array_t         * RESTRICT fa,
+                          uint32_t                               seed,
+                          int                                    pass ) {
+  particle_bc_device_count count;
+  const int nm = sp->k_nm_h(0);
+  if( !nm ) return count;
+
+  const grid_t * g = sp->g;
+  const int64_t id = pbc->id;
+  const uint32_t rank = world_rank, stream = philox_stream( philox_boundary, sp->id | ( pass<<16 ) );
+  const int64_t step = g->step;
+  const int64_t rangel = g->rangel, rangeh = g->rangeh;
+  const float qsp = sp->q;
+  const float cx = 0.25 * g->rdy * g->rdz / g->dt;
+  const float cy = 0.25 * g->rdz * g->rdx / g->dt;
+  const float cz = 0.25 * g->rdx * g->rdy / g->dt;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+
+  const auto& k_particles = sp->k_p_d;
+  const auto& k_particles_i = sp->k_p_i_d;
+  const auto& k_particle_movers = sp->k_pm_d;
+  const auto& k_particle_movers_i = sp->k_pm_i_d;
+  const auto& k_particle_copy = sp->k_pc_d;
+  const auto& k_particle_i_copy = sp->k_pc_i_d;
+  const auto& k_neighbors = g->k_neighbor_d;
+
+  // Currents of the reinjected particles
+  k_field_sa_t k_f_sv = fa->k_field_sa_d;
+  k_f_sv.reset_except( fa->k_f_d );
+
+  Kokkos::parallel_reduce("particle bc device", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, nm), KOKKOS_LAMBDA (const int n, particle_bc_device_count & c) {
+    const int code = k_particle_i_copy(n);
+    if( code<0 ) return; // Already handled
+    const int voxel = code>>3, face = code&7;
+    if( k_neighbors( 6*voxel + face )!=id ) return;
+
+    const int p_index = k_particle_movers_i(n);
+    particle_t p;
+    p.dx = k_particle_copy(n, particle_var::dx);
+    p.dy = k_particle_copy(n, particle_var::dy);
+    p.dz = k_particle_copy(n, particle_var::dz);
+    p.i  = voxel;
+    p.ux = k_particle_copy(n, particle_var::ux);
+    p.uy = k_particle_copy(n, particle_var::uy);
+    p.uz = k_particle_copy(n, particle_var::uz);
+    p.w  = k_particle_copy(n, particle_var::w);
+
+    particle_mover_t pm;
+    pm.dispx = k_particle_movers(n, particle_mover_var::dispx);
+    pm.dispy = k_particle_movers(n, particle_mover_var::dispy);
+    pm.dispz = k_particle_movers(n, particle_mover_var::dispz);
+    pm.i     = p_index;
+
+    counter_rng rng( seed, rank, stream, p_index, step );
+    if( !interact( p, pm, face, rng ) ) {
+      k_particle_i_copy(n) = particle_bc_device_absorbed;
+      c.absorbed++;
+      return;
+    }
+
+    // Reinject in place and finish the move
+    pm.i = p_index;
+    k_particles(p_index, particle_var::dx) = p.dx;
+    k_particles(p_index, particle_var::dy) = p.dy;
+    k_particles(p_index, particle_var::dz) = p.dz;
+    k_particles(p_index, particle_var::ux) = p.ux;
+    k_particles(p_index, particle_var::uy) = p.uy;
+    k_particles(p_index, particle_var::uz) = p.uz;
+    k_particles(p_index, particle_var::w)  = p.w;
+    k_particles_i(p_index) = p.i;
+
+    if( !move_p_kokkos( k_particles, k_particles_i, &pm, k_f_sv, g, k_neighbors,
+                        rangel, rangeh, qsp, cx, cy, cz, nx, ny, nz ) ) {
+      k_particle_i_copy(n) = particle_bc_device_kept;
+      return;
+    }
+
+    // Hit another face; update the mover as advance_p would have
+    const int new_code = k_particles_i(p_index);
+    k_particle_movers(n, particle_mover_var::dispx) = pm.dispx;
+    k_particle_movers(n, particle_mover_var::dispy) = pm.dispy;
+    k_particle_movers(n, particle_mover_var::dispz) = pm.dispz;
+    k_particle_copy(n, particle_var::dx) = k_particles(p_index, particle_var::dx);
+    k_particle_copy(n, particle_var::dy) = k_particles(p_index, particle_var::dy);
+    k_particle_copy(n, particle_var::dz) = k_particles(p_index, particle_var::dz);
+    k_particle_copy(n, particle_var::ux) = k_particles(p_index, particle_var::ux);
+    k_particle_copy(n, particle_var::uy) = k_particles(p_index, particle_var::uy);
+    k_particle_copy(n, particle_var::uz) = k_particles(p_index, particle_var::uz);
+    k_particle_copy(n, particle_var::w)  = k_particles(p_index, particle_var::w);
+    k_particle_i_copy(n) = new_code;
+    if( k_neighbors( 6*(new_code>>3) + (new_code&7) )<=-3 ) c.rerouted++;
+  }, count);
+
+  Kokkos::Experimental::contribute( fa->k_f_d, k_f_sv );
+  return count;
+}
+
+#endif /* _boundary_device_h_ */
@@ -1,6 +1,7 @@
 #define IN_boundary
 #include "boundary_private.h"
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 
 // If this is defined particle and mover buffers will not resize dynamically
@@ -37,9 +38,60 @@ static const int f2rb[6] = { BOUNDARY( 1, 0, 0),
 // Gives the axis associated with a local face
 static const int axis[6]  = { 0, 1, 2,  0,  1,  2 };
 
+// Gives the mover counter of a local face
+static const int face_stat[6] = { comm_stat_mover_mx, comm_stat_mover_my,
+    comm_stat_mover_mz, comm_stat_mover_px, comm_stat_mover_py,
+    comm_stat_mover_pz };
+
 // Gives the location of sending face on the receiver
 static const float dir[6] = { 1, 1, 1, -1, -1, -1 };
 
+// Stand-ins for the views of move_p_kokkos_host_serial.  They let the
+// sender trace a mover through a cell of a neighboring domain with the
+// same arithmetic the owner of the cell will use, without depositing
+// any current.
+
+struct trace_particle_t {
+  float * p;
+  int * i;
+  float & operator()( int, int v ) const { return p[v]; }
+  int   & operator()( int ) const        { return *i; }
+};
+
+struct trace_neighbor_t {
+  int64_t operator()( int64_t ) const { return 0; } // Every face leaves the cell
+};
+
+struct trace_accum_t {
+  float sink;
+  float & operator()( int, int ) { return sink; }
+};
+
+// Trace a mover entering a cell of a neighboring domain (in the state
+// of injector pi, in the coordinates of that cell) to the next face it
+// crosses.  Returns the face (and leaves pi on it, in the coordinates
+// of the cell beyond) or -1 if the mover stops in the cell.
+
+static int
+trace_cell( particle_injector_t * pi,
+            const grid_t * g ) {
+  float p[8] = { pi->dx, pi->dy, pi->dz, pi->ux, pi->uy, pi->uz, pi->w, 0 };
+  int i = 0, face;
+  particle_mover_t pm;
+  trace_particle_t tp = { p, &i };
+  trace_neighbor_t tn;
+  trace_accum_t ta;
+
+  pm.dispx = pi->dispx; pm.dispy = pi->dispy; pm.dispz = pi->dispz; pm.i = 0;
+  if( !move_p_kokkos_host_serial( tp, tp, &pm, ta, g, tn, 0, -1, 0.f ) ) return -1;
+
+  face = i & 7;
+  pi->dx = p[0]; pi->dy = p[1]; pi->dz = p[2];
+  (&pi->dx)[axis[face]] = -(&pi->dx)[axis[face]];
+  pi->dispx = pm.dispx; pi->dispy = pm.dispy; pi->dispz = pm.dispz;
+  return face;
+}
+
 /**
  * @brief The original boundary_p takes all moved particles, and integrates
  * them to the particle list. It requires that nm be monotonically increasing,
@@ -54,13 +106,15 @@ static const float dir[6] = { 1, 1, 1, -1, -1, -1 };
  * @param pbc_list Particle boundary condition list
  * @param sp_list Species list
  * @param fa Field array
- * @param aa Accumulator array
+ * @param diagonal Route movers crossing an edge or corner of the local
+ * domain straight to the rank that keeps them (see below)
  */
 void
 boundary_p_kokkos(
         particle_bc_t       * RESTRICT pbc_list,
         species_t           * RESTRICT sp_list,
-        field_array_t       * RESTRICT fa
+        field_array_t       * RESTRICT fa,
+        int                            diagonal
       )
 {
 
@@ -69,10 +123,10 @@ boundary_p_kokkos(
   static particle_injector_t * RESTRICT ALIGNED(16) ci = NULL;
   static int max_ci = 0;
 
-  int n_send[6], n_recv[6], n_ci;
+  int n_send[27], n_recv[27], n_ci;
 
   species_t * sp;
-  int face;
+  int face, b;
 
   // Check input args
 
@@ -107,33 +161,86 @@ boundary_p_kokkos(
   const int64_t rangeh = g->rangeh;
   const int64_t rangem = g->range[world_size];
 
-  int bc[6], shared[6];
+  // Messages go through the port of the direction of the neighbor
+  // (BOUNDARY(i,j,k)), tagged with that direction
+
+  int bc[27], shared[27];
   int64_t range[6];
 
+  for( b=0; b<27; b++ ) bc[b] = g->bc[b], shared[b] = 0;
   for( face=0; face<6; face++ ) {
-    bc[face] = g->bc[f2b[face]];
-    shared[face] = (bc[face]>=0) && (bc[face]<world_size) &&
-                   (bc[face]!=world_rank);
-    if( shared[face] ) range[face] = g->range[bc[face]];
+    b = f2b[face];
+    shared[b] = (bc[b]>=0) && (bc[b]<world_size) && (bc[b]!=world_rank);
+    if( shared[b] ) range[face] = g->range[bc[b]];
   }
 
+  // With the diagonal exchange, a mover leaving through a face is traced
+  // through the cell it enters.  If it would leave that cell through a
+  // face of the neighbor's domain, it is sent straight to the edge (or
+  // corner) neighbor beyond, and the neighbors it passes through get a
+  // deposit only copy (to accumulate its current in their cell).  This
+  // saves the extra rounds the movers would otherwise take to hop face
+  // by face.  The ranks across the edges and corners are in the
+  // diagonal entries of g->bc (set by the partition_*_box functions;
+  // their sizes are given by the cut planes).  A face whose particle
+  // boundary condition was overridden (set_pbc) still exchanges fields,
+  // but no mover may be routed across it.
+
+  int ndim[27][3];
+  if( diagonal && g->cut ) {
+    int crossed[27];
+    for( b=0; b<27; b++ ) crossed[b] = 0;
+    for( face=0; face<6; face++ ) {
+      const int v = face<3 ? VOXEL(1,1,1, g->nx,g->ny,g->nz) :
+                             VOXEL(g->nx,g->ny,g->nz, g->nx,g->ny,g->nz);
+      crossed[f2b[face]] = shared[f2b[face]] && neighbor[6*v+face]>=0;
+    }
+    for( int k=-1; k<=1; k++ )
+      for( int j=-1; j<=1; j++ )
+        for( int i=-1; i<=1; i++ ) {
+          b = BOUNDARY(i,j,k);
+          if( (i!=0) + (j!=0) + (k!=0) < 2 ) continue;
+          if( bc[b]<0 || bc[b]>=world_size || bc[b]==world_rank ) continue;
+          if( ( i && !crossed[BOUNDARY(i,0,0)] ) ||
+              ( j && !crossed[BOUNDARY(0,j,0)] ) ||
+              ( k && !crossed[BOUNDARY(0,0,k)] ) ) continue;
+          int box[6];
+          grid_rank_box( g, bc[b], box );
+          ndim[b][0] = box[3], ndim[b][1] = box[4], ndim[b][2] = box[5];
+          shared[b] = 1;
+        }
+  }
+  const int n_local[3] = { g->nx, g->ny, g->nz };
+
+  // Tracer ids, when any species has them, travel as an int64_t array
+  // behind the injectors of each message.  Tracers are defined on every
+  // rank together so both ends agree on the message layout.
+
+  int send_ids = 0;
+  LIST_FOR_EACH( sp, sp_list ) if( sp->has_particle_ids() ) send_ids = 1;
+  const size_t injector_size = sizeof(particle_injector_t) +
+                               ( send_ids ? sizeof(int64_t) : 0 );
+
   // Begin receiving the particle counts
 
-  for( face=0; face<6; face++ )
-    if( shared[face] ) {
-      mp_size_recv_buffer( mp, f2b[face], sizeof(int) );
-      mp_begin_recv( mp, f2b[face], sizeof(int), bc[face], f2rb[face] );
+  for( b=0; b<27; b++ )
+    if( shared[b] ) {
+      mp_size_recv_buffer( mp, b, sizeof(int) );
+      mp_begin_recv( mp, b, sizeof(int), bc[b], 26-b );
     }
 
   // Load the particle send and local injection buffers
 
+  const double t_pack = wallclock();
+
   // Track if rhob needs to be updated on the device.
   // TODO: Do the absorbtion on the device.
   int absorbed = 0;
 
   do {
 
-    particle_injector_t * RESTRICT ALIGNED(16) pi_send[6];
+    particle_injector_t * RESTRICT ALIGNED(16) pi_send[27];
+    char * id_send[27];
 
     // Presize the send and injection buffers
     //
@@ -160,11 +267,12 @@ boundary_p_kokkos(
 
     int nm = 0; LIST_FOR_EACH( sp, sp_list ) nm += sp->nm;
 
-    for( face=0; face<6; face++ )
-      if( shared[face] ) {
-        mp_size_send_buffer( mp, f2b[face], 16+nm*sizeof(particle_injector_t) );
-        pi_send[face] = (particle_injector_t *)(((char *)mp_send_buffer(mp,f2b[face]))+16);
-        n_send[face] = 0;
+    for( b=0; b<27; b++ )
+      if( shared[b] ) {
+        mp_size_send_buffer( mp, b, 16+nm*injector_size );
+        pi_send[b] = (particle_injector_t *)(((char *)mp_send_buffer(mp,b))+16);
+        id_send[b] = (char *)(pi_send[b] + nm); // Packed behind the injectors before sending
+        n_send[b] = 0;
       }
 
     if( max_ci<nm ) {
@@ -210,6 +318,9 @@ boundary_p_kokkos(
             //int voxel = p0[i].i;
             int voxel = particle_send(copy_index);
 
+            // Already absorbed by a device boundary (boundary_p_device)
+            if( voxel<0 ) continue;
+
             int face = voxel & 7;
             voxel >>= 3;
 
@@ -253,37 +364,68 @@ boundary_p_kokkos(
             // Send to a neighboring node
             if( ((nn>=0) & (nn< rangel)) | ((nn>rangeh) & (nn<=rangem)) )
             {
-                pi = &pi_send[face][n_send[face]++];
+                particle_injector_t hop[3];
+                int port[3], nh = 1;
 
-                //pi->dx=p0[i].dx;
-                //pi->dz=p0[i].dz;
+                pi = hop;
                 pi->dx = sp->k_pc_h(copy_index, particle_var::dx);
                 pi->dy = sp->k_pc_h(copy_index, particle_var::dy);
                 pi->dz = sp->k_pc_h(copy_index, particle_var::dz);
-
-                pi->i = nn - range[face];
-
-                //pi->ux=p0[i].ux;
-                //pi->uy=p0[i].uy;
-                //pi->uz=p0[i].uz;
                 pi->ux = sp->k_pc_h(copy_index, particle_var::ux);
                 pi->uy = sp->k_pc_h(copy_index, particle_var::uy);
                 pi->uz = sp->k_pc_h(copy_index, particle_var::uz);
-
-                //pi->w=p0[i].w;
-                pi->w = sp->k_pc_h(copy_index, particle_var::w);
-
+                pi->w  = sp->k_pc_h(copy_index, particle_var::w);
                 pi->dispx = pm->dispx; pi->dispy = pm->dispy; pi->dispz = pm->dispz;
-                pi->sp_id = sp_id;
 
                 (&pi->dx)[axis[face]] = dir[face];
                 pi->i                 = nn - range[face];
                 pi->sp_id             = sp_id;
+                port[0]               = f2b[face];
+
+                // Follow the mover through the domains it will cross
+                // (see above)
+                if( shared[f2b[face]] && diagonal && g->cut ) {
+                    const int z = voxel/g->sz, y = (voxel - z*g->sz)/g->sy;
+                    const int at[3] = { voxel - y*g->sy - z*g->sz, y, z };
+                    int d[3] = { 0, 0, 0 };
+                    d[axis[face]] = face<3 ? -1 : 1;
+                    particle_injector_t t = hop[0];
+                    for( ; nh<3; nh++ ) {
+                        const int f = trace_cell( &t, g );
+                        if( f<0 ) break;                   // Stops in the cell
+                        const int a = axis[f];
+                        if( d[a] ) break;                  // Owner moves it on
+                        if( at[a]!=( f<3 ? 1 : n_local[a] ) ) break; // Stays with the owner
+                        d[a] = f<3 ? -1 : 1;
+                        b = BOUNDARY(d[0],d[1],d[2]);
+                        if( !shared[b] ) break;
+                        int c[3];
+                        for( int k=0; k<3; k++ )
+                            c[k] = d[k]<0 ? ndim[b][k] : d[k]>0 ? 1 : at[k];
+                        t.i = VOXEL(c[0],c[1],c[2], ndim[b][0],ndim[b][1],ndim[b][2]);
+                        hop[nh] = t, port[nh] = b;
+                    }
+                }
+
+                // All but the last rank only accumulate the current of the
+                // mover in their cell
+                for( int h=0; h<nh; h++ ) {
+                    b = port[h];
+                    if( send_ids ) {
+                        int64_t id = ( h==nh-1 && sp->has_particle_ids() ) ?
+                                     sp->k_pc_id_h(copy_index) : 0;
+                        memcpy( id_send[b] + n_send[b]*sizeof(int64_t), &id, sizeof(int64_t) );
+                    }
+                    pi = &pi_send[b][n_send[b]++];
+                    *pi = hop[h];
+                    if( h<nh-1 ) pi->sp_id = -1 - sp_id; // Deposit only
+                }
                 //goto backfill;
                 continue;
             }
 
-            // User-defined handling
+            // User-defined handling (those with a device interaction were
+            // applied by boundary_p_device)
 
             // After a particle interacts with a boundary it is removed
             // from the local particle list.  Thus, if a boundary handler
@@ -339,6 +481,17 @@ boundary_p_kokkos(
     }
 
   } while(0);
+
+  COMM_STAT( pack, wallclock() - t_pack );
+
+  // Movers sent to each face neighbor (and to the edge and corner ones)
+
+  for( b=0; b<27; b++ )
+    if( shared[b] ) {
+      int s = comm_stat_mover_diag;
+      for( face=0; face<6; face++ ) if( f2b[face]==b ) s = face_stat[face];
+      comm_stat_now[s] += n_send[b];
+    }
   
 
   // Finish exchanging particle counts and start exchanging actual
@@ -353,32 +506,39 @@ boundary_p_kokkos(
   // equilvanet of a MPI_Getcount to determine how much data you
   // actually received.
 
-  for( face=0; face<6; face++ )
-    if( shared[face] ) {
-      *((int *)mp_send_buffer( mp, f2b[face] )) = n_send[face];
-      mp_begin_send( mp, f2b[face], sizeof(int), bc[face], f2b[face] );
+  for( b=0; b<27; b++ )
+    if( shared[b] ) {
+      *((int *)mp_send_buffer( mp, b )) = n_send[b];
+      mp_begin_send( mp, b, sizeof(int), bc[b], b );
     }
 
-  for( face=0; face<6; face++ )
-    if( shared[face] )  {
-      mp_end_recv( mp, f2b[face] );
-      n_recv[face] = *((int *)mp_recv_buffer( mp, f2b[face] ));
-      mp_size_recv_buffer( mp, f2b[face],
-                           16+n_recv[face]*sizeof(particle_injector_t) );
-      mp_begin_recv( mp, f2b[face], 16+n_recv[face]*sizeof(particle_injector_t),
-                     bc[face], f2rb[face] );
+  for( b=0; b<27; b++ )
+    if( shared[b] )  {
+      mp_end_recv( mp, b );
+      n_recv[b] = *((int *)mp_recv_buffer( mp, b ));
+      mp_size_recv_buffer( mp, b, 16+n_recv[b]*injector_size );
+      mp_begin_recv( mp, b, 16+n_recv[b]*injector_size, bc[b], 26-b );
     }
 
-  for( face=0; face<6; face++ )
-    if( shared[face] ) {
-      mp_end_send( mp, f2b[face] );
+  for( b=0; b<27; b++ )
+    if( shared[b] ) {
+      mp_end_send( mp, b );
       // FIXME: ASSUMES MP WON'T MUCK WITH REST OF SEND BUFFER. IF WE
       // DID MORE EFFICIENT MOVER ALLOCATION ABOVE, THIS WOULD BE
       // ROBUSTED AGAINST MP IMPLEMENTATION VAGARIES
-      mp_begin_send( mp, f2b[face], 16+n_send[face]*sizeof(particle_injector_t),
-                     bc[face], f2b[face] );
+      if( send_ids ) {
+        char * pi_end = ((char *)mp_send_buffer( mp, b )) + 16 +
+                        n_send[b]*sizeof(particle_injector_t);
+        memmove( pi_end, id_send[b], n_send[b]*sizeof(int64_t) );
+      }
+      mp_begin_send( mp, b, 16+n_send[b]*injector_size, bc[b], b );
     }
 
+  // The injection below waits on the messages as they come in; that
+  // time goes to the message wait
+
+  const double t_inject = wallclock() - comm_stat_now[ comm_stat_wait ];
+
   do {
     // Unpack the species list for random acesss
 
@@ -404,20 +564,20 @@ boundary_p_kokkos(
     // Inject particles.  We do custom local injection first to
     // increase message overlap opportunities.
 
-    face = 5;
-    do {
+    for( b=-1; b<27; b++ ) {
       //particle_t          * RESTRICT ALIGNED(32) p;
       particle_mover_t    * RESTRICT ALIGNED(16) pm;
       const particle_injector_t * RESTRICT ALIGNED(16) pi;
-      int nm, n, id;
+      const char * id_recv = NULL; // Local injectors carry no tracer ids
+      int nm, n, id, deposit_only;
 
-      face++; if( face==7 ) face = 0;
-      if( face==6 ) pi = ci, n = n_ci;
-      else if( shared[face] ) {
-        mp_end_recv( mp, f2b[face] );
+      if( b<0 ) pi = ci, n = n_ci;
+      else if( shared[b] ) {
+        mp_end_recv( mp, b );
         pi = (particle_injector_t *)
-          (((char *)mp_recv_buffer(mp,f2b[face]))+16);
-        n  = n_recv[face];
+          (((char *)mp_recv_buffer(mp,b))+16);
+        n  = n_recv[b];
+        if( send_ids ) id_recv = (const char *)( pi + n );
       } else continue;
 
       // WARNING: THIS TRUSTS THAT THE INJECTORS (INCLUDING THOSE
@@ -427,6 +587,8 @@ boundary_p_kokkos(
       pi += n-1;
       for( ; n; pi--, n-- ) {
         id = pi->sp_id;
+        deposit_only = id<0; // Passing through (see the diagonal exchange)
+        if( deposit_only ) id = -1 - id;
 
         pm = sp_pm[id];
         nm = sp_nm[id];
@@ -460,6 +622,13 @@ boundary_p_kokkos(
         int pii = pi->i;
         particle_recv_i(write_index) = pii;
 
+        // pi is injector n-1 of this message
+        if( sp_[id]->has_particle_ids() ) {
+          int64_t pid = 0;
+          if( id_recv ) memcpy( &pid, id_recv + (n-1)*sizeof(int64_t), sizeof(int64_t) );
+          sp_[id]->k_pr_id_h(write_index) = pid;
+        }
+
         // track how many particles we buffer up here
         sp_[id]->num_to_copy++;
 
@@ -485,6 +654,13 @@ boundary_p_kokkos(
                 sp_[id]->q
         );
 
+        if( deposit_only )
+        {
+            // The rank it goes to has it already
+            sp_[id]->num_to_copy--;
+            continue;
+        }
+
         int keep_id = nm + ret_code - 1;
         sp_nm[id] = keep_id+1; // +1 to convert from index to count:w
 
@@ -502,10 +678,12 @@ boundary_p_kokkos(
             particle_send(keep_id, particle_var::uz) = particle_recv(write_index, particle_var::uz);
             particle_send(keep_id, particle_var::w)  = particle_recv(write_index, particle_var::w);
             particle_send_i(keep_id)  = particle_recv_i(write_index);
+            if( sp_[id]->has_particle_ids() )
+              sp_[id]->k_pc_id_h(keep_id) = sp_[id]->k_pr_id_h(write_index);
         }
 
       }
-    } while(face!=5);
+    }
 
     LIST_FOR_EACH( sp, sp_list ) {
       sp->nm=sp_nm[sp->id];
@@ -513,9 +691,11 @@ boundary_p_kokkos(
 
   } while(0);
 
-  for( face=0; face<6; face++ )
+  COMM_STAT( pack, wallclock() - comm_stat_now[ comm_stat_wait ] - t_inject );
+
+  for( b=0; b<27; b++ )
   {
-    if( shared[face] ) mp_end_send(mp,f2b[face]);
+    if( shared[b] ) mp_end_send(mp,b);
   }
 
   // If there is additional bound charge, update rhob on device
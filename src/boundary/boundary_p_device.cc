@@ -0,0 +1,113 @@
+#define IN_boundary
+#include "boundary_device.h"
+
+// Bound on the passes over the custom boundaries each step.  A
+// reinjected particle that hits another custom boundary is handled on
+// the next pass; what is left after the last is warned about by
+// boundary_p_kokkos.
+enum { MAX_DEVICE_PASS = 4 };
+
+/**
+ * @brief Drop the movers flagged as kept by the device boundaries so
+ * compress leaves their particles in place.  The holes in [0,nm_new) are
+ * filled with the surviving movers of [nm_new,nm), so the mover order is
+ * not preserved (neither compress nor boundary_p_kokkos rely on it).
+ *
+ * @param sp Species whose movers to compact
+ */
+static void
+drop_kept_movers( species_t * RESTRICT sp )
+{
+  const int nm = sp->k_nm_h(0);
+  const auto& k_particle_movers = sp->k_pm_d;
+  const auto& k_particle_movers_i = sp->k_pm_i_d;
+  const auto& k_particle_copy = sp->k_pc_d;
+  const auto& k_particle_i_copy = sp->k_pc_i_d;
+
+  int n_kept = 0;
+  Kokkos::parallel_reduce("count kept movers", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, nm), KOKKOS_LAMBDA (const int n, int & kept) {
+    if( k_particle_i_copy(n)==particle_bc_device_kept ) kept++;
+  }, n_kept);
+  if( !n_kept ) return;
+
+  const int nm_new = nm - n_kept;
+
+  // The compressor scratch is free until compress runs
+  const auto& holes = sp->clean_up_to;
+  const auto& fills = sp->clean_up_from;
+
+  Kokkos::parallel_scan("find mover holes", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, nm_new), KOKKOS_LAMBDA (const int n, int & offset, const bool final) {
+    if( k_particle_i_copy(n)==particle_bc_device_kept ) {
+      if( final ) holes(offset) = n;
+      offset++;
+    }
+  });
+
+  // As many holes in the front as survivors in the back
+  int n_holes = 0;
+  Kokkos::parallel_scan("find mover fills", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (nm_new, nm), KOKKOS_LAMBDA (const int n, int & offset, const bool final) {
+    if( k_particle_i_copy(n)!=particle_bc_device_kept ) {
+      if( final ) fills(offset) = n;
+      offset++;
+    }
+  }, n_holes);
+
+  Kokkos::parallel_for("fill mover holes", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n_holes), KOKKOS_LAMBDA (const int r) {
+    const int to = holes(r), from = fills(r);
+    k_particle_movers(to, particle_mover_var::dispx) = k_particle_movers(from, particle_mover_var::dispx);
+    k_particle_movers(to, particle_mover_var::dispy) = k_particle_movers(from, particle_mover_var::dispy);
+    k_particle_movers(to, particle_mover_var::dispz) = k_particle_movers(from, particle_mover_var::dispz);
+    k_particle_movers_i(to) = k_particle_movers_i(from);
+    k_particle_copy(to, particle_var::dx) = k_particle_copy(from, particle_var::dx);
+    k_particle_copy(to, particle_var::dy) = k_particle_copy(from, particle_var::dy);
+    k_particle_copy(to, particle_var::dz) = k_particle_copy(from, particle_var::dz);
+    k_particle_copy(to, particle_var::ux) = k_particle_copy(from, particle_var::ux);
+    k_particle_copy(to, particle_var::uy) = k_particle_copy(from, particle_var::uy);
+    k_particle_copy(to, particle_var::uz) = k_particle_copy(from, particle_var::uz);
+    k_particle_copy(to, particle_var::w)  = k_particle_copy(from, particle_var::w);
+    k_particle_i_copy(to) = k_particle_i_copy(from);
+  });
+
+  sp->k_nm_h(0) = nm_new;
+  Kokkos::deep_copy(sp->k_nm_d, sp->k_nm_h);
+}
+
+/**
+ * @brief Apply the device capable custom particle boundary conditions to
+ * the movers left by advance_p, before they are copied to the host.
+ *
+ * @param pbc_list Particle boundary condition list
+ * @param sp_list Species list
+ * @param fa Field array
+ */
+void
+boundary_p_device( particle_bc_t * RESTRICT pbc_list,
+                   species_t     * RESTRICT sp_list,
+                   field_array_t * RESTRICT fa )
+{
+  particle_bc_t * pbc;
+  species_t * sp;
+
+  int n_device = 0;
+  for( pbc=pbc_list; pbc; pbc=pbc->next ) if( pbc->interact_device ) n_device++;
+  if( !n_device || !sp_list ) return;
+  if( !fa ) ERROR(( "Bad args" ));
+
+  LIST_FOR_EACH( sp, sp_list ) {
+    if( !sp->k_nm_h(0) ) continue;
+
+    for( int pass=0; pass<MAX_DEVICE_PASS; pass++ ) {
+      int rerouted = 0;
+      for( pbc=pbc_list; pbc; pbc=pbc->next )
+        if( pbc->interact_device )
+          rerouted += pbc->interact_device( pbc, sp, fa, pass );
+      if( !rerouted ) break;
+    }
+
+    drop_kept_movers( sp );
+  }
+}
@@ -30,12 +30,27 @@ typedef int /* Number of particles injected */
                                             the voxel containing the above
                                             particle was hit */
 
+/* Device boundary conditions act on the movers of a species still on
+   the device, after advance_p and before the movers are copied to the
+   host (see boundary_device.h).  Movers they handle never reach
+   boundary_p_kokkos.  A boundary without a device interaction is
+   handled by interact on the host. */
+
+typedef int /* Number of movers handed to another custom boundary */
+(*particle_bc_device_func_t)(
+  const particle_bc_t * RESTRICT pbc,   /* The boundary ... */
+  species_t           * RESTRICT sp,    /* acting on the movers of this
+                                           species ... */
+  field_array_t       * RESTRICT fa,    /* with these fields ... */
+  int                            pass ); /* for the pass-th time this step */
+
 typedef void
 (*delete_particle_bc_func_t)( particle_bc_t * RESTRICT pbc );
 
 struct particle_bc {
   void * params;
   particle_bc_func_t interact;
+  particle_bc_device_func_t interact_device; /* NULL if host only */
   delete_particle_bc_func_t delete_pbc;
   int64_t id;
   particle_bc_t * next;
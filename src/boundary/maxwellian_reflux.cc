@@ -36,9 +36,15 @@
 //
 // Written by:  Brian J. Albright, X-1, LANL   April, 2005
 // Revamped by KJB, May 2008, Sep 2009
+//
+// On the device (interact_maxwellian_reflux_device), the same sampling
+// is done by a functor and the refluxed particle is written back in
+// place of the incident one.  Deviates come from a counter_rng keyed by
+// a seed drawn from the pool at construction, so the device reflux does
+// not advance the pool.
 
 #define IN_boundary
-#include "boundary_private.h"
+#include "boundary_device.h"
  
 /* Private interface ********************************************************/
 
@@ -47,6 +53,7 @@ typedef struct maxwellian_reflux {
   rng_t     * rng;
   float     * ut_para;
   float     * ut_perp;
+  uint32_t    seed;    // Of the device reflux
 } maxwellian_reflux_t;
 
 #ifndef M_SQRT2
@@ -176,6 +183,60 @@ interact_maxwellian_reflux( maxwellian_reflux_t * RESTRICT mr,
   return 1;
 }
 
+// Device form of interact_maxwellian_reflux for one species
+
+struct maxwellian_reflux_device {
+
+  maxwellian_reflux_device( const maxwellian_reflux_t * mr,
+                            const species_t * sp ) :
+    ut_para( mr->ut_para[sp->id] ), ut_perp( mr->ut_perp[sp->id] ),
+    dx( sp->g->dx ), dy( sp->g->dy ), dz( sp->g->dz ),
+    rdx( sp->g->rdx ), rdy( sp->g->rdy ), rdz( sp->g->rdz ) {}
+
+  float ut_para, ut_perp;
+  float dx, dy, dz, rdx, rdy, rdz;
+
+  KOKKOS_INLINE_FUNCTION int
+  operator()( particle_t & p, particle_mover_t & pm, int face,
+              counter_rng & rng ) const {
+    // Face -> para axis as in perm above; para is along the face normal
+    // and points into the domain
+    const int   axis  = face<3 ? face : face-3;
+    const float scale = face<3 ? float(M_SQRT2) : -float(M_SQRT2);
+
+    float u[3];
+    u[axis]       = ut_para*scale*sqrtf( rng.exponential() );
+    u[(axis+1)%3] = ut_perp*rng.normal();
+    u[(axis+2)%3] = ut_perp*rng.normal();
+
+    // Age the refluxed particle as the host version does
+    float dispx = dx*pm.dispx, dispy = dy*pm.dispy, dispz = dz*pm.dispz;
+    float ratio = p.ux*p.ux + p.uy*p.uy + p.uz*p.uz;
+    ratio = sqrtf( ( ( 1+ratio )*( dispx*dispx + dispy*dispy + dispz*dispz ) ) /
+                   ( ( 1+(u[0]*u[0]+u[1]*u[1]+u[2]*u[2]) )*( FLT_MIN+ratio ) ) );
+
+    p.ux = u[0];
+    p.uy = u[1];
+    p.uz = u[2];
+    pm.dispx = u[0]*ratio*rdx;
+    pm.dispy = u[1]*ratio*rdy;
+    pm.dispz = u[2]*ratio*rdz;
+    return 1;
+  }
+
+};
+
+int
+interact_maxwellian_reflux_device( const particle_bc_t * RESTRICT pbc,
+                                   species_t           * RESTRICT sp,
+                                   field_array_t       * RESTRICT fa,
+                                   int                            pass ) {
+  const maxwellian_reflux_t * RESTRICT mr =
+    (const maxwellian_reflux_t *)pbc->params;
+  return apply_particle_bc_device( maxwellian_reflux_device( mr, sp ),
+                                   pbc, sp, fa, mr->seed, pass ).rerouted;
+}
+
 void
 checkpt_maxwellian_reflux( const particle_bc_t * RESTRICT pbc ) {
   const maxwellian_reflux_t * RESTRICT mr =
@@ -219,12 +280,16 @@ maxwellian_reflux( species_t  * RESTRICT sp_list,
   MALLOC( mr->ut_perp, num_species( mr->sp_list ) );
   CLEAR( mr->ut_para, num_species( mr->sp_list ) );
   CLEAR( mr->ut_perp, num_species( mr->sp_list ) );
-  return new_particle_bc_internal( mr,
-                                   (particle_bc_func_t)interact_maxwellian_reflux,
-                                   delete_maxwellian_reflux,
-                                   (checkpt_func_t)checkpt_maxwellian_reflux,
-                                   (restore_func_t)restore_maxwellian_reflux,
-                                   NULL );
+  mr->seed    = u32rand( mr->rng );
+  particle_bc_t * pbc =
+    new_particle_bc_internal( mr,
+                              (particle_bc_func_t)interact_maxwellian_reflux,
+                              delete_maxwellian_reflux,
+                              (checkpt_func_t)checkpt_maxwellian_reflux,
+                              (restore_func_t)restore_maxwellian_reflux,
+                              NULL );
+  pbc->interact_device = interact_maxwellian_reflux_device;
+  return pbc;
 }
 
 /* FIXME: NOMINALLY, THIS INTERFACE SHOULD TAKE kT */
@@ -163,10 +163,24 @@ void
 apply_binary_collision_model( binary_collision_model_t * cm ) {
   int p, n_large_pr = 0;
   if( cm->interval<1 || (cm->spi->g->step % cm->interval) ) return;
-  if( cm->spi->last_sorted!=cm->spi->g->step ) sort_p( cm->spi );
-  if( cm->spj->last_sorted!=cm->spi->g->step ) sort_p( cm->spj );
+
+  /* The pipelines work on the host copy of the particles and need its
+     voxel partitioning, so the host particles are always resorted.  The
+     host sort does not carry tracer ids along; coulomb_collision_model
+     runs on the device and does. */
+  if( cm->spi->has_particle_ids() || cm->spj->has_particle_ids() )
+    ERROR(( "Collision model \"%s\" can't be used on species with tracers",
+            cm->name ));
+  cm->spi->copy_to_host();
+  sort_p( cm->spi );
+  if( cm->spj!=cm->spi ) {
+    cm->spj->copy_to_host();
+    sort_p( cm->spj );
+  }
   EXEC_PIPELINES( binary, cm, 0 );
   WAIT_PIPELINES();
+  cm->spi->copy_to_device();
+  if( cm->spj!=cm->spi ) cm->spj->copy_to_device();
   for( p=0; p<N_PIPELINE; p++ ) n_large_pr += cm->n_large_pr[p];
   if( n_large_pr )
     WARNING(( "%i computational particle pairs between species \"%s\" and "
@@ -50,6 +50,15 @@ append_collision_op( collision_op_t * cop,
    every interval time step to all the particle momenta in the
    species.  Above, dW is a basic Weiner process. */
 
+collision_op_t *
+langevin_device( float                kT,
+                 float                nu,
+                 species_t * RESTRICT sp,
+                 int                  interval,
+                 int                  seed = 0 );
+
+/* Same as langevin_device with seed 0, rp is no longer used. */
+
 collision_op_t *
 langevin( float                 kT,
           float                 nu,
@@ -126,6 +135,10 @@ unary_collision_model( const char       * RESTRICT name,
                        /**/  rng_pool_t * RESTRICT rp,
                        int                         interval );
 
+/* The function pointer models above run on a host copy of the particles,
+   which costs a round trip to the device every application.  See
+   unary_device.h for a device version taking functors. */
+
 /* In binary.c */
 
 /* A binary_rate_constant_func_t returns the lab-frame rate constant
@@ -303,4 +316,36 @@ large_angle_coulomb( const char * RESTRICT name, /* Model name */
                      const double sample,        /* Sampling density */
                      const int interval );       /* How often to apply this */
 
+/* In coulomb.c */
+
+/* Binary Coulomb collisions between the particles of spi and spj (which
+   may be the same species) run entirely on the device.  Every interval
+   steps, the particles in each voxel are randomly paired and each pair
+   is scattered through an angle drawn for the elapsed sp->g->dt*interval
+   by either the method of Takizuka and Abe (J Comp Phys 25, 1977) or
+   Nanbu's cumulative scattering (Phys Rev E 55, 1997), which remains
+   accurate when the interval is long compared to the collision time.
+   coulomb_log is the Coulomb logarithm.  This uses non-relativistic
+   kinematics.
+
+   The device operators (this, langevin_device and the unary models of
+   unary_device.h) draw counter-based random numbers (util/rng/philox.h)
+   keyed by seed, rank, operator, species, particle or voxel and step,
+   so a run does not depend on the thread count.  Give operators of the
+   same kind acting on the same species different seeds. */
+
+enum coulomb_collision_method {
+  coulomb_takizuka_abe = 0,
+  coulomb_nanbu        = 1
+};
+
+collision_op_t *
+coulomb_collision_model( const char * RESTRICT name, /* Model name */
+                         species_t  * RESTRICT spi,  /* Species-i */
+                         species_t  * RESTRICT spj,  /* Species-j */
+                         float                 coulomb_log,
+                         int                   method,
+                         int                   seed,
+                         int                   interval );
+
 #endif /* _collision_h_ */
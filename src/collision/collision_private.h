@@ -6,6 +6,7 @@
 #endif
 
 #include "collision.h"
+#include "../util/rng/philox.h"
 
 typedef void
 (*collision_op_func_t)( void * params );
@@ -37,18 +38,4 @@ new_collision_op_internal( void * params,
 void
 delete_collision_op_internal( collision_op_t * cop );
 
-///////////////////////////////////////////////////////////////////////////////
-// Langevin pipeline interface
-
-typedef struct langevin_pipeline_args {
-  MEM_PTR( particle_t, 128 ) p;
-  MEM_PTR( rng_t,      128 ) rng[ MAX_PIPELINE ];
-  float decay; 
-  float drive;
-  int np;
-  PAD_STRUCT( (1+MAX_PIPELINE)*SIZEOF_MEM_PTR+2*sizeof(float)+sizeof(int) )
-} langevin_pipeline_args_t;
-
-PROTOTYPE_PIPELINE( langevin, langevin_pipeline_args_t );
-
 #endif /* _collision_h_ */
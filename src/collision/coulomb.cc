@@ -0,0 +1,360 @@
+#define IN_collision
+#include "collision_private.h"
+#include "../particle_operations/sort.h"
+
+/* Private interface *********************************************************/
+
+typedef Kokkos::View<int*, Kokkos::DefaultExecutionSpace::scratch_memory_space,
+                     Kokkos::MemoryTraits<Kokkos::Unmanaged> > coulomb_scratch_t;
+
+typedef struct coulomb_collision_model {
+  char * name;
+  species_t * spi;
+  species_t * spj;
+  float coulomb_log;
+  int method;
+  int seed;
+  int interval;
+} coulomb_collision_model_t;
+
+/* counter_rng streams of a model: pairs are keyed by the particle index
+   of their species i or species j member, pairings by the voxel index */
+
+enum coulomb_stream {
+  coulomb_stream_pair_i = 0,
+  coulomb_stream_pair_j = 1,
+  coulomb_stream_shuffle = 2
+};
+
+/* Cosine of the scattering angle of Nanbu's cumulative small angle
+   scattering for a pair with normalized path s, sampled from the
+   uniform deviate u on (0,1].  The A(s) fits are from Perez et al,
+   Phys Plasmas 19 (2012).  ln( e^-A + 2 u sinh A )/A is rewritten as
+   1 + ln( u + (1-u) e^-2A )/A so it can't overflow. */
+
+KOKKOS_INLINE_FUNCTION float
+nanbu_cos_chi( const float s, const float u ) {
+  float a;
+  if( s<0.1f ) return fmaxf( 1 + s*logf( u ), -1.f );
+  if( s<3.f ) {
+    a = 1/( 0.0056958f + s*( 0.9560202f + s*( -0.508139f + s*( 0.47913906f +
+            s*( -0.12788975f + s*0.02389567f ) ) ) ) );
+  } else if( s<6.f ) {
+    a = 3*expf( -s );
+  } else {
+    return 2*u - 1; /* Isotropic */
+  }
+  return fmaxf( 1 + logf( u + ( 1-u )*expf( -2*a ) )/a, -1.f );
+}
+
+/* Scatters particle a of species i off particle b of species j.
+   The relative velocity g = c ( ua - ub ) is rotated through a random
+   angle whose distribution follows from the (non-relativistic) Coulomb
+   cross section integrated over frac*dt at partner density n, and the
+   change is shared out according to the masses (Takizuka and Abe, J
+   Comp Phys 25, 1977).  Pairs of unequal weight always update the
+   lighter particle and update the heavier one with probability
+   w_min / w_max, as in binary.cc. */
+
+struct coulomb_scatter {
+
+  k_particles_t k_pi, k_pj;
+  float K;      /* q_i^2 q_j^2 lnL dt interval / ( 4 pi eps0^2 mu^2 ) */
+  float fi, fj; /* m_j/(m_i+m_j), m_i/(m_i+m_j) */
+  float cvac;
+  int method;
+
+  KOKKOS_INLINE_FUNCTION void
+  operator()( const int a, const int b, const float n, const float frac,
+              counter_rng & rng ) const {
+    const float wa = k_pi(a, particle_var::w);
+    const float wb = k_pj(b, particle_var::w);
+    const float gx = k_pi(a, particle_var::ux) - k_pj(b, particle_var::ux);
+    const float gy = k_pi(a, particle_var::uy) - k_pj(b, particle_var::uy);
+    const float gz = k_pi(a, particle_var::uz) - k_pj(b, particle_var::uz);
+    const float g2 = gx*gx + gy*gy + gz*gz;
+    if( !( g2>0 ) ) return;
+    const float g  = sqrtf( g2 );
+    const float gc = cvac*g;
+    const float s  = K*n*frac/( gc*gc*gc );
+
+    float sin_t, omc_t; /* sin and 1-cos of the scattering angle */
+    if( method==coulomb_takizuka_abe ) {
+      /* delta = tan(theta/2) is normal with variance s/2 */
+      const float d  = sqrtf( 0.5f*s )*rng.normal();
+      const float d2 = d*d;
+      sin_t = 2*d/( 1+d2 );
+      omc_t = 2*d2/( 1+d2 );
+    } else {
+      const float c = nanbu_cos_chi( s, 1 - rng.frand() );
+      sin_t = sqrtf( fmaxf( 1 - c*c, 0.f ) );
+      omc_t = 1 - c;
+    }
+    const float phi = 2*float(M_PI)*rng.frand();
+    const float sin_p = sinf( phi ), cos_p = cosf( phi );
+
+    float dgx, dgy, dgz;
+    const float gp = sqrtf( gx*gx + gy*gy );
+    if( gp>1e-6f*g ) {
+      dgx = ( gx*gz*sin_t*cos_p - gy*g*sin_t*sin_p )/gp - gx*omc_t;
+      dgy = ( gy*gz*sin_t*cos_p + gx*g*sin_t*sin_p )/gp - gy*omc_t;
+      dgz = -gp*sin_t*cos_p - gz*omc_t;
+    } else {
+      dgx = g*sin_t*cos_p;
+      dgy = g*sin_t*sin_p;
+      dgz = -gz*omc_t;
+    }
+
+    const float u = rng.frand();
+    if( wa<=wb || wa*u<wb ) {
+      k_pi(a, particle_var::ux) += fi*dgx;
+      k_pi(a, particle_var::uy) += fi*dgy;
+      k_pi(a, particle_var::uz) += fi*dgz;
+    }
+    if( wb<=wa || wb*u<wa ) {
+      k_pj(b, particle_var::ux) -= fj*dgx;
+      k_pj(b, particle_var::uy) -= fj*dgy;
+      k_pj(b, particle_var::uz) -= fj*dgz;
+    }
+  }
+
+}; // struct coulomb_scatter
+
+/* Fisher-Yates shuffle of first, first+1, ... first+n-1 into perm */
+
+KOKKOS_INLINE_FUNCTION void
+coulomb_shuffle( const coulomb_scratch_t & perm, const int first, const int n,
+                 counter_rng & rng ) {
+  for( int k=0; k<n; k++ ) perm(k) = first + k;
+  for( int k=n-1; k>0; k-- ) {
+    const int l = (int)rng.urand( (uint32_t)( k+1 ) );
+    const int t = perm(k); perm(k) = perm(l); perm(l) = t;
+  }
+}
+
+/* Collisions pair particles in the same voxel, so the particles have to
+   be sorted by voxel on this step. */
+
+static void
+sort_by_voxel( species_t * sp ) {
+  if( sp->last_sorted==sp->g->step ) return;
+  DefaultSort::standard_sort( sp->k_p_d, sp->k_p_i_d, sp->k_p_id_d,
+                              sp->np, sp->g->nv );
+  sp->last_sorted = sp->g->step;
+}
+
+static int
+max_voxel_count( const Kokkos::View<int*> & offsets, const int nv ) {
+  int max_n = 0;
+  Kokkos::parallel_reduce("coulomb max voxel count", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, nv), KOKKOS_LAMBDA (const int v, int & m) {
+    const int n = offsets(v+1) - offsets(v);
+    if( n>m ) m = n;
+  }, Kokkos::Max<int>( max_n ));
+  return max_n;
+}
+
+void
+apply_coulomb_collision_model( coulomb_collision_model_t * cm ) {
+  species_t * spi = cm->spi;
+  species_t * spj = cm->spj;
+  const grid_t * g = spi->g;
+  if( cm->interval<1 || (g->step % cm->interval) ) return;
+
+  const int intra = ( spi==spj );
+  const int nv = g->nv;
+
+  sort_by_voxel( spi );
+  if( !intra ) sort_by_voxel( spj );
+
+  Kokkos::View<int*> k_off_i( "coulomb offsets i", nv+1 );
+  DefaultSort::cell_offsets( spi->k_p_i_d, spi->np, nv, k_off_i );
+  Kokkos::View<int*> k_off_j = k_off_i;
+  if( !intra ) {
+    k_off_j = Kokkos::View<int*>( "coulomb offsets j", nv+1 );
+    DefaultSort::cell_offsets( spj->k_p_i_d, spj->np, nv, k_off_j );
+  }
+
+  const int max_i = max_voxel_count( k_off_i, nv );
+  const int max_j = intra ? 0 : max_voxel_count( k_off_j, nv );
+  if( !max_i || ( !intra && !max_j ) ) return;
+
+  const uint32_t seed = cm->seed, rank = world_rank;
+  const uint32_t stream = philox_stream( philox_coulomb,
+                                         ( (uint32_t)spi->id<<15 ) | ( (uint32_t)spj->id<<2 ) );
+  const int64_t step = g->step;
+
+  coulomb_scatter scatter;
+  const double mu  = (double)spi->m*(double)spj->m/( (double)spi->m + (double)spj->m );
+  const double qq  = (double)spi->q*(double)spj->q;
+  scatter.k_pi   = spi->k_p_d;
+  scatter.k_pj   = spj->k_p_d;
+  scatter.K      = (float)( qq*qq*cm->coulomb_log*g->dt*cm->interval /
+                            ( 4*M_PI*g->eps0*g->eps0*mu*mu ) );
+  scatter.fi     = (float)( spj->m/( (double)spi->m + (double)spj->m ) );
+  scatter.fj     = (float)( spi->m/( (double)spi->m + (double)spj->m ) );
+  scatter.cvac   = g->cvac;
+  scatter.method = cm->method;
+
+  const float rdV = 1/g->dV;
+  const auto& k_pi = spi->k_p_d;
+  const auto& k_pj = spj->k_p_d;
+  const size_t scratch_bytes = coulomb_scratch_t::shmem_size( max_i ) +
+                               coulomb_scratch_t::shmem_size( max_j );
+
+  /* One team per voxel */
+
+  Kokkos::parallel_for("coulomb collisions",
+      KOKKOS_TEAM_POLICY_DEVICE( nv, Kokkos::AUTO ).set_scratch_size( 1, Kokkos::PerTeam( scratch_bytes ) ),
+      KOKKOS_LAMBDA (const KOKKOS_TEAM_POLICY_DEVICE::member_type & team_member) {
+    const int v  = team_member.league_rank();
+    const int i0 = k_off_i(v), ni = k_off_i(v+1) - i0;
+    const int j0 = k_off_j(v), nj = k_off_j(v+1) - j0;
+    if( intra ? ni<2 : ( !ni || !nj ) ) return;
+
+    coulomb_scratch_t perm_i( team_member.team_scratch(1), max_i );
+    coulomb_scratch_t perm_j( team_member.team_scratch(1), max_j );
+
+    /* Random pairing */
+
+    Kokkos::single( Kokkos::PerTeam( team_member ), [&] () {
+      counter_rng rng( seed, rank, stream | coulomb_stream_shuffle, v, step );
+      coulomb_shuffle( perm_i, i0, ni, rng );
+      if( !intra ) coulomb_shuffle( perm_j, j0, nj, rng );
+    });
+    team_member.team_barrier();
+
+    if( intra ) {
+
+      /* Every particle collides once with a partner at the voxel
+         density.  For odd counts, the first three collide pairwise for
+         half the interval each (Takizuka and Abe). */
+
+      float w_sum = 0;
+      Kokkos::parallel_reduce( Kokkos::TeamThreadRange( team_member, ni ),
+          [&] (const int k, float & s) { s += k_pi(i0+k, particle_var::w); }, w_sum );
+      const float n = w_sum*rdV;
+
+      int first = 0;
+      if( ni & 1 ) {
+        Kokkos::single( Kokkos::PerTeam( team_member ), [&] () {
+          counter_rng rng( seed, rank, stream | coulomb_stream_pair_i, perm_i(0), step );
+          scatter( perm_i(0), perm_i(1), n, 0.5f, rng );
+          scatter( perm_i(1), perm_i(2), n, 0.5f, rng );
+          scatter( perm_i(0), perm_i(2), n, 0.5f, rng );
+        });
+        first = 3;
+      }
+
+      Kokkos::parallel_for( Kokkos::TeamThreadRange( team_member, ( ni-first )/2 ),
+          [&] (const int k) {
+        const int a = perm_i(first+2*k);
+        counter_rng rng( seed, rank, stream | coulomb_stream_pair_i, a, step );
+        scatter( a, perm_i(first+2*k+1), n, 1.f, rng );
+      });
+
+    } else {
+
+      /* Every particle of the more numerous species collides once with
+         a partner of the other species.  Partners are reused round
+         robin, a round at a time so no particle is in two pairs at
+         once.  The lighter particle of a pair is always updated (see
+         coulomb_scatter), so the pair uses the density of its partner's
+         species, shared out over the pairs it is in each step when it
+         is one of the reused partners. */
+
+      const int i_many = ( ni>=nj );
+      const int n_many = i_many ? ni : nj;
+      const int n_few  = i_many ? nj : ni;
+
+      float wi_sum = 0, wj_sum = 0;
+      Kokkos::parallel_reduce( Kokkos::TeamThreadRange( team_member, ni ),
+          [&] (const int k, float & s) { s += k_pi(i0+k, particle_var::w); }, wi_sum );
+      Kokkos::parallel_reduce( Kokkos::TeamThreadRange( team_member, nj ),
+          [&] (const int k, float & s) { s += k_pj(j0+k, particle_var::w); }, wj_sum );
+      const float reuse = (float)n_few/(float)n_many;
+      const float n_i = wi_sum*rdV*( i_many ? reuse : 1.f ); /* Seen by j */
+      const float n_j = wj_sum*rdV*( i_many ? 1.f : reuse ); /* Seen by i */
+
+      for( int r0=0; r0<n_many; r0+=n_few ) {
+        const int r1 = r0+n_few<n_many ? r0+n_few : n_many;
+        Kokkos::parallel_for( Kokkos::TeamThreadRange( team_member, r0, r1 ),
+            [&] (const int k) {
+          const int a = i_many ? perm_i(k) : perm_i(k-r0);
+          const int b = i_many ? perm_j(k-r0) : perm_j(k);
+          const float n = k_pi(a, particle_var::w)<=k_pj(b, particle_var::w) ? n_j : n_i;
+          counter_rng rng( seed, rank, stream | ( i_many ? coulomb_stream_pair_i :
+                                                           coulomb_stream_pair_j ),
+                           i_many ? a : b, step );
+          scatter( a, b, n, 1.f, rng );
+        });
+        team_member.team_barrier();
+      }
+
+    }
+  });
+}
+
+void
+checkpt_coulomb_collision_model( const collision_op_t * cop ) {
+  const coulomb_collision_model_t * cm =
+    (const coulomb_collision_model_t *)cop->params;
+  CHECKPT( cm, 1 );
+  CHECKPT_STR( cm->name );
+  CHECKPT_PTR( cm->spi );
+  CHECKPT_PTR( cm->spj );
+  checkpt_collision_op_internal( cop );
+}
+
+collision_op_t *
+restore_coulomb_collision_model( void ) {
+  coulomb_collision_model_t * cm;
+  RESTORE( cm );
+  RESTORE_STR( cm->name );
+  RESTORE_PTR( cm->spi );
+  RESTORE_PTR( cm->spj );
+  return restore_collision_op_internal( cm );
+}
+
+void
+delete_coulomb_collision_model( collision_op_t * cop ) {
+  coulomb_collision_model_t * cm = (coulomb_collision_model_t *)cop->params;
+  FREE( cm->name );
+  FREE( cm );
+  delete_collision_op_internal( cop );
+}
+
+/* Public interface **********************************************************/
+
+collision_op_t *
+coulomb_collision_model( const char * RESTRICT name,
+                         species_t  * RESTRICT spi,
+                         species_t  * RESTRICT spj,
+                         float                 coulomb_log,
+                         int                   method,
+                         int                   seed,
+                         int                   interval ) {
+  coulomb_collision_model_t * cm;
+  size_t len = name ? strlen(name) : 0;
+
+  if( !spi || !spj || spi->g!=spj->g || !( coulomb_log>0 ) ||
+      ( method!=coulomb_takizuka_abe && method!=coulomb_nanbu ) )
+    ERROR(( "Bad args" ));
+  if( len==0 ) ERROR(( "Cannot specify a nameless collision model" ));
+
+  MALLOC( cm, 1 );
+  MALLOC( cm->name, len+1 );
+  strcpy( cm->name, name );
+  cm->spi         = spi;
+  cm->spj         = spj;
+  cm->coulomb_log = coulomb_log;
+  cm->method      = method;
+  cm->seed        = seed;
+  cm->interval    = interval;
+  return new_collision_op_internal( cm,
+                                    (collision_op_func_t)apply_coulomb_collision_model,
+                                    delete_coulomb_collision_model,
+                                    (checkpt_func_t)checkpt_coulomb_collision_model,
+                                    (restore_func_t)restore_coulomb_collision_model,
+                                    NULL );
+}
@@ -5,40 +5,13 @@
 
 typedef struct langevin {
   species_t  * sp;
-  rng_pool_t * rp;
+  rng_pool_t * rp; /* Unused, kept for old decks */
   float kT;
   float nu;
+  int seed;
   int interval;
 } langevin_t;
 
-void
-langevin_pipeline( langevin_pipeline_args_t * RESTRICT args,
-                   int pipeline_rank,
-                   int n_pipeline ) {
-  if( pipeline_rank==n_pipeline ) return; /* No host straggler cleanup */
-
-  particle_t * RESTRICT p     = args->p;
-  rng_t      * RESTRICT rng   = args->rng[ pipeline_rank ];
-  float                 decay = args->decay;
-  float                 drive = args->drive;
-
-  double n_target = (double)args->np / (double)n_pipeline;
-  /**/  int i  = (int)( 0.5 + n_target*(double) pipeline_rank    );
-  const int i1 = (int)( 0.5 + n_target*(double)(pipeline_rank+1) );
-
-  for( ; i<i1; i++ ) {
-    p[i].ux = decay*p[i].ux + drive*frandn(rng);
-    p[i].uy = decay*p[i].uy + drive*frandn(rng);
-    p[i].uz = decay*p[i].uz + drive*frandn(rng);
-  }
-}
-
-#if defined(V4_ACCELERATION) && defined(HAS_V4_PIPELINE)
-
-#error "V4 pipeline not implemented"
-
-#endif
-
 void
 apply_langevin( langevin_t * l ) {
   if( l->interval<1 || (l->sp->g->step % l->interval) ) return;
@@ -87,14 +60,22 @@ apply_langevin( langevin_t * l ) {
      desired temperature. */
 
   float nudt  = l->nu * (float)l->interval * l->sp->g->dt;
-  DECLARE_ALIGNED_ARRAY( langevin_pipeline_args_t, 128, args, 1 );
-  args->p     = l->sp->p;
-  COPY( args->rng, l->rp->rng, N_PIPELINE );
-  args->decay = exp( -nudt );
-  args->drive = sqrt(( -expm1(-2*nudt)*l->kT )/( l->sp->m*l->sp->g->cvac ));
-  args->np    = l->sp->np;
-  EXEC_PIPELINES( langevin, args, 0 );
-  WAIT_PIPELINES();
+  const float decay = exp( -nudt );
+  const float drive = sqrt(( -expm1(-2*nudt)*l->kT )/( l->sp->m*l->sp->g->cvac ));
+
+  const uint32_t seed = l->seed, rank = world_rank, stream = philox_stream( philox_langevin, l->sp->id );
+  const int64_t step = l->sp->g->step;
+  const auto& k_particles = l->sp->k_p_d;
+
+  Kokkos::parallel_for("langevin", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, l->sp->np), KOKKOS_LAMBDA (const int p_index) {
+    counter_rng rng( seed, rank, stream, p_index, step );
+    float n[4];
+    rng.normal4( n );
+    k_particles(p_index, particle_var::ux) = decay*k_particles(p_index, particle_var::ux) + drive*n[0];
+    k_particles(p_index, particle_var::uy) = decay*k_particles(p_index, particle_var::uy) + drive*n[1];
+    k_particles(p_index, particle_var::uz) = decay*k_particles(p_index, particle_var::uz) + drive*n[2];
+  });
 }
 
 void
@@ -124,21 +105,21 @@ delete_langevin( collision_op_t * cop ) {
 /* Public interface **********************************************************/
 
 collision_op_t *
-langevin( float                 kT,
-          float                 nu,
-          species_t  * RESTRICT sp,
-          rng_pool_t * RESTRICT rp,
-          int                   interval ) {
+langevin_device( float                kT,
+                 float                nu,
+                 species_t * RESTRICT sp,
+                 int                  interval,
+                 int                  seed ) {
   langevin_t * l;
 
-  if( !sp || !rp || rp->n_rng<N_PIPELINE || kT<0 || nu<0 )
-    ERROR(( "Bad args" ));
+  if( !sp || kT<0 || nu<0 ) ERROR(( "Bad args" ));
 
   MALLOC( l, 1 );
   l->sp       = sp;
-  l->rp       = rp;
+  l->rp       = NULL;
   l->kT       = kT;
   l->nu       = nu;
+  l->seed     = seed;
   l->interval = interval;
   return new_collision_op_internal( l,
                                     (collision_op_func_t)apply_langevin,
@@ -148,3 +129,11 @@ langevin( float                 kT,
                                     NULL );
 }
 
+collision_op_t *
+langevin( float                 kT,
+          float                 nu,
+          species_t  * RESTRICT sp,
+          rng_pool_t * RESTRICT rp,
+          int                   interval ) {
+  return langevin_device( kT, nu, sp, interval, 0 );
+}
@@ -59,8 +59,11 @@ void
 apply_unary_collision_model( unary_collision_model_t * cm ) {
   int p, n_large_pr = 0;
   if( cm->interval<1 || (cm->sp->g->step % cm->interval) ) return;
+  /* The pipelines work on the host copy of the particles */
+  cm->sp->copy_to_host();
   EXEC_PIPELINES( unary, cm, 0 );
   WAIT_PIPELINES();
+  cm->sp->copy_to_device();
   for( p=0; p<N_PIPELINE; p++ ) n_large_pr += cm->n_large_pr[p];
   if( n_large_pr )
     WARNING(( "%i particles in species \"%s\" encountered a large collision "
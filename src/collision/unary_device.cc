@@ -0,0 +1,81 @@
+#define IN_collision
+#include "collision_private.h"
+#include "unary_device.h"
+
+/* Private interface *********************************************************/
+
+typedef struct unary_device_op {
+  unary_device_collision_model_t cm;
+  unary_device_apply_func_t apply;
+  size_t model_size;
+} unary_device_op_t;
+
+void
+apply_unary_device_op( unary_device_op_t * op ) {
+  op->apply( &op->cm );
+}
+
+void
+checkpt_unary_device_op( const collision_op_t * cop ) {
+  const unary_device_op_t * op = (const unary_device_op_t *)cop->params;
+  CHECKPT( op, 1 );
+  CHECKPT_STR( op->cm.name );
+  CHECKPT( op->cm.model, op->model_size );
+  CHECKPT_PTR( op->cm.sp );
+  CHECKPT_SYM( op->apply );
+  checkpt_collision_op_internal( cop );
+}
+
+collision_op_t *
+restore_unary_device_op( void ) {
+  unary_device_op_t * op;
+  RESTORE( op );
+  RESTORE_STR( op->cm.name );
+  RESTORE( op->cm.model );
+  RESTORE_PTR( op->cm.sp );
+  RESTORE_SYM( op->apply );
+  return restore_collision_op_internal( op );
+}
+
+void
+delete_unary_device_op( collision_op_t * cop ) {
+  unary_device_op_t * op = (unary_device_op_t *)cop->params;
+  FREE( op->cm.model );
+  FREE( op->cm.name );
+  FREE( op );
+  delete_collision_op_internal( cop );
+}
+
+/* Public interface **********************************************************/
+
+collision_op_t *
+new_unary_device_collision_op( const char                * RESTRICT name,
+                               const void                * RESTRICT model,
+                               size_t                               model_size,
+                               unary_device_apply_func_t            apply,
+                               /**/  species_t           * RESTRICT sp,
+                               int                                  interval,
+                               int                                  seed ) {
+  unary_device_op_t * op;
+  size_t len = name ? strlen(name) : 0;
+
+  if( !model || !model_size || !apply || !sp ) ERROR(( "Bad args" ));
+  if( !len ) ERROR(( "Cannot specify a nameless collision model" ));
+
+  MALLOC( op, 1 );
+  MALLOC( op->cm.name, len+1 );
+  strcpy( op->cm.name, name );
+  MALLOC( op->cm.model, model_size );
+  memcpy( op->cm.model, model, model_size );
+  op->cm.sp       = sp;
+  op->cm.seed     = seed;
+  op->cm.interval = interval;
+  op->apply       = apply;
+  op->model_size  = model_size;
+  return new_collision_op_internal( op,
+                                    (collision_op_func_t)apply_unary_device_op,
+                                    delete_unary_device_op,
+                                    (checkpt_func_t)checkpt_unary_device_op,
+                                    (restore_func_t)restore_unary_device_op,
+                                    NULL );
+}
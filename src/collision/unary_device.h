@@ -0,0 +1,125 @@
+#ifndef _unary_device_h_
+#define _unary_device_h_
+
+/* Device unary collision models.  These are unary_collision_model with
+   the rate constant and collision function pointers replaced by a device
+   functor, so every particle is tested on the device in a single sweep.
+
+   Model must be trivially copyable (it is checkpointed by value) and
+   provide:
+
+     KOKKOS_INLINE_FUNCTION float
+     rate_constant( const particle_t & p ) const;
+
+   returning the lab-frame rate constant (FREQUENCY) of p against the
+   background, as a unary_rate_constant_func_t does, and:
+
+     template<class Generator>
+     KOKKOS_INLINE_FUNCTION void
+     collide( particle_t & p, Generator & rng ) const;
+
+   which sets p.u{xyz} to the momentum after a collision, as a
+   unary_collision_func_t does.  rng is a counter_rng (see
+   util/rng/philox.h) keyed by the particle index and step.  The species
+   is available to the functor only through whatever it copied at
+   construction. */
+
+#include "collision.h"
+#include "../util/rng/philox.h"
+
+/* The parameters of a device unary model as seen by its apply function.
+   model points to a copy of the Model given at construction. */
+
+typedef struct unary_device_collision_model {
+  char * name;
+  char * model;
+  species_t * sp;
+  int seed;
+  int interval;
+} unary_device_collision_model_t;
+
+typedef void
+(*unary_device_apply_func_t)( const unary_device_collision_model_t * cm );
+
+/* In unary_device.cc */
+
+/* Build a collision operator that calls apply on a checkpointable copy
+   of the model_size bytes at model.  unary_collision_model below is the
+   intended caller. */
+
+collision_op_t *
+new_unary_device_collision_op( const char                * RESTRICT name,
+                               const void                * RESTRICT model,
+                               size_t                               model_size,
+                               unary_device_apply_func_t            apply,
+                               /**/  species_t           * RESTRICT sp,
+                               int                                  interval,
+                               int                                  seed );
+
+template<class Model>
+void
+apply_unary_device_collision_model( const unary_device_collision_model_t * cm ) {
+  species_t * sp = cm->sp;
+  if( cm->interval<1 || (sp->g->step % cm->interval) ) return;
+
+  const uint32_t seed = cm->seed, rank = world_rank, stream = philox_stream( philox_unary, sp->id );
+  const int64_t step = sp->g->step;
+  const Model model = *(const Model *)cm->model;
+  const auto& k_particles = sp->k_p_d;
+  const auto& k_particles_i = sp->k_p_i_d;
+  const float dt = sp->g->dt * (float)cm->interval;
+
+  /* Compute the probability the particle had a collision with the
+     background, noting "probabilities" larger than one for diagnostic
+     purposes, and flip a biased coin (frand is on [0,1) so 0 never
+     collides and 1 always does). */
+
+  int n_large_pr = 0;
+  Kokkos::parallel_reduce("unary collisions", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, sp->np), KOKKOS_LAMBDA (const int p_index, int & n_large) {
+    particle_t p;
+    p.dx = k_particles(p_index, particle_var::dx);
+    p.dy = k_particles(p_index, particle_var::dy);
+    p.dz = k_particles(p_index, particle_var::dz);
+    p.i  = k_particles_i(p_index);
+    p.ux = k_particles(p_index, particle_var::ux);
+    p.uy = k_particles(p_index, particle_var::uy);
+    p.uz = k_particles(p_index, particle_var::uz);
+    p.w  = k_particles(p_index, particle_var::w);
+
+    const float pr_coll = dt*model.rate_constant( p );
+    if( pr_coll>1 ) n_large++;
+
+    counter_rng rng( seed, rank, stream, p_index, step );
+    if( rng.frand()<pr_coll ) {
+      model.collide( p, rng );
+      k_particles(p_index, particle_var::ux) = p.ux;
+      k_particles(p_index, particle_var::uy) = p.uy;
+      k_particles(p_index, particle_var::uz) = p.uz;
+    }
+  }, n_large_pr);
+
+  if( n_large_pr )
+    WARNING(( "%i particles in species \"%s\" encountered a large collision "
+              "probability in collision model \"%s\".  The collision rate for "
+              "such particles will be lower than it should be physically.  "
+              "Consider lowering the collision operator interval or reducing "
+              "the timestep.", n_large_pr, sp->name, cm->name ));
+}
+
+/* Declare a device unary collision model.  Every particle is tested for
+   collision every "interval" timesteps. */
+
+template<class Model>
+collision_op_t *
+unary_collision_model( const char      * RESTRICT name,
+                       const Model     &          model,
+                       /**/  species_t * RESTRICT sp,
+                       int                        interval,
+                       int                        seed = 0 ) {
+  return new_unary_device_collision_op( name, &model, sizeof(Model),
+                                        apply_unary_device_collision_model<Model>,
+                                        sp, interval, seed );
+}
+
+#endif /* _unary_device_h_ */
@@ -1,5 +1,6 @@
 #define IN_emitter
 #include "emitter_private.h"
+#include "../util/rng/philox.h"
 
 /* Private interface *********************************************************/
 
@@ -16,6 +17,7 @@ typedef struct child_langmuir {
   float ut_perp;
   float thresh_e_norm;
   float norm;
+  uint32_t seed;   // Of the device emission
 } child_langmuir_t;
 
 // Notes:
@@ -30,114 +32,139 @@ typedef struct child_langmuir {
 //   See maxwellian_reflux for a derivation how this works.
 // - Particles are randomly distributed across the inject surface
 //   and have random ages.
+// - Emission is done on the device.  A scan over the components counts
+//   the particles each emits and reserves a block for them at the end
+//   of the particle array; the final pass of the scan emits them.
+//   Deviates come from a counter_rng keyed by the component index, so
+//   the emission does not depend on the thread layout.
+
+// Normal axis of a component that is a cell face and the direction
+// (+1 or -1) particles are emitted along it.  Returns 0 for components
+// that are not faces.
+
+KOKKOS_INLINE_FUNCTION int
+child_langmuir_face( const int type, int & axis, float & dir ) {
+  switch( type ) {
+  case BOUNDARY(-1, 0, 0): axis = 0; dir =  1; return 1;
+  case BOUNDARY( 0,-1, 0): axis = 1; dir =  1; return 1;
+  case BOUNDARY( 0, 0,-1): axis = 2; dir =  1; return 1;
+  case BOUNDARY( 1, 0, 0): axis = 0; dir = -1; return 1;
+  case BOUNDARY( 0, 1, 0): axis = 1; dir = -1; return 1;
+  case BOUNDARY( 0, 0, 1): axis = 2; dir = -1; return 1;
+  default: /* Not a cell face ... do not emit */ return 0;
+  }
+}
 
 void
 emit_child_langmuir( child_langmuir_t * RESTRICT              cl,
                      const int        * RESTRICT ALIGNED(128) component,
                      int                                      n_component ) {
-  /**/  species_t        * RESTRICT              sp  = cl->sp;
-  const interpolator_t   * RESTRICT ALIGNED(128) fi  = cl->ia->i;
-  /**/  field_t          * RESTRICT ALIGNED(128) f   = cl->fa->f;
-  /**/  accumulator_t    * RESTRICT ALIGNED(128) a   = cl->aa->a;
-  /**/  rng_t            * RESTRICT              rng = cl->rng;
-
-  /**/  particle_t       * RESTRICT ALIGNED(128) p   = sp->p;
-  /**/  particle_mover_t * RESTRICT ALIGNED(128) pm  = sp->pm;
-  /**/  grid_t           * RESTRICT              g   = sp->g;
+  /**/  species_t * RESTRICT sp = cl->sp;
+  /**/  grid_t    * RESTRICT g  = sp->g;
 
+  const int np               = sp->np;
   const int max_np           = sp->max_np;
   const int max_nm           = sp->max_nm;
   const int np_emit_per_face = cl->n_emit_per_face;
 
   const float qsp     = sp->q;
-  const float rdx     = g->rdx;
-  const float rdy     = g->rdy;
-  const float rdz     = g->rdz;
   const float cdt     = g->cvac*g->dt;
   const float norm    = ( cl->norm*g->eps0*g->dt ) /
                         ( sqrtf(fabsf(qsp*sp->m))*(float)np_emit_per_face );
-  const float norm_x  = norm*sqrtf(rdx)*g->dy*g->dz;
-  const float norm_y  = norm*sqrtf(rdy)*g->dz*g->dx;
-  const float norm_z  = norm*sqrtf(rdz)*g->dx*g->dy;
+  const float norm_x  = norm*sqrtf(g->rdx)*g->dy*g->dz;
+  const float norm_y  = norm*sqrtf(g->rdy)*g->dz*g->dx;
+  const float norm_z  = norm*sqrtf(g->rdz)*g->dx*g->dy;
   const float ut_para = cl->ut_para;
   const float ut_perp = cl->ut_perp;
   const float thresh  = fabsf(qsp)*cl->thresh_e_norm;
 
-  int np = sp->np, np_skipped = 0;
-  int nm = sp->nm, nm_skipped = 0;
-
-  float w, ux, uy, uz;
-  int c, cc, i, np_emit;
-
-  // Loop over all components of the region
-
-  for( c=0; c<n_component; c++ ) {
-    cc = component[c];
-    i  = EXTRACT_LOCAL_CELL( cc );
-
-    // FIXME: COULD PROBABLY ACCELERATE BY GETTING RID OF SWITCH (USE
-    // MAXWELLIAN_REFLUX TRICKS?)
-
-#   define EMIT_PARTICLES(X,Y,Z,dir)                                    \
-    w = fi[i].e##X;                                                     \
-    if( dir qsp*w > thresh ) { /* This face can emit */                 \
-      w = norm_##X*sqrtf(fabsf(w*w*w));                                 \
-      for( np_emit=np_emit_per_face; np_emit; np_emit-- ) {             \
-                                                                        \
-        /* Emit the particle */                                         \
-                                                                        \
-        if( np>=max_np ) { np_skipped++; continue; }                    \
-        u##X = dir ut_para*sqrtf(2*frande(rng));                        \
-        u##Y = ut_perp*frandn(rng);                                     \
-        u##Z = ut_perp*frandn(rng);                                     \
-        p[np].d##X = -(dir 1);                                          \
-        p[np].d##Y = 2*frand_c0(rng)-1;                                 \
-        p[np].d##Z = 2*frand_c0(rng)-1;                                 \
-        p[np].i    = i;                                                 \
-        p[np].u##X = u##X;                                              \
-        p[np].u##Y = u##Y;                                              \
-        p[np].u##Z = u##Z;                                              \
-        p[np].w    = w;                                                 \
-        accumulate_rhob( f, p+np, g, -qsp );                            \
-        np++;                                                           \
-                                                                        \
-        /* Age the particle */                                          \
-                                                                        \
-        if( nm>=max_nm ) { nm_skipped++; continue; }                    \
-        w = ( frand_c0(rng)*cdt ) /                                     \
-          sqrtf( ( u##X*u##X + u##Y*u##Y ) + ( u##Z*u##Z + 1 ) );       \
-        DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, local_pm, 1 );     \
-        local_pm->disp##X = w*u##X*rd##X;                               \
-        local_pm->disp##Y = w*u##Y*rd##Y;                               \
-        local_pm->disp##Z = w*u##Z*rd##Z;                               \
-        local_pm->i       = np-1;                                       \
-        if (move_p( p, local_pm, cl->fa->k_jf_accum_h, g, qsp )) {                         \
-            pm[nm++] = local_pm[0];                                     \
-        }                                                               \
-      }                                                                 \
+  const float rd[3] = { g->rdx, g->rdy, g->rdz };
+  const int nx = g->nx, ny = g->ny, nz = g->nz, sy = g->sy, sz = g->sz;
+  const float r8V = g->r8V;
+  const uint32_t seed = cl->seed, rank = world_rank, stream = philox_stream( philox_emitter, sp->id );
+  const int64_t step = g->step;
+
+  const auto& k_interp = cl->ia->k_i_d;
+  const auto& k_particles = sp->k_p_d;
+  const auto& k_particles_i = sp->k_p_i_d;
+  const Kokkos::View<const int*, Kokkos::MemoryUnmanaged> k_component( component, n_component );
+  const Kokkos::View<float*, Kokkos::LayoutStride, Kokkos::MemoryTraits<Kokkos::Atomic> >
+    rhob = Kokkos::subview( cl->fa->k_f_d, Kokkos::ALL(), int(field_var::rhob) );
+
+  k_particle_ager age_particle( sp, cl->fa );
+
+  int n_emit = 0;
+  Kokkos::parallel_scan("emit child langmuir", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n_component), KOKKOS_LAMBDA (const int c, int & offset, const bool final) {
+    const int cc = k_component(c);
+    const int i  = EXTRACT_LOCAL_CELL( cc );
+    int axis; float dir;
+    if( !child_langmuir_face( EXTRACT_COMPONENT_TYPE( cc ), axis, dir ) ) return;
+
+    float w = k_interp(i, interpolator_var::ex + 4*axis);
+    if( !( dir*qsp*w > thresh ) ) return; // This face cannot emit
+    const int n0 = offset;
+    offset += np_emit_per_face;
+    if( !final ) return;
+
+    const float norm_n = axis==0 ? norm_x : axis==1 ? norm_y : norm_z;
+    w = norm_n*sqrtf(fabsf(w*w*w));
+    const int a1 = axis==2 ? 0 : axis+1, a2 = axis==0 ? 2 : axis-1;
+
+    counter_rng rng( seed, rank, stream, c, step );
+    for( int n=0; n<np_emit_per_face; n++ ) {
+      const int p_index = np + n0 + n;
+      if( p_index>=max_np ) return;
+
+      // Emit the particle
+
+      float u[3], d[3];
+      u[axis] = dir*ut_para*sqrtf(2*rng.exponential());
+      u[a1]   = ut_perp*rng.normal();
+      u[a2]   = ut_perp*rng.normal();
+      d[axis] = -dir;
+      d[a1]   = 2*rng.frand()-1;
+      d[a2]   = 2*rng.frand()-1;
+
+      particle_t p;
+      p.dx = d[0]; p.dy = d[1]; p.dz = d[2];
+      p.i  = i;
+      p.ux = u[0]; p.uy = u[1]; p.uz = u[2];
+      p.w  = w;
+      k_accumulate_rhob_single( rhob, p, -qsp, r8V, nx, ny, nz, sy, sz );
+
+      k_particles(p_index, particle_var::dx) = p.dx;
+      k_particles(p_index, particle_var::dy) = p.dy;
+      k_particles(p_index, particle_var::dz) = p.dz;
+      k_particles(p_index, particle_var::ux) = p.ux;
+      k_particles(p_index, particle_var::uy) = p.uy;
+      k_particles(p_index, particle_var::uz) = p.uz;
+      k_particles(p_index, particle_var::w)  = p.w;
+      k_particles_i(p_index) = i;
+
+      // Age the particle
+
+      const float age = ( rng.frand()*cdt ) /
+        sqrtf( ( u[0]*u[0] + u[1]*u[1] ) + ( u[2]*u[2] + 1 ) );
+      particle_mover_t pm;
+      pm.dispx = age*u[0]*rd[0];
+      pm.dispy = age*u[1]*rd[1];
+      pm.dispz = age*u[2]*rd[2];
+      pm.i     = p_index;
+      age_particle( pm );
     }
+  }, n_emit);
 
-    switch( EXTRACT_COMPONENT_TYPE( cc ) ) {
-    case BOUNDARY(-1, 0, 0): EMIT_PARTICLES(x,y,z,+) break;
-    case BOUNDARY( 0,-1, 0): EMIT_PARTICLES(y,z,x,+) break;
-    case BOUNDARY( 0, 0,-1): EMIT_PARTICLES(z,x,y,+) break;
-    case BOUNDARY( 1, 0, 0): EMIT_PARTICLES(x,y,z,-) break;
-    case BOUNDARY( 0, 1, 0): EMIT_PARTICLES(y,z,x,-) break;
-    case BOUNDARY( 0, 0, 1): EMIT_PARTICLES(z,x,y,-) break;
-    default: /* Not a cell face ... do not emit */   break;
-    }
-
-#   undef EMIT_PARTICLES
-
-  }
+  age_particle.finish( sp, cl->fa );
 
-  sp->np = np;
-  sp->nm = nm;
+  const int np_skipped = np + n_emit - max_np;
+  sp->np = np_skipped>0 ? max_np : np + n_emit;
 
-  if( np_skipped ) WARNING(( "Insufficient local particle storage.  Did not emit %i "
-                             "particles in emit_child_langmuir", np_skipped ));
-  if( nm_skipped ) WARNING(( "Insufficient local particle mover storage.  Did not age %i "
-                             "emitted particles in emit_child_langmuir", nm_skipped ));
+  if( np_skipped>0 ) WARNING(( "Insufficient local particle storage.  Did not emit %i "
+                               "particles in emit_child_langmuir", np_skipped ));
+  if( sp->k_nm_h(0)>=max_nm ) WARNING(( "Insufficient local particle mover storage.  Some "
+                                       "emitted particles may not have been aged in "
+                                       "emit_child_langmuir" ));
 }
 
 void
@@ -201,6 +228,7 @@ child_langmuir( /**/  species_t            * RESTRICT sp,
   cl->ut_perp         = ut_perp;
   cl->thresh_e_norm   = thresh_e_norm;
   cl->norm            = norm;
+  cl->seed            = u32rand( cl->rng );
   return new_emitter_internal( cl,
                                (emit_func_t)emit_child_langmuir,
                                delete_child_langmuir,
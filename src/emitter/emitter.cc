@@ -17,6 +17,7 @@ restore_emitter_internal( void * params ) {
   emitter_t * e;
   RESTORE( e );
   e->params = params;
+  e->k_component = NULL;
   RESTORE_SYM( e->emit );
   RESTORE_SYM( e->delete_e );
   RESTORE_ALIGNED( e->component );
@@ -45,6 +46,7 @@ new_emitter_internal( void * params,
 void
 delete_emitter_internal( emitter_t * e ) {
   UNREGISTER_OBJECT( e );
+  if( e->k_component ) Kokkos::kokkos_free( e->k_component );
   FREE_ALIGNED( e->component );
   FREE( e );
 }
@@ -62,8 +64,19 @@ num_emitter( const emitter_t * RESTRICT e_list ) {
 void
 apply_emitter_list( emitter_t * RESTRICT e_list ) {
   emitter_t * e;
-  LIST_FOR_EACH( e, e_list )
-    e->emit( e->params, e->component, e->n_component );
+  LIST_FOR_EACH( e, e_list ) {
+    if( !e->n_component ) continue;
+    if( !e->k_component ) {
+      e->k_component = (int *)Kokkos::kokkos_malloc( "emitter components",
+                                                     e->n_component*sizeof(int) );
+      Kokkos::View<int*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>
+        component_h( e->component, e->n_component );
+      Kokkos::View<int*, Kokkos::MemoryUnmanaged>
+        component_d( e->k_component, e->n_component );
+      Kokkos::deep_copy( component_d, component_h );
+    }
+    e->emit( e->params, e->k_component, e->n_component );
+  }
 }
 
 void
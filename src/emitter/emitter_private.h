@@ -7,6 +7,13 @@
 
 #include "emitter.h"
 
+/* Emitters run on the device, after advance_p and before the movers
+   are copied to the host.  component is the device copy of the
+   emitter's components.  New particles are appended to the device
+   particle array and aged particles that did not finish their move
+   are appended to the device movers (and mover copies), as advance_p
+   does. */
+
 typedef void
 (*emit_func_t)( /**/  void * RESTRICT              params,
                 const int  * RESTRICT ALIGNED(128) component,
@@ -20,6 +27,7 @@ struct emitter {
   emit_func_t emit;
   delete_emitter_func_t delete_e;
   int * ALIGNED(128) component;
+  int * k_component; /* Device copy of component, made on first use */
   int n_component;
   emitter_t * next;
 };
@@ -36,6 +36,7 @@ checkpt_field_advance_kernels( const field_advance_kernels_t * kernel ) {
   CHECKPT_SYM( kernel->k_synchronize_jf                 );
   CHECKPT_SYM( kernel->k_reduce_jf                      );
   CHECKPT_SYM( kernel->k_synchronize_rho                );
+  CHECKPT_SYM( kernel->k_synchronize_jf_tang_b          );
 
   CHECKPT_SYM( kernel->synchronize_tang_e_norm_b_kokkos );
 
@@ -78,6 +79,7 @@ restore_field_advance_kernels( field_advance_kernels_t * kernel ) {
   RESTORE_SYM( kernel->k_synchronize_jf                 );
   RESTORE_SYM( kernel->k_reduce_jf                      );
   RESTORE_SYM( kernel->k_synchronize_rho                );
+  RESTORE_SYM( kernel->k_synchronize_jf_tang_b          );
 
   RESTORE_SYM( kernel->synchronize_tang_e_norm_b_kokkos );
 
@@ -189,3 +191,85 @@ field_array_t::copy_to_device() {
   Kokkos::deep_copy(k_fe_d, k_fe_h);
 
 }
+
+// Voxels of a box packed contiguously, x fastest
+
+static inline int
+check_field_box( const grid_t * g,
+                 int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 ) {
+  if( ix0<0 || ix1>g->nx+1 || ix0>ix1 ||
+      iy0<0 || iy1>g->ny+1 || iy0>iy1 ||
+      iz0<0 || iz1>g->nz+1 || iz0>iz1 ) ERROR(( "Bad field box" ));
+  return (ix1-ix0+1)*(iy1-iy0+1)*(iz1-iz0+1);
+}
+
+void
+field_array_t::copy_to_host( int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 ) {
+
+  const int n = check_field_box( g, ix0, ix1, iy0, iy1, iz0, iz1 );
+  const int bx = ix1-ix0+1, by = iy1-iy0+1, sy = g->sy, sz = g->sz;
+
+  k_field_t k_box_d( "k_field_box", n );
+  k_field_t::HostMirror k_box_h = Kokkos::create_mirror_view( k_box_d );
+
+  // Avoid capturing this
+  auto& k_field = k_f_d;
+
+  Kokkos::parallel_for("pack field box", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n), KOKKOS_LAMBDA (const int b) {
+    const int v = (ix0 + b%bx) + sy*(iy0 + (b/bx)%by) + sz*(iz0 + b/(bx*by));
+    for( int c=0; c<FIELD_VAR_COUNT; c++ ) k_box_d(b, c) = k_field(v, c);
+  });
+
+  Kokkos::deep_copy(k_box_h, k_box_d);
+
+  auto& k_field_h = k_f_h;
+  field_t * host_field = f;
+
+  Kokkos::parallel_for("unpack field box on host",
+    host_execution_policy(0, n) ,
+    KOKKOS_LAMBDA (int b) {
+      const int v = (ix0 + b%bx) + sy*(iy0 + (b/bx)%by) + sz*(iz0 + b/(bx*by));
+      float * RESTRICT hf = &host_field[v].ex; // field_t leads with the 16 field vars
+      for( int c=0; c<FIELD_VAR_COUNT; c++ ) {
+        k_field_h(v, c) = k_box_h(b, c);
+        hf[c] = k_box_h(b, c);
+      }
+    });
+
+}
+
+void
+field_array_t::copy_to_device( int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 ) {
+
+  const int n = check_field_box( g, ix0, ix1, iy0, iy1, iz0, iz1 );
+  const int bx = ix1-ix0+1, by = iy1-iy0+1, sy = g->sy, sz = g->sz;
+
+  k_field_t k_box_d( "k_field_box", n );
+  k_field_t::HostMirror k_box_h = Kokkos::create_mirror_view( k_box_d );
+
+  auto& k_field_h = k_f_h;
+  field_t * host_field = f;
+
+  Kokkos::parallel_for("pack field box on host",
+    host_execution_policy(0, n) ,
+    KOKKOS_LAMBDA (int b) {
+      const int v = (ix0 + b%bx) + sy*(iy0 + (b/bx)%by) + sz*(iz0 + b/(bx*by));
+      const float * RESTRICT hf = &host_field[v].ex;
+      for( int c=0; c<FIELD_VAR_COUNT; c++ ) {
+        k_field_h(v, c) = hf[c];
+        k_box_h(b, c) = hf[c];
+      }
+    });
+
+  Kokkos::deep_copy(k_box_d, k_box_h);
+
+  auto& k_field = k_f_d;
+
+  Kokkos::parallel_for("unpack field box", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n), KOKKOS_LAMBDA (const int b) {
+    const int v = (ix0 + b%bx) + sy*(iy0 + (b/bx)%by) + sz*(iz0 + b/(bx*by));
+    for( int c=0; c<FIELD_VAR_COUNT; c++ ) k_field(v, c) = k_box_d(b, c);
+  });
+
+}
@@ -7,6 +7,7 @@
 // AFFECT ANY PRACTICAL SIMULATIONS.
 
 #include "../grid/grid.h"
+#include "../grid/halo.h"
 #include "../material/material.h"
 #include "../vpic/kokkos_helpers.h"
 
@@ -224,6 +225,7 @@ typedef struct field_advance_kernels {
   void (*k_synchronize_jf )( struct field_array * RESTRICT fa );
   void (*k_reduce_jf )( struct field_array * RESTRICT fa );
   void (*k_synchronize_rho)( struct field_array * RESTRICT fa );
+  void (*k_synchronize_jf_tang_b)( struct field_array * RESTRICT fa );
   double (*synchronize_tang_e_norm_b_kokkos)( struct field_array * RESTRICT fa );
 
   void   (*compute_div_e_err_kokkos  )( /**/  struct field_array * RESTRICT fa );
@@ -265,10 +267,32 @@ typedef struct field_buffers
     Kokkos::View<float*>::HostMirror   yzx_rbuf_neg_h;
     Kokkos::View<float*>::HostMirror   zxy_rbuf_neg_h;
 
+    // Single round exchanges (see halo.h), set up on first use
+    halo_t * jf     = nullptr;
+    halo_t * rho    = nullptr;
+    halo_t * tang_b = nullptr;
+    halo_t * norm_e = nullptr;
+    halo_t * div_b  = nullptr;
+    halo_t * jf_tang_b = nullptr;
+
+    // Set when the ghost tang b is exchanged along with the current
+    // (k_synchronize_jf_tang_b); the next advance_e then skips its
+    // exchange
+    int tang_b_ghosted = 0;
+
     field_buffers() {
         // User should try avoid calling this
     }
 
+    ~field_buffers() {
+        delete jf;
+        delete rho;
+        delete tang_b;
+        delete norm_e;
+        delete div_b;
+        delete jf_tang_b;
+    }
+
     field_buffers(int xyz_size, int yzx_size, int zxy_size) {
         xyz_sbuf_pos = Kokkos::View<float*>("Send buffer for XYZ positive face", xyz_size);
         xyz_rbuf_pos = Kokkos::View<float*>("Receive buffer for XYZ positive face", xyz_size);
@@ -284,19 +308,19 @@ typedef struct field_buffers
         zxy_sbuf_neg = Kokkos::View<float*>("Send buffer for ZXY negative face", zxy_size);
         zxy_rbuf_neg = Kokkos::View<float*>("Receive buffer for ZXY negative face", zxy_size);
 
-        xyz_sbuf_pos_h = Kokkos::create_mirror_view(xyz_sbuf_pos);
-        yzx_sbuf_pos_h = Kokkos::create_mirror_view(yzx_sbuf_pos);
-        zxy_sbuf_pos_h = Kokkos::create_mirror_view(zxy_sbuf_pos);
-        xyz_rbuf_pos_h = Kokkos::create_mirror_view(xyz_rbuf_pos);
-        yzx_rbuf_pos_h = Kokkos::create_mirror_view(yzx_rbuf_pos);
-        zxy_rbuf_pos_h = Kokkos::create_mirror_view(zxy_rbuf_pos);
-
-        xyz_sbuf_neg_h = Kokkos::create_mirror_view(xyz_sbuf_neg);
-        yzx_sbuf_neg_h = Kokkos::create_mirror_view(yzx_sbuf_neg);
-        zxy_sbuf_neg_h = Kokkos::create_mirror_view(zxy_sbuf_neg);
-        xyz_rbuf_neg_h = Kokkos::create_mirror_view(xyz_rbuf_neg);
-        yzx_rbuf_neg_h = Kokkos::create_mirror_view(yzx_rbuf_neg);
-        zxy_rbuf_neg_h = Kokkos::create_mirror_view(zxy_rbuf_neg);
+        xyz_sbuf_pos_h = mp_mirror(xyz_sbuf_pos);
+        yzx_sbuf_pos_h = mp_mirror(yzx_sbuf_pos);
+        zxy_sbuf_pos_h = mp_mirror(zxy_sbuf_pos);
+        xyz_rbuf_pos_h = mp_mirror(xyz_rbuf_pos);
+        yzx_rbuf_pos_h = mp_mirror(yzx_rbuf_pos);
+        zxy_rbuf_pos_h = mp_mirror(zxy_rbuf_pos);
+
+        xyz_sbuf_neg_h = mp_mirror(xyz_sbuf_neg);
+        yzx_sbuf_neg_h = mp_mirror(yzx_sbuf_neg);
+        zxy_sbuf_neg_h = mp_mirror(zxy_sbuf_neg);
+        xyz_rbuf_neg_h = mp_mirror(xyz_rbuf_neg);
+        yzx_rbuf_neg_h = mp_mirror(yzx_rbuf_neg);
+        zxy_rbuf_neg_h = mp_mirror(zxy_rbuf_neg);
     }
 } field_buffers_t;
 // A field_array holds all the field quanties and pointers to
@@ -345,16 +369,16 @@ typedef struct field_array {
 
   void init_kokkos_fields(int n_fields, int xyz_sz, int yzx_sz, int zxy_sz)
   {
-      k_f_d = k_field_t("k_fields", n_fields);
+      k_f_d = first_touch_view<k_field_t>("k_fields", n_fields);
       k_field_sa_d = Kokkos::Experimental::create_scatter_view(k_f_d);
-      k_fe_d = k_field_edge_t("k_field_edges", n_fields);
+      k_fe_d = first_touch_view<k_field_edge_t>("k_field_edges", n_fields);
       k_f_h = Kokkos::create_mirror_view(k_f_d);
       k_fe_h = Kokkos::create_mirror_view(k_fe_d);
 
-      k_f_rhob_accum_d = k_field_accum_t("k_rhob_accum", n_fields);
+      k_f_rhob_accum_d = first_touch_view<k_field_accum_t>("k_rhob_accum", n_fields);
       k_f_rhob_accum_h = Kokkos::create_mirror_view(k_f_rhob_accum_d);
 
-      k_jf_accum_d = k_jf_accum_t("k_jf_accum", n_fields);
+      k_jf_accum_d = first_touch_view<k_jf_accum_t>("k_jf_accum", n_fields);
       k_jf_accum_h = Kokkos::create_mirror_view(k_jf_accum_d);
 
       fb = new field_buffers_t(xyz_sz, yzx_sz, zxy_sz);
@@ -375,6 +399,20 @@ typedef struct field_array {
    */
   void copy_to_device();
 
+  /**
+   * @brief Copies the fields (not the edge materials) of the voxels in
+   * the box [ix0,ix1]x[iy0,iy1]x[iz0,iz1] (ghost voxel indexing,
+   * inclusive) to the host.  The box is packed on the device so only it
+   * crosses the bus.  last_copied is not updated.
+   */
+  void copy_to_host( int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 );
+
+  /**
+   * @brief Copies the fields of the voxels in a box to the device (see
+   * the host version).
+   */
+  void copy_to_device( int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 );
+
 
 } field_array_t;
 
@@ -0,0 +1,100 @@
+#ifndef _field_inject_h_
+#define _field_inject_h_
+
+#include "field_advance.h"
+
+// Device field and current sources.  A source sets (or adds to) one
+// field component over a box or a plane of voxels directly in the
+// device fields, so a user_field_injection or user_current_injection
+// built on them can set kokkos_field_injection or
+// kokkos_current_injection and skip the full field copies.
+//
+// profile is a functor
+//
+//   KOKKOS_INLINE_FUNCTION float
+//   operator()( float x, float y, float z, double t ) const;
+//
+// giving the value of the component at the global position (x,y,z) of
+// its mesh point (components are staggered as in the field solver:
+// E, J and tca on edge centers, cB on face centers, rhob, rhof and
+// div_e_err on nodes and div_b_err on cell centers) and time t.  t
+// stays double so phases like omega t keep their precision late in a
+// run.
+
+// Offset in cells of the mesh point of component c from the node
+// (ix-1,iy-1,iz-1) of voxel (ix,iy,iz) along axis
+
+KOKKOS_INLINE_FUNCTION float
+field_var_offset( int c, int axis ) {
+  switch( c ) {
+  case field_var::ex:   case field_var::tcax: case field_var::jfx: return axis==0 ? 0.5f : 0.f;
+  case field_var::ey:   case field_var::tcay: case field_var::jfy: return axis==1 ? 0.5f : 0.f;
+  case field_var::ez:   case field_var::tcaz: case field_var::jfz: return axis==2 ? 0.5f : 0.f;
+  case field_var::cbx:  return axis==0 ? 0.f : 0.5f;
+  case field_var::cby:  return axis==1 ? 0.f : 0.5f;
+  case field_var::cbz:  return axis==2 ? 0.f : 0.5f;
+  case field_var::div_b_err: return 0.5f;
+  default: break;
+  }
+  return 0.f; // Nodes
+}
+
+// Set (add==0) or add to component c of the voxels in
+// [ix0,ix1]x[iy0,iy1]x[iz0,iz1] (inclusive, ghost voxel indexing)
+
+template<class Profile>
+void
+inject_field_box( field_array_t * RESTRICT fa,
+                  field_var::f_v c,
+                  int ix0, int ix1, int iy0, int iy1, int iz0, int iz1,
+                  const Profile & profile,
+                  double t,
+                  int add = 1 )
+{
+  if( !fa ) ERROR(( "Bad args" ));
+  const grid_t * g = fa->g;
+  if( ix0<0 || ix1>g->nx+1 || iy0<0 || iy1>g->ny+1 || iz0<0 || iz1>g->nz+1 )
+    ERROR(( "Bad field injection box" ));
+  if( ix0>ix1 || iy0>iy1 || iz0>iz1 ) return;
+
+  const int sy = g->sy, sz = g->sz;
+  const float dx = g->dx, dy = g->dy, dz = g->dz;
+  const float x0 = g->x0 + ( field_var_offset( c, 0 ) - 1 )*dx;
+  const float y0 = g->y0 + ( field_var_offset( c, 1 ) - 1 )*dy;
+  const float z0 = g->z0 + ( field_var_offset( c, 2 ) - 1 )*dz;
+  const auto& k_field = fa->k_f_d;
+
+  Kokkos::MDRangePolicy<Kokkos::Rank<3>> box({iz0, iy0, ix0}, {iz1+1, iy1+1, ix1+1});
+  Kokkos::parallel_for("inject field box", box,
+      KOKKOS_LAMBDA (const int iz, const int iy, const int ix) {
+    const int v = ix + sy*iy + sz*iz;
+    const float f = profile( x0 + ix*dx, y0 + iy*dy, z0 + iz*dz, t );
+    if( add ) k_field(v, c) += f;
+    else      k_field(v, c)  = f;
+  });
+}
+
+// Set or add to component c on the plane of voxels with index i along
+// axis (0, 1 or 2).  The plane covers the local mesh points of c:
+// 1..n along axes c is staggered on and 1..n+1 along the others.
+
+template<class Profile>
+void
+inject_field_plane( field_array_t * RESTRICT fa,
+                    field_var::f_v c,
+                    int axis, int i,
+                    const Profile & profile,
+                    double t,
+                    int add = 1 )
+{
+  if( !fa || axis<0 || axis>2 ) ERROR(( "Bad args" ));
+  const grid_t * g = fa->g;
+  int lo[3] = { 1, 1, 1 };
+  int hi[3] = { g->nx, g->ny, g->nz };
+  for( int a=0; a<3; a++ ) if( field_var_offset( c, a )==0 ) hi[a]++;
+  lo[axis] = hi[axis] = i;
+  inject_field_box( fa, c, lo[0], hi[0], lo[1], hi[1], lo[2], hi[2],
+                    profile, t, add );
+}
+
+#endif // _field_inject_h_
@@ -665,7 +665,12 @@ void advance_e_kokkos(field_array_t* RESTRICT fa, float frac) {
     * Begin tangential B ghost setup
     ***************************************************************************/
 
-    kokkos_begin_remote_ghost_tang_b( fa, fa->g, *(fa->fb) );
+    // The remote ghosts may have come with the current
+    // (k_synchronize_jf_tang_b)
+    const int remote = !fa->fb->tang_b_ghosted;
+    fa->fb->tang_b_ghosted = 0;
+
+    if( remote ) kokkos_begin_remote_ghost_tang_b( fa, fa->g, *(fa->fb) );
 
     k_local_ghost_tang_b( fa, fa->g );
 
@@ -675,7 +680,7 @@ void advance_e_kokkos(field_array_t* RESTRICT fa, float frac) {
     * Finish tangential B ghost setup
     ***************************************************************************/
 
-    kokkos_end_remote_ghost_tang_b( fa, fa->g, *(fa->fb) );
+    if( remote ) kokkos_end_remote_ghost_tang_b( fa, fa->g, *(fa->fb) );
 
     /***************************************************************************
     * Update exterior fields
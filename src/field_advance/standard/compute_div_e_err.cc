@@ -329,7 +329,7 @@ compute_div_e_err_kokkos( field_array_t * RESTRICT fa ) {
 
   // Begin setting normal e ghosts
 
-    k_begin_remote_ghost_norm_e( fa, fa->g );
+    kokkos_begin_remote_ghost_norm_e( fa, fa->g, *(fa->fb) );
 
     k_local_ghost_norm_e( fa, fa->g );
 
@@ -349,7 +349,7 @@ compute_div_e_err_kokkos( field_array_t * RESTRICT fa ) {
 
   // Finish setting normal e ghosts
 
-    k_end_remote_ghost_norm_e( fa, fa->g );
+    kokkos_end_remote_ghost_norm_e( fa, fa->g, *(fa->fb) );
 
     compute_div_e_err_exterior_kokkos(fa, fa->g);
 
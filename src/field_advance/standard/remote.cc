@@ -141,30 +141,6 @@ typedef class XYZ {} XYZ;
 typedef class YZX {} YZX;
 typedef class ZXY {} ZXY;
 
-template <typename T> void begin_recv_kokkos(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf, Kokkos::View<float*>::HostMirror& rbuf_h) {
-}
-template<> void begin_recv_kokkos<XYZ>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    int size = (1 + ny*(nz+1) + nz*(ny+1))*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
-}
-template<> void begin_recv_kokkos<YZX>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    int size = (1 + nx*(nz+1) + nz*(nx+1))*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
-}
-template<> void begin_recv_kokkos<ZXY>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    int size = (1 + nx*(ny+1) + ny*(nx+1))*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
-}
-
 template <typename T> void begin_recv(int i, int j, int k, int nx, int ny, int nz, const grid_t* g) {
     int nX, nY, nZ;
     if (std::is_same<T, XYZ>::value) {
@@ -187,91 +163,6 @@ template<> void begin_recv<ZXY>(int i, int j, int k, int nx, int ny, int nz, con
     begin_recv_port(i,j,k,(1+nx*(ny+1)+ny*(nx+1))*sizeof(float),g);
 }
 
-template <typename T> void begin_send_kokkos(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf, Kokkos::View<float*>::HostMirror& sbuf_h) {}
-
-template <> void begin_send_kokkos<XYZ>(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    k_field_t& k_field = fa->k_f_d;
-    const size_t size = (1+ny*(nz+1)+nz*(ny+1));
-
-        int face = (i+j+k)<0 ? 1 : nx;
-        float dx = g->dx;
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_edge({1, 1}, {nz+1, ny+2});
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> yz_edge({1, 1}, {nz+2, ny+1});
-
-        Kokkos::parallel_for("begin_send<XYZ>: ZY Edge Loop", zy_edge, KOKKOS_LAMBDA(const int z, const int y) {
-//            if(z+y == 2) {
-//                sbuf_d(0) = dx;
-//            }
-            const int x = face;
-            sbuf_d(1 + (z-1)*(ny+1) + (y-1)) = k_field(VOXEL(x,y,z, nx,ny,nz), field_var::cby);
-        });
-        Kokkos::parallel_for("begin_send<XYZ>: YZ Edge Loop", yz_edge, KOKKOS_LAMBDA(const int z, const int y) {
-            const int x = face;
-            sbuf_d(1 + nz*(ny+1) + (z-1)*ny + (y-1)) = k_field(VOXEL(x,y,z, nx,ny,nz), field_var::cbz);
-        });
-// CPU
-        Kokkos::deep_copy(sbuf_h, sbuf_d);
-        sbuf_h(0) = dx;
-        begin_send_port_k(i,j,k,size*sizeof(float), g, reinterpret_cast<char*>(sbuf_h.data()));
-
-// GPU
-//        begin_send_port_k(i,j,k,size*sizeof(float), g, reinterpret_cast<char*>(sbuf_d.data()));
-
-}
-template <> void begin_send_kokkos<YZX>(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    k_field_t& k_field = fa->k_f_d;
-    size_t size = (1+nz*(nx+1)+nx*(nz+1));
-    int face = (i+j+k)<0 ? 1 : ny;
-    float dy = g->dy;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> xz_edge({1, 1}, {nz+2, nx+1});
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_edge({1, 1}, {nz+1, nx+2});
-
-    Kokkos::parallel_for("begin_send<YZX>: XZ Edge Loop", xz_edge, KOKKOS_LAMBDA(const int z, const int x) {
-//        if(z+x == 2) {
-//            sbuf_d(0) = dy;
-//        }
-        const int y = face;
-        sbuf_d(1 + (z-1)*nx + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbz);
-    });
-    Kokkos::parallel_for("begin_send<YZX>: ZX Edge Loop", zx_edge, KOKKOS_LAMBDA(const int z, const int x) {
-        const int y = face;
-        sbuf_d(1 + (nz+1)*nx + (nx+1)*(z-1) + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbx);
-    });
-// CPU
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = dy;
-    begin_send_port_k(i, j, k, size*sizeof(float), g, reinterpret_cast<char*>(sbuf_h.data()));
-// GPU
-//    begin_send_port_k(i, j, k, size*sizeof(float), g, reinterpret_cast<char*>(sbuf_d.data()));
-
-}
-template <> void begin_send_kokkos<ZXY>(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    size_t size = (1+nx*(ny+1)+ny*(nx+1));
-    k_field_t& k_field = fa->k_f_d;
-    int face = (i+j+k)<0 ? 1 : nz;
-    float dz = g->dz;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_edge({1, 1}, {ny+1, nx+2});
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> xy_edge({1, 1}, {ny+2, nx+1});
-
-    Kokkos::parallel_for("begin_send<ZXY>: YX Edge Loop", yx_edge, KOKKOS_LAMBDA(const int y, const int x) {
-//        if(y+x == 2) {
-//            sbuf_d(0) = dz;
-//        }
-        const int z = face;
-        sbuf_d(1 + (nx+1)*(y-1) + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbx);
-    });
-    Kokkos::parallel_for("begin_send<ZXY>: XY Edge Loop", xy_edge, KOKKOS_LAMBDA(const int y, const int x) {
-        const int z = face;
-        sbuf_d(1 + (nx+1)*ny + (y-1)*nx + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cby);
-    });
-// CPU
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = dz;
-    begin_send_port_k(i,j,k,size*sizeof(float), g, reinterpret_cast<char*>(sbuf_h.data()));
-// GPU
-//    begin_send_port_k(i,j,k,size*sizeof(float), g, reinterpret_cast<char*>(sbuf_d.data()));
-}
-
 template <typename T> void begin_send(int i, int j, int k, int nX, int nY, int nZ, field_array_t*  fa, const grid_t* g) {}
 template <> void begin_send<XYZ>(int i, int j, int k, int nx, int ny, int nz, field_array_t* field, const grid_t* g) {
     k_field_t k_field = field->k_f_d;
@@ -402,22 +293,11 @@ void
 kokkos_begin_remote_ghost_tang_b( field_array_t      * RESTRICT fa,
                            const grid_t *              g,
                             field_buffers_t&            f_buffers) {
-    const int nx = g->nx, ny = g->ny, nz = g->nz;
-
-    begin_recv_kokkos<XYZ>(g,-1,0,0,nx,ny,nz, f_buffers.xyz_sbuf_neg, f_buffers.xyz_rbuf_neg_h);
-    begin_recv_kokkos<YZX>(g,0,-1,0,nx,ny,nz, f_buffers.yzx_sbuf_neg, f_buffers.yzx_rbuf_neg_h);
-    begin_recv_kokkos<ZXY>(g,0,0,-1,nx,ny,nz, f_buffers.zxy_sbuf_neg, f_buffers.zxy_rbuf_neg_h);
-    begin_recv_kokkos<XYZ>(g,1,0,0,nx,ny,nz,  f_buffers.xyz_sbuf_pos, f_buffers.xyz_rbuf_pos_h);
-    begin_recv_kokkos<YZX>(g,0,1,0,nx,ny,nz,  f_buffers.yzx_sbuf_pos, f_buffers.yzx_rbuf_pos_h);
-    begin_recv_kokkos<ZXY>(g,0,0,1,nx,ny,nz,  f_buffers.zxy_sbuf_pos, f_buffers.zxy_rbuf_pos_h);
-
-    begin_send_kokkos<XYZ>(g,fa,-1,0,0,nx,ny,nz, f_buffers.xyz_sbuf_neg, f_buffers.xyz_sbuf_neg_h);
-    begin_send_kokkos<YZX>(g,fa,0,-1,0,nx,ny,nz, f_buffers.yzx_sbuf_neg, f_buffers.yzx_sbuf_neg_h);
-    begin_send_kokkos<ZXY>(g,fa,0,0,-1,nx,ny,nz, f_buffers.zxy_sbuf_neg, f_buffers.zxy_sbuf_neg_h);
-    begin_send_kokkos<XYZ>(g,fa,1,0,0,nx,ny,nz,  f_buffers.xyz_sbuf_pos, f_buffers.xyz_sbuf_pos_h);
-    begin_send_kokkos<YZX>(g,fa,0,1,0,nx,ny,nz,  f_buffers.yzx_sbuf_pos, f_buffers.yzx_sbuf_pos_h);
-    begin_send_kokkos<ZXY>(g,fa,0,0,1,nx,ny,nz,  f_buffers.zxy_sbuf_pos, f_buffers.zxy_sbuf_pos_h);
-
+    static const halo_comp_t tang_b[3] = { { field_var::cbx, HALO_GHOST, { 0, 1, 1 } },
+                                           { field_var::cby, HALO_GHOST, { 1, 0, 1 } },
+                                           { field_var::cbz, HALO_GHOST, { 1, 1, 0 } } };
+    if( !f_buffers.tang_b ) f_buffers.tang_b = new halo_t( g, tang_b, 3 );
+    begin_halo_exchange( *f_buffers.tang_b, g, fa->k_f_d );
 }
 
 void
@@ -440,106 +320,6 @@ k_begin_remote_ghost_tang_b( field_array_t      * RESTRICT fa,
     begin_send<ZXY>(0,0,1,nx,ny,nz,fa,g);
 }
 
-template<typename T> void end_recv_kokkos(const grid_t* g, field_array_t* RESTRICT field, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf, Kokkos::View<float*>::HostMirror& rbuf_h) {}
-
-template<> void end_recv_kokkos<XYZ>(const grid_t* g, field_array_t* RESTRICT field, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    float* p = static_cast<float*>(end_recv_port_k(i,j,k,g));
-//    size_t size = 1 + (ny+1)*nz + ny*(nz+1);
-    if(p) {
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        k_field_t k_field = field->k_f_d;
-
-        int face = (i+j+k)<0 ? nx+1 : 0;
-        float dx = g->dx;
-
-            float lw = rbuf_h(0);
-            const float rw = (2.*dx) / (lw + dx);
-            lw = (lw - dx)/(lw + dx);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_edge({1, 1}, {nz+1, ny+2});
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> yz_edge({1, 1}, {nz+2, ny+1});
-        Kokkos::parallel_for("end_recv<XYZ>: ZY Edge loop", zy_edge, KOKKOS_LAMBDA(const int z, const int y) {
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dx) / (lw + dx);
-//            lw = (lw - dx)/(lw + dx);
-            k_field(VOXEL(face,y,z,nx,ny,nz), field_var::cby) = rw*rbuf_d((z-1)*(ny+1) + (y-1) + 1) + lw*k_field(VOXEL(face+i,y+j,z+k,nx,ny,nz), field_var::cby);
-        });
-        Kokkos::parallel_for("end_recv<XYZ>: YZ Edge loop", yz_edge, KOKKOS_LAMBDA(const int z, const int y) {
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dx) / (lw + dx);
-//            lw = (lw - dx)/(lw + dx);
-            k_field(VOXEL(face,y,z,nx,ny,nz), field_var::cbz) = rw*rbuf_d((ny+1)*nz + (z-1)*ny + (y-1) + 1) + lw*k_field(VOXEL(face+i,y+j,z+k,nx,ny,nz), field_var::cbz);
-        });
-    }
-}
-template<> void end_recv_kokkos<YZX>(const grid_t* g, field_array_t* RESTRICT field, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-   float* p = static_cast<float*>(end_recv_port_k(i,j,k,g));
-//    size_t size = 1 + nx*(nz+1) + (nx+1)*nz;
-    if(p) {
-// CPU
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        k_field_t k_field = field->k_f_d;
-
-        int face = (i+j+k)<0 ? ny+1 : 0;
-        float dy = g->dy;
-
-            float lw = rbuf_h(0);
-            const float rw = (2.*dy) / (lw+dy);
-            lw = (lw-dy)/(lw+dy);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> xz_edge({1, 1}, {nz+2, nx+1});
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_edge({1, 1}, {nz+1, nx+2});
-        Kokkos::parallel_for("end_recv<YZX>: XZ Edge loop", xz_edge, KOKKOS_LAMBDA(const int z, const int x) {
-            const int y = face;
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dy) / (lw+dy);
-//            lw = (lw-dy)/(lw+dy);
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbz) = rw*rbuf_d(1 + (z-1)*nx + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::cbz);
-        });
-        Kokkos::parallel_for("end_recv<YZX>: ZX Edge loop", zx_edge, KOKKOS_LAMBDA(const int z, const int x) {
-            const int y = face;
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dy) / (lw+dy);
-//            lw = (lw-dy)/(lw+dy);
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbx) = rw*rbuf_d(1 + nx*(nz+1) + (z-1)*(nx+1) + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::cbx);
-        });
-    }
-}
-template<> void end_recv_kokkos<ZXY>(const grid_t* g, field_array_t* RESTRICT field, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    float* p = static_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        k_field_t k_field = field->k_f_d;
-// CPU
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        int face = (i+j+k)<0 ? nz+1 : 0;
-        float dz = g->dz;
-
-            float lw = rbuf_h(0);
-            const float rw = (2.*dz) / (lw+dz);
-            lw = (lw-dz)/(lw+dz);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_edge({1, 1}, {ny+1, nx+2});
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> xy_edge({1, 1}, {ny+2, nx+1});
-        Kokkos::parallel_for("end_recv<ZXY>: YX Edge loop", yx_edge, KOKKOS_LAMBDA(const int y, const int x) {
-            const int z = face;
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dz) / (lw+dz);
-//            lw = (lw-dz)/(lw+dz);
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cbx) = rw*rbuf_d(1 + (y-1)*(nx+1) + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::cbx);
-        });
-        Kokkos::parallel_for("end_recv<ZXY>: XY Edge loop", xy_edge, KOKKOS_LAMBDA(const int y, const int x) {
-            const int z = face;
-//            float lw = rbuf_d(0);
-//            const float rw = (2.*dz) / (lw+dz);
-//            lw = (lw-dz)/(lw+dz);
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::cby) = rw*rbuf_d(1 + ny*(nx+1) + (y-1)*nx + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::cby);
-        });
-    }
-}
-
 template<typename T> void end_recv(int i, int j, int k, int nx, int ny, int nz, field_array_t* RESTRICT field, const grid_t* g) {}
 
 template<> void end_recv<XYZ>(int i, int j, int k, int nx, int ny, int nz, field_array_t* RESTRICT field, const grid_t* g) {
@@ -653,9 +433,6 @@ template<> void end_recv<ZXY>(int i, int j, int k, int nx, int ny, int nz, field
 }
 
 // Completely unnecessary, only for symmetry of function calls
-template<typename T> void end_send_kokkos(const grid_t* g, int i, int j, int k) {
-    end_send_port_k(i,j,k, g);
-}
 
 void
 k_end_remote_ghost_tang_b( field_array_t      * RESTRICT field,
@@ -681,105 +458,7 @@ void
 kokkos_end_remote_ghost_tang_b( field_array_t      * RESTRICT field,
                          const grid_t *              g ,
                             field_buffers_t&        f_buffers) {
-    const int nx = g->nx, ny = g->ny, nz = g->nz;
-
-    end_recv_kokkos<XYZ>(g, field, -1, 0, 0, nx, ny, nz, f_buffers.xyz_rbuf_neg, f_buffers.xyz_rbuf_neg_h);
-    end_recv_kokkos<YZX>(g, field, 0, -1, 0, nx, ny, nz, f_buffers.yzx_rbuf_neg, f_buffers.yzx_rbuf_neg_h);
-    end_recv_kokkos<ZXY>(g, field, 0, 0, -1, nx, ny, nz, f_buffers.zxy_rbuf_neg, f_buffers.zxy_rbuf_neg_h);
-    end_recv_kokkos<XYZ>(g, field, 1, 0, 0,  nx, ny, nz, f_buffers.xyz_rbuf_pos, f_buffers.xyz_rbuf_pos_h);
-    end_recv_kokkos<YZX>(g, field, 0, 1, 0,  nx, ny, nz, f_buffers.yzx_rbuf_pos, f_buffers.yzx_rbuf_pos_h);
-    end_recv_kokkos<ZXY>(g, field, 0, 0, 1,  nx, ny, nz, f_buffers.zxy_rbuf_pos, f_buffers.zxy_rbuf_pos_h);
-
-    end_send_kokkos<XYZ>(g, -1,0,0);
-    end_send_kokkos<YZX>(g, 0,-1,0);
-    end_send_kokkos<ZXY>(g, 0,0,-1);
-    end_send_kokkos<XYZ>(g, 1,0,0);
-    end_send_kokkos<YZX>(g, 0,1,0);
-    end_send_kokkos<ZXY>(g, 0,0,1);
-}
-
-template<typename T> void begin_recv_ghost_norm_e_kokkos(const grid_t* g, int i, int j, int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
-template<> void begin_recv_ghost_norm_e_kokkos<XYZ>(const grid_t* g, int i, int j, int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int ny = g->ny, nz = g->nz;
-    int size = ( 1 + (ny+1)*(nz+1) )*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_d.data()));
-}
-template<> void begin_recv_ghost_norm_e_kokkos<YZX>(const grid_t* g, int i, int j, int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int nx = g->nx, nz = g->nz;
-    int size = ( 1 + (nx+1)*(nz+1) )*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_d.data()));
-}
-template<> void begin_recv_ghost_norm_e_kokkos<ZXY>(const grid_t* g, int i, int j, int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int nx = g->nx, ny = g->ny;
-    int size = ( 1 + (nx+1)*(ny+1) )*sizeof(float);
-// CPU
-    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g, reinterpret_cast<char*>(rbuf_d.data()));
-}
-template<typename T> void begin_send_ghost_norm_e_kokkos(field_array_t* fa, const grid_t* g, int i, int j, int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {}
-template<> void begin_send_ghost_norm_e_kokkos<XYZ>(field_array_t* fa, const grid_t* g, int i, int j, int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = g->nx, ny = g->ny, nz = g->nz;
-    const int size = ( 1 + (ny+1)*(nz+1) )*sizeof(float);
-    k_field_t& k_field = fa->k_f_d;
-    const int face = (i+j+k)<0 ? 1 : nx;
-    const float dx = g->dx;
-
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_node({1, 1}, {nz+2, ny+2});
-    Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<XYZ>", zy_node, KOKKOS_LAMBDA(const int z, const int y) {
-        if(z+y == 2) {
-            sbuf_d(0) = dx;
-        }
-        const int x = face;
-        sbuf_d(1 + (z-1)*(ny+1) + (y-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ex);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dx;
-    begin_send_port_k(i,j,k,size,g,reinterpret_cast<char*>(sbuf_h.data()));
-}
-template<> void begin_send_ghost_norm_e_kokkos<YZX>(field_array_t* fa, const grid_t* g, int i, int j, int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = g->nx, ny = g->ny, nz = g->nz;
-    const int size = ( 1 + (nx+1)*(nz+1) )*sizeof(float);
-    k_field_t& k_field = fa->k_f_d;
-    const int face = (i+j+k)<0 ? 1 : ny;
-    const float dy = g->dy;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_node({1, 1}, {nz+2, nx+2});
-    Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<YZX>", zx_node, KOKKOS_LAMBDA(const int z, const int x) {
-        if(z+x == 2) {
-            sbuf_d(0) = dy;
-        }
-        const int y = face;
-        sbuf_d(1 + (z-1)*(nx+1) + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ey);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dy;
-    begin_send_port_k(i,j,k,size,g,reinterpret_cast<char*>(sbuf_h.data()));
-
-}
-template<> void begin_send_ghost_norm_e_kokkos<ZXY>(field_array_t* fa, const grid_t* g, int i, int j, int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = g->nx, ny = g->ny, nz = g->nz;
-    const int size = ( 1 + (nx+1)*(ny+1) )*sizeof(float);
-    k_field_t& k_field = fa->k_f_d;
-    const int face = (i+j+k)<0 ? 1 : nz;
-    const float dz = g->dz;
-
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_node({1, 1}, {ny+2, nx+2});
-    Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<ZXY>", yx_node, KOKKOS_LAMBDA(const int y, const int x) {
-        if(y+x == 2) {
-            sbuf_d(0) = dz;
-        }
-        const int z = face;
-        sbuf_d(1 + (y-1)*(nx+1) + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ez);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dz;
-    begin_send_port_k(i,j,k,size,g,reinterpret_cast<char*>(sbuf_h.data()));
+    end_halo_exchange( *f_buffers.tang_b, g, field->k_f_d );
 }
 
 template<typename T> void begin_recv_ghost_norm_e(const grid_t* g, int i, int j, int k) {}
@@ -889,19 +568,11 @@ void
 kokkos_begin_remote_ghost_norm_e( field_array_t      * ALIGNED(128) field,
                            const grid_t *              g,
                             field_buffers_t&            f_buffers) {
-    begin_recv_ghost_norm_e_kokkos<XYZ>(g, -1,  0,  0, f_buffers.xyz_rbuf_neg, f_buffers.xyz_rbuf_neg_h);
-    begin_recv_ghost_norm_e_kokkos<YZX>(g,  0, -1,  0, f_buffers.yzx_rbuf_neg, f_buffers.yzx_rbuf_neg_h);
-    begin_recv_ghost_norm_e_kokkos<ZXY>(g,  0,  0, -1, f_buffers.zxy_rbuf_neg, f_buffers.zxy_rbuf_neg_h);
-    begin_recv_ghost_norm_e_kokkos<XYZ>(g, 1, 0, 0, f_buffers.xyz_rbuf_pos, f_buffers.xyz_rbuf_pos_h);
-    begin_recv_ghost_norm_e_kokkos<YZX>(g, 0, 1, 0, f_buffers.yzx_rbuf_pos, f_buffers.yzx_rbuf_pos_h);
-    begin_recv_ghost_norm_e_kokkos<ZXY>(g, 0, 0, 1, f_buffers.zxy_rbuf_pos, f_buffers.zxy_rbuf_pos_h);
-
-    begin_send_ghost_norm_e_kokkos<XYZ>(field, g, -1,  0,  0, f_buffers.xyz_sbuf_neg, f_buffers.xyz_sbuf_neg_h);
-    begin_send_ghost_norm_e_kokkos<YZX>(field, g,  0, -1,  0, f_buffers.yzx_sbuf_neg, f_buffers.yzx_sbuf_neg_h);
-    begin_send_ghost_norm_e_kokkos<ZXY>(field, g,  0,  0, -1, f_buffers.zxy_sbuf_neg, f_buffers.zxy_sbuf_neg_h);
-    begin_send_ghost_norm_e_kokkos<XYZ>(field, g, 1, 0, 0, f_buffers.xyz_sbuf_pos, f_buffers.xyz_sbuf_pos_h);
-    begin_send_ghost_norm_e_kokkos<YZX>(field, g, 0, 1, 0, f_buffers.yzx_sbuf_pos, f_buffers.yzx_sbuf_pos_h);
-    begin_send_ghost_norm_e_kokkos<ZXY>(field, g, 0, 0, 1, f_buffers.zxy_sbuf_pos, f_buffers.zxy_sbuf_pos_h);
+    static const halo_comp_t norm_e[3] = { { field_var::ex, HALO_GHOST, { 1, 0, 0 } },
+                                           { field_var::ey, HALO_GHOST, { 0, 1, 0 } },
+                                           { field_var::ez, HALO_GHOST, { 0, 0, 1 } } };
+    if( !f_buffers.norm_e ) f_buffers.norm_e = new halo_t( g, norm_e, 3 );
+    begin_halo_exchange( *f_buffers.norm_e, g, field->k_f_d );
 }
 
 void
@@ -958,70 +629,6 @@ begin_remote_ghost_norm_e( field_t      * ALIGNED(128) field,
 # undef BEGIN_SEND
 }
 
-template<typename T> void end_recv_ghost_norm_e_kokkos(field_array_t* fa, const grid_t* g, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
-template<> void end_recv_ghost_norm_e_kokkos<XYZ>(field_array_t* fa, const grid_t* g, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        int nx = g->nx, ny = g->ny, nz = g->nz;
-        float lw = rbuf_h(0);
-        float rw = (2.*g->dx)/(lw+g->dx);
-        lw = (lw-g->dx)/(lw+g->dx);
-        int face = (i+j+k)<0 ? nx+1 : 0;
-        //int size = 1 + (ny+1)*(nz+1);
-        k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_node({1, 1}, {nz+2, ny+2});
-        Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<XYZ>", zy_node, KOKKOS_LAMBDA(const int z, const int y) {
-            const int x = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ex) = rw*rbuf_d(1 + (z-1)*(ny+1) + (y-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::ex);
-        });
-    }
-}
-template<> void end_recv_ghost_norm_e_kokkos<YZX>(field_array_t* fa, const grid_t* g, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        int nx = g->nx, ny = g->ny, nz = g->nz;
-        float lw = rbuf_h(0);
-        float rw = (2.*g->dy)/(lw+g->dy);
-        lw = (lw-g->dy)/(lw+g->dy);
-        int face = (i+j+k)<0 ? ny+1 : 0;
-        //int size = 1 + (nx+1)*(nz+1);
-        k_field_t& k_field = fa->k_f_d;
-
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_node({1, 1}, {nz+2, nx+2});
-        Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<YZX>", zx_node, KOKKOS_LAMBDA(const int z, const int x) {
-            const int y = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ey) = rw*rbuf_d(1 + (z-1)*(nx+1) + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::ey);
-        });
-    }
-}
-template<> void end_recv_ghost_norm_e_kokkos<ZXY>(field_array_t* fa, const grid_t* g, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        int nx = g->nx, ny = g->ny, nz = g->nz;
-        float lw = rbuf_h(0);
-        float rw = (2.*g->dz)/(lw+g->dz);
-        lw = (lw-g->dz)/(lw+g->dz);
-        int face = (i+j+k)<0 ? nz+1 : 0;
-        //int size = 1 + (nx+1)*(ny+1);
-        k_field_t& k_field = fa->k_f_d;
-
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_node({1, 1}, {ny+2, nx+2});
-        Kokkos::parallel_for("begin_send_ghost_norm_e_kokkos<ZXY>", yx_node, KOKKOS_LAMBDA(const int y, const int x) {
-            const int z = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ez) = rw*rbuf_d(1 + (y-1)*(nx+1) + (x-1)) + lw*k_field(VOXEL(x+i,y+j,z+k,nx,ny,nz), field_var::ez);
-        });
-    }
-}
-template<typename T> void end_send_ghost_norm_e_kokkos(const grid_t* g, const int i, const int j, const int k) {
-    end_send_port_k(i,j,k,g);
-}
-
 template<typename T> void end_recv_ghost_norm_e(field_array_t* fa, const grid_t* g, const int i, const int j, const int k) {}
 template<> void end_recv_ghost_norm_e<XYZ>(field_array_t* fa, const grid_t* g, const int i, const int j, const int k) {
     float* p = reinterpret_cast<float*>(end_recv_port(i,j,k,g));
@@ -1122,20 +729,7 @@ void
 kokkos_end_remote_ghost_norm_e( field_array_t      * ALIGNED(128) field,
                          const grid_t *              g,
                             field_buffers_t&            f_buffers) {
-
-    end_recv_ghost_norm_e_kokkos<XYZ>(field, g, -1,  0,  0, f_buffers.xyz_rbuf_neg, f_buffers.xyz_rbuf_neg_h);
-    end_recv_ghost_norm_e_kokkos<YZX>(field, g,  0, -1,  0, f_buffers.yzx_rbuf_neg, f_buffers.yzx_rbuf_neg_h);
-    end_recv_ghost_norm_e_kokkos<ZXY>(field, g,  0,  0, -1, f_buffers.zxy_rbuf_neg, f_buffers.zxy_rbuf_neg_h);
-    end_recv_ghost_norm_e_kokkos<XYZ>(field, g, 1, 0, 0, f_buffers.xyz_rbuf_pos, f_buffers.xyz_rbuf_pos_h);
-    end_recv_ghost_norm_e_kokkos<YZX>(field, g, 0, 1, 0, f_buffers.yzx_rbuf_pos, f_buffers.yzx_rbuf_pos_h);
-    end_recv_ghost_norm_e_kokkos<ZXY>(field, g, 0, 0, 1, f_buffers.zxy_rbuf_pos, f_buffers.zxy_rbuf_pos_h);
-
-    end_send_ghost_norm_e_kokkos<XYZ>(g, -1,  0,  0);
-    end_send_ghost_norm_e_kokkos<YZX>(g,  0, -1,  0);
-    end_send_ghost_norm_e_kokkos<ZXY>(g,  0,  0, -1);
-    end_send_ghost_norm_e_kokkos<XYZ>(g, 1, 0, 0);
-    end_send_ghost_norm_e_kokkos<YZX>(g, 0, 1, 0);
-    end_send_ghost_norm_e_kokkos<ZXY>(g, 0, 0, 1);
+    end_halo_exchange( *f_buffers.norm_e, g, field->k_f_d );
 }
 void
 k_end_remote_ghost_norm_e( field_array_t      * ALIGNED(128) field,
@@ -1192,66 +786,6 @@ end_remote_ghost_norm_e( field_t      * ALIGNED(128) field,
 # undef END_SEND
 }
 
-template<typename T> void begin_recv_ghost_div_b(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
-template<> void begin_recv_ghost_div_b<XYZ>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int ny = fa->g->ny, nz=fa->g->nz;
-    const int size = (1 + ny*nz)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
-}
-template<> void begin_recv_ghost_div_b<YZX>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int nx = fa->g->nx, nz=fa->g->nz;
-    const int size = (1 + nz*nx)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
-}
-template<> void begin_recv_ghost_div_b<ZXY>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const int nx = fa->g->nx, ny = fa->g->ny;
-    const int size = (1 + nx*ny)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
-}
-template<typename T> void begin_send_ghost_div_b(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {}
-template<> void begin_send_ghost_div_b<XYZ>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
-    const int size = (1 + ny*nz)*sizeof(float);
-    const int face = (i+j+k)<0 ? 1 : nx;
-    const k_field_t& k_field = fa->k_f_d;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> x_face({1, 1}, {nz+1, ny+1});
-    Kokkos::parallel_for("begin_send_ghost_div_b<XYZ>", x_face, KOKKOS_LAMBDA(const int z, const int y) {
-        const int x = face;
-        sbuf_d(1 + (z-1)*ny + (y-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dx;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
-}
-template<> void begin_send_ghost_div_b<YZX>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
-    const int size = (1 + nx*nz)*sizeof(float);
-    const int face = (i+j+k) < 0 ? 1 : ny;
-    const k_field_t& k_field = fa->k_f_d;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> y_face({1, 1}, {nz+1, nx+1});
-    Kokkos::parallel_for("begin_send_ghost_div_b<YZX>", y_face, KOKKOS_LAMBDA(const int z, const int x) {
-        const int y = face;
-        sbuf_d(1 + (z-1)*nx + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dy;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
-}
-template<> void begin_send_ghost_div_b<ZXY>(field_array* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
-    const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
-    const int size = (1 + nx*ny)*sizeof(float);
-    const int face = (i+j+k) < 0 ? 1 : nz;
-    const k_field_t& k_field = fa->k_f_d;
-    Kokkos::MDRangePolicy<Kokkos::Rank<2>> z_face({1, 1}, {ny+1, nx+1});
-    Kokkos::parallel_for("begin_send_ghost_div_b<ZXY>", z_face, KOKKOS_LAMBDA(const int y, const int x) {
-        const int z = face;
-        sbuf_d(1 + (y-1)*nx + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err);
-    });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dz;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
-}
-
 void
 begin_remote_ghost_div_b( field_t      * ALIGNED(128) field,
                           const grid_t *              g ) {
@@ -1289,105 +823,13 @@ begin_remote_ghost_div_b( field_t      * ALIGNED(128) field,
 }
 
 void k_begin_remote_ghost_div_b(field_array_t* ALIGNED(128) fa, const grid_t* g, field_buffers_t& fb) {
-// Start receiving
-    begin_recv_ghost_div_b<XYZ>(fa, -1,  0,  0, fb.xyz_rbuf_neg, fb.xyz_rbuf_neg_h);
-    begin_recv_ghost_div_b<YZX>(fa,  0, -1,  0, fb.yzx_rbuf_neg, fb.yzx_rbuf_neg_h);
-    begin_recv_ghost_div_b<ZXY>(fa,  0,  0, -1, fb.zxy_rbuf_neg, fb.zxy_rbuf_neg_h);
-
-    begin_recv_ghost_div_b<XYZ>(fa,  1,  0,  0, fb.xyz_rbuf_pos, fb.xyz_rbuf_pos_h);
-    begin_recv_ghost_div_b<YZX>(fa,  0,  1,  0, fb.yzx_rbuf_pos, fb.yzx_rbuf_pos_h);
-    begin_recv_ghost_div_b<ZXY>(fa,  0,  0,  1, fb.zxy_rbuf_pos, fb.zxy_rbuf_pos_h);
-
-// Start sending
-    begin_send_ghost_div_b<XYZ>(fa, -1,  0,  0, fb.xyz_sbuf_neg, fb.xyz_sbuf_neg_h);
-    begin_send_ghost_div_b<YZX>(fa,  0, -1,  0, fb.yzx_sbuf_neg, fb.yzx_sbuf_neg_h);
-    begin_send_ghost_div_b<ZXY>(fa,  0,  0, -1, fb.zxy_sbuf_neg, fb.zxy_sbuf_neg_h);
-
-    begin_send_ghost_div_b<XYZ>(fa,  1,  0,  0, fb.xyz_sbuf_pos, fb.xyz_sbuf_pos_h);
-    begin_send_ghost_div_b<YZX>(fa,  0,  1,  0, fb.yzx_sbuf_pos, fb.yzx_sbuf_pos_h);
-    begin_send_ghost_div_b<ZXY>(fa,  0,  0,  1, fb.zxy_sbuf_pos, fb.zxy_sbuf_pos_h);
-}
-
-template<typename T> void end_recv_ghost_div_b(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
-template<> void end_recv_ghost_div_b<XYZ>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const grid_t* g = fa->g;
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        const int nx = g->nx, ny = g->ny, nz = g->nz;
-        const int face = (i+j+k) < 0 ? nx+1 : 0;
-        float lw = rbuf_h(0);
-        float rw = (2. * g->dx) / (lw + g->dx);
-        lw = (lw - g->dx) / (lw + g->dx);
-        const k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> x_face({1, 1}, {nz+1, ny+1});
-        Kokkos::parallel_for("end_recv_ghost_div_b<XYZ>", x_face, KOKKOS_LAMBDA(const int z, const int y) {
-            const int x = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err) = rw * rbuf_d(1 + (z-1)*ny + (y-1)) + lw * k_field(VOXEL(x+i, y+j, z+k, nx, ny, nz), field_var::div_b_err);
-        });
-    }
-}
-template<> void end_recv_ghost_div_b<YZX>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const grid_t* g = fa->g;
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        const int nx = g->nx, ny = g->ny, nz = g->nz;
-        const int face = (i+j+k) < 0 ? ny+1 : 0;
-        float lw = rbuf_h(0);
-        float rw = (2. * g->dy) / (lw + g->dy);
-        lw = (lw - g->dy) / (lw + g->dy);
-        const k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> y_face({1, 1}, {nz+1, nx+1});
-        Kokkos::parallel_for("end_recv_ghost_div_b<XYZ>", y_face, KOKKOS_LAMBDA(const int z, const int x) {
-            const int y = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err) = rw * rbuf_d(1 + (z-1)*nx + (x-1)) + lw * k_field(VOXEL(x+i, y+j, z+k, nx, ny, nz), field_var::div_b_err);
-        });
-    }
-}
-template<> void end_recv_ghost_div_b<ZXY>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    const grid_t* g = fa->g;
-    float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,g));
-    if(p) {
-        const int nx = g->nx, ny = g->ny, nz = g->nz;
-        const int face = (i+j+k) < 0 ? nz+1 : 0;
-        float lw = rbuf_h(0);
-        float rw = (2. * g->dz) / (lw + g->dz);
-        lw = (lw - g->dz) / (lw + g->dz);
-        const k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
-        Kokkos::MDRangePolicy<Kokkos::Rank<2>> z_face({1, 1}, {ny+1, nx+1});
-        Kokkos::parallel_for("end_recv_ghost_div_b<XYZ>", z_face, KOKKOS_LAMBDA(const int y, const int x) {
-            const int z = face;
-            k_field(VOXEL(x,y,z,nx,ny,nz), field_var::div_b_err) = rw * rbuf_d(1 + (y-1)*nx + (x-1)) + lw * k_field(VOXEL(x+i, y+j, z+k, nx, ny, nz), field_var::div_b_err);
-        });
-    }
-}
-
-template<typename T> void end_send_ghost_div_b(field_array_t* fa, const int i, const int j, const int k) {
-    end_send_port_k(i,j,k,fa->g);
+    static const halo_comp_t div_b[1] = { { field_var::div_b_err, HALO_GHOST, { 1, 1, 1 } } };
+    if( !fb.div_b ) fb.div_b = new halo_t( g, div_b, 1 );
+    begin_halo_exchange( *fb.div_b, g, fa->k_f_d );
 }
 
 void k_end_remote_ghost_div_b(field_array_t* ALIGNED(128) fa, const grid_t* g, field_buffers_t& fb) {
-    //const int nx = g->nx, nz = g->nz;
-
-// End receiving
-    end_recv_ghost_div_b<XYZ>(fa, -1,  0,  0, fb.xyz_rbuf_neg, fb.xyz_rbuf_neg_h);
-    end_recv_ghost_div_b<YZX>(fa,  0, -1,  0, fb.yzx_rbuf_neg, fb.yzx_rbuf_neg_h);
-    end_recv_ghost_div_b<ZXY>(fa,  0,  0, -1, fb.zxy_rbuf_neg, fb.zxy_rbuf_neg_h);
-
-    end_recv_ghost_div_b<XYZ>(fa,  1,  0,  0, fb.xyz_rbuf_pos, fb.xyz_rbuf_pos_h);
-    end_recv_ghost_div_b<YZX>(fa,  0,  1,  0, fb.yzx_rbuf_pos, fb.yzx_rbuf_pos_h);
-    end_recv_ghost_div_b<ZXY>(fa,  0,  0,  1, fb.zxy_rbuf_pos, fb.zxy_rbuf_pos_h);
-
-// End sending
-    end_send_ghost_div_b<XYZ>(fa, -1,  0,  0);
-    end_send_ghost_div_b<YZX>(fa,  0, -1,  0);
-    end_send_ghost_div_b<ZXY>(fa,  0,  0, -1);
-
-    end_send_ghost_div_b<XYZ>(fa,  1,  0,  0);
-    end_send_ghost_div_b<YZX>(fa,  0,  1,  0);
-    end_send_ghost_div_b<ZXY>(fa,  0,  0,  1);
+    end_halo_exchange( *fb.div_b, g, fa->k_f_d );
 }
 
 void
@@ -1567,17 +1009,17 @@ template<typename T> void begin_recv_tang_e_norm_b(field_array_t* fa, const int
 template<> void begin_recv_tang_e_norm_b<XYZ>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int ny = fa->g->ny, nz = fa->g->nz;
     const int size = (2*ny*(nz+1) + 2*nz*(ny+1) + ny*nz)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k,size,fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 template<> void begin_recv_tang_e_norm_b<YZX>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int nx = fa->g->nx, nz = fa->g->nz;
     const int size = (2*nz*(nx+1) + 2*nx*(nz+1) + nz*nx)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k,size,fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 template<> void begin_recv_tang_e_norm_b<ZXY>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int nx = fa->g->nx, ny = fa->g->ny;
     const int size = (2*nx*(ny+1) + 2*ny*(nx+1) + nx*ny)*sizeof(float);
-    begin_recv_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k,size,fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 
 template<typename T> void begin_send_tang_e_norm_b(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {}
@@ -1601,8 +1043,8 @@ template<> void begin_send_tang_e_norm_b<XYZ>(field_array_t* fa, const int i, co
         sbuf_d(nz*ny + 2*ny*(nz+1) + 2*((z-1)*(ny+1) + (y-1))) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ez);
         sbuf_d(nz*ny + 2*ny*(nz+1) + 2*((z-1)*(ny+1) + (y-1)) + 1) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::tcaz);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_tang_e_norm_b<YZX>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
     const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
@@ -1624,8 +1066,8 @@ template<> void begin_send_tang_e_norm_b<YZX>(field_array_t* fa, const int i, co
         sbuf_d(nx*nz + 2*nz*(nx+1) + 2*((z-1)*nx + (x-1))) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ex);
         sbuf_d(nx*nz + 2*nz*(nx+1) + 2*((z-1)*nx + (x-1)) + 1) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::tcax);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_tang_e_norm_b<ZXY>(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
     const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
@@ -1647,8 +1089,8 @@ template<> void begin_send_tang_e_norm_b<ZXY>(field_array_t* fa, const int i, co
         sbuf_d(ny*nx + 2*nx*(ny+1) + 2*((y-1)*(nx+1) + (x-1))) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::ey);
         sbuf_d(ny*nx + 2*nx*(ny+1) + 2*((y-1)*(nx+1) + (x-1)) + 1) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::tcay);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 
 template<typename T> double end_recv_tang_e_norm_b(field_array_t* fa, const int i, const int j, const int k, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {return 0.0f;}
@@ -1660,7 +1102,7 @@ template<> double end_recv_tang_e_norm_b<XYZ>(field_array_t* fa, const int i, co
         const int face = (i+j+k)<0 ? nx+1 : 1;
         const int x = face;
         k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> x_face({1, 1}, {nz+1, ny+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> yz_edge({1, 1}, {nz+2, ny+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_edge({1, 1}, {nz+1, ny+2});
@@ -1704,7 +1146,7 @@ template<> double end_recv_tang_e_norm_b<YZX>(field_array_t* fa, const int i, co
         const int face = (i+j+k)<0 ? ny+1 : 1;
         const int y = face;
         k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> y_face({1, 1}, {nz+1, nx+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_edge({1, 1}, {nz+1, nx+2});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> xz_edge({1, 1}, {nz+2, nx+1});
@@ -1748,7 +1190,7 @@ template<> double end_recv_tang_e_norm_b<ZXY>(field_array_t* fa, const int i, co
         const int face = (i+j+k)<0 ? nz+1 : 1;
         const int z = face;
         k_field_t& k_field = fa->k_f_d;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> z_face({1, 1}, {ny+1, nx+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> xy_edge({1, 1}, {ny+2, nx+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_edge({1, 1}, {ny+1, nx+2});
@@ -1801,6 +1243,9 @@ synchronize_tang_e_norm_b_kokkos( field_array_t * RESTRICT fa ) {
 
     auto& fb = *(fa->fb);
 
+    // The time outside the message waits is the pack / unpack
+    const double t = wallclock() - comm_stat_now[ comm_stat_wait ];
+
     // Exchange x-faces
     begin_recv_tang_e_norm_b<XYZ>(fa, -1,  0,  0, fb.xyz_rbuf_neg, fb.xyz_rbuf_neg_h);
     begin_recv_tang_e_norm_b<XYZ>(fa,  1,  0,  0, fb.xyz_rbuf_pos, fb.xyz_rbuf_pos_h);
@@ -1831,37 +1276,42 @@ synchronize_tang_e_norm_b_kokkos( field_array_t * RESTRICT fa ) {
     end_send_tang_e_norm_b<ZXY>(fa,   0,  0, -1);
     end_send_tang_e_norm_b<ZXY>(fa,   0,  0,  1);
 
+    COMM_STAT( pack, wallclock() - comm_stat_now[ comm_stat_wait ] - t );
+
   mp_allsum_d( &err, &gerr, 1 );
   return gerr;
 }
 
+// The spacing header of a face message is written on the device so the
+// message can go straight from device memory (see MP_DEVICE_BUFFERS)
+static void
+put_spacing( const Kokkos::View<float*>& buf, const float d ) {
+    Kokkos::parallel_for("put_spacing", Kokkos::RangePolicy<>(0, 1), KOKKOS_LAMBDA(const int) {
+        buf(0) = d;
+    });
+}
+
+// Mean weights of a shared face from the local spacing d and the
+// remote spacing r (the header of the neighbor's message)
+KOKKOS_INLINE_FUNCTION void
+face_weights( const float r, const float d, float& lw, float& rw ) {
+    const float s = r + d;
+    rw = r/s;
+    lw = d/s;
+}
+
 template <typename T> void begin_recv_jf(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
 template <> void begin_recv_jf<XYZ>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int size = (ny*(nz+1) + nz*(ny+1) + 1)*sizeof(float);
-// Original
-//    begin_recv_port(i,j,k,size,g);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
+    begin_recv_port_k(i,j,k,size,g,mp_buffer(rbuf_d, rbuf_h));
 }
 template <> void begin_recv_jf<YZX>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int size = (nz*(nx+1) + nx*(nz+1) + 1)*sizeof(float);
-// Original
-//    begin_recv_port(i,j,k,size,g);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
+    begin_recv_port_k(i,j,k,size,g,mp_buffer(rbuf_d, rbuf_h));
 }
 template <> void begin_recv_jf<ZXY>(const grid_t* g, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int size = (nx*(ny+1) + ny*(nx+1) + 1)*sizeof(float);
-// Original
-//    begin_recv_port(i,j,k,size,g);
-// CPU
-    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_h.data()));
-// GPU
-//    begin_recv_port_k(i,j,k,size,g,reinterpret_cast<char*>(rbuf_d.data()));
+    begin_recv_port_k(i,j,k,size,g,mp_buffer(rbuf_d, rbuf_h));
 }
 
 template <typename T> void begin_send_jf(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {}
@@ -1880,9 +1330,9 @@ template<> void begin_send_jf<XYZ>(const grid_t* g, field_array_t* fa, int i, in
         const int x = face;
         sbuf_d(1 + (nz+1)*ny + (z-1)*(ny+1) + (y-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfz);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dx;
-    begin_send_port_k(i,j,k,size,g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, g->dx);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_jf<YZX>(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
 
@@ -1899,9 +1349,9 @@ template<> void begin_send_jf<YZX>(const grid_t* g, field_array_t* fa, int i, in
         const int y = face;
         sbuf_d(1 + (nx+1)*nz + (z-1)*nx + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfx);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dy;
-    begin_send_port_k(i,j,k,size,g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, g->dy);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_jf<ZXY>(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
 
@@ -1918,9 +1368,9 @@ template<> void begin_send_jf<ZXY>(const grid_t* g, field_array_t* fa, int i, in
         const int z = face;
         sbuf_d(1 + (ny+1)*nx + (y-1)*(nx+1) + (x-1)) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfy);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = g->dz;
-    begin_send_port_k(i, j, k, size, g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, g->dz);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i, j, k, size, g, mp_buffer(sbuf_d, sbuf_h));
 }
 
 template <typename T> void end_recv_jf(const grid_t* g, field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
@@ -1930,21 +1380,24 @@ template<> void end_recv_jf<XYZ>(const grid_t* g, field_array_t* fa, int i, int
     k_field_t& k_field = fa->k_f_d;
     if(p) {
         const int face = (i+j+k)<0 ? nx+1 : 1;
-        float rw  = rbuf_h(0);
-        float lw  = rw + g->dx;
-        rw /= lw;
-        lw  = g->dx/lw;
-        lw += lw;
-        rw += rw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = g->dx;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> yz_edge({1, 1}, {nz+2, ny+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> zy_edge({1, 1}, {nz+1, ny+2});
         Kokkos::parallel_for("sync_jf: end_recv_jf<XYZ>: yz_edge_loop", yz_edge, KOKKOS_LAMBDA(const int z, const int y) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int x = face;
             float jfy = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfy);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfy) = lw*jfy + rw*rbuf_d(1 + (z-1)*ny + (y-1));
         });
         Kokkos::parallel_for("sync_jf: end_recv_jf<XYZ>: zy_edge_loop", zy_edge, KOKKOS_LAMBDA(const int z, const int y) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int x = face;
             float jfz = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfz);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfz) = lw*jfz + rw*rbuf_d(1 + (nz+1)*ny + (z-1)*(ny+1) + (y-1));
@@ -1957,21 +1410,24 @@ template<> void end_recv_jf<YZX>(const grid_t* g, field_array_t* fa, int i, int
     k_field_t& k_field = fa->k_f_d;
     if(p) {
         const int face = (i+j+k)<0 ? ny+1 : 1;
-        float rw  = rbuf_h(0);
-        float lw  = rw + g->dy;
-        rw /= lw;
-        lw  = g->dy/lw;
-        lw += lw;
-        rw += rw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = g->dy;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> zx_edge({1, 1}, {nz+1, nx+2});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> xz_edge({1, 1}, {nz+2, nx+1});
         Kokkos::parallel_for("sync_jf: end_recv_jf<YZX>: zx_edge_loop", zx_edge, KOKKOS_LAMBDA(const int z, const int x) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int y = face;
             float jfz = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfz);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfz) = lw * jfz + rw * rbuf_d(1 + (z-1)*(nx+1) + (x-1));
         });
         Kokkos::parallel_for("sync_jf: end_recv_jf<YZX>: xz_edge_loop", xz_edge, KOKKOS_LAMBDA(const int z, const int x) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int y = face;
             float jfx = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfx);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfx)  = lw * jfx + rw * rbuf_d(1 + nz*(nx+1) + (z-1)*nx + (x-1));
@@ -1984,21 +1440,24 @@ template<> void end_recv_jf<ZXY>(const grid_t* g, field_array_t* fa, int i, int
     k_field_t& k_field = fa->k_f_d;
     if(p) {
         const int face = (i+j+k)<0 ? nz+1 : 1;
-        float rw  = rbuf_h(0);
-        float lw  = rw + g->dz;
-        rw /= lw;
-        lw  = g->dz/lw;
-        lw += lw;
-        rw += rw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = g->dz;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> xy_edge({1, 1}, {ny+2, nx+1});
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> yx_edge({1, 1}, {ny+1, nx+2});
         Kokkos::parallel_for("sync_jf: end_recv_jf<ZXY>: xy_edge_loop", xy_edge, KOKKOS_LAMBDA(const int y, const int x) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int z = face;
             float jfx = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfx);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfx) = lw * jfx + rw * rbuf_d(1 + (y-1)*nx + (x-1));
         });
         Kokkos::parallel_for("sync_jf: end_recv_jf<ZXY>: yx_edge_loop", yx_edge, KOKKOS_LAMBDA(const int y, const int x) {
+            float lw, rw;
+            face_weights(rbuf_d(0), d, lw, rw);
+            lw += lw;
+            rw += rw;
             const int z = face;
             float jfy = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfy);
             k_field(VOXEL(x,y,z,nx,ny,nz), field_var::jfy) = lw * jfy + rw * rbuf_d(1 + (ny+1)*nx + (y-1)*(nx+1) + (x-1));
@@ -2110,6 +1569,21 @@ void k_synchronize_jf(field_array_t* RESTRICT fa) {
 
     auto& fb = *(fa->fb);
 
+    // Exchange the faces, edges and corners in one round when the grid
+    // knows its edge and corner neighbors (see halo.h)
+    if( g->cut ) {
+        static const halo_comp_t jf[3] = { { field_var::jfx, HALO_SUM, { 1, 0, 0 } },
+                                           { field_var::jfy, HALO_SUM, { 0, 1, 0 } },
+                                           { field_var::jfz, HALO_SUM, { 0, 0, 1 } } };
+        if( !fb.jf ) fb.jf = new halo_t( g, jf, 3 );
+        begin_halo_exchange( *fb.jf, g, fa->k_f_d );
+        end_halo_exchange( *fb.jf, g, fa->k_f_d );
+        return;
+    }
+
+    // The time outside the message waits is the pack / unpack
+    const double t = wallclock() - comm_stat_now[ comm_stat_wait ];
+
     // Exchange x-faces
     begin_recv_jf<XYZ>(g, -1, 0, 0, nx, ny, nz, fb.xyz_rbuf_neg, fb.xyz_rbuf_neg_h);
     begin_recv_jf<XYZ>(g,  1, 0, 0, nx, ny, nz, fb.xyz_rbuf_pos, fb.xyz_rbuf_pos_h);
@@ -2140,17 +1614,47 @@ void k_synchronize_jf(field_array_t* RESTRICT fa) {
     end_send_jf<ZXY>(g, 0, 0, -1);
     end_send_jf<ZXY>(g, 0, 0,  1);
 
+    COMM_STAT( pack, wallclock() - comm_stat_now[ comm_stat_wait ] - t );
+}
+
+// The current and the ghost tangential B of the next advance_e in one
+// round.  The magnetic field must already be advanced to B_{1/2} (it does
+// not depend on the current); advance_e then skips its own exchange.
+// Without the edge and corner neighbors this is k_synchronize_jf.
+
+void k_synchronize_jf_tang_b(field_array_t* RESTRICT fa) {
+    if(!fa) ERROR(( "Bad args" ));
+    grid_t* RESTRICT g = fa->g;
+    auto& fb = *(fa->fb);
+
+    if( !g->cut ) {
+        k_synchronize_jf(fa);
+        return;
+    }
+
+    k_local_adjust_jf(fa, g);
+
+    static const halo_comp_t jf_tang_b[6] = { { field_var::jfx, HALO_SUM,   { 1, 0, 0 } },
+                                              { field_var::jfy, HALO_SUM,   { 0, 1, 0 } },
+                                              { field_var::jfz, HALO_SUM,   { 0, 0, 1 } },
+                                              { field_var::cbx, HALO_GHOST, { 0, 1, 1 } },
+                                              { field_var::cby, HALO_GHOST, { 1, 0, 1 } },
+                                              { field_var::cbz, HALO_GHOST, { 1, 1, 0 } } };
+    if( !fb.jf_tang_b ) fb.jf_tang_b = new halo_t( g, jf_tang_b, 6 );
+    begin_halo_exchange( *fb.jf_tang_b, g, fa->k_f_d );
+    end_halo_exchange( *fb.jf_tang_b, g, fa->k_f_d );
+    fb.tang_b_ghosted = 1;
 }
 
 template <typename T> void begin_recv_rho(field_array* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
 template<> void begin_recv_rho<XYZ>(field_array* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    begin_recv_port_k(i,j,k, ( 1 + 2*(ny+1)*(nz+1) )*sizeof(float), fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k, ( 1 + 2*(ny+1)*(nz+1) )*sizeof(float), fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 template<> void begin_recv_rho<YZX>(field_array* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    begin_recv_port_k(i,j,k, ( 1 + 2*(nz+1)*(nx+1) )*sizeof(float), fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k, ( 1 + 2*(nz+1)*(nx+1) )*sizeof(float), fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 template<> void begin_recv_rho<ZXY>(field_array* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
-    begin_recv_port_k(i,j,k, ( 1 + 2*(nx+1)*(ny+1) )*sizeof(float), fa->g, reinterpret_cast<char*>(rbuf_h.data()));
+    begin_recv_port_k(i,j,k, ( 1 + 2*(nx+1)*(ny+1) )*sizeof(float), fa->g, mp_buffer(rbuf_d, rbuf_h));
 }
 template<typename T> void begin_send_rho(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {}
 
@@ -2166,9 +1670,9 @@ template<> void begin_send_rho<XYZ>(field_array_t* fa, int i, int j, int k, int
         sbuf_d(idx_f) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhof);
         sbuf_d(idx_b) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhob);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dx;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, fa->g->dx);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_rho<YZX>(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
     int size = ( 1 + 2*(nz+1)*(nx+1) )*sizeof(float);
@@ -2182,9 +1686,9 @@ template<> void begin_send_rho<YZX>(field_array_t* fa, int i, int j, int k, int
         sbuf_d(idx_f) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhof);
         sbuf_d(idx_b) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhob);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dy;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, fa->g->dy);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 template<> void begin_send_rho<ZXY>(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& sbuf_d, Kokkos::View<float*>::HostMirror& sbuf_h) {
     int size = ( 1 + 2*(nx+1)*(ny+1) )*sizeof(float);
@@ -2198,9 +1702,9 @@ template<> void begin_send_rho<ZXY>(field_array_t* fa, int i, int j, int k, int
         sbuf_d(idx_f) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhof);
         sbuf_d(idx_b) = k_field(VOXEL(x,y,z,nx,ny,nz), field_var::rhob);
     });
-    Kokkos::deep_copy(sbuf_h, sbuf_d);
-    sbuf_h(0) = fa->g->dz;
-    begin_send_port_k(i,j,k,size,fa->g, reinterpret_cast<char*>(sbuf_h.data()));
+    put_spacing(sbuf_d, fa->g->dz);
+    mp_stage_send(sbuf_h, sbuf_d);
+    begin_send_port_k(i,j,k,size,fa->g, mp_buffer(sbuf_d, sbuf_h));
 }
 
 template <typename T> void end_recv_rho(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {}
@@ -2208,19 +1712,16 @@ template <typename T> void end_recv_rho(field_array_t* fa, int i, int j, int k,
 template<> void end_recv_rho<XYZ>(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     //const int size = 1 + 2*(ny+1)*(nz+1);
     const int face = (i+j+k)<0 ? nx+1 : 1;
-    float hlw, hrw, lw, rw;
     float* p = reinterpret_cast<float *>(end_recv_port_k(i,j,k,fa->g));
     k_field_t& k_field = fa->k_f_d;
     if( p ) {
-        hrw  = rbuf_h(0);
-        hlw  = hrw + fa->g->dx;
-        hrw /= hlw;
-        hlw  = fa->g->dx/hlw;
-        lw   = hlw + hlw;
-        rw   = hrw + hrw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = fa->g->dx;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> x_node({1, 1}, {nz+2, ny+2});
         Kokkos::parallel_for("sync_rho: end_recv_rho<XYZ>: x_node_loop", x_node, KOKKOS_LAMBDA(const int z, const int y) {
+            float hlw, hrw;
+            face_weights(rbuf_d(0), d, hlw, hrw);
+            const float lw = hlw + hlw, rw = hrw + hrw;
             const int x = face;
             const int idx_f = 1 + 2*((z-1)*(ny+1) + (y-1));
             const int idx_b = 1 + 2*((z-1)*(ny+1) + (y-1)) + 1;
@@ -2235,19 +1736,16 @@ template<> void end_recv_rho<XYZ>(field_array_t* fa, int i, int j, int k, int nx
 template<> void end_recv_rho<YZX>(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int face = (i+j+k)<0 ? ny+1 : 1;
     //const int size = 1 + 2*(nx+1)*(nz+1);
-    float hlw, hrw, lw, rw;
     float* p = reinterpret_cast<float*>(end_recv_port_k(i,j,k,fa->g));
     if(p) {
         k_field_t& k_field = fa->k_f_d;
-        hrw  = rbuf_h(0);
-        hlw  = hrw + fa->g->dy;
-        hrw /= hlw;
-        hlw  = fa->g->dy/hlw;
-        lw   = hlw + hlw;
-        rw   = hrw + hrw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = fa->g->dy;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> y_node({1, 1}, {nz+2, nx+2});
         Kokkos::parallel_for("sync_rho: end_recv_rho<YZX>: y_node_loop", y_node, KOKKOS_LAMBDA(const int z, const int x) {
+            float hlw, hrw;
+            face_weights(rbuf_d(0), d, hlw, hrw);
+            const float lw = hlw + hlw, rw = hrw + hrw;
             const int y = face;
             const int idx_f = 1 + 2*((z-1)*(nx+1) + (x-1));
             const int idx_b = 1 + 2*((z-1)*(nx+1) + (x-1)) + 1;
@@ -2261,19 +1759,16 @@ template<> void end_recv_rho<YZX>(field_array_t* fa, int i, int j, int k, int nx
 template<> void end_recv_rho<ZXY>(field_array_t* fa, int i, int j, int k, int nx, int ny, int nz, Kokkos::View<float*>& rbuf_d, Kokkos::View<float*>::HostMirror& rbuf_h) {
     const int face = (i+j+k)<0 ? nz+1 : 1;
     //const int size = 1 + 2*(nx+1)*(ny+1);
-    float hlw, hrw, lw, rw;
     float* p = reinterpret_cast<float *>(end_recv_port_k(i,j,k,fa->g));
     k_field_t& k_field = fa->k_f_d;
     if( p ) {
-        hrw  = rbuf_h(0);
-        hlw  = hrw + fa->g->dz;
-        hrw /= hlw;
-        hlw  = fa->g->dz/hlw;
-        lw   = hlw + hlw;
-        rw   = hrw + hrw;
-        Kokkos::deep_copy(rbuf_d, rbuf_h);
+        const float d = fa->g->dz;
+        mp_stage_recv(rbuf_d, rbuf_h);
         Kokkos::MDRangePolicy<Kokkos::Rank<2>> z_node({1, 1}, {ny+2, nx+2});
         Kokkos::parallel_for("sync_rho: end_recv_rho<ZXY>: z_node_loop", z_node, KOKKOS_LAMBDA(const int y, const int x) {
+            float hlw, hrw;
+            face_weights(rbuf_d(0), d, hlw, hrw);
+            const float lw = hlw + hlw, rw = hrw + hrw;
             const int z = face;
             const int idx_f = 1 + 2*((y-1)*(nx+1) + (x-1));
             const int idx_b = 1 + 2*((y-1)*(nx+1) + (x-1)) + 1;
@@ -2415,6 +1910,19 @@ void k_synchronize_rho(field_array_t* RESTRICT fa) {
 
     auto& fb = *(fa->fb);
 
+    // See k_synchronize_jf
+    if( g->cut ) {
+        static const halo_comp_t rho[2] = { { field_var::rhof, HALO_SUM,  { 0, 0, 0 } },
+                                            { field_var::rhob, HALO_MEAN, { 0, 0, 0 } } };
+        if( !fb.rho ) fb.rho = new halo_t( g, rho, 2 );
+        begin_halo_exchange( *fb.rho, g, fa->k_f_d );
+        end_halo_exchange( *fb.rho, g, fa->k_f_d );
+        return;
+    }
+
+    // See k_synchronize_jf
+    const double t = wallclock() - comm_stat_now[ comm_stat_wait ];
+
     // Exchange x-faces
     begin_recv_rho<XYZ>(fa, -1, 0, 0, nx, ny, nz, fb.xyz_rbuf_neg, fb.xyz_rbuf_neg_h);
     begin_recv_rho<XYZ>(fa,  1, 0, 0, nx, ny, nz, fb.xyz_rbuf_pos, fb.xyz_rbuf_pos_h);
@@ -2445,5 +1953,6 @@ void k_synchronize_rho(field_array_t* RESTRICT fa) {
     end_send_rho<ZXY>(  fa, 0, 0, -1);
     end_send_rho<ZXY>(  fa, 0, 0,  1);
 
+    COMM_STAT( pack, wallclock() - comm_stat_now[ comm_stat_wait ] - t );
 }
 
@@ -53,6 +53,7 @@ static field_advance_kernels_t sfa_kernels = {
   k_synchronize_jf,
   k_reduce_jf,
   k_synchronize_rho,
+  k_synchronize_jf_tang_b,
 
   synchronize_tang_e_norm_b_kokkos,
 
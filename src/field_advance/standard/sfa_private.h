@@ -366,6 +366,9 @@ k_synchronize_rho(field_array_t* RESTRICT fa);
 void
 k_synchronize_jf( field_array_t * RESTRICT fa );
 
+void
+k_synchronize_jf_tang_b( field_array_t * RESTRICT fa );
+
 // In local.c
 
 void
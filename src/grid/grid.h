@@ -99,6 +99,20 @@ typedef struct grid {
                             // boundary conditions to apply at domain edge
                             // 0 ... nproc-1 ... comm boundary condition
                             // <0 ... locally applied boundary condition
+                            // The edge and corner entries hold the
+                            // ranks across them (used for particle
+                            // exchange only), or pec_fields if none.
+
+  // Rectilinear domain decomposition set by the partition_*_box
+  // functions (gpx==0 for custom domains).  The gpx x gpy x gpz
+  // processor mesh covers the gnx x gny x gnz global cells spanning
+  // (gx0,gy0,gz0)-(gx1,gy1,gz1).  Processor column px owns the global
+  // x cells cut[px]:cut[px+1]-1; the y cuts follow at cut[gpx+1+py]
+  // and the z cuts at cut[gpx+gpy+2+pz].
+  int gpx, gpy, gpz;
+  int gnx, gny, gnz;
+  double gx0, gy0, gz0, gx1, gy1, gz1;
+  int * cut;
 
   // Phase 3 grid data structures
   // NOTE: VOXEL INDEXING LIMITS NUMBER OF VOXELS TO 2^31 (INCLUDING
@@ -259,13 +273,24 @@ set_pbc( grid_t *g, int bound, int pbc );
 // Reverse this protocol to robustly convert from voxel+offset to
 // global coordinates.  Due to the vagaries of floating point, the
 // inverse process may not be exact.
+//
+// By default, the global cells are divided evenly over the processor
+// mesh (gnx must be a multiple of gpx, ...).  A non-uniform rectilinear
+// decomposition is given by the cut planes cx[0:gpx], cy[0:gpy] and
+// cz[0:gpz] (increasing global cell indices with cx[0]==0 and
+// cx[gpx]==gnx, ...); processor (px,py,pz) then owns the global cells
+// cx[px]:cx[px+1]-1 x cy[py]:cy[py+1]-1 x cz[pz]:cz[pz+1]-1.  A NULL
+// cut array means an even division along that axis.
 
 void
 partition_periodic_box( grid_t *g,
 			double gx0, double gy0, double gz0,
 			double gx1, double gy1, double gz1,
                         int gnx, int gny, int gnz,
-                        int gpx, int gpy, int gpz );
+                        int gpx, int gpy, int gpz,
+                        const int * cx = NULL,
+                        const int * cy = NULL,
+                        const int * cz = NULL );
 
 void
 partition_absorbing_box( grid_t *g,
@@ -273,14 +298,52 @@ partition_absorbing_box( grid_t *g,
                          double gx1, double gy1, double gz1,
                          int gnx, int gny, int gnz,
                          int gpx, int gpy, int gpz,
-                         int pbc );
+                         int pbc,
+                         const int * cx = NULL,
+                         const int * cy = NULL,
+                         const int * cz = NULL );
 
 void
 partition_metal_box( grid_t *g,
                      double gx0, double gy0, double gz0,
                      double gx1, double gy1, double gz1,
                      int gnx, int gny, int gnz,
-                     int gpx, int gpy, int gpz );
+                     int gpx, int gpy, int gpz,
+                     const int * cx = NULL,
+                     const int * cy = NULL,
+                     const int * cz = NULL );
+
+// Move the cut planes of a grid set up by a partition_*_box function
+// to cx, cy and cz (NULL keeps the cuts along that axis).  The local
+// domain is resized in place; the processor mesh, the neighbors and
+// the boundary conditions on the domain edges are kept.  Only the
+// grid is changed: anything sized by the local grid (fields,
+// particles, ...) must be redistributed by the caller.  Collective.
+
+void
+repartition_grid( grid_t *g,
+                  const int * cx,
+                  const int * cy,
+                  const int * cz );
+
+// Record the ranks across the edges and corners of the local domain of
+// a grid set up by a partition_*_box function in the diagonal entries
+// of g->bc.  There is one if there are neighboring ranks across all the
+// faces the edge or corner touches.  set_fbc calls this whenever a face
+// of such a grid changes, so the diagonals follow the field boundary
+// conditions a deck sets after defining its grid.
+
+void
+join_diagonals( grid_t *g );
+
+// Global offset (box[0:2]) and size (box[3:5]) in cells of the local
+// domain of rank in the decomposition of g.  Returns 0 (and leaves box
+// untouched) if g was not set up by a partition_*_box function.
+
+int
+grid_rank_box( const grid_t *g,
+               int rank,
+               int box[6] );
 
 // In grid_comm.c
 
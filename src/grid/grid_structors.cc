@@ -18,6 +18,7 @@ checkpt_grid( const grid_t * g ) {
   CHECKPT( g, 1 );
   if( g->range    ) CHECKPT_ALIGNED( g->range, world_size+1, 16 );
   if( g->neighbor ) CHECKPT_ALIGNED( g->neighbor, 6*g->nv, 128 );
+  if( g->cut      ) CHECKPT( g->cut, g->gpx+g->gpy+g->gpz+3 );
   CHECKPT_PTR( g->mp );
   CHECKPT_PTR( g->mp_k );
 }
@@ -28,6 +29,7 @@ restore_grid( void ) {
   RESTORE( g );
   if( g->range    ) RESTORE_ALIGNED( g->range );
   if( g->neighbor ) RESTORE_ALIGNED( g->neighbor );
+  if( g->cut      ) RESTORE( g->cut );
   RESTORE_PTR( g->mp );
   RESTORE_PTR( g->mp_k );
   return g;
@@ -55,6 +57,7 @@ delete_grid( grid_t * g ) {
   UNREGISTER_OBJECT( g );
   FREE_ALIGNED( g->neighbor );
   FREE_ALIGNED( g->range );
+  FREE( g->cut );
   delete_mp( g->mp );
   delete_mp( g->mp_k );
 //    delete_mp_kokkos(g->mp_k);
@@ -0,0 +1,186 @@
+#include "halo.h"
+
+// Messages are tagged with the direction of the neighbor (as in
+// boundary_p_kokkos).  Without persistent messages (the relay), each
+// goes through the port of that direction of g->mp_k instead.
+
+#define IS_RANK(r) ( (r)>=0 && (r)<world_size )
+
+halo::halo( const grid_t * g,
+            const halo_comp_t * c,
+            int n_comp ) {
+  const int n[3] = { g->nx, g->ny, g->nz };
+  int i, j, k, b, q, m, a;
+
+  if( !g || !c || n_comp<1 || n_comp>HALO_MAX_COMP ) ERROR(( "Bad args" ));
+
+  this->n_comp = n_comp;
+  for( m=0; m<n_comp; m++ ) {
+    comp[m] = c[m];
+    if( comp[m].kind!=HALO_GHOST && !g->cut )
+      ERROR(( "Exchanging shared values in one round needs the edge and "
+              "corner neighbors of a grid set up by a partition_*_box "
+              "function" ));
+  }
+  nx = g->nx, ny = g->ny, nz = g->nz;
+
+  // Count the segments
+
+  n_seg = 0;
+  for( b=0; b<27; b++ ) size[b] = 0, off[b] = 0;
+  for( k=-1; k<=1; k++ )
+    for( j=-1; j<=1; j++ )
+      for( i=-1; i<=1; i++ ) {
+        const int d[3] = { i, j, k }, nd = (i!=0) + (j!=0) + (k!=0);
+        b = BOUNDARY(i,j,k);
+        if( !nd || !IS_RANK( g->bc[b] ) ) continue;
+        for( m=0; m<n_comp; m++ ) {
+          for( a=0, q=0; q<3; q++ ) if( d[q] && comp[m].s[q]!=(comp[m].kind==HALO_GHOST) ) a++;
+          if( !a && ( comp[m].kind!=HALO_GHOST || nd==1 ) ) n_seg++;
+        }
+      }
+
+  seg    = Kokkos::View<halo_seg_t*>( "halo segments", n_seg ? n_seg : 1 );
+  seg_h  = Kokkos::create_mirror_view( seg );
+  seg_of = Kokkos::View<int*>( "halo segment index", 27*n_comp );
+  Kokkos::View<int*>::HostMirror seg_of_h = Kokkos::create_mirror_view( seg_of );
+  for( q=0; q<27*n_comp; q++ ) seg_of_h(q) = -1;
+
+  // Lay the messages out
+
+  total = 0, n_seg = 0;
+  for( k=-1; k<=1; k++ )
+    for( j=-1; j<=1; j++ )
+      for( i=-1; i<=1; i++ ) {
+        const int d[3] = { i, j, k }, nd = (i!=0) + (j!=0) + (k!=0);
+        b = BOUNDARY(i,j,k);
+        if( !nd || !IS_RANK( g->bc[b] ) ) continue;
+        off[b] = total;
+        total += HALO_HEADER;
+        for( m=0; m<n_comp; m++ ) {
+          const halo_comp_t * cm = comp + m;
+          const int ghost = cm->kind==HALO_GHOST;
+          for( a=0, q=0; q<3; q++ ) if( d[q] && cm->s[q]!=ghost ) a++;
+          if( a || ( ghost && nd!=1 ) ) continue;
+          halo_seg_t & s = seg_h(n_seg);
+          s.off  = total;
+          s.b    = b;
+          s.face = nd==1 ? ( i ? 0 : j ? 1 : 2 ) + ( i+j+k<0 ? 0 : 3 ) : -1;
+          s.var  = cm->var, s.kind = cm->kind, s.c = m;
+          s.n    = 1;
+          for( q=0; q<3; q++ ) {
+            s.s[q] = cm->s[q];
+            if( !d[q] )  s.lo[q] = 1,                          s.len[q] = n[q] + 1 - cm->s[q];
+            else         s.lo[q] = d[q]<0 ? 1 : n[q] + !ghost, s.len[q] = 1;
+            s.n *= s.len[q];
+          }
+          seg_of_h( b*n_comp + m ) = n_seg++;
+          total += s.n;
+        }
+        size[b] = total - off[b];
+        if( size[b]==HALO_HEADER ) total = off[b], size[b] = 0;
+      }
+
+  Kokkos::deep_copy( seg, seg_h );
+  Kokkos::deep_copy( seg_of, seg_of_h );
+
+  sbuf   = Kokkos::View<float*>( "halo send buffer",    total ? total : 1 );
+  rbuf   = Kokkos::View<float*>( "halo receive buffer", total ? total : 1 );
+  sbuf_h = mp_mirror( sbuf );
+  rbuf_h = mp_mirror( rbuf );
+
+  // The message headers never change
+
+  Kokkos::View<float*>::HostMirror hdr = Kokkos::create_mirror_view( sbuf );
+  for( b=0; b<27; b++ )
+    if( size[b] ) {
+      float * p = hdr.data() + off[b];
+      p[0] = g->dx, p[1] = g->dy, p[2] = g->dz, p[3] = 0;
+    }
+  Kokkos::deep_copy( sbuf, hdr );
+
+  CLEAR( &w, 1 );
+  for( q=0; q<6; q++ ) {
+    b = BOUNDARY( q==0 ? -1 : q==3 ? 1 : 0,
+                  q==1 ? -1 : q==4 ? 1 : 0,
+                  q==2 ? -1 : q==5 ? 1 : 0 );
+    w.active[q] = size[b]!=0;
+    w.off[q]    = off[b];
+  }
+  w.d[0] = g->dx, w.d[1] = g->dy, w.d[2] = g->dz;
+
+  // The buffers and the neighbors never change either
+
+  char * rb = mp_buffer( rbuf, rbuf_h ), * sb = mp_buffer( sbuf, sbuf_h );
+  batch = new_mp_batch( 27 );
+  if( batch )
+    for( b=0; b<27; b++ )
+      if( size[b] ) {
+        mp_batch_add_recv( batch, rb + off[b]*sizeof(float), size[b]*sizeof(float),
+                           g->bc[b], 26-b );
+        mp_batch_add_send( batch, sb + off[b]*sizeof(float), size[b]*sizeof(float),
+                           g->bc[b], b );
+      }
+}
+
+void
+halo_begin_recv( halo_t * h,
+                 const grid_t * g ) {
+  int b;
+  if( h->batch ) {
+    mp_batch_begin_recv( h->batch );
+    return;
+  }
+  for( b=0; b<27; b++ )
+    if( h->size[b] ) {
+      mp_set_recv_buffer( g->mp_k, b, h->size[b]*sizeof(float),
+                          mp_buffer( h->rbuf, h->rbuf_h ) + h->off[b]*sizeof(float) );
+      mp_begin_recv( g->mp_k, b, h->size[b]*sizeof(float), g->bc[b], 26-b );
+    }
+}
+
+void
+halo_begin_send( halo_t * h,
+                 const grid_t * g ) {
+  int b;
+  if( h->batch ) {
+    mp_batch_begin_send( h->batch );
+    return;
+  }
+  for( b=0; b<27; b++ )
+    if( h->size[b] ) {
+      mp_set_send_buffer( g->mp_k, b, h->size[b]*sizeof(float),
+                          mp_buffer( h->sbuf, h->sbuf_h ) + h->off[b]*sizeof(float) );
+      mp_begin_send( g->mp_k, b, h->size[b]*sizeof(float), g->bc[b], b );
+    }
+}
+
+void
+halo_end_recv( halo_t * h,
+               const grid_t * g ) {
+  int b;
+  if( h->batch ) {
+    mp_batch_end_recv( h->batch );
+    return;
+  }
+  for( b=0; b<27; b++ )
+    if( h->size[b] ) {
+      mp_end_recv( g->mp_k, b );
+      mp_unset_recv_buffer( g->mp_k, b );
+    }
+}
+
+void
+halo_end_send( halo_t * h,
+               const grid_t * g ) {
+  int b;
+  if( h->batch ) {
+    mp_batch_end_send( h->batch );
+    return;
+  }
+  for( b=0; b<27; b++ )
+    if( h->size[b] ) {
+      mp_end_send( g->mp_k, b );
+      mp_unset_send_buffer( g->mp_k, b );
+    }
+}
@@ -0,0 +1,249 @@
+#ifndef _halo_h_
+#define _halo_h_
+
+#include "grid.h"
+
+// A halo exchange moves the values of a list of components that a
+// local domain shares with (or needs from) its neighbors in a single
+// communication round: one kernel packs the messages to all neighbors
+// into one buffer, all the messages are in flight at once and one
+// kernel unpacks them.  The messages are persistent (set up once when
+// the halo is made; see mp_batch_t) when the messaging layer has them.
+// MPI reads and writes the buffers in device memory when it can (see
+// MP_DEVICE_BUFFERS in mp.h); otherwise there is one copy through a
+// host mirror each way.  It works on any
+// Kokkos::View<float*[N]> indexed by VOXEL (fields, hydro, ...).
+//
+// Components are described by where they live in a voxel: s[a] is 1
+// if the component is centered along axis a (like jfx or cbx along y)
+// and 0 if it is on the node planes of axis a.
+//
+// HALO_SUM and HALO_MEAN components are node plane values shared by the
+// neighboring domains (jf, rhof, hydro / rhob).  Those on an edge or a
+// corner of the local domain are shared with the domains across it, so
+// these exchanges include the edge and corner neighbors (so they need a
+// grid built by a partition_*_box function).  The result is the same
+// weighted sum the face by face exchanges give.
+//
+// HALO_GHOST components fill the ghost layer beyond each shared face
+// from the first layer of the neighbor (tang b, norm e, div b err).
+// Only the face neighbors are involved.
+
+enum halo_kinds {
+  HALO_SUM   = 0, // Twice weighted sum of the shared values
+  HALO_MEAN  = 1, // Weighted average of the shared values
+  HALO_GHOST = 2  // Ghost value interpolated from the neighbor
+};
+
+#define HALO_MAX_COMP 16 // Enough for hydro
+#define HALO_HEADER   4  // Sender dx, dy, dz and a pad before each message
+
+typedef struct halo_comp {
+  int var;  // Index of the component in the view
+  int kind; // HALO_SUM, HALO_MEAN or HALO_GHOST
+  int s[3]; // 1 if centered along x, y, z
+} halo_comp_t;
+
+// The values of one component in one message, in x fastest order.  lo
+// is the first voxel of the region sent (the received region is the
+// same one for HALO_SUM / HALO_MEAN, one voxel further out for
+// HALO_GHOST).
+
+typedef struct halo_seg {
+  int off, n;          // Offset in the message buffers and count
+  int b, face;         // Neighbor BOUNDARY(i,j,k) (and 0:5 face or -1)
+  int var, kind, c;    // Component
+  int s[3];
+  int lo[3], len[3];
+} halo_seg_t;
+
+// What the unpack needs to interpolate across the shared faces (0:2 =
+// -x,-y,-z, 3:5 = +x,+y,+z).  The weights follow from the local spacing
+// and the spacing of the face neighbor (the header of its message);
+// they are worked out in the unpack kernel so the headers never have to
+// be read on the host.
+
+typedef struct halo_weights {
+  int   active[6];
+  int   off[6];  // Header of the message from the face neighbor
+  float d[3];    // Local dx, dy, dz
+} halo_weights_t;
+
+typedef struct halo {
+
+  int n_comp;
+  halo_comp_t comp[HALO_MAX_COMP];
+
+  int nx, ny, nz;
+  int size[27], off[27]; // Message sizes / offsets in floats (0 size = no message)
+  int total;            // Size of the buffers in floats
+  int n_seg;
+  halo_weights_t w;
+
+  Kokkos::View<halo_seg_t*> seg;
+  Kokkos::View<halo_seg_t*>::HostMirror seg_h;
+  Kokkos::View<int*> seg_of;  // seg_of(b*n_comp+c): segment of component c to b or -1
+
+  Kokkos::View<float*> sbuf, rbuf;               // Headers written once in sbuf
+  Kokkos::View<float*>::HostMirror sbuf_h, rbuf_h; // Empty with MP_DEVICE_BUFFERS
+
+  mp_batch_t * batch = nullptr; // The messages to and from the neighbors
+                                // (NULL: through the ports of g->mp_k)
+
+  halo() {
+    // User should try avoid calling this
+  }
+
+  halo( const grid_t * g, const halo_comp_t * c, int n_comp );
+
+  // The batch refers to the buffers of this halo
+  halo( const halo & ) = delete;
+  halo & operator=( const halo & ) = delete;
+
+  ~halo() {
+    delete_mp_batch( batch );
+  }
+
+} halo_t;
+
+// In halo.cc
+
+void
+halo_begin_recv( halo_t * h,
+                 const grid_t * g );
+
+void
+halo_begin_send( halo_t * h,
+                 const grid_t * g );
+
+// Waits for the messages
+
+void
+halo_end_recv( halo_t * h,
+               const grid_t * g );
+
+void
+halo_end_send( halo_t * h,
+               const grid_t * g );
+
+// Start exchanging the halo of f.  f can be updated away from the halo
+// until end_halo_exchange is called (the shared values are packed here
+// and the ghost values are written there).
+
+template<class View>
+void
+begin_halo_exchange( halo_t & h,
+                     const grid_t * g,
+                     const View & f ) {
+  const int nx = g->nx, ny = g->ny, nz = g->nz, n_seg = h.n_seg;
+  const Kokkos::View<halo_seg_t*> seg = h.seg;
+  const Kokkos::View<float*> sbuf = h.sbuf;
+
+  halo_begin_recv( &h, g );
+
+  // The pack is done when staged (the unpack is left to run on with the
+  // step, so only its staging copy is timed)
+  const double t_pack = wallclock();
+
+  if( n_seg ) {
+    Kokkos::parallel_for( "halo pack", Kokkos::RangePolicy<>(0, h.total),
+      KOKKOS_LAMBDA( const int t ) {
+        int l = 0, u = n_seg-1;
+        while( l<u ) { const int m = (l+u+1)>>1; if( seg(m).off<=t ) l = m; else u = m-1; }
+        const halo_seg_t & s = seg(l);
+        int r = t - s.off;
+        if( r<0 || r>=s.n ) return; // Message header
+        const int x = s.lo[0] + r % s.len[0]; r /= s.len[0];
+        const int y = s.lo[1] + r % s.len[1]; r /= s.len[1];
+        const int z = s.lo[2] + r;
+        sbuf(t) = f( VOXEL(x,y,z, nx,ny,nz), s.var );
+      });
+  }
+  mp_stage_send( h.sbuf_h, h.sbuf );
+  COMM_STAT( pack, wallclock() - t_pack );
+
+  halo_begin_send( &h, g );
+}
+
+template<class View>
+void
+end_halo_exchange( halo_t & h,
+                   const grid_t * g,
+                   const View & f ) {
+  const int nx = g->nx, ny = g->ny, nz = g->nz, n_seg = h.n_seg, n_comp = h.n_comp;
+  const Kokkos::View<halo_seg_t*> seg = h.seg;
+  const Kokkos::View<int*> seg_of = h.seg_of;
+  const Kokkos::View<float*> rbuf = h.rbuf;
+
+  halo_end_recv( &h, g );
+  const halo_weights_t w = h.w;
+
+  if( n_seg ) {
+    const double t_pack = wallclock();
+    mp_stage_recv( h.rbuf, h.rbuf_h );
+    COMM_STAT( pack, wallclock() - t_pack );
+    Kokkos::parallel_for( "halo unpack", Kokkos::RangePolicy<>(0, h.total),
+      KOKKOS_LAMBDA( const int t ) {
+        int l = 0, u = n_seg-1;
+        while( l<u ) { const int m = (l+u+1)>>1; if( seg(m).off<=t ) l = m; else u = m-1; }
+        const halo_seg_t & s = seg(l);
+        int r = t - s.off;
+        if( r<0 || r>=s.n || s.face<0 ) return; // Header or edge / corner message
+        int e[3];
+        e[0] = s.lo[0] + r % s.len[0]; r /= s.len[0];
+        e[1] = s.lo[1] + r % s.len[1]; r /= s.len[1];
+        e[2] = s.lo[2] + r;
+        const int n[3] = { nx, ny, nz };
+        const int a = s.face % 3, side = s.face<3 ? -1 : 1;
+
+        if( s.kind==HALO_GHOST ) {
+          const float l = w.d[a], r = rbuf( w.off[s.face] + a );
+          const int v = VOXEL(e[0],e[1],e[2], nx,ny,nz);
+          e[a] += side;
+          f( VOXEL(e[0],e[1],e[2], nx,ny,nz), s.var ) =
+            ( (2*l)*rbuf(t) + (r-l)*f( v, s.var ) ) / (r+l);
+          return;
+        }
+
+        // The value is shared with the neighbors across each face of
+        // the domain it is on.  It is done by the message of the first
+        // such axis, gathering what all of them (and the edge and
+        // corner neighbors between them) sent.
+        int on = 0, d[3] = { 0, 0, 0 };
+        for( int q=0; q<3; q++ ) {
+          if( s.s[q] ) continue;
+          if(      e[q]==1      && w.active[q  ] ) on |= 1<<q, d[q] = -1;
+          else if( e[q]==n[q]+1 && w.active[q+3] ) on |= 1<<q, d[q] =  1;
+        }
+        if( on & ((1<<a)-1) ) return;
+
+        const int v = VOXEL(e[0],e[1],e[2], nx,ny,nz);
+        float sum = 0;
+        for( int m=0; m<8; m++ ) {
+          if( m & ~on ) continue;
+          float wt = 1;
+          int dm[3] = { 0, 0, 0 };
+          for( int q=0; q<3; q++ ) {
+            if( !( on & (1<<q) ) ) continue;
+            const int fq = q + ( d[q]<0 ? 0 : 3 );
+            const float l = w.d[q], r = rbuf( w.off[fq] + q );
+            if( m & (1<<q) ) dm[q] = d[q], wt *= r/(l+r);
+            else                           wt *= l/(l+r);
+            if( s.kind==HALO_SUM ) wt += wt;
+          }
+          if( !m ) { sum += wt*f( v, s.var ); continue; }
+          const int sm = seg_of( BOUNDARY(dm[0],dm[1],dm[2])*n_comp + s.c );
+          if( sm<0 ) continue;
+          const halo_seg_t & o = seg(sm);
+          sum += wt*rbuf( o.off + ( e[0]-o.lo[0] ) +
+                                  o.len[0]*( ( e[1]-o.lo[1] ) +
+                                             o.len[1]*( e[2]-o.lo[2] ) ) );
+        }
+        f( v, s.var ) = sum;
+      });
+  }
+
+  halo_end_send( &h, g );
+}
+
+#endif // _halo_h_
@@ -181,6 +181,10 @@ set_fbc( grid_t * g,
     ERROR(( "Bad args" ));
 
   g->bc[boundary] = fbc;
+
+  // The ranks across the edges and corners depend on the faces
+  const int i = boundary%3 - 1, j = (boundary/3)%3 - 1, k = boundary/9 - 1;
+  if( g->cut && (i!=0) + (j!=0) + (k!=0)==1 ) join_diagonals( g );
 }
 
 void
@@ -32,27 +32,34 @@
     (rank) = _ix + gpx*( _iy + gpy*_iz );            \
   } while(0)
 
-void
-partition_periodic_box( grid_t * g,
-                        double gx0, double gy0, double gz0,
-                        double gx1, double gy1, double gz1,
-                        int gnx, int gny, int gnz,
-                        int gpx, int gpy, int gpz ) {
-  double f;
-  int rank, px, py, pz; 
-
-  // Make sure the grid can be setup
-
-  if( !g ) ERROR(( "NULL grid" ));
+// Fill the cut planes of one axis (an even division if c is NULL)
+
+static void
+set_cuts( int * cut,
+          const int * c,
+          int gn, int gp ) {
+  int i;
+  if( c ) {
+    if( c[0]!=0 || c[gp]!=gn ) ERROR(( "Cut planes must span 0:%i", gn ));
+    for( i=0; i<gp; i++ )
+      if( c[i+1]<=c[i] ) ERROR(( "Cut planes must be increasing" ));
+    for( i=0; i<=gp; i++ ) cut[i] = c[i];
+  } else {
+    for( i=0; i<=gp; i++ ) cut[i] = i*(gn/gp);
+  }
+}
 
-  if( gpx<1 || gpy<1 || gpz<1 || gpx*gpy*gpz!=world_size )
-    ERROR(( "Bad domain decompostion (%ix%ix%i)", gpx, gpy, gpz ));
+// Size and position the local domain from the decomposition in g
 
-  if( gnx<1 || gny<1 || gnz<1 || gnx%gpx!=0 || gny%gpy!=0 || gnz%gpz!=0 )
-    ERROR(( "Bad resolution (%ix%ix%i) for domain decomposition",
-            gnx, gny, gnz, gpx, gpy, gpz ));
+static void
+size_local_domain( grid_t * g ) {
+  const int gpx = g->gpx, gpy = g->gpy, gnx = g->gnx, gny = g->gny, gnz = g->gnz;
+  const double gx0 = g->gx0, gy0 = g->gy0, gz0 = g->gz0;
+  const double gx1 = g->gx1, gy1 = g->gy1, gz1 = g->gz1;
+  const int * cx = g->cut, * cy = cx + gpx + 1, * cz = cy + gpy + 1;
+  double f;
+  int px, py, pz;
 
-  // Setup basic variables
   RANK_TO_INDEX( world_rank, px,py,pz );
 
   g->dx = (gx1-gx0)/(double)gnx;
@@ -69,16 +76,80 @@ partition_periodic_box( grid_t * g,
            ((double)gny/(gy1-gy0))*
            ((double)gnz/(gz1-gz0))*0.125;
 
-  f = (double) px   /(double)gpx; g->x0 = gx0*(1-f) + gx1*f;
-  f = (double) py   /(double)gpy; g->y0 = gy0*(1-f) + gy1*f;
-  f = (double) pz   /(double)gpz; g->z0 = gz0*(1-f) + gz1*f;
+  // For an even division, cx[px]/gnx is px/gpx exactly, so this
+  // places the domains where the uniform decomposition always did
+
+  f = (double)cx[px  ]/(double)gnx; g->x0 = gx0*(1-f) + gx1*f;
+  f = (double)cy[py  ]/(double)gny; g->y0 = gy0*(1-f) + gy1*f;
+  f = (double)cz[pz  ]/(double)gnz; g->z0 = gz0*(1-f) + gz1*f;
 
-  f = (double)(px+1)/(double)gpx; g->x1 = gx0*(1-f) + gx1*f;
-  f = (double)(py+1)/(double)gpy; g->y1 = gy0*(1-f) + gy1*f;
-  f = (double)(pz+1)/(double)gpz; g->z1 = gz0*(1-f) + gz1*f;
+  f = (double)cx[px+1]/(double)gnx; g->x1 = gx0*(1-f) + gx1*f;
+  f = (double)cy[py+1]/(double)gny; g->y1 = gy0*(1-f) + gy1*f;
+  f = (double)cz[pz+1]/(double)gnz; g->z1 = gz0*(1-f) + gz1*f;
 
   // Size the local grid
-  size_grid(g,gnx/gpx,gny/gpy,gnz/gpz);
+  size_grid( g, cx[px+1]-cx[px], cy[py+1]-cy[py], cz[pz+1]-cz[pz] );
+}
+
+void
+join_diagonals( grid_t * g ) {
+  const int gpx = g->gpx, gpy = g->gpy, gpz = g->gpz;
+  int px, py, pz, i, j, k, rank, bc;
+
+  RANK_TO_INDEX( world_rank, px,py,pz );
+  for( k=-1; k<=1; k++ )
+    for( j=-1; j<=1; j++ )
+      for( i=-1; i<=1; i++ ) {
+        if( (i!=0) + (j!=0) + (k!=0) < 2 ) continue;
+        rank = pec_fields;
+#       define IS_RANK(b) ( bc = g->bc[b], bc>=0 && bc<world_size )
+        if( ( !i || IS_RANK( BOUNDARY(i,0,0) ) ) &&
+            ( !j || IS_RANK( BOUNDARY(0,j,0) ) ) &&
+            ( !k || IS_RANK( BOUNDARY(0,0,k) ) ) )
+          INDEX_TO_RANK( px+i,py+j,pz+k, rank );
+#       undef IS_RANK
+        g->bc[ BOUNDARY(i,j,k) ] = rank;
+      }
+}
+
+void
+partition_periodic_box( grid_t * g,
+                        double gx0, double gy0, double gz0,
+                        double gx1, double gy1, double gz1,
+                        int gnx, int gny, int gnz,
+                        int gpx, int gpy, int gpz,
+                        const int * cx,
+                        const int * cy,
+                        const int * cz ) {
+  int rank, px, py, pz; 
+
+  // Make sure the grid can be setup
+
+  if( !g ) ERROR(( "NULL grid" ));
+
+  if( gpx<1 || gpy<1 || gpz<1 || gpx*gpy*gpz!=world_size )
+    ERROR(( "Bad domain decompostion (%ix%ix%i)", gpx, gpy, gpz ));
+
+  if( gnx<1 || gny<1 || gnz<1 ||
+      ( !cx && gnx%gpx!=0 ) || ( !cy && gny%gpy!=0 ) || ( !cz && gnz%gpz!=0 ) )
+    ERROR(( "Bad resolution (%ix%ix%i) for domain decomposition",
+            gnx, gny, gnz, gpx, gpy, gpz ));
+
+  // Setup basic variables
+  RANK_TO_INDEX( world_rank, px,py,pz );
+
+  g->gpx = gpx; g->gpy = gpy; g->gpz = gpz;
+  g->gnx = gnx; g->gny = gny; g->gnz = gnz;
+  g->gx0 = gx0; g->gy0 = gy0; g->gz0 = gz0;
+  g->gx1 = gx1; g->gy1 = gy1; g->gz1 = gz1;
+
+  FREE( g->cut );
+  MALLOC( g->cut, gpx+gpy+gpz+3 );
+  set_cuts( g->cut,             cx, gnx, gpx );
+  set_cuts( g->cut+gpx+1,       cy, gny, gpy );
+  set_cuts( g->cut+gpx+gpy+2,   cz, gnz, gpz );
+
+  size_local_domain( g );
 
   // Join the grid to neighbors
   INDEX_TO_RANK(px-1,py,  pz,  rank); join_grid(g,BOUNDARY(-1, 0, 0),rank);
@@ -88,6 +159,7 @@ partition_periodic_box( grid_t * g,
   INDEX_TO_RANK(px,  py+1,pz,  rank); join_grid(g,BOUNDARY( 0, 1, 0),rank);
   INDEX_TO_RANK(px,  py,  pz+1,rank); join_grid(g,BOUNDARY( 0, 0, 1),rank);
 
+  join_diagonals( g );
 }
 
 void
@@ -96,14 +168,18 @@ partition_absorbing_box( grid_t * g,
                          double gx1, double gy1, double gz1,
                          int gnx, int gny, int gnz,
                          int gpx, int gpy, int gpz,
-                         int pbc ) {
+                         int pbc,
+                         const int * cx,
+                         const int * cy,
+                         const int * cz ) {
   int px, py, pz; 
 
   partition_periodic_box( g,
                           gx0, gy0, gz0,
                           gx1, gy1, gz1,
                           gnx, gny, gnz,
-                          gpx, gpy, gpz );
+                          gpx, gpy, gpz,
+                          cx, cy, cz );
 
   // Override periodic boundary conditions
 
@@ -148,14 +224,18 @@ partition_metal_box( grid_t * g,
                      double gx0, double gy0, double gz0,
                      double gx1, double gy1, double gz1,
                      int gnx, int gny, int gnz,
-                     int gpx, int gpy, int gpz ) {
+                     int gpx, int gpy, int gpz,
+                     const int * cx,
+                     const int * cy,
+                     const int * cz ) {
   int px, py, pz; 
 
   partition_periodic_box( g,
                           gx0, gy0, gz0,
                           gx1, gy1, gz1,
                           gnx, gny, gnz,
-                          gpx, gpy, gpz );
+                          gpx, gpy, gpz,
+                          cx, cy, cz );
 
   // Override periodic boundary conditions
 
@@ -191,3 +271,64 @@ partition_metal_box( grid_t * g,
     set_pbc(g,BOUNDARY(0,0,1),reflect_particles);
   }
 }
+
+void
+repartition_grid( grid_t * g,
+                  const int * cx,
+                  const int * cy,
+                  const int * cz ) {
+  static const int face[6] = { BOUNDARY(-1, 0, 0), BOUNDARY( 0,-1, 0),
+                               BOUNDARY( 0, 0,-1), BOUNDARY( 1, 0, 0),
+                               BOUNDARY( 0, 1, 0), BOUNDARY( 0, 0, 1) };
+  int bc[6], pbc[6], f, x, y, z;
+
+  if( !g ) ERROR(( "NULL grid" ));
+  if( !g->cut ) ERROR(( "Grid was not set up by a partition_*_box function" ));
+
+  const int gpx = g->gpx, gpy = g->gpy, gpz = g->gpz;
+
+  // Remember the boundary conditions on the domain faces (the particle
+  // boundary condition of a face is held by the neighbors of its voxels)
+
+  for( f=0; f<6; f++ ) {
+    bc[f] = g->bc[ face[f] ];
+    x = f==3 ? g->nx : 1;
+    y = f==4 ? g->ny : 1;
+    z = f==5 ? g->nz : 1;
+    pbc[f] = (int)g->neighbor[ 6*VOXEL(x,y,z, g->nx,g->ny,g->nz) + f ];
+  }
+
+  if( cx ) set_cuts( g->cut,           cx, g->gnx, gpx );
+  if( cy ) set_cuts( g->cut+gpx+1,     cy, g->gny, gpy );
+  if( cz ) set_cuts( g->cut+gpx+gpy+2, cz, g->gnz, gpz );
+
+  size_local_domain( g );
+
+  for( f=0; f<6; f++ )
+    if( bc[f]>=0 ) join_grid( g, face[f], bc[f] );
+    else {
+      set_fbc( g, face[f], bc[f] );
+      set_pbc( g, face[f], pbc[f] );
+    }
+
+  join_diagonals( g );
+}
+
+int
+grid_rank_box( const grid_t * g,
+               int rank,
+               int box[6] ) {
+  int px, py, pz;
+
+  if( !g || !box || rank<0 || rank>=world_size ) ERROR(( "Bad args" ));
+  if( !g->cut ) return 0;
+
+  const int gpx = g->gpx, gpy = g->gpy;
+  const int * cx = g->cut, * cy = cx + gpx + 1, * cz = cy + gpy + 1;
+
+  RANK_TO_INDEX( rank, px,py,pz );
+  box[0] = cx[px]; box[3] = cx[px+1] - cx[px];
+  box[1] = cy[py]; box[4] = cy[py+1] - cy[py];
+  box[2] = cz[pz]; box[5] = cz[pz+1] - cz[pz];
+  return 1;
+}
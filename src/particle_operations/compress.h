@@ -70,6 +70,11 @@ struct DefaultCompress {
 
         Kokkos::View<int*> clean_up_from = sp->clean_up_from;
         Kokkos::View<int*> clean_up_to = sp->clean_up_to;
+
+        // Tracer ids (empty unless the species has tracers) move with the
+        // particles
+        k_particle_ids_t particle_ids = sp->k_p_id_d;
+        const bool has_ids = particle_ids.extent(0) > 0;
         
         // Zero out the arrays and counters
         Kokkos::deep_copy(clean_up_to_count, 0);
@@ -176,6 +181,7 @@ struct DefaultCompress {
             particles(write_to, particle_var::uz) = particles(pull_from, particle_var::uz);
             particles(write_to, particle_var::w)  = particles(pull_from, particle_var::w);
             particles_i(write_to) = particles_i(pull_from);
+            if (has_ids) particle_ids(write_to) = particle_ids(pull_from);
         });
 
         Kokkos::deep_copy(clean_up_from_count_h, clean_up_from_count);
@@ -194,7 +200,18 @@ struct DefaultCompress {
             particles(write_to, particle_var::uz) = particles(pull_from, particle_var::uz);
             particles(write_to, particle_var::w)  = particles(pull_from, particle_var::w);
             particles_i(write_to) = particles_i(pull_from);
+            if (has_ids) particle_ids(write_to) = particle_ids(pull_from);
         });
+
+        // Keep the ids of the vacated slots zero, so particles appended
+        // there later start untracked
+        if (has_ids) {
+            Kokkos::parallel_for("compress clear ids", Kokkos::RangePolicy <
+            Kokkos::DefaultExecutionSpace > (np-nm, np), KOKKOS_LAMBDA (int n)
+            {
+                particle_ids(n) = 0;
+            });
+        }
     }
 
 //    static void test_compress(
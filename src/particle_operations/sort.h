@@ -36,6 +36,7 @@ struct DefaultSort {
     static void standard_sort(
             k_particles_t particles,
             k_particles_i_t particles_i,
+            k_particle_ids_t particle_ids,
             const int32_t np,
             const int32_t num_bins
     )
@@ -69,11 +70,38 @@ struct DefaultSort {
 	}
         // Sort particle indices
         bin_sort.sort(particles_i);
+        // Sort tracer ids, if the species has them
+        if(particle_ids.extent(0) > 0) bin_sort.sort(particle_ids);
+    }
+
+    /**
+     * @brief Voxel offsets of particles sorted by standard_sort: the particles
+     * in voxel v are offsets(v) ... offsets(v+1)-1.  offsets needs num_bins+1
+     * entries.
+     */
+    static void cell_offsets(
+            k_particles_i_t particles_i,
+            const int32_t np,
+            const int32_t num_bins,
+            Kokkos::View<int*> offsets
+    )
+    {
+        // Count the particles of voxel v into offsets(v+1) ...
+        Kokkos::deep_copy(offsets, 0);
+        Kokkos::parallel_for("Count voxel particles", Kokkos::RangePolicy<>(0, np), KOKKOS_LAMBDA(const int i) {
+          Kokkos::atomic_increment(&(offsets(particles_i(i)+1)));
+        });
+        // ... and turn the counts into offsets with an inclusive scan
+        Kokkos::parallel_scan("Voxel offsets", Kokkos::RangePolicy<>(0, num_bins+1), KOKKOS_LAMBDA(const int v, int& sum, const bool final) {
+          sum += offsets(v);
+          if(final) offsets(v) = sum;
+        });
     }
 
     static void strided_sort(
             k_particles_t particles,
             k_particles_i_t particles_i,
+            k_particle_ids_t particle_ids,
             const int32_t np,
             const int32_t num_bins
     )
@@ -123,11 +151,14 @@ struct DefaultSort {
 	}
         // Sort particle indices
         bin_sort.sort(particles_i);
+        // Sort tracer ids, if the species has them
+        if(particle_ids.extent(0) > 0) bin_sort.sort(particle_ids);
     }
 
     static void tiled_sort(
             k_particles_t particles,
             k_particles_i_t particles_i,
+            k_particle_ids_t particle_ids,
             const int32_t np,
             const int32_t num_bins,
             const int32_t tile_size   // # of cells per tile
@@ -176,11 +207,14 @@ struct DefaultSort {
 		}
         // Sort particle indices
         bin_sort.sort(particles_i);
+        // Sort tracer ids, if the species has them
+        if(particle_ids.extent(0) > 0) bin_sort.sort(particle_ids);
     }
 
     static void tiled_strided_sort(
             k_particles_t particles,
             k_particles_i_t particles_i,
+            k_particle_ids_t particle_ids,
             const int32_t np,
             const int32_t num_bins,
             const int32_t tile_size   // # of cells per tile
@@ -244,6 +278,8 @@ struct DefaultSort {
 		}
         // Sort particle indices
         bin_sort.sort(particles_i);
+        // Sort tracer ids, if the species has them
+        if(particle_ids.extent(0) > 0) bin_sort.sort(particle_ids);
     }
 };
 
@@ -253,11 +289,12 @@ struct ParticleSorter : private Policy {
   using Policy::strided_sort;
   using Policy::tiled_sort;
   using Policy::tiled_strided_sort;
-  void sort(k_particles_t particles, k_particles_i_t particles_i, const int32_t np, const int num_bins) {
+  using Policy::cell_offsets;
+  void sort(k_particles_t particles, k_particles_i_t particles_i, k_particle_ids_t particle_ids, const int32_t np, const int num_bins) {
 #ifdef SORT_TILE_SIZE // strided_tiled_sort or tiled_strided_sort
-    SORT(particles, particles_i, np, num_bins, SORT_TILE_SIZE);
+    SORT(particles, particles_i, particle_ids, np, num_bins, SORT_TILE_SIZE);
 #else // standard_sort or strided_sort
-    SORT(particles, particles_i, np, num_bins);
+    SORT(particles, particles_i, particle_ids, np, num_bins);
 #endif
   }
 };
@@ -43,7 +43,7 @@ typedef struct interpolator_array {
 
   void init_kokkos_interp(int nv)
   {
-    k_i_d = k_interpolator_t("k_interpolators", nv);
+    k_i_d = first_touch_view<k_interpolator_t>("k_interpolators", nv);
     k_i_h = Kokkos::create_mirror_view(k_i_d);
   }
 
@@ -0,0 +1,122 @@
+#include "particle_histogram.h"
+
+// Device form of a HistogramAxis with the bin mapping precomputed
+
+struct histogram_binner {
+
+  histogram_binner() :
+    quantity(-1), nbins(0), log(0), clamp(0), offset(0), scale(0) {}
+
+  histogram_binner( const HistogramAxis & axis ) :
+    quantity( axis.quantity ), nbins( axis.nbins ),
+    log( axis.log ), clamp( axis.clamp ) {
+    const float lo = log ? logf( axis.min ) : axis.min;
+    const float hi = log ? logf( axis.max ) : axis.max;
+    offset = lo;
+    scale  = nbins/( hi - lo );
+  }
+
+  int quantity, nbins, log, clamp;
+  float offset, scale;
+
+  // Bin of p on this axis, or -1 if it is dropped
+
+  KOKKOS_INLINE_FUNCTION int
+  operator()( const selected_particle_t & p ) const {
+    const float u2 = p.ux*p.ux + ( p.uy*p.uy + p.uz*p.uz );
+    float v;
+
+    switch( quantity ) {
+    case hist_ke:    v = u2/( 1 + sqrtf( 1 + u2 ) );               break;
+    case hist_u:     v = sqrtf( u2 );                              break;
+    case hist_ux:    v = p.ux;                                     break;
+    case hist_uy:    v = p.uy;                                     break;
+    case hist_uz:    v = p.uz;                                     break;
+    case hist_x:     v = p.x;                                      break;
+    case hist_y:     v = p.y;                                      break;
+    case hist_z:     v = p.z;                                      break;
+    case hist_theta: v = u2>0 ? acosf( fminf( fmaxf( p.ux/sqrtf( u2 ), -1.f ), 1.f ) ) : 0;
+                     break;
+    case hist_phi:   v = atan2f( p.uz, p.uy );                     break;
+    default:         return -1;
+    }
+
+    if( log ) {
+      if( !( v>0 ) ) return clamp ? 0 : -1;
+      v = logf( v );
+    }
+
+    // Written to also reject NaN
+    const float b = ( v - offset )*scale;
+    if( !( b>=0 ) ) return clamp ? 0 : -1;
+    if( !( b<nbins ) ) return clamp ? nbins-1 : -1;
+    return int( b );
+  }
+
+}; // struct histogram_binner
+
+static void
+check_axis( const HistogramAxis & axis ) {
+  if( axis.quantity<hist_ke || axis.quantity>hist_phi )
+    ERROR(( "Unknown histogram quantity %d", axis.quantity ));
+  if( axis.nbins<1 ) ERROR(( "Histogram axes need at least one bin" ));
+  if( !( axis.max>axis.min ) ) ERROR(( "Histogram axis range is empty" ));
+  if( axis.log && !( axis.min>0 ) )
+    ERROR(( "Logarithmic histogram axes need a positive minimum" ));
+}
+
+Kokkos::View<double*>
+histogram_particles( const species_t * sp,
+                     const interpolator_array_t * ia,
+                     const ParticleHistogram & hist )
+{
+  if( !sp || !ia ) ERROR(( "Bad args" ));
+  if( hist.ndim!=1 && hist.ndim!=2 ) ERROR(( "Histograms must be 1-D or 2-D" ));
+  if( hist.weight<hist_weight_w || hist.weight>hist_weight_energy )
+    ERROR(( "Unknown histogram weight %d", hist.weight ));
+  if( hist.selection.stride<1 ) ERROR(( "Particle selection stride must be positive" ));
+  check_axis( hist.axis[0] );
+  if( hist.ndim==2 ) check_axis( hist.axis[1] );
+
+  const selected_particle_builder record( sp, ia );
+  const ParticleSelection sel = hist.selection;
+  const histogram_binner bin0( hist.axis[0] );
+  const histogram_binner bin1 = hist.ndim==2 ? histogram_binner( hist.axis[1] ) :
+                                               histogram_binner();
+  const int ndim = hist.ndim;
+  const int weight = hist.weight;
+  const int stride = sel.stride;
+  const double mc2 = double( sp->m )*sp->g->cvac*sp->g->cvac;
+
+  Kokkos::View<double*> k_hist( "k_histogram", hist.nbins() );
+  Kokkos::Experimental::ScatterView<double*> k_hist_sv( k_hist );
+
+  Kokkos::parallel_for("histogram particles", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, sp->np), KOKKOS_LAMBDA (const int p_index) {
+    if( p_index % stride ) return;
+    const selected_particle_t p = record( p_index );
+    if( !sel.accepts( p ) ) return;
+
+    const int i0 = bin0( p );
+    if( i0<0 ) return;
+    int b = i0;
+    if( ndim==2 ) {
+      const int i1 = bin1( p );
+      if( i1<0 ) return;
+      b += bin0.nbins*i1;
+    }
+
+    double v = 1;
+    if( weight==hist_weight_w ) v = p.w;
+    else if( weight==hist_weight_energy ) {
+      const float u2 = p.ux*p.ux + ( p.uy*p.uy + p.uz*p.uz );
+      v = mc2*p.w*( u2/( 1 + sqrtf( 1 + u2 ) ) );
+    }
+
+    auto access = k_hist_sv.access();
+    access(b) += v;
+  });
+
+  Kokkos::Experimental::contribute( k_hist, k_hist_sv );
+  return k_hist;
+}
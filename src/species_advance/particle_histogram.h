@@ -0,0 +1,93 @@
+#ifndef _particle_histogram_h_
+#define _particle_histogram_h_
+
+#include "particle_select.h"
+
+// Quantities a histogram axis can bin.  Energies are kinetic energies
+// gamma-1 (in units of m c^2).  Angles are in radians: theta is the
+// angle between u and +x on [0,pi] (as in post/anglehist.c) and phi is
+// the azimuth about x, atan2(uz,uy) on [-pi,pi].  Positions are global.
+
+enum histogram_quantity {
+  hist_ke    = 0,
+  hist_u     = 1,
+  hist_ux    = 2,
+  hist_uy    = 3,
+  hist_uz    = 4,
+  hist_x     = 5,
+  hist_y     = 6,
+  hist_z     = 7,
+  hist_theta = 8,
+  hist_phi   = 9
+};
+
+// What each particle adds to its bin
+
+enum histogram_weight {
+  hist_weight_w      = 0, // Physical particles (the particle weight)
+  hist_weight_macro  = 1, // Macro particles
+  hist_weight_energy = 2  // Kinetic energy w m c^2 (gamma-1), as energy_p
+};
+
+// nbins bins spanning [min,max), logarithmically spaced when log is set
+// (then min must be positive).  Values outside the range are dropped
+// unless clamp is set, in which case they land in the first or last bin.
+
+struct HistogramAxis {
+
+  HistogramAxis() :
+    quantity(hist_ke), nbins(1), min(0), max(1), log(0), clamp(0) {}
+
+  HistogramAxis( int quantity_, int nbins_, float min_, float max_,
+                 int log_ = 0, int clamp_ = 0 ) :
+    quantity(quantity_), nbins(nbins_), min(min_), max(max_),
+    log(log_), clamp(clamp_) {}
+
+  int quantity;
+  int nbins;
+  float min, max;
+  int log;
+  int clamp;
+
+}; // struct HistogramAxis
+
+// A 1-D (e.g. an energy spectrum) or 2-D (e.g. x-ux phase space or an
+// angle-energy distribution) histogram of the particles of a species
+// passing selection.  Bins are stored with axis 0 varying fastest.
+
+struct ParticleHistogram {
+
+  ParticleHistogram() : ndim(0), weight(hist_weight_w) {}
+
+  ParticleHistogram( const HistogramAxis & axis0,
+                     int weight_ = hist_weight_w ) :
+    ndim(1), weight(weight_) { axis[0] = axis0; }
+
+  ParticleHistogram( const HistogramAxis & axis0,
+                     const HistogramAxis & axis1,
+                     int weight_ = hist_weight_w ) :
+    ndim(2), weight(weight_) { axis[0] = axis0; axis[1] = axis1; }
+
+  int nbins() const {
+    return ndim==2 ? axis[0].nbins*axis[1].nbins : axis[0].nbins;
+  }
+
+  int ndim;
+  int weight;
+  HistogramAxis axis[2];
+  ParticleSelection selection;
+
+}; // struct ParticleHistogram
+
+// In particle_histogram.cc
+
+// Accumulate the histogram of the local particles of sp on the device.
+// Particles are time-centered with the interpolator first, as for
+// particle dumps.
+
+Kokkos::View<double*>
+histogram_particles( const species_t * sp,
+                     const interpolator_array_t * ia,
+                     const ParticleHistogram & hist );
+
+#endif // _particle_histogram_h_
@@ -0,0 +1,166 @@
+#ifndef _particle_inject_h_
+#define _particle_inject_h_
+
+#include "species_advance.h"
+#include "../util/rng/philox.h"
+
+// Device particle injection.  Particles are created directly in the
+// device particle array, so decks using it can set
+// kokkos_particle_injection and skip the full particle copies around
+// user_particle_injection.
+//
+// density is a functor
+//
+//   KOKKOS_INLINE_FUNCTION float
+//   operator()( float x, float y, float z ) const;
+//
+// giving the expected number of macro particles to inject this call in
+// the local cell centered on the global position (x,y,z) (i.e. a rate
+// times the injection interval, or a density times the cell volume,
+// over the weight).  The count is rounded stochastically.  Particles are
+// placed uniformly in the cell.  momentum is a functor
+//
+//   KOKKOS_INLINE_FUNCTION void
+//   operator()( float x, float y, float z, counter_rng & rng,
+//               float u[3] ) const;
+//
+// setting the normalized momentum of a particle at (x,y,z).
+//
+// A scan over the local cells counts the particles and reserves a block
+// for them at the end of the particle array; its final pass creates
+// them.  The cost is the number of cells plus the number of particles
+// injected, whatever the number of particles already present.  Deviates
+// come from a counter_rng keyed by (seed, rank, species, voxel, step),
+// so use different seeds for different injections into the same species
+// in the same step.
+//
+// As inject_particle, particles can be aged: age is the fraction of a
+// timestep they have already been pushed (age<0 means a uniform random
+// age on [0,-age) for each particle).  Aged particles that stop on a
+// face go on the device movers, so injection must happen after
+// advance_p and before the movers are processed (advance does this for
+// user_particle_injection when kokkos_particle_injection is set).
+
+// Maxwellian of thermal momentum uth drifting at (udx,udy,udz)
+
+struct drifting_maxwellian {
+
+  drifting_maxwellian( float uth_, float udx_ = 0, float udy_ = 0, float udz_ = 0 ) :
+    uth(uth_), udx(udx_), udy(udy_), udz(udz_) {}
+
+  float uth, udx, udy, udz;
+
+  KOKKOS_INLINE_FUNCTION void
+  operator()( float x, float y, float z, counter_rng & rng, float u[3] ) const {
+    float n[4];
+    rng.normal4( n );
+    u[0] = udx + uth*n[0];
+    u[1] = udy + uth*n[1];
+    u[2] = udz + uth*n[2];
+  }
+
+}; // struct drifting_maxwellian
+
+// Returns the number of particles injected locally
+
+template<class Density, class Momentum>
+int
+inject_particles_device( species_t     * RESTRICT sp,
+                         field_array_t * RESTRICT fa,
+                         const Density  & density,
+                         const Momentum & momentum,
+                         float w,
+                         float age = 0,
+                         int update_rhob = 1,
+                         uint32_t seed = 0 )
+{
+  if( !sp || !fa || sp->g!=fa->g ) ERROR(( "Bad args" ));
+  if( w<0 ) ERROR(( "inject_particles: w < 0" ));
+
+  const grid_t * g = sp->g;
+  const int np = sp->np, max_np = sp->max_np;
+  const int nx = g->nx, ny = g->ny, nz = g->nz, sy = g->sy, sz = g->sz;
+  const float x0 = g->x0, y0 = g->y0, z0 = g->z0;
+  const float dx = g->dx, dy = g->dy, dz = g->dz;
+  const float rdx = g->rdx, rdy = g->rdy, rdz = g->rdz;
+  const float cdt = g->cvac*g->dt, qsp = sp->q, r8V = g->r8V;
+  const uint32_t rank = world_rank, stream = philox_stream( philox_inject, sp->id );
+  const int64_t step = g->step;
+
+  const auto& k_particles = sp->k_p_d;
+  const auto& k_particles_i = sp->k_p_i_d;
+  const Kokkos::View<float*, Kokkos::LayoutStride, Kokkos::MemoryTraits<Kokkos::Atomic> >
+    rhob = Kokkos::subview( fa->k_f_d, Kokkos::ALL(), int(field_var::rhob) );
+
+  k_particle_ager age_particle( sp, fa );
+
+  int n_inject = 0;
+  Kokkos::parallel_scan("inject particles", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, nx*ny*nz), KOKKOS_LAMBDA (const int c, int & offset, const bool final) {
+    const int ix = c%nx + 1, iy = ( c/nx )%ny + 1, iz = c/( nx*ny ) + 1;
+    const int voxel = VOXEL( ix, iy, iz, nx, ny, nz );
+
+    counter_rng rng( seed, rank, stream, voxel, step );
+    const float expect = density( x0 + ( ix-0.5f )*dx,
+                                  y0 + ( iy-0.5f )*dy,
+                                  z0 + ( iz-0.5f )*dz );
+    const int n = expect>0 ? int( expect + rng.frand() ) : 0;
+    if( !n ) return;
+    const int n0 = offset;
+    offset += n;
+    if( !final ) return;
+
+    for( int k=0; k<n; k++ ) {
+      const int p_index = np + n0 + k;
+      if( p_index>=max_np ) return;
+
+      particle_t p;
+      p.dx = 2*rng.frand()-1;
+      p.dy = 2*rng.frand()-1;
+      p.dz = 2*rng.frand()-1;
+      p.i  = voxel;
+      p.w  = w;
+
+      float u[3];
+      momentum( x0 + ( ix-1 + 0.5f*( p.dx+1 ) )*dx,
+                y0 + ( iy-1 + 0.5f*( p.dy+1 ) )*dy,
+                z0 + ( iz-1 + 0.5f*( p.dz+1 ) )*dz, rng, u );
+      p.ux = u[0]; p.uy = u[1]; p.uz = u[2];
+
+      k_particles(p_index, particle_var::dx) = p.dx;
+      k_particles(p_index, particle_var::dy) = p.dy;
+      k_particles(p_index, particle_var::dz) = p.dz;
+      k_particles(p_index, particle_var::ux) = p.ux;
+      k_particles(p_index, particle_var::uy) = p.uy;
+      k_particles(p_index, particle_var::uz) = p.uz;
+      k_particles(p_index, particle_var::w)  = p.w;
+      k_particles_i(p_index) = voxel;
+
+      if( update_rhob ) k_accumulate_rhob_single( rhob, p, -qsp, r8V, nx, ny, nz, sy, sz );
+
+      if( age!=0 ) {
+        const float a = ( age<0 ? -age*rng.frand() : age )*cdt /
+                        sqrtf( u[0]*u[0] + u[1]*u[1] + u[2]*u[2] + 1 );
+        particle_mover_t pm;
+        pm.dispx = u[0]*a*rdx;
+        pm.dispy = u[1]*a*rdy;
+        pm.dispz = u[2]*a*rdz;
+        pm.i     = p_index;
+        age_particle( pm );
+      }
+    }
+  }, n_inject);
+
+  age_particle.finish( sp, fa );
+
+  const int np_skipped = np + n_inject - max_np;
+  if( np_skipped>0 ) {
+    WARNING(( "Insufficient local particle storage.  Did not inject %i "
+              "particles of species \"%s\"", np_skipped, sp->name ));
+    n_inject -= np_skipped;
+  }
+  sp->np += n_inject;
+  return n_inject;
+}
+
+#endif // _particle_inject_h_
@@ -0,0 +1,166 @@
+#ifndef _particle_select_h_
+#define _particle_select_h_
+
+#include <cfloat>
+
+#include "species_advance.h"
+
+// A time-centered particle with its position in global coordinates.  This
+// is the record written by selective particle dumps and the argument
+// handed to user selection predicates.
+
+typedef struct selected_particle {
+  float x, y, z;    // Global position
+  float ux, uy, uz; // Time-centered normalized momentum
+  float w;          // Particle weight (number of physical particles)
+} selected_particle_t;
+
+// Built in particle selection criteria.  A particle is selected when it
+// passes every criterion: its index is a multiple of stride, its kinetic
+// energy (gamma-1, in units of m c^2) and momentum magnitude |u| lie in
+// the given closed windows, and its global position lies in the box
+// [x0,x1]x[y0,y1]x[z0,z1].  The defaults select everything.
+
+struct ParticleSelection {
+
+  ParticleSelection() :
+    stride(1),
+    ke_min(0), ke_max(FLT_MAX),
+    u_min(0), u_max(FLT_MAX),
+    x0(-FLT_MAX), y0(-FLT_MAX), z0(-FLT_MAX),
+    x1( FLT_MAX), y1( FLT_MAX), z1( FLT_MAX) {}
+
+  int stride;
+  float ke_min, ke_max;
+  float u_min, u_max;
+  float x0, y0, z0;
+  float x1, y1, z1;
+
+  KOKKOS_INLINE_FUNCTION bool
+  accepts( const selected_particle_t & p ) const {
+    const float u2 = p.ux*p.ux + ( p.uy*p.uy + p.uz*p.uz );
+    const float u  = sqrtf( u2 );
+    const float ke = u2/( 1 + sqrtf( 1 + u2 ) ); // gamma-1, robustly
+    return ke >= ke_min && ke <= ke_max &&
+           u  >= u_min  && u  <= u_max  &&
+           p.x >= x0 && p.x <= x1 &&
+           p.y >= y0 && p.y <= y1 &&
+           p.z >= z0 && p.z <= z1;
+  }
+
+}; // struct ParticleSelection
+
+// Default user predicate: accept every particle.
+
+struct select_all_particles {
+  KOKKOS_INLINE_FUNCTION bool
+  operator()( const selected_particle_t & ) const { return true; }
+};
+
+// Builds the selected_particle_t record of a particle on the device.
+
+struct selected_particle_builder {
+
+  selected_particle_builder( const species_t * sp,
+                             const interpolator_array_t * ia ) :
+    k_particles( sp->k_p_d ), k_particles_i( sp->k_p_i_d ),
+    k_interp( ia->k_i_d ),
+    qdt_2mc( (sp->q*sp->g->dt)/(2*sp->m*sp->g->cvac) ),
+    x0( sp->g->x0 ), y0( sp->g->y0 ), z0( sp->g->z0 ),
+    dx( sp->g->dx ), dy( sp->g->dy ), dz( sp->g->dz ),
+    sy( sp->g->sy ), sz( sp->g->sz ) {}
+
+  k_particles_t k_particles;
+  k_particles_i_t k_particles_i;
+  k_interpolator_t k_interp;
+  float qdt_2mc;
+  float x0, y0, z0;
+  float dx, dy, dz;
+  int sy, sz;
+
+  KOKKOS_INLINE_FUNCTION selected_particle_t
+  operator()( const int p_index ) const {
+    const int ii  = k_particles_i(p_index);
+    const int iz  = ii/sz;
+    const int iy  = ( ii - iz*sz )/sy;
+    const int ix  = ii - iz*sz - iy*sy;
+    const float px = k_particles(p_index, particle_var::dx);
+    const float py = k_particles(p_index, particle_var::dy);
+    const float pz = k_particles(p_index, particle_var::dz);
+
+    selected_particle_t p;
+    p.x  = x0 + ( ( ix - 1 ) + 0.5f*( px + 1 ) )*dx;
+    p.y  = y0 + ( ( iy - 1 ) + 0.5f*( py + 1 ) )*dy;
+    p.z  = z0 + ( ( iz - 1 ) + 0.5f*( pz + 1 ) )*dz;
+    p.ux = k_particles(p_index, particle_var::ux);
+    p.uy = k_particles(p_index, particle_var::uy);
+    p.uz = k_particles(p_index, particle_var::uz);
+    p.w  = k_particles(p_index, particle_var::w);
+    center_momentum( k_interp, ii, px, py, pz, p.ux, p.uy, p.uz, qdt_2mc );
+    return p;
+  }
+
+}; // struct selected_particle_builder
+
+// Stream-compact the indices of the particles of sp passing selection
+// and predicate.  predicate is a device-callable functor taking a const
+// selected_particle_t & and returning bool.  The first n_selected entries
+// of the returned view are set.
+
+template<class Predicate>
+Kokkos::View<int*>
+select_particle_indices( const species_t * sp,
+                         const interpolator_array_t * ia,
+                         const ParticleSelection & selection,
+                         const Predicate & predicate,
+                         int & n_selected )
+{
+  if( selection.stride<1 ) ERROR(( "Particle selection stride must be positive" ));
+
+  const int np = sp->np;
+  const int stride = selection.stride;
+  const ParticleSelection sel = selection;
+  const selected_particle_builder record( sp, ia );
+
+  Kokkos::View<int*> k_index( Kokkos::ViewAllocateWithoutInitializing("selected index"), np );
+
+  n_selected = 0;
+  Kokkos::parallel_scan("select particles", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, np), KOKKOS_LAMBDA (const int p_index, int & offset, const bool final) {
+    if( p_index % stride ) return;
+    const selected_particle_t p = record( p_index );
+    if( !sel.accepts( p ) || !predicate( p ) ) return;
+    if( final ) k_index(offset) = p_index;
+    offset++;
+  }, n_selected);
+
+  return k_index;
+}
+
+// Stream-compact the particles of sp passing selection and predicate into
+// a device view of selected_particle_t records.
+
+template<class Predicate>
+Kokkos::View<selected_particle_t*>
+select_particles( const species_t * sp,
+                  const interpolator_array_t * ia,
+                  const ParticleSelection & selection,
+                  const Predicate & predicate )
+{
+  int n_selected;
+  const selected_particle_builder record( sp, ia );
+  Kokkos::View<int*> k_index = select_particle_indices( sp, ia, selection,
+                                                        predicate, n_selected );
+
+  Kokkos::View<selected_particle_t*> k_selected(
+      Kokkos::ViewAllocateWithoutInitializing("selected particles"), n_selected );
+
+  Kokkos::parallel_for("gather selected particles", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n_selected), KOKKOS_LAMBDA (const int n) {
+    k_selected(n) = record( k_index(n) );
+  });
+
+  return k_selected;
+}
+
+#endif // _particle_select_h_
@@ -9,6 +9,7 @@
  */
 
 #include "species_advance.h"
+#include "tracer.h"
 #include "../boundary/boundary.h"
 
 /* Private interface *********************************************************/
@@ -28,6 +29,7 @@ checkpt_species( const species_t * sp ) {
   CHECKPT_PTR( sp->g );
   CHECKPT_PTR( sp->next );
   CHECKPT_PTR( sp->pb_diag );
+  CHECKPT_PTR( sp->tracer );
 }
 
 species_t *
@@ -41,12 +43,14 @@ restore_species( void ) {
   RESTORE_PTR( sp->g );
   RESTORE_PTR( sp->next );
   RESTORE_PTR( sp->pb_diag );
+  RESTORE_PTR( sp->tracer );
   return sp;
 }
 
 void
 delete_species( species_t * sp ) {
   delete_pbd(sp->pb_diag);
+  delete_tracer(sp->tracer);
   UNREGISTER_OBJECT( sp );
   FREE_ALIGNED( sp->partition );
   FREE_ALIGNED( sp->pm );
@@ -169,6 +173,7 @@ species_t::copy_to_host()
   Kokkos::deep_copy(k_pm_h, k_pm_d);
   Kokkos::deep_copy(k_pm_i_h, k_pm_i_d);
   Kokkos::deep_copy(k_nm_h, k_nm_d);
+  if( has_particle_ids() ) Kokkos::deep_copy(k_p_id_h, k_p_id_d);
 
   nm = k_nm_h(0);
 
@@ -259,6 +264,7 @@ species_t::copy_to_device()
   Kokkos::deep_copy(k_pm_d, k_pm_h);
   Kokkos::deep_copy(k_pm_i_d, k_pm_i_h);
   Kokkos::deep_copy(k_nm_d, k_nm_h);
+  if( has_particle_ids() ) Kokkos::deep_copy(k_p_id_d, k_p_id_h);
 
 }
 
@@ -266,7 +272,7 @@ void
 species_t::copy_outbound_to_host()
 {
 
-  Kokkos::deep_copy(k_nm_h, k_nm_d);
+  mp_stage(k_nm_h, k_nm_d);
   nm = k_nm_h(0);
 
   auto pm_h_dispx = Kokkos::subview(k_pm_h, std::make_pair(0, nm), 0);
@@ -279,10 +285,10 @@ species_t::copy_outbound_to_host()
   auto pm_i_h_subview = Kokkos::subview(k_pm_i_h, std::make_pair(0, nm));
   auto pm_i_d_subview = Kokkos::subview(k_pm_i_d, std::make_pair(0, nm));
 
-  Kokkos::deep_copy(pm_h_dispx, pm_d_dispx);
-  Kokkos::deep_copy(pm_h_dispy, pm_d_dispy);
-  Kokkos::deep_copy(pm_h_dispz, pm_d_dispz);
-  Kokkos::deep_copy(pm_i_h_subview, pm_i_d_subview);
+  mp_stage(pm_h_dispx, pm_d_dispx);
+  mp_stage(pm_h_dispy, pm_d_dispy);
+  mp_stage(pm_h_dispz, pm_d_dispz);
+  mp_stage(pm_i_h_subview, pm_i_d_subview);
 
   // Avoid capturing this
   auto& k_particle_movers_h = k_pm_h;
@@ -298,33 +304,64 @@ species_t::copy_outbound_to_host()
       movers[i].i     = k_particle_i_movers_h(i);
     });
 
-
+  // Copy particle mirror movers back so we have their data safe. Ready for
+  // boundary_p_kokkos
+  auto pc_d_subview = Kokkos::subview(k_pc_d, std::make_pair(0, nm), Kokkos::ALL);
+  auto pci_d_subview = Kokkos::subview(k_pc_i_d, std::make_pair(0, nm));
+  auto pc_h_subview = Kokkos::subview(k_pc_h, std::make_pair(0, nm), Kokkos::ALL);
+  auto pci_h_subview = Kokkos::subview(k_pc_i_h, std::make_pair(0, nm));
+
+  mp_stage(pc_h_subview, pc_d_subview);
+  mp_stage(pci_h_subview, pci_d_subview);
+
+  // Tracer ids travel with the mover copies.  Gathering them here through
+  // the mover indices keeps the advance kernels unchanged.
+  if( has_particle_ids() )
+  {
+    const auto& particle_ids = k_p_id_d;
+    const auto& particle_copy_ids = k_pc_id_d;
+    const auto& particle_movers_i = k_pm_i_d;
+    Kokkos::parallel_for("gather mover ids", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace > (0, nm),
+      KOKKOS_LAMBDA (const int n) {
+        particle_copy_ids(n) = particle_ids(particle_movers_i(n));
+      });
+
+    auto pcid_d_subview = Kokkos::subview(k_pc_id_d, std::make_pair(0, nm));
+    auto pcid_h_subview = Kokkos::subview(k_pc_id_h, std::make_pair(0, nm));
+    mp_stage(pcid_h_subview, pcid_d_subview);
+  }
 }
 
 void
 species_t::copy_inbound_to_device()
 {
 
+#if KOKKOS_DEVICE_IS_HOST
+  // The device reads the received particles where they are
+  auto& particle_copy = k_pr_h;
+  auto& particle_copy_i = k_pr_i_h;
+#else
   // TODO: Why do we need particle_copy as an intermediate?
   // currently the recv particles are in particles_recv, not particle_copy
   auto pr_h_subview  = Kokkos::subview(k_pr_h,   std::make_pair(0, num_to_copy), Kokkos::ALL);
   auto pc_h_subview  = Kokkos::subview(k_pc_h,   std::make_pair(0, num_to_copy), Kokkos::ALL);
   auto pri_h_subview = Kokkos::subview(k_pr_i_h, std::make_pair(0, num_to_copy));
   auto pci_h_subview = Kokkos::subview(k_pc_i_h, std::make_pair(0, num_to_copy));
-  Kokkos::deep_copy(pc_h_subview, pr_h_subview);
-  Kokkos::deep_copy(pci_h_subview, pri_h_subview);
+  mp_stage(pc_h_subview, pr_h_subview);
+  mp_stage(pci_h_subview, pri_h_subview);
 
 
   auto pc_d_subview  = Kokkos::subview(k_pc_d,   std::make_pair(0, num_to_copy), Kokkos::ALL);
   auto pci_d_subview = Kokkos::subview(k_pc_i_d, std::make_pair(0, num_to_copy));
-  Kokkos::deep_copy(pc_d_subview, pc_h_subview);
-  Kokkos::deep_copy(pci_d_subview, pci_h_subview);
-
-  // Append it to the particles
+  mp_stage(pc_d_subview, pc_h_subview);
+  mp_stage(pci_d_subview, pci_h_subview);
 
   // Avoid capturing this
   auto& particle_copy = k_pc_d;
   auto& particle_copy_i = k_pc_i_d;
+#endif
+
+  // Append it to the particles
   auto& particles = k_p_d;
   auto& particles_i = k_p_i_d;
   const int npart = np;
@@ -345,6 +382,27 @@ species_t::copy_inbound_to_device()
 
     });
 
+  if( has_particle_ids() ) {
+#if KOKKOS_DEVICE_IS_HOST
+    auto& particle_copy_id = k_pr_id_h;
+#else
+    auto prid_h_subview = Kokkos::subview(k_pr_id_h, std::make_pair(0, num_to_copy));
+    auto pcid_h_subview = Kokkos::subview(k_pc_id_h, std::make_pair(0, num_to_copy));
+    auto pcid_d_subview = Kokkos::subview(k_pc_id_d, std::make_pair(0, num_to_copy));
+    mp_stage(pcid_h_subview, prid_h_subview);
+    mp_stage(pcid_d_subview, pcid_h_subview);
+
+    auto& particle_copy_id = k_pc_id_d;
+#endif
+    auto& particle_ids = k_p_id_d;
+
+    Kokkos::parallel_for("append moved particle ids",
+      Kokkos::RangePolicy <Kokkos::DefaultExecutionSpace> (0, num_to_copy),
+      KOKKOS_LAMBDA (int i) {
+        particle_ids(npart+i) = particle_copy_id(i);
+      });
+  }
+
   // Reset this to zero now we've done the write back
   this->np += num_to_copy;
   num_to_copy = 0;
@@ -56,8 +56,13 @@ typedef struct particle_injector {
   species_id sp_id;          // Species of particle
 } particle_injector_t;
 
+// Particles staged on the device in the legacy particle_t layout (used
+// to stream particle dumps to the host)
+using k_particle_dump_t = Kokkos::View<particle_t*>;
+
 // Seems like this belongs in boundary.h
 class species_t;
+class tracer_t;
 typedef struct pb_diagnostic {
 
     int         enable; // Wether or not to use this diagnostic
@@ -133,6 +138,9 @@ class species_t {
         // Particle boundary diagnostic.
         pb_diagnostic_t * pb_diag = NULL;
 
+        // Tracer particles (see tracer.h), NULL unless tracers are defined.
+        tracer_t * tracer = NULL;
+
 
         //// END CHECKPOINTED DATA, START KOKKOS //////
 
@@ -188,6 +196,15 @@ class species_t {
         Kokkos::View<int*> clean_up_from;
         Kokkos::View<int*> clean_up_to;
 
+        // Tracer ids, only allocated for species with tracers.  They are
+        // permuted along with the particles by sort, compress and
+        // boundary_p.  Ids at and beyond np are kept zero.
+        k_particle_ids_t k_p_id_d;                   // ids of the particles
+        k_particle_ids_t::HostMirror k_p_id_h;
+        k_particle_ids_t k_pc_id_d;                  // ids of the mover copies
+        k_particle_ids_t::HostMirror k_pc_id_h;
+        k_particle_ids_t::HostMirror k_pr_id_h;      // ids of received particles
+
         // Init Kokkos Particle Arrays
         species_t(int n_particles, int n_pmovers)
         {
@@ -200,8 +217,8 @@ class species_t {
         }
         void init_kokkos_particles(int n_particles, int n_pmovers)
         {
-            k_p_d = k_particles_t("k_particles", n_particles);
-            k_p_i_d = k_particles_i_t("k_particles_i", n_particles);
+            k_p_d = first_touch_view<k_particles_t>("k_particles", n_particles);
+            k_p_i_d = first_touch_view<k_particles_i_t>("k_particles_i", n_particles);
             k_pc_d = k_particle_copy_t("k_particle_copy_for_movers", n_pmovers);
             k_pc_i_d = k_particle_i_copy_t("k_particle_copy_for_movers_i", n_pmovers);
             k_pr_h = k_particle_copy_t::HostMirror("k_particle_send_for_movers", n_pmovers);
@@ -229,6 +246,18 @@ class species_t {
             clean_up_from_count_h = Kokkos::create_mirror_view(clean_up_from_count);
         }
 
+        void init_kokkos_particle_ids()
+        {
+            k_p_id_d = first_touch_view<k_particle_ids_t>("k_particle_ids", max_np);
+            k_pc_id_d = k_particle_ids_t("k_particle_copy_for_movers_ids", max_nm);
+            k_pr_id_h = k_particle_ids_t::HostMirror("k_particle_send_for_movers_ids", max_nm);
+
+            k_p_id_h = Kokkos::create_mirror_view(k_p_id_d);
+            k_pc_id_h = Kokkos::create_mirror_view(k_pc_id_d);
+        }
+
+        bool has_particle_ids() const { return k_p_id_d.extent(0) > 0; }
+
         /**
          * @brief Copies all the outbound particles and movers to the host.
          */
@@ -308,6 +337,67 @@ void
 center_p( /**/  species_t            * RESTRICT sp,
           const interpolator_array_t * RESTRICT ia );
 
+// Device version of center_p that leaves the species untouched: the
+// centered copies of particles [first,first+n) are written to k_out(0:n)
+// in the legacy particle_t layout, ready to be staged for output.  The
+// kernel is launched asynchronously on exec.
+
+void center_p_kokkos(
+        const Kokkos::DefaultExecutionSpace& exec,
+        const k_particles_t& k_particles,
+        const k_particles_i_t& k_particles_i,
+        const k_interpolator_t& k_interp,
+        const k_particle_dump_t& k_out,
+        int first,
+        int n,
+        float qdt_2mc
+);
+
+// Half advance E and half Boris rotate of a single particle momentum, as
+// done by center_p.  Shared by the device kernels that center particles.
+
+KOKKOS_INLINE_FUNCTION void
+center_momentum( const k_interpolator_t& k_interp,
+                 const int ii,
+                 const float dx, const float dy, const float dz,
+                 float& ux, float& uy, float& uz,
+                 const float qdt_2mc )
+{
+  const float qdt_4mc        = 0.5*qdt_2mc; // For half Boris rotate
+  const float one            = 1.;
+  const float one_third      = 1./3.;
+  const float two_fifteenths = 2./15.;
+
+  float hax, hay, haz, cbx, cby, cbz;
+  float v0, v1, v2, v3, v4;
+
+  hax  = qdt_2mc*(    ( k_interp(ii, interpolator_var::ex)    + dy*k_interp(ii, interpolator_var::dexdy)    ) +
+                   dz*( k_interp(ii, interpolator_var::dexdz) + dy*k_interp(ii, interpolator_var::d2exdydz) ) );
+  hay  = qdt_2mc*(    ( k_interp(ii, interpolator_var::ey)    + dz*k_interp(ii, interpolator_var::deydz)    ) +
+                   dx*( k_interp(ii, interpolator_var::deydx) + dz*k_interp(ii, interpolator_var::d2eydzdx) ) );
+  haz  = qdt_2mc*(    ( k_interp(ii, interpolator_var::ez)    + dx*k_interp(ii, interpolator_var::dezdx)    ) +
+                   dy*( k_interp(ii, interpolator_var::dezdy) + dx*k_interp(ii, interpolator_var::d2ezdxdy) ) );
+  cbx  = k_interp(ii, interpolator_var::cbx) + dx*k_interp(ii, interpolator_var::dcbxdx); // Interpolate B
+  cby  = k_interp(ii, interpolator_var::cby) + dy*k_interp(ii, interpolator_var::dcbydy);
+  cbz  = k_interp(ii, interpolator_var::cbz) + dz*k_interp(ii, interpolator_var::dcbzdz);
+  ux  += hax;                              // Half advance E
+  uy  += hay;
+  uz  += haz;
+  v0   = qdt_4mc/(float)sqrt(one + (ux*ux + (uy*uy + uz*uz)));
+  /**/                                     // Boris - scalars
+  v1   = cbx*cbx + (cby*cby + cbz*cbz);
+  v2   = (v0*v0)*v1;
+  v3   = v0*(one+v2*(one_third+v2*two_fifteenths));
+  v4   = v3/(one+v1*(v3*v3));
+  v4  += v4;
+  v0   = ux + v3*( uy*cbz - uz*cby );      // Boris - uprime
+  v1   = uy + v3*( uz*cbx - ux*cbz );
+  v2   = uz + v3*( ux*cby - uy*cbx );
+  ux  += v4*( v1*cbz - v2*cby );           // Boris - rotation
+  uy  += v4*( v2*cbx - v0*cbz );
+  uz  += v4*( v0*cby - v1*cbx );
+}
+
 // In uncenter_p.cxx
 
 // This is the inverse of center_p.  Thus, particles with r and u at
@@ -644,6 +734,95 @@ move_p_kokkos(
   return 0; // Return "mover not in use"
 }
 
+// Finishes the partial push of a particle written to the device particle
+// array (an injected or emitted particle being aged) and, if it stops on
+// a face, appends it to the device movers and mover copies as advance_p
+// does.  It is copied by value into device kernels.  The currents go to
+// the field scatter view, so reset it before the kernel and contribute
+// it after (see finish()).
+//
+// A mover slot is reserved before the move (in reserved, which starts
+// at the mover count) and given back if the particle finishes its move,
+// so the movers never overrun max_nm however many threads age at once.
+struct k_particle_ager {
+
+    k_particle_ager( species_t * sp, field_array_t * fa ) :
+        particles( sp->k_p_d ), particles_i( sp->k_p_i_d ),
+        movers( sp->k_pm_d ), movers_i( sp->k_pm_i_d ),
+        copy( sp->k_pc_d ), copy_i( sp->k_pc_i_d ), k_nm( sp->k_nm_d ),
+        reserved( "ager reserved" ),
+        neighbors( sp->g->k_neighbor_d ), field_sv( fa->k_field_sa_d ),
+        g( sp->g ), rangel( sp->g->rangel ), rangeh( sp->g->rangeh ),
+        qsp( sp->q ),
+        cx( 0.25 * sp->g->rdy * sp->g->rdz / sp->g->dt ),
+        cy( 0.25 * sp->g->rdz * sp->g->rdx / sp->g->dt ),
+        cz( 0.25 * sp->g->rdx * sp->g->rdy / sp->g->dt ),
+        nx( sp->g->nx ), ny( sp->g->ny ), nz( sp->g->nz ),
+        max_nm( sp->max_nm )
+    {
+        field_sv.reset_except( fa->k_f_d );
+        Kokkos::deep_copy( reserved, k_nm );
+    }
+
+    k_particles_t particles;
+    k_particles_i_t particles_i;
+    k_particle_movers_t movers;
+    k_particle_i_movers_t movers_i;
+    k_particle_copy_t copy;
+    k_particle_i_copy_t copy_i;
+    k_counter_t k_nm;
+    k_counter_t reserved;
+    k_neighbor_t neighbors;
+    k_field_sa_t field_sv;
+    const grid_t * g;
+    int64_t rangel, rangeh;
+    float qsp, cx, cy, cz;
+    int nx, ny, nz, max_nm;
+
+    // Move particle pm.i by pm.disp.  Returns 1 if the particle is now on
+    // the movers, 0 if it finished its move and -1 if there was no mover
+    // left (the particle is not moved).
+    KOKKOS_INLINE_FUNCTION int
+    operator()( particle_mover_t & pm ) const {
+        if( Kokkos::atomic_fetch_add( &reserved(0), 1 ) >= max_nm ) {
+            Kokkos::atomic_fetch_sub( &reserved(0), 1 );
+            return -1;
+        }
+        if( !move_p_kokkos( particles, particles_i, &pm, field_sv, g, neighbors,
+                            rangel, rangeh, qsp, cx, cy, cz, nx, ny, nz ) ) {
+            Kokkos::atomic_fetch_sub( &reserved(0), 1 );
+            return 0;
+        }
+
+        // Every slot taken here was reserved above, so nm < max_nm
+        const int nm = Kokkos::atomic_fetch_add( &k_nm(0), 1 );
+
+        const int pi = pm.i;
+        movers(nm, particle_mover_var::dispx) = pm.dispx;
+        movers(nm, particle_mover_var::dispy) = pm.dispy;
+        movers(nm, particle_mover_var::dispz) = pm.dispz;
+        movers_i(nm) = pi;
+
+        copy(nm, particle_var::dx) = particles(pi, particle_var::dx);
+        copy(nm, particle_var::dy) = particles(pi, particle_var::dy);
+        copy(nm, particle_var::dz) = particles(pi, particle_var::dz);
+        copy(nm, particle_var::ux) = particles(pi, particle_var::ux);
+        copy(nm, particle_var::uy) = particles(pi, particle_var::uy);
+        copy(nm, particle_var::uz) = particles(pi, particle_var::uz);
+        copy(nm, particle_var::w)  = particles(pi, particle_var::w);
+        copy_i(nm) = particles_i(pi);
+        return 1;
+    }
+
+    // Call after the kernel: contributes the currents and updates the
+    // host mover count of sp.
+    void finish( species_t * sp, field_array_t * fa ) {
+        Kokkos::Experimental::contribute( fa->k_f_d, field_sv );
+        Kokkos::deep_copy( sp->k_nm_h, sp->k_nm_d );
+    }
+
+};
+
 // this has no data race protection for write into the accumulators
 template<class particle_view_t, class particle_i_view_t, class neighbor_view_t, class accum_view_t>
 int
@@ -868,35 +1047,29 @@ move_p_kokkos_host_serial(
   return 0; // Return "mover not in use"
 }
 
+// Accumulate the bound charge of a single particle p into k_rhob_accum.
+// k_rhob_accum is anything indexed by voxel, e.g. a host accumulator or
+// an atomic view of the device rhob.
 // TODO: this bascially duplicates funcitonality in rho_p.cc and should be DRY'd
-template<typename kf_t, typename kp_t, typename kpi_t> // k_field_t, k_particles_t, k_particles_i_t
-void k_accumulate_rhob_single_cpu(
-        kf_t& k_rhob_accum,
-        kp_t& kpart,
-        kpi_t& kpart_i,
-        const int i,
-        const grid_t* g,
-        const float qsp
+template<typename kf_t>
+KOKKOS_INLINE_FUNCTION
+void k_accumulate_rhob_single(
+        const kf_t& k_rhob_accum,
+        const particle_t& p,
+        const float qsp,
+        const float r8V,
+        const int nx,
+        const int ny,
+        const int nz,
+        const int sy,
+        const int sz
 )
 {
-    // Extract grid vars
-    const float r8V = g->r8V;
-    const int nx = g->nx;
-    const int ny = g->ny;
-    const int nz = g->nz;
-    const int sy = g->sy;
-    const int sz = g->sz;
-
-    // Kernel
-    //float w0 = p->dx, w1 = p->dy, w2, w3, w4, w5, w6, w7, dz = p->dz;
-    //int v = p->i, x, y, z, sy = g->sy, sz = g->sz;
-    //w7 = (qsp*g->r8V)*p->w;
-    float w0 = kpart(i, particle_var::dx);
-    float w1 = kpart(i, particle_var::dy);
-    float w7 = (qsp * r8V) * kpart(i, particle_var::w);
-    float dz = kpart(i, particle_var::dz);
-    int v = kpart_i(i);
-    //printf("\n Vars are %g, %g, %g %g\n", w0, w1, w7, dz);
+    float w0 = p.dx;
+    float w1 = p.dy;
+    float w7 = (qsp * r8V) * p.w;
+    float dz = p.dz;
+    int v = p.i;
 
     float w6 = w7 - w0 * w7;
     w7 = w7 + w0 * w7;
@@ -954,9 +1127,6 @@ void k_accumulate_rhob_single_cpu(
         w5 += w5;
         w7 += w7;
     }
-    //printf("Absorbing %d into %d for %e %e %e %e %e %e %e %e \n", i, v, w0, w1, w2, w3, w4, w5, w6, w7);
-    // Save the bound charge to an accumulator array to be added to rhob on the
-    // device later
     k_rhob_accum(v) += w0;
     k_rhob_accum(v+1) += w1;
     k_rhob_accum(v+sy) += w2;
@@ -967,4 +1137,27 @@ void k_accumulate_rhob_single_cpu(
     k_rhob_accum(v+sz+sy+1) += w7;
 }
 
+template<typename kf_t, typename kp_t, typename kpi_t> // k_field_t, k_particles_t, k_particles_i_t
+void k_accumulate_rhob_single_cpu(
+        kf_t& k_rhob_accum,
+        kp_t& kpart,
+        kpi_t& kpart_i,
+        const int i,
+        const grid_t* g,
+        const float qsp
+)
+{
+    particle_t p;
+    p.dx = kpart(i, particle_var::dx);
+    p.dy = kpart(i, particle_var::dy);
+    p.dz = kpart(i, particle_var::dz);
+    p.w  = kpart(i, particle_var::w);
+    p.i  = kpart_i(i);
+
+    // Save the bound charge to an accumulator array to be added to rhob on the
+    // device later
+    k_accumulate_rhob_single( k_rhob_accum, p, qsp, g->r8V,
+                              g->nx, g->ny, g->nz, g->sy, g->sz );
+}
+
 #endif // _species_advance_h_
@@ -1184,17 +1184,9 @@ advance_p( /**/  species_t            * RESTRICT sp,
 
   //  printf("nm = %d \n", nm);
 
-  // Copy particle mirror movers back so we have their data safe. Ready for
-  // boundary_p_kokkos
-  auto pc_d_subview = Kokkos::subview(sp->k_pc_d, std::make_pair(0, sp->k_nm_h(0)), Kokkos::ALL);
-  auto pci_d_subview = Kokkos::subview(sp->k_pc_i_d, std::make_pair(0, sp->k_nm_h(0)));
-  auto pc_h_subview = Kokkos::subview(sp->k_pc_h, std::make_pair(0, sp->k_nm_h(0)), Kokkos::ALL);
-  auto pci_h_subview = Kokkos::subview(sp->k_pc_i_h, std::make_pair(0, sp->k_nm_h(0)));
-
-  Kokkos::deep_copy(pc_h_subview, pc_d_subview);
-  Kokkos::deep_copy(pci_h_subview, pci_d_subview);
-  //  Kokkos::deep_copy(sp->k_pc_h, sp->k_pc_d);
-  //  Kokkos::deep_copy(sp->k_pc_i_h, sp->k_pc_i_d);
+  // The mover copies (and their tracer ids) are copied to the host by
+  // copy_outbound_to_host, after the device boundary conditions have had
+  // their go at them.
 
   KOKKOS_TOC( PARTICLE_DATA_MOVEMENT, 1);
 }
@@ -146,6 +146,44 @@ center_p_pipeline_v4( center_p_pipeline_args_t * args,
 
 #endif
 
+void center_p_kokkos(
+        const Kokkos::DefaultExecutionSpace& exec,
+        const k_particles_t& k_particles,
+        const k_particles_i_t& k_particles_i,
+        const k_interpolator_t& k_interp,
+        const k_particle_dump_t& k_out,
+        int first,
+        int n,
+        float qdt_2mc
+)
+{
+  // this goes over [first, first+n) using p_index, writing k_out(0:n)
+  Kokkos::parallel_for("center p", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (exec, 0, n), KOKKOS_LAMBDA (int out_index) {
+
+    const int p_index = first + out_index;
+    const int ii   = k_particles_i(p_index);
+    const float dx = k_particles(p_index, particle_var::dx);
+    const float dy = k_particles(p_index, particle_var::dy);
+    const float dz = k_particles(p_index, particle_var::dz);
+    float ux = k_particles(p_index, particle_var::ux);
+    float uy = k_particles(p_index, particle_var::uy);
+    float uz = k_particles(p_index, particle_var::uz);
+
+    center_momentum(k_interp, ii, dx, dy, dz, ux, uy, uz, qdt_2mc);
+
+    particle_t & p = k_out(out_index);       // Store centered copy
+    p.dx = dx;
+    p.dy = dy;
+    p.dz = dz;
+    p.i  = ii;
+    p.ux = ux;
+    p.uy = uy;
+    p.uz = uz;
+    p.w  = k_particles(p_index, particle_var::w);
+  });
+}
+
 void
 center_p( /**/  species_t            * RESTRICT sp,
           const interpolator_array_t * RESTRICT ia ) {
@@ -0,0 +1,206 @@
+#include "tracer.h"
+#include "../util/io/FileIO.h"
+
+#include <vector>
+
+#define BUFLEN (256)
+
+// Number of ids each rank may hand out
+#define TRACER_IDS_PER_RANK ( (int64_t)1 << 40 )
+
+/* Private interface *********************************************************/
+
+// Append samples of the tracers of sp to k_buf_d, starting at record first.
+// Returns the number of tracers; the samples are only stored if all of
+// them fit.
+
+static size_t
+gather_tracers( tracer_t * tracer,
+                const interpolator_array_t * ia,
+                int64_t step,
+                size_t first )
+{
+  const species_t * sp = tracer->sp;
+  const selected_particle_builder record( sp, ia );
+  const auto& particle_ids = sp->k_p_id_d;
+  const auto& k_buf = tracer->k_buf_d;
+  const size_t capacity = k_buf.extent(0);
+  const int32_t sample_step = (int32_t)step;
+
+  size_t n = 0;
+  Kokkos::parallel_scan("gather tracers", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, sp->np), KOKKOS_LAMBDA (const int p_index, size_t & offset, const bool final) {
+    const int64_t id = particle_ids(p_index);
+    if( !id ) return;
+    if( final && first+offset<capacity ) {
+      const selected_particle_t p = record( p_index );
+      tracer_record_t & r = k_buf(first+offset);
+      r.id   = id;
+      r.step = sample_step;
+      r.x  = p.x;  r.y  = p.y;  r.z  = p.z;
+      r.ux = p.ux; r.uy = p.uy; r.uz = p.uz;
+      r.w  = p.w;
+    }
+    offset++;
+  }, n);
+
+  return n;
+}
+
+void
+checkpt_tracer( tracer_t * tracer ) {
+  // Flush the buffer to disk so we don't have to save it (the device
+  // buffer does not survive a restore anyway).
+  flush_tracers( tracer );
+  CHECKPT( tracer, 1 );
+  CHECKPT_STR( tracer->fname );
+  // The host ids are current, checkpt copies the particles to the host
+  checkpt_data( tracer->sp->k_p_id_h.data(), sizeof(int64_t), sizeof(int64_t),
+                tracer->sp->np, tracer->sp->np, 0 );
+  CHECKPT_PTR( tracer->sp );
+}
+
+tracer_t *
+restore_tracer( void ) {
+  tracer_t * tracer;
+  RESTORE( tracer );
+  RESTORE_STR( tracer->fname );
+  tracer->restored_ids = (int64_t *)restore_data();
+  RESTORE_PTR( tracer->sp );
+  return tracer;
+}
+
+/* Public interface **********************************************************/
+
+tracer_t *
+new_tracer( species_t * sp,
+            const char * fbase,
+            int interval,
+            size_t buffer_records ) {
+  tracer_t * tracer;
+
+  if( !sp ) ERROR(( "NULL species" ));
+  if( !fbase ) ERROR(( "NULL tracer file base" ));
+  if( sp->tracer ) ERROR(( "Species \"%s\" already has tracers", sp->name ));
+  if( interval<1 ) ERROR(( "Tracer interval must be positive" ));
+  if( buffer_records<1 ) buffer_records = 1;
+
+  MALLOC( tracer, 1 );
+  CLEAR( tracer, 1 );
+  new(&tracer->k_buf_d) k_tracer_records_t();
+
+  MALLOC( tracer->fname, BUFLEN );
+  CLEAR( tracer->fname, BUFLEN );
+  snprintf( tracer->fname, BUFLEN, "%s.%i", fbase, world_rank );
+
+  tracer->sp           = sp;
+  tracer->interval     = interval;
+  tracer->next_id      = world_rank*TRACER_IDS_PER_RANK + 1;
+  tracer->max_buffered = buffer_records;
+  tracer->n_buffered   = 0;
+  tracer->n_written    = 0;
+  tracer->restored_ids = NULL;
+  tracer->k_buf_d      = k_tracer_records_t( "k_tracer_records", buffer_records );
+
+  sp->init_kokkos_particle_ids();
+  sp->tracer = tracer;
+
+  REGISTER_OBJECT( tracer, checkpt_tracer, restore_tracer, NULL );
+  return tracer;
+}
+
+void
+delete_tracer( tracer_t * tracer ) {
+  if( !tracer ) return;
+  flush_tracers( tracer );
+  UNREGISTER_OBJECT( tracer );
+  tracer->k_buf_d = k_tracer_records_t();
+  FREE( tracer->restored_ids );
+  FREE( tracer->fname );
+  FREE( tracer );
+}
+
+void
+restore_tracer_kokkos( tracer_t * tracer ) {
+  species_t * sp = tracer->sp;
+
+  // See restore_kokkos for why the view is constructed in place
+  new(&tracer->k_buf_d) k_tracer_records_t();
+  tracer->k_buf_d = k_tracer_records_t( "k_tracer_records", tracer->max_buffered );
+
+  sp->init_kokkos_particle_ids();
+  for( int n=0; n<sp->np; n++ ) sp->k_p_id_h(n) = tracer->restored_ids[n];
+  FREE( tracer->restored_ids );
+  tracer->restored_ids = NULL;
+}
+
+void
+resume_tracer_ids( tracer_t * tracer ) {
+  if( !tracer ) ERROR(( "NULL tracer" ));
+  const species_t * sp = tracer->sp;
+
+  // Largest offset in any rank's range among the ids in use here
+  int64_t used = 0;
+  for( int n=0; n<sp->np; n++ ) {
+    const int64_t id = sp->k_p_id_h(n);
+    if( id && id%TRACER_IDS_PER_RANK>used ) used = id%TRACER_IDS_PER_RANK;
+  }
+
+  std::vector<int64_t> all( world_size );
+  mp_allgather_i64( &used, all.data(), 1 );
+  for( int r=0; r<world_size; r++ ) if( all[r]>used ) used = all[r];
+
+  const int64_t next_id = world_rank*TRACER_IDS_PER_RANK + used + 1;
+  if( next_id>tracer->next_id ) tracer->next_id = next_id;
+}
+
+void
+record_tracers( tracer_t * tracer,
+                const interpolator_array_t * ia,
+                int64_t step ) {
+  if( !tracer || !ia ) ERROR(( "Bad args" ));
+
+  size_t n = gather_tracers( tracer, ia, step, tracer->n_buffered );
+  if( tracer->n_buffered+n<=tracer->k_buf_d.extent(0) ) {
+    tracer->n_buffered += n;
+    return;
+  }
+
+  // The sample did not fit.  Make room and take it again.
+  flush_tracers( tracer );
+  if( n>tracer->k_buf_d.extent(0) ) {
+    WARNING(( "Growing the tracer buffer of species \"%s\" to %lu records",
+              tracer->sp->name, (unsigned long)n ));
+    tracer->k_buf_d = k_tracer_records_t( "k_tracer_records", n );
+    tracer->max_buffered = n;
+  }
+  tracer->n_buffered = gather_tracers( tracer, ia, step, 0 );
+}
+
+void
+flush_tracers( tracer_t * tracer ) {
+  if( !tracer || !tracer->n_buffered ) return;
+
+  auto k_records = Kokkos::subview( tracer->k_buf_d,
+                                    std::make_pair( size_t(0), tracer->n_buffered ) );
+  auto h_records = Kokkos::create_mirror_view_and_copy( KOKKOS_PINNED_SPACE(), k_records );
+
+  FileIO fileIO;
+  FileIOStatus status;
+
+  if( tracer->n_written ) {
+    status = fileIO.open( tracer->fname, io_read_write );
+    if( status==fail ) ERROR(( "Could not open \"%s\".", tracer->fname ));
+    // After a restart, overwrite anything written past the checkpoint
+    fileIO.seek( tracer->n_written*sizeof(tracer_record_t), SEEK_SET );
+  } else {
+    status = fileIO.open( tracer->fname, io_write );
+    if( status==fail ) ERROR(( "Could not open \"%s\".", tracer->fname ));
+  }
+
+  fileIO.write( h_records.data(), tracer->n_buffered );
+  fileIO.close();
+
+  tracer->n_written += tracer->n_buffered;
+  tracer->n_buffered = 0;
+}
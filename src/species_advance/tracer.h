@@ -0,0 +1,123 @@
+#ifndef _tracer_h_
+#define _tracer_h_
+
+#include "particle_select.h"
+
+// Tracer particles carry a nonzero 64-bit id in the species id column
+// (species_t::k_p_id_d).  The id follows the particle through sorting,
+// compression and the boundary_p exchange, so the tracers can be sampled
+// on the device every few steps without matching up full dumps.
+//
+// Ids are unique across ranks: rank r hands out r*2^40+1, r*2^40+2, ...
+
+typedef struct tracer_record {
+  int64_t id;       // Tracer id
+  int32_t step;     // Step the sample was taken on
+  float x, y, z;    // Global position
+  float ux, uy, uz; // Time-centered normalized momentum
+  float w;          // Particle weight (number of physical particles)
+} tracer_record_t;
+
+using k_tracer_records_t = Kokkos::View<tracer_record_t*>;
+
+class tracer_t {
+    public:
+
+        species_t * sp;          // Traced species
+        char * fname;            // Output file of this rank
+        int interval;            // Steps between samples
+        int64_t next_id;         // Next local id handed out by tag_tracers
+        size_t max_buffered;     // Capacity of the device buffer
+        size_t n_buffered;       // Records waiting in the device buffer
+        size_t n_written;        // Records already in the output file
+        int64_t * restored_ids;  // Ids read back by restore_tracer
+
+        //// END CHECKPOINTED DATA, START KOKKOS //////
+
+        k_tracer_records_t k_buf_d; // Device buffer of samples awaiting a flush
+
+};
+
+// In tracer.cc
+
+// Allocate the tracer id column of sp and a device buffer holding up to
+// buffer_records samples.  Samples of all tracers are taken every
+// interval steps and appended to "fbase.<rank>" whenever the buffer
+// fills (and at checkpoints).  Must be called on every rank.
+
+tracer_t *
+new_tracer( species_t * sp,
+            const char * fbase,
+            int interval,
+            size_t buffer_records );
+
+void
+delete_tracer( tracer_t * tracer );
+
+void
+checkpt_tracer( tracer_t * tracer );
+
+tracer_t *
+restore_tracer( void );
+
+// Rebuild the device buffer of a restored tracer and refill the species
+// id column.  Called by restore_kokkos before the particles are copied to
+// the device.
+
+void
+restore_tracer_kokkos( tracer_t * tracer );
+
+// Continue the ids this rank hands out past every id in the host id
+// column of any rank.  Particles restored with ids from another
+// decomposition (see portable_restart.cc) can carry ids from any old
+// rank's range.  Must be called on every rank.
+
+void
+resume_tracer_ids( tracer_t * tracer );
+
+// Append a sample of every local tracer to the device buffer.  The
+// interpolator must be loaded for the current fields.
+
+void
+record_tracers( tracer_t * tracer,
+                const interpolator_array_t * ia,
+                int64_t step );
+
+// Write the buffered samples to the output file.
+
+void
+flush_tracers( tracer_t * tracer );
+
+// Give fresh ids to the untracked particles passing selection and
+// predicate (see particle_select.h).  The ids handed out on a rank run
+// on from the last one without gaps, whatever was already tracked.
+// Returns the number of particles tagged on this rank.
+
+template<class Predicate>
+int
+tag_tracers( tracer_t * tracer,
+             const interpolator_array_t * ia,
+             const ParticleSelection & selection,
+             const Predicate & predicate )
+{
+  int n_selected, n_tagged = 0;
+  Kokkos::View<int*> k_index = select_particle_indices( tracer->sp, ia, selection,
+                                                        predicate, n_selected );
+
+  const auto& particle_ids = tracer->sp->k_p_id_d;
+  const int64_t first_id = tracer->next_id;
+
+  // Only the selected particles not tracked yet take an id
+  Kokkos::parallel_scan("tag tracers", Kokkos::RangePolicy < Kokkos::DefaultExecutionSpace >
+      (0, n_selected), KOKKOS_LAMBDA (const int n, int & offset, const bool final) {
+    const int p_index = k_index(n);
+    if( particle_ids(p_index) ) return;
+    if( final ) particle_ids(p_index) = first_id + offset;
+    offset++;
+  }, n_tagged);
+
+  tracer->next_id += n_tagged;
+  return n_tagged;
+}
+
+#endif // _tracer_h_
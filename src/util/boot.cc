@@ -1,8 +1,15 @@
 #include "util.h"
+#include "io/FileUtils.h"
 #include "git_version.h"
 
 #include <iostream>
+#include <vector>
+#include <stdio.h>
 #include <omp.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 double _boot_timestamp = 0;
 
@@ -13,6 +20,70 @@ uptime( void ) {
   return time_sum/(double)world_size - _boot_timestamp;
 }
 
+#ifdef __linux__
+
+// The cpus of NUMA domain node (none if there is no such domain)
+
+static std::vector<int>
+numa_cpus( int node ) {
+  std::vector<int> cpus;
+  char fname[128];
+  int a, b, c;
+  sprintf( fname, "/sys/devices/system/node/node%i/cpulist", node );
+  FILE * f = fopen( fname, "r" );
+  if( !f ) return cpus;
+  while( fscanf( f, "%d", &a )==1 ) { // e.g. "0-15,32-47"
+    b = a, c = fgetc( f );
+    if( c=='-' ) {
+      if( fscanf( f, "%d", &b )!=1 ) break;
+      c = fgetc( f );
+    }
+    for( ; a<=b; a++ ) cpus.push_back( a );
+    if( c!=',' ) break;
+  }
+  fclose( f );
+  return cpus;
+}
+
+#endif
+
+// Bind the ranks on a node to its NUMA domains in turn (launch one rank
+// per socket) and pin the threads of each to the cpus of its domain.
+// With the threads staying put, the first touch of the views (see
+// first_touch_view) places their pages next to the threads using them.
+
+static void
+bind_rank_per_socket( void ) {
+#ifdef __linux__
+  int rank, size, n_node = 0, t;
+  mp_node_rank( &rank, &size );
+  while( !numa_cpus( n_node ).empty() ) n_node++;
+  if( !n_node ) {
+    if( world_rank==0 ) WARNING(( "No NUMA domains found; --rank-per-socket ignored" ));
+    return;
+  }
+  if( size!=n_node && world_rank==0 )
+    WARNING(( "%i ranks on a node with %i NUMA domains", size, n_node ));
+
+  const std::vector<int> cpus = numa_cpus( rank % n_node );
+  cpu_set_t set;
+  CPU_ZERO( &set );
+  for( t=0; t<(int)cpus.size(); t++ ) CPU_SET( cpus[t], &set );
+  if( sched_setaffinity( 0, sizeof(set), &set ) )
+    WARNING(( "Could not bind rank %i to NUMA domain %i", world_rank, rank % n_node ));
+
+# pragma omp parallel
+  {
+    cpu_set_t one;
+    CPU_ZERO( &one );
+    CPU_SET( cpus[ omp_get_thread_num() % cpus.size() ], &one );
+    sched_setaffinity( 0, sizeof(one), &one ); // The calling thread
+  }
+#else
+  if( world_rank==0 ) WARNING(( "--rank-per-socket needs Linux; ignored" ));
+#endif
+}
+
 void
 boot_services( int * pargc,
                char *** pargv )
@@ -36,6 +107,20 @@ boot_services( int * pargc,
 
     boot_mp( pargc, pargv );
 
+    // Each member of an ensemble runs in its own directory (relative
+    // paths on the command line and in the deck are relative to it)
+
+    if( mp_ensemble_size()>1 )
+    {
+        char dname[64];
+        sprintf( dname, "ensemble.%i", mp_ensemble_member() );
+        if( world_rank==0 ) FileUtils::makeDirectory( dname );
+        mp_barrier();
+        if( chdir( dname ) ) ERROR(( "Could not enter \"%s\"", dname ));
+    }
+
+    const int rank_per_socket = strip_cmdline( pargc, pargv, "--rank-per-socket" );
+
     // Set the boot_timestamp
     mp_barrier();
     _boot_timestamp = 0;
@@ -74,6 +159,8 @@ boot_services( int * pargc,
 
     omp_set_num_threads(thread.n_pipeline);
 
+    if( rank_per_socket ) bind_rank_per_socket();
+
     // TODO: move this into a specific run outputter class
     if (world_rank == 0)
     {
@@ -82,6 +169,9 @@ boot_services( int * pargc,
         std::cout << "# VPIC Git Hash: "  << GIT_REVISION << std::endl;
         std::cout << "# Built on: "  << BUILD_TIMESTAMP << std::endl;
         std::cout << "# MPI Ranks: " << _world_size << std::endl;
+        if( mp_ensemble_size()>1 )
+            std::cout << "# Ensemble Member: " << mp_ensemble_member()
+                      << " of " << mp_ensemble_size() << std::endl;
         std::cout << "# Threads: " << thread.n_pipeline << std::endl;
 
         std::cout << "######### End Run Details ########" << std::endl;
@@ -11,6 +11,9 @@
 #define IN_checkpt
 #include "checkpt_private.h"
 
+#include <thread>
+#include <atomic>
+
 /* Boolean flag indicating whether or not checkpoint is booted. */
 
 static int booted = 0;
@@ -22,6 +25,98 @@ static int booted = 0;
 static checkpt_t * checkpt = NULL;
 static checkpt_t * restore = NULL;
 
+/* Host memory stream an asynchronous checkpt is serialized to.  While
+   checkpt_objects_async is serializing, checkpt is NULL and staging is
+   the stream.  Once serialized, the stream is handed to the flush
+   thread; flushing is cleared by that thread when the stream is on
+   disk.
+
+   The stream is a list of chunks, each twice the size of the previous
+   up to stream_max_chunk, so it is never copied as it grows and holds
+   at most one partly filled chunk beyond the image. */
+
+typedef struct checkpt_chunk {
+  char * data;
+  size_t n, max;
+  struct checkpt_chunk * next;
+} checkpt_chunk_t;
+
+typedef struct checkpt_stream {
+  checkpt_chunk_t * head, * tail;
+  size_t n;
+  char name[256];
+} checkpt_stream_t;
+
+static const size_t stream_min_chunk = (size_t)1<<20;
+static const size_t stream_max_chunk = (size_t)1<<26;
+
+static checkpt_stream_t * staging = NULL;
+
+/* Host memory stream being restored from (restore_objects_mem) */
+
+static const char * unstaging = NULL;
+static size_t unstaging_n = 0, unstaging_at = 0;
+static std::thread flusher;
+static std::atomic<int> flushing( 0 );
+
+#define WRITING ( checkpt || staging   )
+#define READING ( restore || unstaging )
+
+static void
+stream_write( checkpt_stream_t * s,
+              const void * _data,
+              size_t n_byte ) {
+  const char * data = (const char *)_data;
+  s->n += n_byte;
+  while( n_byte ) {
+    checkpt_chunk_t * c = s->tail;
+    if( !c || c->n==c->max ) {
+      size_t max = c ? 2*c->max : stream_min_chunk;
+      if( max>stream_max_chunk ) max = stream_max_chunk;
+      MALLOC( c, 1 );
+      MALLOC( c->data, max );
+      c->n    = 0;
+      c->max  = max;
+      c->next = NULL;
+      if( s->tail ) s->tail->next = c;
+      else          s->head       = c;
+      s->tail = c;
+    }
+    size_t n = c->max - c->n;
+    if( n>n_byte ) n = n_byte;
+    memcpy( c->data + c->n, data, n );
+    c->n += n, data += n, n_byte -= n;
+  }
+}
+
+/* Pass the stream in order to the file out and / or the buffer mem
+   (either may be NULL), freeing each chunk once it is passed, then
+   free the stream */
+
+static void
+stream_drain( checkpt_stream_t * s,
+              checkpt_t * out,
+              char * mem ) {
+  checkpt_chunk_t * c = s->head;
+  while( c ) {
+    checkpt_chunk_t * next = c->next;
+    if( out ) checkpt_write( out, c->data, c->n );
+    if( mem ) memcpy( mem, c->data, c->n ), mem += c->n;
+    FREE( c->data );
+    FREE( c );
+    c = next;
+  }
+  FREE( s );
+}
+
+static void
+flush_stream( checkpt_stream_t * s ) {
+  checkpt_t * out = checkpt_open_wronly( s->name );
+  stream_drain( s, out, NULL );
+  checkpt_close( out );
+  flushing = 0;
+}
+
 /* The registry is a list of objects that need to checkpointed (in the
    order they should be checkpointed).  The registry gives each object
    a unique identifier that is invariant across a checkpt/restore and
@@ -105,6 +200,12 @@ boot_checkpt( int * pargc,
   restore  = NULL;
   next_id  = 1;
 
+  /* Decks commonly exit right after a checkpt; do not lose one in
+     flight (this also runs before flusher is destroyed) */
+
+  static int wait_at_exit = 0;
+  if( !wait_at_exit ) atexit( checkpt_wait ), wait_at_exit = 1;
+
   /* Mark the service as booted */
 
   booted = 1;
@@ -116,12 +217,13 @@ halt_checkpt( void ) {
   /* Check input args */
 
   if( !booted  ) ERROR(( "checkpt service not booted." ));
+  checkpt_wait();
   if( registry ) {
     dump_registry();
     ERROR(( "halt called with some objects still registered" ));
   }
-  if( checkpt  ) ERROR(( "currently writing a checkpt" ));
-  if( restore  ) ERROR(( "currently reading a checkpt" ));
+  if( WRITING  ) ERROR(( "currently writing a checkpt" ));
+  if( READING  ) ERROR(( "currently reading a checkpt" ));
 
   /* Mark the service as halted */
 
@@ -174,8 +276,8 @@ register_object( void * obj,
   /* Check input args */
 
   if( !booted ) ERROR(( "checkpt service not booted" ));
-  if( checkpt ) ERROR(( "currently writing a checkpt" ));
-  if( restore ) ERROR(( "currently reading a checkpt" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
 
   /* Check that obj is valid and that obj isn't already registered.
      At the same time, find the last entry in the registry. */
@@ -208,8 +310,8 @@ unregister_object( void * obj ) {
   /* Check input args */
 
   if( !booted ) ERROR(( "checkpt service not booted" ));
-  if( checkpt ) ERROR(( "currently writing a checkpt" ));
-  if( restore ) ERROR(( "currently reading a checkpt" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
 
   /* Find the entry for this object in the register and the previous
      entry.  If the object is not registered, return an error */
@@ -229,19 +331,12 @@ unregister_object( void * obj ) {
   FREE( node );
 }
 
-void
-checkpt_objects( const char * name ) {
-  registry_t * node;
-
-  /* Check input args */
-
-  if( !booted ) ERROR(( "checkpt not booted" ));
-  if( checkpt ) ERROR(( "currently writing a checkpt" ));
-  if( restore ) ERROR(( "currently reading a checkpt" ));
+/* Serialize the registry to the open checkpt stream */
 
-  /* Open the checkpt serialization stream */
+static void
+checkpt_registry( void ) {
+  registry_t * node;
 
-  checkpt = checkpt_open_wronly( name );
   CHECKPT_VAL( size_t, next_id );
 
   /* Checkpoint the objects */
@@ -256,25 +351,80 @@ checkpt_objects( const char * name ) {
     if( node->checkpt_func ) node->checkpt_func( node->obj );
   }
 
-  /* Mark that there are no more objects in the stream, close the
-     serialization stream and indicate that we are no longer writing a
-     checkpt */
-  
+  /* Mark that there are no more objects in the stream */
+
   CHECKPT_VAL( size_t, 0xBADF00D );
+}
+
+void
+checkpt_objects( const char * name ) {
+
+  /* Check input args */
+
+  if( !booted ) ERROR(( "checkpt not booted" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
+
+  /* Wait for any checkpt in flight (it might have the same name) */
+
+  checkpt_wait();
+
+  /* Open the checkpt serialization stream */
+
+  checkpt = checkpt_open_wronly( name );
+  checkpt_registry();
+
+  /* Close the serialization stream and indicate that we are no longer
+     writing a checkpt */
+  
   checkpt_close( checkpt );
   checkpt = NULL;
 }
 
 void
-restore_objects( const char * name ) {
-  registry_t * node, * prev;
-  size_t prefix;
+checkpt_objects_async( const char * name ) {
 
   /* Check input args */
 
   if( !booted ) ERROR(( "checkpt not booted" ));
-  if( checkpt ) ERROR(( "currently writing a checkpt" ));
-  if( restore ) ERROR(( "currently reading a checkpt" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
+  if( !name ) ERROR(( "NULL name" ));
+  if( strlen( name )>=sizeof(staging->name) ) ERROR(( "checkpt name too long" ));
+
+  checkpt_wait();
+
+  /* Snapshot the objects to host memory */
+
+  MALLOC( staging, 1 );
+  CLEAR( staging, 1 );
+  strcpy( staging->name, name );
+  checkpt_registry();
+
+  /* And hand the snapshot to the flush thread */
+
+  checkpt_stream_t * s = staging;
+  staging  = NULL;
+  flushing = 1;
+  flusher  = std::thread( flush_stream, s );
+}
+
+void
+checkpt_wait( void ) {
+  if( flusher.joinable() ) flusher.join();
+}
+
+int
+checkpt_in_flight( void ) {
+  return flushing;
+}
+
+/* Replace the registry with the one in the open restore stream */
+
+static void
+restore_registry( void ) {
+  registry_t * node, * prev;
+  size_t prefix;
 
   /* Delete all objects in the in favor of the checkpointed objects */
 
@@ -287,9 +437,6 @@ restore_objects( const char * name ) {
   registry = NULL;
   next_id = 0;
 
-  /* Open the checkpt deserialization stream */
-
-  restore = checkpt_open_rdonly( name );
   RESTORE_VAL( size_t, next_id );
 
   /* Restore the objects */
@@ -312,6 +459,25 @@ restore_objects( const char * name ) {
     dump_node( node );
     if( node->restore_func ) node->obj = node->restore_func();
   }
+}
+
+void
+restore_objects( const char * name ) {
+
+  /* Check input args */
+
+  if( !booted ) ERROR(( "checkpt not booted" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
+
+  /* A checkpt in flight might be the one being restored */
+
+  checkpt_wait();
+
+  /* Open the checkpt deserialization stream and restore */
+
+  restore = checkpt_open_rdonly( name );
+  restore_registry();
 
   /* Close the checkpt deserialization stream and indicate that we are
      no longer reading a checkpt */
@@ -320,6 +486,50 @@ restore_objects( const char * name ) {
   restore = NULL;
 }
 
+/* In memory checkpt / restore (used by the buddy checkpt) */
+
+void
+checkpt_objects_mem( char ** data,
+                     size_t * n ) {
+
+  /* Check input args */
+
+  if( !booted ) ERROR(( "checkpt not booted" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
+  if( !data || !n ) ERROR(( "Bad args" ));
+
+  MALLOC( staging, 1 );
+  CLEAR( staging, 1 );
+  checkpt_registry();
+
+  checkpt_stream_t * s = staging;
+  staging = NULL;
+  *n = s->n;
+  MALLOC( *data, s->n ? s->n : 1 );
+  stream_drain( s, NULL, *data );
+}
+
+void
+restore_objects_mem( const char * data,
+                     size_t n ) {
+
+  /* Check input args */
+
+  if( !booted ) ERROR(( "checkpt not booted" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
+  if( !data ) ERROR(( "NULL data" ));
+
+  checkpt_wait();
+
+  unstaging = data, unstaging_n = n, unstaging_at = 0;
+  restore_registry();
+  if( unstaging_at!=unstaging_n )
+    ERROR(( "Malformed checkpt (trailing data)" ));
+  unstaging = NULL;
+}
+
 void
 reanimate_objects( void ) {
   registry_t * node;
@@ -327,8 +537,8 @@ reanimate_objects( void ) {
   /* Check input args */
 
   if( !booted ) ERROR(( "checkpt not booted" ));
-  if( checkpt ) ERROR(( "currently writing a checkpt" ));
-  if( restore ) ERROR(( "currently reading a checkpt" ));
+  if( WRITING ) ERROR(( "currently writing a checkpt" ));
+  if( READING ) ERROR(( "currently reading a checkpt" ));
 
   /* Call each objects reanimate function */
 
@@ -346,12 +556,14 @@ checkpt_raw( const void * data,
 
   /* Check input args */
 
-  if( !checkpt ) ERROR(( "not writing a checkpt" ));
+  if( !WRITING ) ERROR(( "not writing a checkpt" ));
   if( !data && n_byte ) ERROR(( "NULL data" ));
 
   /* Write data to the serialization stream */
 
-  if( n_byte ) checkpt_write( checkpt, data, n_byte );
+  if( !n_byte ) return;
+  if( staging ) stream_write( staging, data, n_byte );
+  else          checkpt_write( checkpt, data, n_byte );
 }
 
 void
@@ -360,12 +572,19 @@ restore_raw( void * data,
 
   /* Check input args */
 
-  if( !restore ) ERROR(( "not reading a checkpt" ));
+  if( !READING ) ERROR(( "not reading a checkpt" ));
   if( !data && n_byte ) ERROR(( "NULL data" ));
 
   /* Read data from the deserialization stream */
 
-  if( n_byte ) checkpt_read( restore, data, n_byte );
+  if( !n_byte ) return;
+  if( unstaging ) {
+    if( n_byte > unstaging_n - unstaging_at )
+      ERROR(( "Malformed checkpt (truncated)" ));
+    memcpy( data, unstaging + unstaging_at, n_byte );
+    unstaging_at += n_byte;
+  }
+  else checkpt_read( restore, data, n_byte );
 }
 
 /* Composiite checkpt helpers */
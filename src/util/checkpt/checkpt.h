@@ -101,6 +101,47 @@ checkpt_objects( const char * name );
 void
 restore_objects( const char * name );
 
+/* Asynchronous checkpt.  checkpt_objects_async serializes all objects
+   to a host memory stream (the checkpt functions run as usual, so this
+   is a snapshot of the objects at the time of the call) and returns as
+   soon as the snapshot is complete.  The stream is written to the
+   checkpt with the given name by a background thread.  Only one
+   checkpt can be in flight at a time; checkpt_objects,
+   checkpt_objects_async, restore_objects and halt_checkpt wait for the
+   previous one to finish.  The snapshot costs as much host memory as
+   the checkpt itself.  checkpt_wait blocks until no checkpt is in
+   flight and checkpt_in_flight polls. */
+
+void
+checkpt_objects_async( const char * name );
+
+void
+checkpt_wait( void );
+
+int
+checkpt_in_flight( void );
+
+/* Buddy checkpt.  checkpt_objects_buddy serializes all objects to
+   memory, mirrors the image to the next rank over MPI and writes this
+   rank's image and the previous rank's mirror to name.<rank> and
+   name.<rank-1>.buddy.  name should be on node local storage
+   (preferably a memory backed file system like /dev/shm) so this is
+   much faster than a checkpt to a parallel file system; it is
+   collective.  restore_objects_buddy restores all objects from the
+   buddy checkpt with the given name, taking the image of a rank that
+   lost its own from the rank that holds its mirror.  The rank lost
+   (-1 for none) ignores its images, which simulates the replacement of
+   a node for testing.  It returns 0 without restoring anything if a
+   rank and its buddy both lost their images, in which case the caller
+   should fall back to a file system checkpt.  It is collective. */
+
+void
+checkpt_objects_buddy( const char * name );
+
+int
+restore_objects_buddy( const char * name,
+                       int lost );
+
 /* Call the reanimate functions on all objects.  This is typically
    done after the restore process. */
 
@@ -0,0 +1,162 @@
+/* Buddy checkpt.  Each rank serializes its objects to memory, swaps the
+   image with its partner over MPI (rank r keeps the image of r-1 and
+   r+1 keeps the image of r) and writes both images to node local
+   storage (name should be on a node local file system, ideally a
+   memory backed one like /dev/shm):
+
+     name.<rank>             the image of this rank
+     name.<rank-1>.buddy     the image of the previous rank
+
+   A lost rank (e.g. its node was replaced) is recovered from the buddy
+   image held by the next rank.  The job is lost only if a rank and its
+   successor both lose their storage, in which case the caller falls
+   back to a file system checkpt. */
+
+#define IN_checkpt
+#include "checkpt_private.h"
+#include "../mp/mp.h"
+
+#include <stdio.h>
+
+#define BUDDY_MAGIC 0xB0DDC4E7
+
+/* Write a buffer atomically (an interrupted write leaves the previous
+   image in place) */
+
+static void
+write_image( const char * fname,
+             const char * data,
+             size_t n ) {
+  char tmp[512];
+  size_t head[2] = { BUDDY_MAGIC, n };
+  checkpt_t * out;
+
+  if( snprintf( tmp, sizeof(tmp), "%s.tmp", fname )>=(int)sizeof(tmp) )
+    ERROR(( "Buddy checkpt name too long" ));
+  out = checkpt_open_wronly( tmp );
+  checkpt_write( out, head, sizeof(head) );
+  checkpt_write( out, data, n );
+  checkpt_close( out );
+  if( rename( tmp, fname ) ) ERROR(( "Unable to rename \"%s\"", tmp ));
+}
+
+/* Returns NULL if there is no valid image */
+
+static char *
+read_image( const char * fname,
+            size_t * n ) {
+  size_t head[2];
+  char * data;
+  checkpt_t * in;
+  FILE * f = fopen( fname, "rb" );
+
+  if( !f ) return NULL;
+  fclose( f );
+  in = checkpt_open_rdonly( fname );
+  checkpt_read( in, head, sizeof(head) );
+  if( head[0]!=BUDDY_MAGIC ) {
+    checkpt_close( in );
+    WARNING(( "\"%s\" is not a buddy checkpt image", fname ));
+    return NULL;
+  }
+  MALLOC( data, head[1] ? head[1] : 1 );
+  checkpt_read( in, data, head[1] );
+  checkpt_close( in );
+  *n = head[1];
+  return data;
+}
+
+/* Exchange sizes, then data, around the ring */
+
+static void
+ring_exchange( const char * sbuf, size_t n_send, int dst,
+               char ** rbuf, size_t * n_recv, int src ) {
+  uint64_t ns = n_send, nr = 0;
+  mp_sendrecv_uc( (const unsigned char *)&ns, sizeof(ns), dst,
+                  (unsigned char *)&nr, sizeof(nr), src );
+  MALLOC( *rbuf, nr ? nr : 1 );
+  mp_sendrecv_uc( (const unsigned char *)sbuf, n_send, dst,
+                  (unsigned char *)*rbuf, nr, src );
+  *n_recv = nr;
+}
+
+void
+checkpt_objects_buddy( const char * name ) {
+  char fname[512], * own, * copy;
+  size_t n_own, n_copy;
+  const int next = (world_rank+1)%world_size;
+  const int prev = (world_rank+world_size-1)%world_size;
+
+  if( !name ) ERROR(( "NULL name" ));
+
+  checkpt_objects_mem( &own, &n_own );
+
+  snprintf( fname, sizeof(fname), "%s.%i", name, world_rank );
+  write_image( fname, own, n_own );
+
+  if( world_size>1 ) {
+    ring_exchange( own, n_own, next, &copy, &n_copy, prev );
+    snprintf( fname, sizeof(fname), "%s.%i.buddy", name, prev );
+    write_image( fname, copy, n_copy );
+    FREE( copy );
+  }
+
+  FREE( own );
+}
+
+int
+restore_objects_buddy( const char * name,
+                       int lost ) {
+  char fname[512], * own = NULL, * copy = NULL, * recv = NULL;
+  size_t n_own = 0, n_copy = 0, n_recv = 0;
+  const int next = (world_rank+1)%world_size;
+  const int prev = (world_rank+world_size-1)%world_size;
+  int have[2], * all, r, ok;
+
+  if( !name ) ERROR(( "NULL name" ));
+
+  /* Find the images this rank still has (a rank that is told it was
+     lost ignores its storage, which simulates a replaced node) */
+
+  if( world_rank!=lost ) {
+    snprintf( fname, sizeof(fname), "%s.%i", name, world_rank );
+    own = read_image( fname, &n_own );
+    if( world_size>1 ) {
+      snprintf( fname, sizeof(fname), "%s.%i.buddy", name, prev );
+      copy = read_image( fname, &n_copy );
+    }
+  }
+
+  have[0] = own!=NULL, have[1] = copy!=NULL;
+  MALLOC( all, 2*world_size );
+  mp_allgather_i( have, all, 2 );
+
+  /* Rank r can be recovered if it has its image or r+1 has a copy */
+
+  ok = 1;
+  for( r=0; r<world_size; r++ )
+    if( !all[2*r] && ( world_size==1 || !all[2*((r+1)%world_size)+1] ) ) {
+      if( world_rank==0 )
+        WARNING(( "Rank %i and its buddy lost their images of \"%s\"", r, name ));
+      ok = 0;
+    }
+
+  /* Send the previous rank its copy if it lost its image */
+
+  if( ok && world_size>1 ) {
+    const int send = !all[2*prev];
+    ring_exchange( copy, send ? n_copy : 0, prev, &recv, &n_recv, next );
+    if( !own ) {
+      MESSAGE(( "Recovered from the buddy image" ));
+      own = recv, n_own = n_recv, recv = NULL;
+    }
+  }
+
+  if( ok ) restore_objects_mem( own, n_own );
+
+  FREE( all );
+  FREE( recv );
+  FREE( copy );
+  FREE( own );
+  return ok;
+}
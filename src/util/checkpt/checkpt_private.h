@@ -29,4 +29,15 @@ checkpt_write( checkpt_t * checkpt,
                const void * data,
                size_t sz );
 
+/* Checkpt all objects to a MALLOC'd host buffer (freed with FREE) and
+   restore all objects from one */
+
+void
+checkpt_objects_mem( char ** data,
+                     size_t * n );
+
+void
+restore_objects_mem( const char * data,
+                     size_t n );
+
 #endif /* _checkpt_private_h_ */
@@ -0,0 +1,106 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "../../util.h"
+#include "src/vpic/vpic_unit_deck.h"
+
+#include <stdio.h>
+
+/* The checkpointed object (checkpt and restore functions must be in the
+   global symbol table) */
+
+int value;
+
+void
+checkpt_value( const int * v ) {
+  CHECKPT_VAL( int, *v );
+}
+
+int *
+restore_value( void ) {
+  RESTORE_VAL( int, value );
+  return &value;
+}
+
+/* An object whose image size depends on the rank, so the buddies
+   exchange images of different sizes */
+
+int n_blob;
+char blob[1<<20];
+
+static void
+fill_blob( int rank ) {
+  n_blob = (rank%4+1)*200000 + 7;
+  for( int i=0; i<n_blob; i++ ) blob[i] = (char)( i*(rank+1) );
+}
+
+static int
+blob_ok( int rank ) {
+  if( n_blob!=(rank%4+1)*200000 + 7 ) return 0;
+  for( int i=0; i<n_blob; i++ ) if( blob[i]!=(char)( i*(rank+1) ) ) return 0;
+  return 1;
+}
+
+void
+checkpt_blob( const char * b ) {
+  CHECKPT_VAL( int, n_blob );
+  checkpt_raw( b, n_blob );
+}
+
+char *
+restore_blob( void ) {
+  RESTORE_VAL( int, n_blob );
+  restore_raw( blob, n_blob );
+  return blob;
+}
+
+TEST_CASE("buddy", "[checkpt]") {
+
+  boot_checkpt(NULL, NULL);
+  boot_mp(NULL, NULL);
+
+  const char * name = "buddy_test";
+  char fname[256];
+
+  value = world_rank + 1;
+  fill_blob( world_rank );
+  REGISTER_OBJECT( &value, checkpt_value, restore_value, NULL );
+  REGISTER_OBJECT( blob, checkpt_blob, restore_blob, NULL );
+  checkpt_objects_buddy( name );
+
+  // Every rank has its own image
+  value = -1, n_blob = 0;
+  REQUIRE( restore_objects_buddy( name, -1 ) );
+  REQUIRE( value==world_rank + 1 );
+  REQUIRE( blob_ok( world_rank ) );
+
+  if( world_size>1 ) {
+
+    // Rank 0 is replaced and recovers from rank 1 (whose own image is
+    // a different size)
+    value = -1, n_blob = 0;
+    REQUIRE( restore_objects_buddy( name, 0 ) );
+    REQUIRE( value==world_rank + 1 );
+    REQUIRE( blob_ok( world_rank ) );
+
+    // Rank 0 and its buddy are both lost
+    if( world_rank==1 ) {
+      sprintf( fname, "%s.0.buddy", name );
+      remove( fname );
+    }
+    mp_barrier();
+  }
+
+  // Nothing to recover from (the caller falls back to a file checkpt)
+  REQUIRE_FALSE( restore_objects_buddy( name, 0 ) );
+
+  sprintf( fname, "%s.%i", name, world_rank );
+  remove( fname );
+  sprintf( fname, "%s.%i.buddy", name, (world_rank+world_size-1)%world_size );
+  remove( fname );
+
+  halt_mp();
+} // TEST
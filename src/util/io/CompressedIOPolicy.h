@@ -0,0 +1,181 @@
+/*
+	Definition of CompressedIOPolicy class
+
+	Adds write_compressed/read_compressed to any read/write policy.  The
+	payload is split into fixed-size blocks that are encoded by a pool of
+	worker threads while the calling thread writes finished blocks, in
+	order, through the underlying policy.  Output through the ordinary
+	write method is unchanged, so headers stay readable by existing tools.
+
+	Frame layout (all little endian):
+
+		uint32  magic (file_compression::frame_magic)
+		uint32  codec (FileIOCodec)
+		uint32  element size in bytes
+		uint32  reserved (0)
+		uint64  number of elements
+		uint64  elements per block
+		uint64  number of blocks
+		blocks: uint32 kind, uint32 payload bytes, payload
+
+	vim: set ts=3 :
+*/
+
+#ifndef CompressedIOPolicy_h
+#define CompressedIOPolicy_h
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "FileIOData.h"
+#include "FileCompression.h"
+
+/*!
+	\class CompressedIOPolicy CompressedIOPolicy.h
+	\brief  blockwise, multi-threaded compression on top of ReadWritePolicy
+*/
+template<class ReadWritePolicy>
+class CompressedIOPolicy
+	: public ReadWritePolicy
+	{
+	public:
+
+		//! Constructor
+		CompressedIOPolicy() {}
+
+		//! Destructor
+		~CompressedIOPolicy() {}
+
+		template<typename T> size_t write_compressed(const T * data,
+			size_t elements, const FileIOCompression & c);
+		template<typename T> size_t read_compressed(T * data,
+			size_t elements);
+
+	}; // class CompressedIOPolicy
+
+/*!
+	Write elements of data as a compressed frame.  With codec_none the
+	data are written raw, exactly as write would.  Only float arrays are
+	eligible for codec_quantize; other types fall back to lossless.
+	Returns the number of elements written.
+*/
+template<class ReadWritePolicy>
+template<typename T>
+inline size_t CompressedIOPolicy<ReadWritePolicy>::write_compressed(
+	const T * data, size_t elements, const FileIOCompression & c)
+	{
+		using namespace file_compression;
+
+		if(c.codec == codec_none)
+			return ReadWritePolicy::write(data, elements);
+
+		const bool quantizable = std::is_same<T, float>::value;
+		const size_t elem_size = sizeof(T);
+		const size_t block_bytes = c.block_bytes ? c.block_bytes :
+			default_block_bytes;
+		const uint64_t block_elements = std::max<size_t>(1,
+			block_bytes/elem_size);
+		const uint64_t nblocks = (elements + block_elements - 1)/block_elements;
+
+		// frame header
+		const uint32_t head[4] = { frame_magic, uint32_t(c.codec),
+			uint32_t(elem_size), 0 };
+		const uint64_t sizes[3] = { uint64_t(elements), block_elements,
+			nblocks };
+		ReadWritePolicy::write(head, 4);
+		ReadWritePolicy::write(sizes, 3);
+
+		const uint8_t * bytes = reinterpret_cast<const uint8_t *>(data);
+		std::vector<std::vector<uint8_t> > encoded(nblocks);
+		std::vector<char> ready(nblocks, 0);
+		std::atomic<uint64_t> next(0);
+		std::mutex lock;
+		std::condition_variable done;
+
+		auto worker = [&]() {
+			for(uint64_t b = next++; b < nblocks; b = next++) {
+				const size_t first = b*block_elements;
+				const size_t n = std::min<size_t>(block_elements,
+					elements - first);
+				std::vector<uint8_t> out;
+				encode_block(c, quantizable, bytes + first*elem_size, n,
+					elem_size, out);
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					encoded[b].swap(out);
+					ready[b] = 1;
+				}
+				done.notify_one();
+			} // for
+		};
+
+		int threads = c.threads > 0 ? c.threads :
+			int(std::thread::hardware_concurrency());
+		threads = int(std::min<uint64_t>(std::max(threads, 1), nblocks));
+
+		std::vector<std::thread> pool;
+		for(int t(0); t<threads; t++) pool.emplace_back(worker);
+
+		// write blocks in order as soon as they are available
+		for(uint64_t b(0); b<nblocks; b++) {
+			std::vector<uint8_t> out;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				done.wait(guard, [&]{ return ready[b] != 0; });
+				out.swap(encoded[b]);
+			}
+			ReadWritePolicy::write(out.data(), out.size());
+		} // for
+
+		for(auto & t : pool) t.join();
+
+		return elements;
+	} // CompressedIOPolicy::write_compressed
+
+/*!
+	Read a frame written by write_compressed into data, which must hold
+	elements values.  Returns the number of elements decoded, or zero if
+	the frame is malformed or does not match T/elements.
+*/
+template<class ReadWritePolicy>
+template<typename T>
+inline size_t CompressedIOPolicy<ReadWritePolicy>::read_compressed(
+	T * data, size_t elements)
+	{
+		using namespace file_compression;
+
+		uint32_t head[4];
+		uint64_t sizes[3];
+		if(ReadWritePolicy::read(head, 4) != 4) return 0;
+		if(ReadWritePolicy::read(sizes, 3) != 3) return 0;
+
+		if(head[0] != frame_magic || head[2] != sizeof(T) ||
+			sizes[0] != elements || sizes[1] == 0) return 0;
+
+		uint8_t * bytes = reinterpret_cast<uint8_t *>(data);
+		std::vector<uint8_t> payload;
+
+		for(uint64_t b(0); b<sizes[2]; b++) {
+			uint32_t block[2];
+			if(ReadWritePolicy::read(block, 2) != 2) return 0;
+
+			payload.resize(block[1]);
+			if(ReadWritePolicy::read(payload.data(), block[1]) != block[1])
+				return 0;
+
+			const size_t first = b*sizes[1];
+			if(first >= elements) return 0;
+			const size_t n = std::min<size_t>(sizes[1], elements - first);
+			if(!decode_block(block[0], payload.data(), payload.size(),
+				bytes + first*sizeof(T), n, sizeof(T))) return 0;
+		} // for
+
+		return elements;
+	} // CompressedIOPolicy::read_compressed
+
+#endif // CompressedIOPolicy_h
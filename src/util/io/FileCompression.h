@@ -0,0 +1,378 @@
+/*
+	Definition of FileCompression codecs
+
+	Block codecs used by CompressedIOPolicy.  Every block is encoded
+	independently so that blocks can be compressed on worker threads and
+	decoded without reference to their neighbours.
+
+	codec_lossless: byte-shuffle (group byte k of every element) followed
+		by a small LZ77 coder with an LZ4-like token layout.
+
+	codec_quantize: error-bounded quantizer for float data.  Values are
+		rounded to integer multiples of 2*tolerance, delta coded along the
+		block, zigzag mapped and passed through the lossless coder.  Every
+		reconstructed value is checked against the bound; a block that
+		cannot honour it (non-finite values, integer overflow) is stored
+		losslessly instead.
+
+	The on-disk layout is described in CompressedIOPolicy.h and mirrored
+	by the C decoder in interfaces/c/vpic_codec.h.
+
+	vim: set ts=3 :
+*/
+
+#ifndef FileCompression_h
+#define FileCompression_h
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/*!
+	\enum FileIOCodec
+	\brief Codec applied to an array payload by CompressedIOPolicy.
+*/
+enum FileIOCodec {
+	codec_none = 0,
+	codec_lossless = 1,
+	codec_quantize = 2
+}; // FileIOCodec
+
+/*!
+	\struct FileIOCompression
+	\brief Per-dump compression settings.
+
+	For codec_quantize, abs_tolerance takes precedence when positive;
+	otherwise rel_tolerance is applied relative to the largest magnitude
+	in each block.
+*/
+struct FileIOCompression {
+	FileIOCodec codec;
+	double abs_tolerance;
+	double rel_tolerance;
+	size_t block_bytes;		// uncompressed bytes per block (0: default)
+	int threads;				// worker threads (0: hardware concurrency; dumps
+								// use the pipeline threads of the rank)
+}; // struct FileIOCompression
+
+namespace file_compression {
+
+// Frame and block identifiers.  These values are part of the file format.
+const uint32_t frame_magic = 0x315a5056; // "VPZ1" little endian
+const size_t default_block_bytes = size_t(1) << 20;
+
+enum block_kind {
+	block_raw = 0,
+	block_lossless = 1,
+	block_quantize = 2
+}; // block_kind
+
+// LZ parameters
+const int lz_min_match = 4;
+const int lz_hash_bits = 14;
+const size_t lz_max_offset = 65535;
+
+inline void shuffle(const uint8_t * in, uint8_t * out, size_t n,
+	size_t elem_size)
+	{
+		for(size_t b(0); b<elem_size; b++) {
+			uint8_t * o = out + b*n;
+			for(size_t i(0); i<n; i++) o[i] = in[i*elem_size + b];
+		} // for
+	} // shuffle
+
+inline void unshuffle(const uint8_t * in, uint8_t * out, size_t n,
+	size_t elem_size)
+	{
+		for(size_t b(0); b<elem_size; b++) {
+			const uint8_t * s = in + b*n;
+			for(size_t i(0); i<n; i++) out[i*elem_size + b] = s[i];
+		} // for
+	} // unshuffle
+
+inline void lz_put_length(std::vector<uint8_t> & out, size_t len)
+	{
+		while(len >= 255) { out.push_back(255); len -= 255; }
+		out.push_back(uint8_t(len));
+	} // lz_put_length
+
+inline uint32_t lz_hash(const uint8_t * p)
+	{
+		uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return (v*2654435761u) >> (32 - lz_hash_bits);
+	} // lz_hash
+
+/*!
+	Append the LZ encoding of in[0,n) to out.  Each sequence is a token
+	byte (literal length in the high nibble, match length minus
+	lz_min_match in the low nibble, 15 meaning "extended"), the extended
+	literal length, the literals, and, unless the sequence is the last one,
+	a 16-bit little-endian offset and the extended match length.
+*/
+inline void lz_compress(const uint8_t * in, size_t n,
+	std::vector<uint8_t> & out)
+	{
+		std::vector<int64_t> table(size_t(1) << lz_hash_bits, -1);
+
+		size_t anchor = 0;
+		size_t i = 0;
+
+		while(n >= size_t(lz_min_match) && i + lz_min_match <= n) {
+			const uint32_t h = lz_hash(in + i);
+			const int64_t ref = table[h];
+			table[h] = int64_t(i);
+
+			if(ref < 0 || i - size_t(ref) > lz_max_offset ||
+				std::memcmp(in + ref, in + i, lz_min_match) != 0) {
+				i++;
+				continue;
+			} // if
+
+			size_t match = lz_min_match;
+			while(i + match < n && in[ref + match] == in[i + match]) match++;
+
+			const size_t literals = i - anchor;
+			const size_t extra = match - lz_min_match;
+			out.push_back(uint8_t(((literals < 15 ? literals : 15) << 4) |
+				(extra < 15 ? extra : 15)));
+			if(literals >= 15) lz_put_length(out, literals - 15);
+			out.insert(out.end(), in + anchor, in + i);
+
+			const size_t offset = i - size_t(ref);
+			out.push_back(uint8_t(offset & 0xff));
+			out.push_back(uint8_t(offset >> 8));
+			if(extra >= 15) lz_put_length(out, extra - 15);
+
+			i += match;
+			anchor = i;
+		} // while
+
+		// trailing literals; the decoder stops once n bytes are produced
+		const size_t literals = n - anchor;
+		out.push_back(uint8_t((literals < 15 ? literals : 15) << 4));
+		if(literals >= 15) lz_put_length(out, literals - 15);
+		out.insert(out.end(), in + anchor, in + n);
+	} // lz_compress
+
+/*!
+	Decode an LZ stream into out[0,n).  Returns false on malformed input.
+*/
+inline bool lz_decompress(const uint8_t * in, size_t in_bytes,
+	uint8_t * out, size_t n)
+	{
+		const uint8_t * ip = in;
+		const uint8_t * const iend = in + in_bytes;
+		size_t op = 0;
+
+		while(ip < iend) {
+			const uint8_t token = *ip++;
+
+			size_t literals = token >> 4;
+			if(literals == 15) {
+				uint8_t s;
+				do {
+					if(ip >= iend) return false;
+					s = *ip++;
+					literals += s;
+				} while(s == 255);
+			} // if
+
+			if(size_t(iend - ip) < literals || n - op < literals) return false;
+			std::memcpy(out + op, ip, literals);
+			ip += literals;
+			op += literals;
+
+			if(op == n) return ip == iend;
+			if(iend - ip < 2) return false;
+
+			const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+			ip += 2;
+
+			size_t match = (token & 0x0f);
+			if(match == 15) {
+				uint8_t s;
+				do {
+					if(ip >= iend) return false;
+					s = *ip++;
+					match += s;
+				} while(s == 255);
+			} // if
+			match += lz_min_match;
+
+			if(offset == 0 || offset > op || n - op < match) return false;
+
+			// byte-wise copy: overlapping matches are legal
+			for(size_t m(0); m<match; m++, op++) out[op] = out[op - offset];
+		} // while
+
+		return op == n;
+	} // lz_decompress
+
+/*!
+	Lossless block: shuffle by element size, then LZ.
+*/
+inline void encode_lossless(const uint8_t * in, size_t n, size_t elem_size,
+	std::vector<uint8_t> & out)
+	{
+		std::vector<uint8_t> shuffled(n*elem_size);
+		shuffle(in, shuffled.data(), n, elem_size);
+		lz_compress(shuffled.data(), shuffled.size(), out);
+	} // encode_lossless
+
+inline bool decode_lossless(const uint8_t * in, size_t in_bytes,
+	uint8_t * out, size_t n, size_t elem_size)
+	{
+		std::vector<uint8_t> shuffled(n*elem_size);
+		if(!lz_decompress(in, in_bytes, shuffled.data(), shuffled.size()))
+			return false;
+		unshuffle(shuffled.data(), out, n, elem_size);
+		return true;
+	} // decode_lossless
+
+inline uint32_t zigzag(int32_t v)
+	{ return (uint32_t(v) << 1) ^ uint32_t(v >> 31); }
+
+inline int32_t unzigzag(uint32_t v)
+	{ return int32_t(v >> 1) ^ -int32_t(v & 1); }
+
+/*!
+	Quantize a float block with the given absolute tolerance.  On success
+	the quantization step is returned through step and the zigzagged
+	deltas are written to q.  Returns false if the bound cannot be met.
+*/
+inline bool quantize(const float * in, size_t n, double tolerance,
+	double & step, std::vector<uint32_t> & q)
+	{
+		if(!(tolerance > 0.0)) return false;
+
+		step = 2.0*tolerance;
+		q.resize(n);
+
+		int64_t previous = 0;
+		for(size_t i(0); i<n; i++) {
+			if(!std::isfinite(in[i])) return false;
+
+			const double scaled = std::nearbyint(double(in[i])/step);
+			if(std::fabs(scaled) > 1073741823.0) return false;
+
+			const int64_t v = int64_t(scaled);
+			const float reconstructed = float(double(v)*step);
+			if(std::fabs(double(reconstructed) - double(in[i])) > tolerance)
+				return false;
+
+			q[i] = zigzag(int32_t(v - previous));
+			previous = v;
+		} // for
+
+		return true;
+	} // quantize
+
+inline void dequantize(const uint32_t * q, size_t n, double step,
+	float * out)
+	{
+		int64_t previous = 0;
+		for(size_t i(0); i<n; i++) {
+			previous += unzigzag(q[i]);
+			out[i] = float(double(previous)*step);
+		} // for
+	} // dequantize
+
+/*!
+	Absolute tolerance for a quantized block.  A relative tolerance is
+	scaled by the largest finite magnitude in the block.
+*/
+inline double block_tolerance(const FileIOCompression & c,
+	const float * in, size_t n)
+	{
+		if(c.abs_tolerance > 0.0) return c.abs_tolerance;
+
+		double vmax = 0.0;
+		for(size_t i(0); i<n; i++)
+			if(std::isfinite(in[i]) && std::fabs(in[i]) > vmax)
+				vmax = std::fabs(in[i]);
+
+		return c.rel_tolerance*vmax;
+	} // block_tolerance
+
+/*!
+	Encode one block.  The block header is kind (uint32), payload bytes
+	(uint32) and, for quantized blocks, the step (double) as the first
+	eight bytes of the payload.  quantizable selects whether the data are
+	floats that the quantizer may touch.
+*/
+inline void encode_block(const FileIOCompression & c, bool quantizable,
+	const uint8_t * in, size_t n, size_t elem_size,
+	std::vector<uint8_t> & out)
+	{
+		uint32_t kind = block_lossless;
+		std::vector<uint8_t> payload;
+
+		if(c.codec == codec_quantize && quantizable) {
+			const float * f = reinterpret_cast<const float *>(in);
+			std::vector<uint32_t> q;
+			double step;
+
+			if(quantize(f, n, block_tolerance(c, f, n), step, q)) {
+				kind = block_quantize;
+				payload.resize(sizeof(double));
+				std::memcpy(payload.data(), &step, sizeof(double));
+				encode_lossless(reinterpret_cast<const uint8_t *>(q.data()),
+					n, sizeof(uint32_t), payload);
+			} // if
+		} // if
+
+		if(kind == block_lossless) encode_lossless(in, n, elem_size, payload);
+
+		// incompressible data are stored as is
+		if(kind == block_lossless && payload.size() >= n*elem_size) {
+			kind = block_raw;
+			payload.assign(in, in + n*elem_size);
+		} // if
+
+		const uint32_t bytes = uint32_t(payload.size());
+		out.resize(2*sizeof(uint32_t));
+		std::memcpy(out.data(), &kind, sizeof(uint32_t));
+		std::memcpy(out.data() + sizeof(uint32_t), &bytes, sizeof(uint32_t));
+		out.insert(out.end(), payload.begin(), payload.end());
+	} // encode_block
+
+/*!
+	Decode one block payload of the given kind into out (n elements).
+*/
+inline bool decode_block(uint32_t kind, const uint8_t * in, size_t in_bytes,
+	uint8_t * out, size_t n, size_t elem_size)
+	{
+		switch(kind) {
+
+			case block_raw:
+				if(in_bytes != n*elem_size) return false;
+				std::memcpy(out, in, in_bytes);
+				return true;
+
+			case block_lossless:
+				return decode_lossless(in, in_bytes, out, n, elem_size);
+
+			case block_quantize: {
+				if(elem_size != sizeof(float) || in_bytes < sizeof(double))
+					return false;
+				double step;
+				std::memcpy(&step, in, sizeof(double));
+				std::vector<uint32_t> q(n);
+				if(!decode_lossless(in + sizeof(double), in_bytes - sizeof(double),
+					reinterpret_cast<uint8_t *>(q.data()), n, sizeof(uint32_t)))
+					return false;
+				dequantize(q.data(), n, step, reinterpret_cast<float *>(out));
+				return true;
+			} // case
+
+			default:
+				return false;
+
+		} // switch
+	} // decode_block
+
+} // namespace file_compression
+
+#endif // FileCompression_h
@@ -14,6 +14,7 @@
 
 #include <stdarg.h>
 #include "FileIOData.h"
+#include "CompressedIOPolicy.h"
 
 /*!
 	\class FileIO FileIO.h
@@ -52,6 +53,14 @@ template<class ReadWritePolicy> struct FileIO_T
 		size_t write(const T * data, size_t elements)
 			{ return ReadWritePolicy::write(data, elements); }
 
+		template<typename T>
+		size_t write_compressed(const T * data, size_t elements,
+			const FileIOCompression & c)
+			{ return ReadWritePolicy::write_compressed(data, elements, c); }
+		template<typename T>
+		size_t read_compressed(T * data, size_t elements)
+			{ return ReadWritePolicy::read_compressed(data, elements); }
+
 		int64_t seek(uint64_t offset, int32_t whence)
 			{ return ReadWritePolicy::seek(offset, whence); }
 		int64_t tell()
@@ -67,19 +76,19 @@ template<class ReadWritePolicy> struct FileIO_T
 #if defined HOST_BUILD
 #include "StandardIOPolicy.h"
 
-typedef FileIO_T<StandardIOPolicy> FileIO;
+typedef FileIO_T<CompressedIOPolicy<StandardIOPolicy> > FileIO;
 #else
 #include "P2PIOPolicy.h"
 
 //typedef FileIO_T<P2PIOPolicy<true> > FileIOSwapped;
 //typedef FileIO_T<P2PIOPolicy<true> > FileIO;
-typedef FileIO_T<P2PIOPolicy<true> > FileIO;
+typedef FileIO_T<CompressedIOPolicy<P2PIOPolicy<true> > > FileIO;
 typedef FileIO_T<P2PIOPolicy<false> > FileIOUnswapped;
 #endif // BUILD
 
 #else
 #include "StandardIOPolicy.h"
-typedef FileIO_T<StandardIOPolicy> FileIO;
+typedef FileIO_T<CompressedIOPolicy<StandardIOPolicy> > FileIO;
 typedef FileIO_T<StandardIOPolicy> FileIOUnswapped;
 #endif // MP Implementation
 
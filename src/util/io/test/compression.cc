@@ -0,0 +1,82 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "src/util/io/FileIO.h"
+
+/* Smooth field with a little noise, similar to dump payloads */
+
+static std::vector<float> make_data( size_t n ) {
+  std::vector<float> data(n);
+  unsigned int s = 12345;
+  for( size_t i=0; i<n; i++ ) {
+    s = 1664525u*s + 1013904223u;
+    data[i] = std::sin( 0.001f*i ) + 1e-4f*float(s>>8)/float(1<<24);
+  }
+  return data;
+} // make_data
+
+template<typename T>
+static std::vector<T> round_trip( const std::vector<T> & in,
+                                  const FileIOCompression & c ) {
+  const char * name = "compression_test.bin";
+  FileIO fileIO;
+  REQUIRE( fileIO.open( name, io_write )==ok );
+  REQUIRE( fileIO.write_compressed( in.data(), in.size(), c )==in.size() );
+  fileIO.close();
+
+  std::vector<T> out( in.size() );
+  REQUIRE( fileIO.open( name, io_read )==ok );
+  REQUIRE( fileIO.read_compressed( out.data(), out.size() )==out.size() );
+  fileIO.close();
+  std::remove( name );
+  return out;
+} // round_trip
+
+TEST_CASE("lossless", "[compression]") {
+  std::vector<float> in = make_data( 300000 );
+  FileIOCompression c = { codec_lossless, 0, 0, 1<<16, 4 };
+  std::vector<float> out = round_trip( in, c );
+  REQUIRE( std::memcmp( in.data(), out.data(), in.size()*sizeof(float) )==0 );
+} // TEST
+
+TEST_CASE("lossless_struct", "[compression]") {
+  struct cell { float f[3]; short m[2]; };
+  std::vector<cell> in(5000);
+  for( size_t i=0; i<in.size(); i++ ) {
+    in[i].f[0] = i; in[i].f[1] = 0.5f*i; in[i].f[2] = 0;
+    in[i].m[0] = 1; in[i].m[1] = short(i%3);
+  }
+  FileIOCompression c = { codec_lossless, 0, 0, 4096, 0 };
+  std::vector<cell> out = round_trip( in, c );
+  REQUIRE( std::memcmp( in.data(), out.data(), in.size()*sizeof(cell) )==0 );
+} // TEST
+
+TEST_CASE("quantize_absolute", "[compression]") {
+  std::vector<float> in = make_data( 200000 );
+  const double tol = 1e-3;
+  FileIOCompression c = { codec_quantize, tol, 0, 1<<16, 3 };
+  std::vector<float> out = round_trip( in, c );
+  double err = 0;
+  for( size_t i=0; i<in.size(); i++ )
+    err = std::max( err, std::fabs( double(in[i]) - double(out[i]) ) );
+  REQUIRE( err<=tol );
+} // TEST
+
+TEST_CASE("quantize_relative_nonfinite", "[compression]") {
+  std::vector<float> in = make_data( 100000 );
+  in[10] = INFINITY; // this block must fall back to lossless
+  const double rel = 1e-4;
+  FileIOCompression c = { codec_quantize, 0, rel, 1<<14, 2 };
+  std::vector<float> out = round_trip( in, c );
+  REQUIRE( std::isinf( out[10] ) );
+  for( size_t i=0; i<in.size(); i++ )
+    if( i!=10 ) REQUIRE( std::fabs( double(in[i]) - double(out[i]) )<=rel*2 );
+} // TEST
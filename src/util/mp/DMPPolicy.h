@@ -3,7 +3,8 @@
 
 #include <mpi.h>
 #include <cstdlib>
-#include <cstdlib>
+#include <algorithm>
+#include <vector>
 
 #include "../checkpt/checkpt.h"
 #include "Kokkos_Core.hpp"
@@ -26,6 +27,23 @@ struct mp {
   MPI_Request * rreq;         MPI_Request * sreq;
 };
 
+/* Persistent requests are not checkpointed (the owner of a batch sets
+   it up again on restore) */
+
+struct mp_batch {
+  int max_msg, n_recv, n_send;
+  int64_t n_recv_byte, n_send_byte;
+  MPI_Request * rreq;         MPI_Request * sreq;
+  int * rreq_sz;
+  MPI_Status * status;
+};
+
+/* Sends up to this size (in bytes) go in standard mode */
+
+#ifndef MP_EAGER_LIMIT
+#define MP_EAGER_LIMIT 65536
+#endif
+
 /* Create the world collective */
 
 static collective_t __world = { NULL, 0, 0, MPI_COMM_SELF };
@@ -101,6 +119,22 @@ struct DMPPolicy {
      if( ierr!=MPI_SUCCESS ) ERROR(( "MPI error %i on "#x, ierr ));      \
    } while(0)
 
+  // Messages up to the eager limit are sent in standard mode: MPI
+  // delivers them without a rendezvous with the receiver.  Larger ones
+  // are synchronous so MPI never has to buffer them for a late receiver.
+
+  int eager_limit = MP_EAGER_LIMIT;
+
+  inline void
+  isend( void * buf,
+         int sz,
+         int dst,
+         int tag,
+         MPI_Request * req ) {
+    if( sz<=eager_limit ) TRAP( MPI_Isend(  buf, sz, MPI_BYTE, dst, tag, world->comm, req ) );
+    else                  TRAP( MPI_Issend( buf, sz, MPI_BYTE, dst, tag, world->comm, req ) );
+  }
+
   inline void
   boot_mp( int * pargc,
            char *** pargv ) {
@@ -118,6 +152,7 @@ struct DMPPolicy {
     TRAP( MPI_Comm_free( &__world.comm ) );
     __world.parent = NULL, __world.color = 0, __world.key = 0;
     __world.comm = MPI_COMM_SELF;
+    _world = &__world;
     _world_size = 1;
     _world_rank = 0;
     TRAP( MPI_Finalize() ); 
@@ -125,7 +160,54 @@ struct DMPPolicy {
   
   inline void
   mp_abort( int reason ) {  
-    MPI_Abort( world->comm, reason );
+    MPI_Abort( __world.comm, reason ); // The whole job, not just this world
+  }
+
+  inline void
+  mp_node_rank( int * rank,
+                int * size ) {
+    // All the processes on the node share it, whatever ensemble member
+    // they are in
+    MPI_Comm all = mp_universe()->comm, node;
+    int key;
+    if( !rank || !size ) ERROR(( "Bad args" ));
+    TRAP( MPI_Comm_rank( all, &key ) );
+    TRAP( MPI_Comm_split_type( all, MPI_COMM_TYPE_SHARED, key,
+                               MPI_INFO_NULL, &node ) );
+    TRAP( MPI_Comm_rank( node, rank ) );
+    TRAP( MPI_Comm_size( node, size ) );
+    TRAP( MPI_Comm_free( &node ) );
+  }
+
+  // A collective of the processes of parent with the same color,
+  // ranked by key
+
+  inline collective_t *
+  new_collective( collective_t * parent,
+                  int color,
+                  int key ) {
+    collective_t * c;
+    if( !parent || color<0 ) ERROR(( "Bad args" ));
+    MALLOC( c, 1 );
+    c->parent = parent, c->color = color, c->key = key;
+    TRAP( MPI_Comm_split( parent->comm, color, key, &c->comm ) );
+    return c;
+  }
+
+  inline void
+  delete_collective( collective_t * c ) {
+    if( !c ) return;
+    if( c==&__world || c==_world ) ERROR(( "Bad args" ));
+    TRAP( MPI_Comm_free( &c->comm ) );
+    FREE( c );
+  }
+
+  inline void
+  mp_set_world( collective_t * c ) {
+    if( !c ) ERROR(( "Bad args" ));
+    _world = c;
+    TRAP( MPI_Comm_rank( c->comm, &_world_rank ) );
+    TRAP( MPI_Comm_size( c->comm, &_world_size ) );
   }
   
   inline void
@@ -193,6 +275,29 @@ struct DMPPolicy {
     TRAP( MPI_Recv( buf, n, MPI_INT, src, 0, world->comm, MPI_STATUS_IGNORE ) );
   }
   
+  // Large buffers go in chunks to keep the counts in range of an int.
+  // The sends and the receives are chunked independently, as the
+  // partners' sizes may differ; chunks of the same pair and tag match
+  // in order.
+
+  inline void
+  mp_sendrecv_uc( const unsigned char * sbuf, size_t n_send, int dst,
+                  unsigned char * rbuf, size_t n_recv, int src ) {
+    const size_t chunk = (size_t)1<<30;
+    if( (!sbuf && n_send) || (!rbuf && n_recv) ||
+        dst<0 || dst>=world_size || src<0 || src>=world_size )
+      ERROR(( "Bad args" ));
+    std::vector<MPI_Request> req( ( n_recv+chunk-1 )/chunk + ( n_send+chunk-1 )/chunk );
+    int k = 0;
+    for( size_t r=0; r<n_recv; r+=chunk, k++ )
+      TRAP( MPI_Irecv( rbuf+r, (int)std::min( chunk, n_recv-r ), MPI_UNSIGNED_CHAR,
+                       src, 1, world->comm, &req[k] ) );
+    for( size_t s=0; s<n_send; s+=chunk, k++ )
+      TRAP( MPI_Isend( (void *)(sbuf+s), (int)std::min( chunk, n_send-s ), MPI_UNSIGNED_CHAR,
+                       dst, 1, world->comm, &req[k] ) );
+    if( k ) TRAP( MPI_Waitall( k, req.data(), MPI_STATUSES_IGNORE ) );
+  }
+
   inline mp_t *
   new_mp( int n_port ) {
     mp_t * mp;
@@ -322,7 +427,7 @@ struct DMPPolicy {
     if( !mp || port<0 || port>=mp->n_port || dst<0 || dst>=world_size ||
         sz<1 || mp->sbuf_sz[port]<sz ) ERROR(( "Bad args" ));
     mp->sreq_sz[port] = sz;
-    TRAP(MPI_Issend(mp->sbuf[port],sz, MPI_BYTE, dst, tag, world->comm, &mp->sreq[port]));
+    isend( mp->sbuf[port], sz, dst, tag, &mp->sreq[port] );
   }
   
   inline void
@@ -370,7 +475,7 @@ struct DMPPolicy {
     if( !mp || port<0 || port>=mp->n_port || dst<0 || dst>=world_size ||
         sz<1 || mp->sbuf_sz[port]<sz ) ERROR(( "Bad args" ));
     mp->sreq_sz[port] = sz;
-    TRAP(MPI_Issend(mp->sbuf[port],sz, MPI_BYTE, dst, tag, world->comm, &mp->sreq[port]));
+    isend( mp->sbuf[port], sz, dst, tag, &mp->sreq[port] );
   }
   
   inline void
@@ -406,7 +511,7 @@ struct DMPPolicy {
             size<1 || mp_k->sbuf_sz[port]<size ) ERROR(( "Bad args" ));
         mp_k->sreq_sz[port] = size;
         mp_k->sbuf[port] = send_buf;
-        TRAP(MPI_Issend(send_buf,size, MPI_BYTE, dst, tag, world->comm, &mp_k->sreq[port]));
+        isend( send_buf, size, dst, tag, &mp_k->sreq[port] );
     }
 
     inline void
@@ -453,6 +558,108 @@ struct DMPPolicy {
         mp->rbuf_sz[port] = 0;
     }
 
+    inline void
+    mp_set_eager_limit(int n_byte) {
+        if(n_byte < 0) ERROR(("Bad args"));
+        eager_limit = n_byte;
+    }
+
+    inline int
+    mp_eager_limit(void) {
+        return eager_limit;
+    }
+
+  /* Persistent messages */
+
+  inline mp_batch_t *
+  new_mp_batch( int max_msg ) {
+    mp_batch_t * b;
+    if( max_msg<1 ) ERROR(( "Bad args" ));
+    MALLOC( b, 1 );
+    b->max_msg = max_msg, b->n_recv = 0, b->n_send = 0;
+    b->n_recv_byte = 0, b->n_send_byte = 0;
+    MALLOC( b->rreq,    max_msg ); MALLOC( b->sreq, max_msg );
+    MALLOC( b->rreq_sz, max_msg ); MALLOC( b->status, max_msg );
+    return b;
+  }
+
+  inline void
+  delete_mp_batch( mp_batch_t * b ) {
+    int n, finalized;
+    if( !b ) return;
+    TRAP( MPI_Finalized( &finalized ) );
+    if( !finalized ) {
+      for( n=0; n<b->n_recv; n++ ) TRAP( MPI_Request_free( &b->rreq[n] ) );
+      for( n=0; n<b->n_send; n++ ) TRAP( MPI_Request_free( &b->sreq[n] ) );
+    }
+    FREE( b->status ); FREE( b->rreq_sz );
+    FREE( b->sreq );   FREE( b->rreq );
+    FREE( b );
+  }
+
+  inline void
+  mp_batch_add_recv( mp_batch_t * b,
+                     void * buf,
+                     int sz,
+                     int src,
+                     int tag ) {
+    if( !b || !buf || b->n_recv>=b->max_msg || sz<1 ||
+        src<0 || src>=world_size ) ERROR(( "Bad args" ));
+    b->rreq_sz[b->n_recv] = sz;
+    b->n_recv_byte += sz;
+    TRAP( MPI_Recv_init( buf, sz, MPI_BYTE, src, tag, world->comm,
+                         &b->rreq[b->n_recv] ) );
+    b->n_recv++;
+  }
+
+  inline void
+  mp_batch_add_send( mp_batch_t * b,
+                     void * buf,
+                     int sz,
+                     int dst,
+                     int tag ) {
+    if( !b || !buf || b->n_send>=b->max_msg || sz<1 ||
+        dst<0 || dst>=world_size ) ERROR(( "Bad args" ));
+    if( sz<=eager_limit )
+      TRAP( MPI_Send_init(  buf, sz, MPI_BYTE, dst, tag, world->comm,
+                            &b->sreq[b->n_send] ) );
+    else
+      TRAP( MPI_Ssend_init( buf, sz, MPI_BYTE, dst, tag, world->comm,
+                            &b->sreq[b->n_send] ) );
+    b->n_send_byte += sz;
+    b->n_send++;
+  }
+
+  inline void
+  mp_batch_begin_recv( mp_batch_t * b ) {
+    if( !b ) ERROR(( "Bad args" ));
+    if( b->n_recv ) TRAP( MPI_Startall( b->n_recv, b->rreq ) );
+  }
+
+  inline void
+  mp_batch_begin_send( mp_batch_t * b ) {
+    if( !b ) ERROR(( "Bad args" ));
+    if( b->n_send ) TRAP( MPI_Startall( b->n_send, b->sreq ) );
+  }
+
+  inline void
+  mp_batch_end_recv( mp_batch_t * b ) {
+    int n, sz;
+    if( !b ) ERROR(( "Bad args" ));
+    if( !b->n_recv ) return;
+    TRAP( MPI_Waitall( b->n_recv, b->rreq, b->status ) );
+    for( n=0; n<b->n_recv; n++ ) {
+      TRAP( MPI_Get_count( &b->status[n], MPI_BYTE, &sz ) );
+      if( b->rreq_sz[n]!=sz ) ERROR(( "Sizes do not match" ));
+    }
+  }
+
+  inline void
+  mp_batch_end_send( mp_batch_t * b ) {
+    if( !b ) ERROR(( "Bad args" ));
+    if( b->n_send ) TRAP( MPI_Waitall( b->n_send, b->sreq, MPI_STATUSES_IGNORE ) );
+  }
+
 # undef RESIZE_FACTOR
 # undef TRAP
 
@@ -23,6 +23,11 @@ struct mp {
   int * rreq;                 int * sreq;
 };
 
+struct mp_batch {
+  int n_recv, n_send;
+  int64_t n_recv_byte, n_send_byte;
+};
+
 /* Create the world collective */
 
 static collective_t __world = { NULL, 0, 0 };
@@ -117,6 +122,31 @@ struct RelayPolicy {
     ConnectionManager::instance().finalize();
   }
 
+  // The relay does not know which processes share a node
+  inline void
+  mp_node_rank( int * rank,
+                int * size ) {
+    if( !rank || !size ) ERROR(( "Bad args" ));
+    *rank = 0, *size = 1;
+  }
+
+  inline collective_t *
+  new_collective( collective_t * parent,
+                  int color,
+                  int key ) {
+    ERROR(( "Sub-collectives are not supported by the relay" ));
+    return NULL;
+  }
+
+  inline void
+  delete_collective( collective_t * c ) {
+  }
+
+  inline void
+  mp_set_world( collective_t * c ) {
+    if( c!=&__world ) ERROR(( "Sub-collectives are not supported by the relay" ));
+  }
+
   inline void
   mp_abort( int reason ) {
     P2PConnection & p2p = P2PConnection::instance();
@@ -216,6 +246,12 @@ struct RelayPolicy {
     p2p.recv( buf, request.count, request.tag, request.id );
   }
 
+  inline void
+  mp_sendrecv_uc( const unsigned char * sbuf, size_t n_send, int dst,
+                  unsigned char * rbuf, size_t n_recv, int src ) {
+    ERROR(( "mp_sendrecv_uc is not supported by the relay" ));
+  }
+
   /* ---- BEGIN EXACT CUT-AND-PASTE JOB FROM DMPPOLICY ---- */
   /* FIXME-KJB: AT THIS POINT, MUCH OF MP IN DMP AND RELAY COULD BE EXTRACTED
      INTO A UNIFIED IMPLEMENTATION (AND, AT THE SAME TIME, THE API FIXED) */
@@ -383,6 +419,89 @@ struct RelayPolicy {
     p2p.wait_send( port );
   }
 
+  /* Messages from and to buffers the caller owns (as in DMPPolicy) */
+
+  inline void
+  mp_set_send_buffer( mp_t * mp, int port, int size, char * buf ) {
+    if( !mp || !buf || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    mp->sbuf[port]    = buf;
+    mp->sbuf_sz[port] = size;
+  }
+
+  inline void
+  mp_set_recv_buffer( mp_t * mp, int port, int size, char * buf ) {
+    if( !mp || !buf || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    mp->rbuf[port]    = buf;
+    mp->rbuf_sz[port] = size;
+  }
+
+  inline void
+  mp_unset_send_buffer( mp_t * mp, int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    mp->sbuf[port]    = NULL;
+    mp->sbuf_sz[port] = 0;
+  }
+
+  inline void
+  mp_unset_recv_buffer( mp_t * mp, int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    mp->rbuf[port]    = NULL;
+    mp->rbuf_sz[port] = 0;
+  }
+
+  inline void
+  mp_set_eager_limit( int n_byte ) {
+    if( n_byte<0 ) ERROR(( "Bad args" ));
+  }
+
+  inline int
+  mp_eager_limit( void ) {
+    return 0;
+  }
+
+  /* The relay has no persistent messages.  Callers fall back to one
+     port per message (see mp.h). */
+
+  inline mp_batch_t *
+  new_mp_batch( int max_msg ) {
+    if( max_msg<1 ) ERROR(( "Bad args" ));
+    return NULL;
+  }
+
+  inline void
+  delete_mp_batch( mp_batch_t * b ) {
+  }
+
+  inline void
+  mp_batch_add_recv( mp_batch_t * b, void * buf, int sz, int src, int tag ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
+  inline void
+  mp_batch_add_send( mp_batch_t * b, void * buf, int sz, int dst, int tag ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
+  inline void
+  mp_batch_begin_recv( mp_batch_t * b ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
+  inline void
+  mp_batch_begin_send( mp_batch_t * b ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
+  inline void
+  mp_batch_end_recv( mp_batch_t * b ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
+  inline void
+  mp_batch_end_send( mp_batch_t * b ) {
+    ERROR(( "Persistent messages are not supported by the relay" ));
+  }
+
 # undef RESIZE_FACTOR
 
 }; // struct RelayPolicy
@@ -10,12 +10,65 @@
 
 #include "mp.h"
 #include "MPWrapper.h"
+#include "../profile/profile.h"
+
+// The message counts, sizes and wait times go to the communication
+// telemetry (see COMM_STATS in profile.h)
+
+#define WAIT( call ) do {                  \
+    const double _t = wallclock();         \
+    call;                                  \
+    COMM_STAT( wait, wallclock() - _t );   \
+  } while(0)
+
+// The whole job and, in an ensemble run, the member of this process
+
+static collective_t * universe = NULL, * member = NULL;
+static int n_member = 1;
 
 void boot_mp( int * pargc, char *** pargv ) {
   MPWrapper::instance().boot_mp( pargc, pargv );
+  universe = world, member = NULL, n_member = 1;
+  if( pargc && pargv ) n_member = strip_cmdline_int( pargc, pargv, "--ensemble", 1 );
+  if( n_member<1 || world_size % n_member )
+    ERROR(( "The %i processes can't be split into %i ensemble members",
+            world_size, n_member ));
+  if( n_member>1 ) {
+    member = new_collective( universe, world_rank/( world_size/n_member ),
+                             world_rank );
+    mp_set_world( member );
+  }
+}
+
+void halt_mp( void ) {
+  if( member ) {
+    mp_set_world( universe );
+    delete_collective( member );
+    member = NULL;
+  }
+  n_member = 1;
+  MPWrapper::instance().halt_mp();
 }
 
-void halt_mp( void ) { MPWrapper::instance().halt_mp(); }
+void mp_node_rank( int * rank, int * size ) {
+  MPWrapper::instance().mp_node_rank( rank, size );
+}
+
+collective_t * new_collective( collective_t * parent, int color, int key ) {
+  return MPWrapper::instance().new_collective( parent, color, key );
+}
+
+void delete_collective( collective_t * c ) {
+  MPWrapper::instance().delete_collective( c );
+}
+
+void mp_set_world( collective_t * c ) { MPWrapper::instance().mp_set_world( c ); }
+
+collective_t * mp_universe( void ) { return universe ? universe : world; }
+
+int mp_ensemble_size( void ) { return n_member; }
+
+int mp_ensemble_member( void ) { return member ? member->color : 0; }
 
 void mp_abort( int reason ) { MPWrapper::instance().mp_abort( reason ); }
 
@@ -49,10 +102,27 @@ void mp_recv_i( int *buf, int n, int src ) {
   return MPWrapper::instance().mp_recv_i( buf, n, src );
 }
 
+void mp_sendrecv_uc( const unsigned char * sbuf, size_t n_send, int dst,
+                     unsigned char * rbuf, size_t n_recv, int src ) {
+  return MPWrapper::instance().mp_sendrecv_uc( sbuf, n_send, dst,
+                                               rbuf, n_recv, src );
+}
+
 mp_t * new_mp( int n_port ) { return MPWrapper::instance().new_mp( n_port ); }
 
 void delete_mp( mp_t * mp ) { MPWrapper::instance().delete_mp( mp ); }
 
+static int64_t n_staging_copy = 0, n_staging_byte = 0;
+
+void mp_add_staging( size_t n_byte ) {
+  n_staging_copy++;
+  n_staging_byte += n_byte;
+}
+
+int64_t mp_staging_copies( void ) { return n_staging_copy; }
+
+int64_t mp_staging_bytes( void ) { return n_staging_byte; }
+
 void * ALIGNED(16) mp_recv_buffer( mp_t * mp, int tag ) {
   return MPWrapper::instance().mp_recv_buffer( mp, tag );
 }
@@ -70,52 +140,58 @@ void mp_size_send_buffer( mp_t * mp, int tag, int size ) {
 }
 
 void mp_begin_recv( mp_t * mp, int rbuf, int size, int sender, int tag ) {
+  COMM_STAT( msg_recv, 1 ); COMM_STAT( byte_recv, size );
   MPWrapper::instance().mp_begin_recv( mp, rbuf, size, sender, tag );
 }
 
 void mp_begin_send( mp_t * mp, int sbuf, int size, int receiver, int tag ) {
+  COMM_STAT( msg_sent, 1 ); COMM_STAT( byte_sent, size );
   MPWrapper::instance().mp_begin_send( mp, sbuf, size, receiver, tag );
 }
 
 void mp_end_recv( mp_t * mp, int rbuf ) {
-  MPWrapper::instance().mp_end_recv( mp, rbuf );
+  WAIT( MPWrapper::instance().mp_end_recv( mp, rbuf ) );
 }
 
 void mp_end_send( mp_t * mp, int sbuf ) {
-  MPWrapper::instance().mp_end_send( mp, sbuf );
+  WAIT( MPWrapper::instance().mp_end_send( mp, sbuf ) );
 }
 
 // Kokkos stuff
 void mp_begin_recv_kokkos( mp_t* mp_k, int port, int size, int sender, int tag, char* ALIGNED(128) recv_buf ) {
+  COMM_STAT( msg_recv, 1 ); COMM_STAT( byte_recv, size );
   MPWrapper::instance().mp_begin_recv_kokkos( mp_k, port, size, sender, tag, recv_buf );
 }
 
 void mp_begin_send_kokkos( mp_t* mp_k, int port, int size, int receiver, int tag, char* ALIGNED(128) send_buf ) {
+  COMM_STAT( msg_sent, 1 ); COMM_STAT( byte_sent, size );
   MPWrapper::instance().mp_begin_send_kokkos( mp_k, port, size, receiver, tag, send_buf );
 }
 
 void mp_end_recv_kokkos( mp_t* mp_k, int port ) {
-  MPWrapper::instance().mp_end_recv_kokkos( mp_k, port );
+  WAIT( MPWrapper::instance().mp_end_recv_kokkos( mp_k, port ) );
 }
 
 void mp_end_send_kokkos( mp_t* mp_k, int port ) {
-  MPWrapper::instance().mp_end_send_kokkos( mp_k, port );
+  WAIT( MPWrapper::instance().mp_end_send_kokkos( mp_k, port ) );
 }
 
 void mp_begin_recv_k( mp_t * mp, int rbuf, int size, int sender, int tag, char* recv_buf ) {
+  COMM_STAT( msg_recv, 1 ); COMM_STAT( byte_recv, size );
   MPWrapper::instance().mp_begin_recv_k( mp, rbuf, size, sender, tag, recv_buf );
 }
 
 void mp_begin_send_k( mp_t * mp, int sbuf, int size, int receiver, int tag, char* recv_buf ) {
+  COMM_STAT( msg_sent, 1 ); COMM_STAT( byte_sent, size );
   MPWrapper::instance().mp_begin_send_k( mp, sbuf, size, receiver, tag, recv_buf );
 }
 
 void mp_end_recv_k( mp_t * mp, int rbuf ) {
-  MPWrapper::instance().mp_end_recv_k( mp, rbuf );
+  WAIT( MPWrapper::instance().mp_end_recv_k( mp, rbuf ) );
 }
 
 void mp_end_send_k( mp_t * mp, int sbuf ) {
-  MPWrapper::instance().mp_end_send_k( mp, sbuf );
+  WAIT( MPWrapper::instance().mp_end_send_k( mp, sbuf ) );
 }
 
 void mp_set_send_buffer(mp_t* mp, int port, int size, char* sbuf) {
@@ -133,3 +209,43 @@ void mp_unset_send_buffer(mp_t* mp, int port) {
 void mp_unset_recv_buffer(mp_t* mp, int port) {
   MPWrapper::instance().mp_unset_recv_buffer(mp, port);
 }
+
+void mp_set_eager_limit( int n_byte ) {
+  MPWrapper::instance().mp_set_eager_limit( n_byte );
+}
+
+int mp_eager_limit( void ) { return MPWrapper::instance().mp_eager_limit(); }
+
+mp_batch_t * new_mp_batch( int max_msg ) {
+  return MPWrapper::instance().new_mp_batch( max_msg );
+}
+
+void delete_mp_batch( mp_batch_t * b ) {
+  MPWrapper::instance().delete_mp_batch( b );
+}
+
+void mp_batch_add_recv( mp_batch_t * b, void * buf, int sz, int src, int tag ) {
+  MPWrapper::instance().mp_batch_add_recv( b, buf, sz, src, tag );
+}
+
+void mp_batch_add_send( mp_batch_t * b, void * buf, int sz, int dst, int tag ) {
+  MPWrapper::instance().mp_batch_add_send( b, buf, sz, dst, tag );
+}
+
+void mp_batch_begin_recv( mp_batch_t * b ) {
+  if( b ) { COMM_STAT( msg_recv, b->n_recv ); COMM_STAT( byte_recv, b->n_recv_byte ); }
+  MPWrapper::instance().mp_batch_begin_recv( b );
+}
+
+void mp_batch_begin_send( mp_batch_t * b ) {
+  if( b ) { COMM_STAT( msg_sent, b->n_send ); COMM_STAT( byte_sent, b->n_send_byte ); }
+  MPWrapper::instance().mp_batch_begin_send( b );
+}
+
+void mp_batch_end_recv( mp_batch_t * b ) {
+  WAIT( MPWrapper::instance().mp_batch_end_recv( b ) );
+}
+
+void mp_batch_end_send( mp_batch_t * b ) {
+  WAIT( MPWrapper::instance().mp_batch_end_send( b ) );
+}
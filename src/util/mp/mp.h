@@ -1,6 +1,7 @@
-// FIXME: THIS API SHOULD NOT BE HARDWIRED TO USE ONLY THE WORLD
-// COMM. FIXME: THIS API NEEDS A SERIOUS REVAMP (BUT AT LEAST IT IS
-// LESS A HOUSE OF SHAME THAN PREVIOUSLY).
+// All of this API (and grid_comm and the turnstiles built on it) works
+// on the world collective, which need not be the whole job (see
+// mp_set_world).  FIXME: THIS API NEEDS A SERIOUS REVAMP (BUT AT LEAST
+// IT IS LESS A HOUSE OF SHAME THAN PREVIOUSLY).
 
 #ifndef mp_h
 #define mp_h
@@ -15,6 +16,11 @@ typedef struct mp mp_t;
 struct mp_kokkos;
 typedef struct mp_kokkos mp_kokkos_t;
 
+/* Opaque handle to a batch of persistent messages */
+
+struct mp_batch;
+typedef struct mp_batch mp_batch_t;
+
 /* Define a "turnstile".  At most up to n_turnstile processes can be
    in the turnstile at any given time.  Use this to implement
    critical sections and do other tricks liking limiting the number
@@ -33,6 +39,9 @@ typedef struct mp_kokkos mp_kokkos_t;
    Code in turnstiles should not attempt to communicate with other
    processes.
   
+   The turnstile is over the processes of the world (each member of an
+   ensemble has its own).
+
    If everything were perfectly synchronous, then, when
    using a 10 turnstiles, processes 0:9 would enter the turnstile,
    followed by 10:19, followed by 20:29, ... */
@@ -48,6 +57,10 @@ typedef struct mp_kokkos mp_kokkos_t;
      mp_send_i( &_baton, 1, world_rank+_n_turnstile );  \
  } while(0)
 
+/* "--ensemble n" on the command line splits the job into n members of
+   equal size (consecutive ranks) that run independently: world is the
+   member of this process. */
+
 void
 boot_mp( int * pargc,
          char *** pargv );
@@ -55,9 +68,49 @@ boot_mp( int * pargc,
 void
 halt_mp( void );
 
+/* Aborts the whole job */
+
 void
 mp_abort( int reason );
 
+/* The rank of this process among the processes of the whole job (all
+   the ensemble members) on the same node, and their number */
+
+void
+mp_node_rank( int * rank,
+              int * size );
+
+/* Collectives.  new_collective makes a collective of the processes of
+   parent that give the same color, ranked by key (it must be called by
+   all of them).  mp_set_world makes every mp call (and world_rank /
+   world_size) use the collective c from then on, e.g. to talk between
+   the members of a coupled ensemble over mp_universe() for a while. */
+
+collective_t *
+new_collective( collective_t * parent,
+                int color,
+                int key );
+
+void
+delete_collective( collective_t * c );
+
+void
+mp_set_world( collective_t * c );
+
+/* The whole job */
+
+collective_t *
+mp_universe( void );
+
+/* The number of ensemble members and the member of this process (0 to
+   mp_ensemble_size()-1; decks can use it to pick their parameters) */
+
+int
+mp_ensemble_size( void );
+
+int
+mp_ensemble_member( void );
+
 /* Collective commucations */
 
 void
@@ -102,6 +155,13 @@ mp_recv_i( int * buf,
            int n,
            int src );
 
+/* Send n_send bytes to dst while receiving n_recv bytes from src
+   (sizes must be agreed on beforehand; any size, including 0) */
+
+void
+mp_sendrecv_uc( const unsigned char * sbuf, size_t n_send, int dst,
+                unsigned char * rbuf, size_t n_recv, int src );
+
 /* Buffered non-blocking point-to-point communications */
 
 mp_t *
@@ -196,4 +256,132 @@ void mp_unset_send_buffer(mp_t* mp, int port);
 
 void mp_unset_recv_buffer(mp_t* mp, int port);
 
+/* Sends up to the eager limit (in bytes) are made in standard mode and
+   larger ones in synchronous mode (the sender waits for the matching
+   receive).  A new limit applies to the sends begun or added to a
+   batch afterward. */
+
+void
+mp_set_eager_limit( int n_byte );
+
+int
+mp_eager_limit( void );
+
+/* Persistent messages.  An exchange that sends and receives the same
+   buffers to and from the same processes every time (the field halos)
+   sets the messages up once in a batch; the batch then begins and ends
+   all its receives (or sends) in one call each, without setting up any
+   request.  A received message must have exactly the size added.
+   Batches are not checkpointed.  new_mp_batch returns NULL when the
+   messaging layer has no persistent messages (the relay); the messages
+   then have to go through the ports of an mp_t. */
+
+mp_batch_t *
+new_mp_batch( int max_msg );
+
+void
+delete_mp_batch( mp_batch_t * b );
+
+void
+mp_batch_add_recv( mp_batch_t * b,
+                   void * buf,
+                   int sz,
+                   int src,
+                   int tag );
+
+void
+mp_batch_add_send( mp_batch_t * b,
+                   void * buf,
+                   int sz,
+                   int dst,
+                   int tag );
+
+void
+mp_batch_begin_recv( mp_batch_t * b );
+
+void
+mp_batch_begin_send( mp_batch_t * b );
+
+void
+mp_batch_end_recv( mp_batch_t * b );
+
+void
+mp_batch_end_send( mp_batch_t * b );
+
+/* Message buffers in device memory.  When MP_DEVICE_BUFFERS is set,
+   MPI is handed the device views themselves: either the device memory
+   is host memory or MPI is device aware (configure with
+   USE_GPU_AWARE_MPI).  The host mirrors are then neither allocated nor
+   copied to.  Otherwise the messages are staged through the mirrors.
+
+   The staging copies actually made are counted (mp_staging_copies) so
+   it can be checked that none are. */
+
+#if defined(USE_GPU_AWARE_MPI) || KOKKOS_DEVICE_IS_HOST
+#define MP_DEVICE_BUFFERS 1
+#else
+#define MP_DEVICE_BUFFERS 0
+#endif
+
+void
+mp_add_staging( size_t n_byte );
+
+int64_t
+mp_staging_copies( void );
+
+int64_t
+mp_staging_bytes( void );
+
+// Copy src to dst unless they are the same memory (then only wait for
+// the kernels writing src, as Kokkos::deep_copy would)
+
+template<class Dst, class Src>
+void
+mp_stage( const Dst & dst,
+          const Src & src ) {
+  if( (const void *)dst.data()==(const void *)src.data() ) {
+    Kokkos::fence();
+    return;
+  }
+  mp_add_staging( src.size()*sizeof(typename Src::value_type) );
+  Kokkos::deep_copy( dst, src );
+}
+
+// Host mirror of a message buffer (empty if MPI uses the buffer itself)
+
+template<class View>
+typename View::HostMirror
+mp_mirror( const View & d ) {
+  if( MP_DEVICE_BUFFERS ) return typename View::HostMirror();
+  return Kokkos::create_mirror_view( d );
+}
+
+// What to hand MPI for a message buffer d with mirror h
+
+template<class View>
+char *
+mp_buffer( const View & d,
+           const typename View::HostMirror & h ) {
+  return reinterpret_cast<char *>( MP_DEVICE_BUFFERS ? d.data() : h.data() );
+}
+
+// Make a message packed in d ready to send from mp_buffer( d, h )
+
+template<class View>
+void
+mp_stage_send( const typename View::HostMirror & h,
+               const View & d ) {
+  if( MP_DEVICE_BUFFERS ) Kokkos::fence(); // The packing kernels are done
+  else                    mp_stage( h, d );
+}
+
+// Make a message received in mp_buffer( d, h ) readable in d
+
+template<class View>
+void
+mp_stage_recv( const View & d,
+               const typename View::HostMirror & h ) {
+  if( !MP_DEVICE_BUFFERS ) mp_stage( d, h );
+}
+
 #endif /* mp_h */
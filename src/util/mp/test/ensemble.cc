@@ -0,0 +1,46 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "../../util.h"
+
+TEST_CASE( "ensemble", "[mp]" ) {
+
+  // Run as "ensemble --ensemble 2" on 2 (or any even number of) ranks
+
+  int pargc = 3;
+  char a0[] = "ensemble", a1[] = "--ensemble", a2[] = "2";
+  char * args[] = { a0, a1, a2, NULL };
+  char ** pargv = args;
+  boot_checkpt( NULL, NULL );
+  boot_mp( &pargc, &pargv );
+  REQUIRE( pargc==1 );
+
+  collective_t * universe = mp_universe();
+  const int n = world_size, member = mp_ensemble_member();
+  REQUIRE( mp_ensemble_size()==2 );
+
+  // The collectives see only the member
+
+  int one = 1, sum = 0;
+  mp_allsum_i( &one, &sum, 1 );
+  REQUIRE( sum==n );
+
+  int turns = 0;
+  BEGIN_TURNSTILE( 1 ) {
+    turns = world_rank + 1;
+  } END_TURNSTILE;
+  REQUIRE( turns==world_rank + 1 );
+
+  // The members can still talk over the whole job
+
+  mp_set_world( universe );
+  REQUIRE( world_size==2*n );
+  int m = member, m_sum = 0;
+  mp_allsum_i( &m, &m_sum, 1 );
+  REQUIRE( m_sum==n );
+
+  halt_mp();
+} // TEST
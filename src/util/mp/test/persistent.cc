@@ -0,0 +1,133 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "../../util.h"
+
+/* Six messages of different sizes (a face exchange of a small local
+   domain) to and from the partner process (itself when running alone),
+   made with a new request per message and with a persistent batch, with
+   standard mode sends and with synchronous ones.  Every message of every
+   exchange carries its own values, so a message received into the wrong
+   buffer or a batch that resends stale data is caught.  The timing of
+   the two ways is the messages benchmark deck (sample/bench). */
+
+#define N_MSG  6
+#define N_ITER 20
+#define SZ     1024 // Largest message in ints
+
+static int sbuf[N_MSG][SZ], rbuf[N_MSG][SZ];
+
+static int
+size( int m ) {
+  return (SZ/N_MSG)*(m+1);
+}
+
+static int
+value( int rank,
+       int m,
+       int it ) {
+  return ( ( rank*N_MSG + m )*N_ITER + it )*SZ;
+}
+
+static void
+fill( int * p,
+      int m,
+      int v ) {
+  for( int n=0; n<size(m); n++ ) p[n] = v + n;
+}
+
+static int
+check( const int * p,
+       int m,
+       int v ) {
+  for( int n=0; n<size(m); n++ ) if( p[n]!=v + n ) return 0;
+  return 1;
+}
+
+/* Returns the messages received with wrong values */
+
+static int
+exchange_ports( int partner ) {
+  mp_t * mp = new_mp( N_MSG );
+  int m, it, bad = 0;
+  for( m=0; m<N_MSG; m++ ) {
+    mp_size_recv_buffer( mp, m, size(m)*sizeof(int) );
+    mp_size_send_buffer( mp, m, size(m)*sizeof(int) );
+  }
+  for( it=0; it<N_ITER; it++ ) {
+    for( m=0; m<N_MSG; m++ )
+      mp_begin_recv( mp, m, size(m)*sizeof(int), partner, m );
+    for( m=0; m<N_MSG; m++ ) {
+      fill( (int *)mp_send_buffer( mp, m ), m, value( world_rank, m, it ) );
+      mp_begin_send( mp, m, size(m)*sizeof(int), partner, m );
+    }
+    for( m=0; m<N_MSG; m++ ) {
+      mp_end_recv( mp, m );
+      if( !check( (int *)mp_recv_buffer( mp, m ), m, value( partner, m, it ) ) ) bad++;
+    }
+    for( m=0; m<N_MSG; m++ ) mp_end_send( mp, m );
+  }
+  delete_mp( mp );
+  return bad;
+}
+
+/* NULL when the messaging layer has no persistent messages (the relay) */
+
+static mp_batch_t *
+batch( int partner ) {
+  mp_batch_t * b = new_mp_batch( N_MSG );
+  if( b )
+    for( int m=0; m<N_MSG; m++ ) {
+      mp_batch_add_recv( b, rbuf[m], size(m)*sizeof(int), partner, m );
+      mp_batch_add_send( b, sbuf[m], size(m)*sizeof(int), partner, m );
+    }
+  return b;
+}
+
+static int
+exchange_batch( mp_batch_t * b,
+                int partner ) {
+  int m, it, bad = 0;
+  for( it=0; it<N_ITER; it++ ) {
+    for( m=0; m<N_MSG; m++ ) fill( rbuf[m], m, -1 );
+    mp_batch_begin_recv( b );
+    for( m=0; m<N_MSG; m++ ) fill( sbuf[m], m, value( world_rank, m, it ) );
+    mp_batch_begin_send( b );
+    mp_batch_end_recv( b );
+    for( m=0; m<N_MSG; m++ ) if( !check( rbuf[m], m, value( partner, m, it ) ) ) bad++;
+    mp_batch_end_send( b );
+  }
+  return bad;
+}
+
+TEST_CASE( "persistent", "[mp]" ) {
+
+  boot_checkpt( NULL, NULL );
+  boot_mp( NULL, NULL );
+
+  const int partner = world_size>1 ? world_rank ^ 1 : world_rank;
+  if( partner<world_size ) {
+    const int eager = mp_eager_limit();
+
+    // All the messages fit under the default eager limit
+    mp_batch_t * b = batch( partner );
+    REQUIRE( exchange_ports( partner )==0 );
+    if( b ) REQUIRE( exchange_batch( b, partner )==0 );
+    if( b ) delete_mp_batch( b );
+
+    // Then all of them over it (synchronous sends); a batch takes the
+    // limit when its sends are added
+    mp_set_eager_limit( 1 );
+    b = batch( partner );
+    REQUIRE( exchange_ports( partner )==0 );
+    if( b ) REQUIRE( exchange_batch( b, partner )==0 );
+    if( b ) delete_mp_batch( b );
+    mp_set_eager_limit( eager );
+  }
+
+  mp_barrier();
+  halt_mp();
+} // TEST
@@ -0,0 +1,80 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "src/vpic/vpic.h"
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 1 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "staging", "[mp]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  {
+    // A copy is only made when the mirror is elsewhere
+    Kokkos::View<float*> d( "d", 8 );
+    Kokkos::View<float*>::HostMirror h = Kokkos::create_mirror_view( d );
+    int64_t n = mp_staging_copies();
+    mp_stage( h, d );
+    REQUIRE( mp_staging_copies()==n + ( KOKKOS_DEVICE_IS_HOST ? 0 : 1 ) );
+
+    // The current on the periodic faces (the local domain is its own
+    // neighbor) is summed in one exchange
+    grid_t * g = simulation->grid;
+    k_field_t f = simulation->field_array->k_f_d;
+    static const halo_comp_t jf[3] = { { field_var::jfx, HALO_SUM, { 1, 0, 0 } },
+                                       { field_var::jfy, HALO_SUM, { 0, 1, 0 } },
+                                       { field_var::jfz, HALO_SUM, { 0, 0, 1 } } };
+    halo_t halo( g, jf, 3 );
+    Kokkos::deep_copy( f, 1.0f );
+
+    n = mp_staging_copies();
+    begin_halo_exchange( halo, g, f );
+    end_halo_exchange( halo, g, f );
+    if( MP_DEVICE_BUFFERS ) REQUIRE( mp_staging_copies()==n );
+    else                    REQUIRE( mp_staging_copies()==n + 2 );
+
+    k_field_t::HostMirror fh = Kokkos::create_mirror_view( f );
+    Kokkos::deep_copy( fh, f );
+    const int nx = g->nx, ny = g->ny, nz = g->nz;
+    REQUIRE( fh( VOXEL(2,2,2, nx,ny,nz), field_var::jfx )==1 );
+    REQUIRE( fh( VOXEL(2,1,2, nx,ny,nz), field_var::jfx )==2 );
+    REQUIRE( fh( VOXEL(2,5,2, nx,ny,nz), field_var::jfx )==2 );
+    REQUIRE( fh( VOXEL(2,1,1, nx,ny,nz), field_var::jfx )==4 );
+    REQUIRE( fh( VOXEL(5,5,2, nx,ny,nz), field_var::jfz )==4 );
+  }
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -1,6 +1,10 @@
 #include "profile.h"
+#include "../mp/mp.h"
 #include "sys/time.h"
 
+#include <algorithm>
+#include <vector>
+
 profile_internal_use_only_timer_t profile_internal_use_only[] = {
 # define PROFILE_TIMER_INIT( timer ) { #timer, 0., 0., 0, 0 },
   PROFILE_TIMERS( PROFILE_TIMER_INIT )
@@ -53,3 +57,103 @@ wallclock( void ) {
   gettimeofday( tv, NULL );
   return (double)(tv->tv_sec) + 1e-6*(double)(tv->tv_usec);
 }
+
+double comm_stat[ n_comm_stat ], comm_stat_total[ n_comm_stat ];
+double comm_stat_other[ n_comm_stat ];
+double * comm_stat_now = comm_stat_other;
+
+// The counters and the busy time of every rank are gathered on rank 0
+// (a few hundred bytes per rank, once per report), which gives the
+// min / mean / max and the busiest ranks in one collective.
+
+void
+report_comm_stats( int n_step,
+                   int top_k ) {
+  profile_internal_use_only_timer_t * p;
+  const int n = 2*n_comm_stat + 1;
+  double loc[ 2*n_comm_stat+1 ];
+  int s, r;
+
+  // The counters of the steps, the busy time, then the counters outside
+  // the steps.  The time in the profiled operations since the last
+  // update_profile (which include the user diagnostics), less the time
+  // waiting on messages there, is the work of this rank.
+
+  for( s=0; s<n_comm_stat; s++ ) loc[s] = comm_stat[s];
+  loc[ n_comm_stat ] = 0;
+  for( p=profile_internal_use_only; p->name; p++ ) loc[ n_comm_stat ] += p->t;
+  loc[ n_comm_stat ] -= comm_stat[ comm_stat_wait ] + comm_stat_other[ comm_stat_wait ];
+  for( s=0; s<n_comm_stat; s++ ) loc[ n_comm_stat+1+s ] = comm_stat_other[s];
+
+  std::vector<double> all( world_rank==0 ? n*world_size : 0 );
+  mp_gather_uc( (unsigned char *)loc, (unsigned char *)all.data(), sizeof(loc) );
+
+  if( world_rank==0 ) {
+    static const char * label[] = {
+#   define COMM_STAT_LABEL( stat, label ) label,
+      COMM_STATS( COMM_STAT_LABEL )
+#   undef COMM_STAT_LABEL
+      "busy (s)"
+    };
+    const double rs = 1./(double)( n_step>0 ? n_step : 1 );
+    double mean_busy = 0, max_busy = 0;
+
+    log_printf( "\n"
+                "%25.25s |    Min        Mean       Max\n"
+                "--------------------------+----------------------------------\n",
+                "Per Step" );
+    for( s=0; s<=n_comm_stat; s++ ) {
+      double mn = all[s], mx = all[s], sum = 0;
+      for( r=0; r<world_size; r++ ) {
+        const double v = all[ r*n+s ];
+        mn = std::min( mn, v ), mx = std::max( mx, v ), sum += v;
+      }
+      if( s==n_comm_stat ) mean_busy = sum/(double)world_size, max_busy = mx;
+      if( mn==0 && mx==0 ) continue;
+      log_printf( "%25.25s | %.3e  %.3e  %.3e\n",
+                  label[s], rs*mn, rs*sum/(double)world_size, rs*mx );
+    }
+    log_printf( "Imbalance (max / mean busy): %.3f\n",
+                mean_busy>0 ? max_busy/mean_busy : 1. );
+
+    std::vector<int> rank( world_size );
+    for( r=0; r<world_size; r++ ) rank[r] = r;
+    top_k = std::min( std::max( top_k, 0 ), world_size );
+    std::partial_sort( rank.begin(), rank.begin()+top_k, rank.end(),
+                       [&]( int a, int b ) {
+                         return all[ a*n+n_comm_stat ]>all[ b*n+n_comm_stat ];
+                       } );
+    if( top_k ) log_printf( "Busiest ranks (busy / wait s per step):" );
+    for( r=0; r<top_k; r++ )
+      log_printf( " %i (%.3e / %.3e)", rank[r],
+                  rs*all[ rank[r]*n+n_comm_stat ],
+                  rs*all[ rank[r]*n+comm_stat_wait ] );
+    log_printf( "\n" );
+
+    // Not per step: the diagnostics may communicate on a few steps only
+    int first = 1;
+    for( s=0; s<n_comm_stat; s++ ) {
+      const int o = n_comm_stat+1+s;
+      double mn = all[o], mx = all[o], sum = 0;
+      for( r=0; r<world_size; r++ ) {
+        const double v = all[ r*n+o ];
+        mn = std::min( mn, v ), mx = std::max( mx, v ), sum += v;
+      }
+      if( mn==0 && mx==0 ) continue;
+      if( first )
+        log_printf( "\n"
+                    "%25.25s |    Min        Mean       Max\n"
+                    "--------------------------+----------------------------------\n",
+                    "Outside Steps (Total)" );
+      log_printf( "%25.25s | %.3e  %.3e  %.3e\n",
+                  label[s], mn, sum/(double)world_size, mx );
+      first = 0;
+    }
+    log_printf( "\n" );
+  }
+
+  for( s=0; s<n_comm_stat; s++ ) {
+    comm_stat_total[s] += comm_stat[s];
+    comm_stat[s] = 0, comm_stat_other[s] = 0;
+  }
+}
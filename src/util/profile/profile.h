@@ -17,6 +17,7 @@
   _( reduce_accumulators ) \
   _( emission_model    ) \
   _( boundary_p        ) \
+  _( boundary_p_device ) \
   _( clear_jf          ) \
   _( unload_accumulator ) \
   _( synchronize_jf    ) \
@@ -51,6 +52,7 @@
   _( BACKFILL ) \
   _( BACKFILL_COMPRESS ) \
   _( user_data_movement ) \
+  _( record_tracers    ) \
   _( user_diagnostics  )
 
 enum profile_internal_use_only_timers {
@@ -134,4 +136,53 @@ update_profile( int dump );
 double
 wallclock( void );
 
+// Communication telemetry.  The message passing layer and the particle
+// and field exchanges add to these counters on each rank (COMM_STAT).
+// Like the timers, add a line to this macro to add a counter.
+
+#define COMM_STATS(_) \
+  _( msg_sent,   "messages sent"    ) \
+  _( byte_sent,  "bytes sent"       ) \
+  _( msg_recv,   "messages received" ) \
+  _( byte_recv,  "bytes received"   ) \
+  _( wait,       "message wait (s)" ) \
+  _( pack,       "pack / unpack (s)" ) \
+  _( mover_mx,   "movers to -x"     ) \
+  _( mover_px,   "movers to +x"     ) \
+  _( mover_my,   "movers to -y"     ) \
+  _( mover_py,   "movers to +y"     ) \
+  _( mover_mz,   "movers to -z"     ) \
+  _( mover_pz,   "movers to +z"     ) \
+  _( mover_diag, "movers to edges / corners" )
+
+enum comm_stats {
+# define COMM_STAT_ENUM( stat, label ) comm_stat_##stat,
+  COMM_STATS( COMM_STAT_ENUM )
+# undef COMM_STAT_ENUM
+  n_comm_stat
+};
+
+extern double comm_stat[ n_comm_stat ];       // In steps since the last report
+extern double comm_stat_total[ n_comm_stat ]; // In steps before the last report
+extern double comm_stat_other[ n_comm_stat ]; // Outside them since the last report
+
+// The counters COMM_STAT adds to: comm_stat while a step runs (see
+// vpic_simulation::advance) and comm_stat_other otherwise (setup,
+// restores, and the user diagnostics with their dumps and checkpoints)
+
+extern double * comm_stat_now;
+
+#define COMM_STAT( stat, v ) ( comm_stat_now[ comm_stat_##stat ] += (double)(v) )
+
+// Reduces the counters over all ranks, writes the min / mean / max per
+// step and the top_k ranks with the most time in the profiled operations
+// outside message waits to the log (on rank 0), followed by the totals
+// of the messages outside the steps, and resets them.  Call
+// it over the steps profiled since the last update_profile, before the
+// next update_profile.  Must be called by all ranks.
+
+void
+report_comm_stats( int n_step,
+                   int top_k );
+
 #endif // _profile_h_
@@ -0,0 +1,197 @@
+#ifndef _philox_h_
+#define _philox_h_
+
+/* Counter-based random numbers for device kernels.
+
+   philox4x32 is the Philox-4x32-10 bijection of Salmon et al, "Parallel
+   random numbers: as easy as 1, 2, 3" (SC11): a 128-bit counter and a
+   64-bit key map to 128 random bits.  There is no generator state beyond
+   the counter, so a deviate depends only on what it is keyed by, not on
+   which thread draws it or in what order.
+
+   counter_rng is keyed by (seed, rank, stream, index, step).  index is
+   typically a particle or voxel index and stream tells apart the users
+   of the same seed: philox_stream tags it with the operator drawing
+   (top four bits) over the operator's own bits (e.g. a species id).
+   Successive draws advance a draw
+   counter in the remaining counter word, so each (seed, rank, stream,
+   index, step) has 2^34 deviates to itself.  Nothing needs
+   checkpointing; a restart at step n draws what the original run drew.
+
+   The integer and uniform outputs are bit-exact on every platform and
+   the scalar host code is the reference for the device.  The normal and
+   exponential variants go through logf, cosf and sinf, so they can
+   differ in the last bit between math libraries. */
+
+#include <stdint.h>
+#include <math.h>
+
+#ifndef KOKKOS_INLINE_FUNCTION
+#define KOKKOS_INLINE_FUNCTION inline
+#endif
+
+/* 32x32->64 bit product split into its high and low words */
+
+KOKKOS_INLINE_FUNCTION uint32_t
+philox_mulhilo( const uint32_t a, const uint32_t b, uint32_t & hi ) {
+  const uint64_t p = (uint64_t)a*(uint64_t)b;
+  hi = (uint32_t)( p>>32 );
+  return (uint32_t)p;
+}
+
+/* Philox-4x32-10.  ctr and key are not modified; the result is in out. */
+
+KOKKOS_INLINE_FUNCTION void
+philox4x32( const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4] ) {
+  uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+  uint32_t k0 = key[0], k1 = key[1];
+  for( int r=0; r<10; r++ ) {
+    uint32_t hi0, hi1;
+    const uint32_t lo0 = philox_mulhilo( 0xD2511F53u, c0, hi0 );
+    const uint32_t lo1 = philox_mulhilo( 0xCD9E8D57u, c2, hi1 );
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += 0x9E3779B9u;
+    k1 += 0xBB67AE85u;
+  }
+  out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/* Integer to float conversions.  u01 is on [0,1) and u01_open on (0,1],
+   both in steps of 2^-24 so the conversion is exact. */
+
+KOKKOS_INLINE_FUNCTION float
+philox_u01( const uint32_t x ) {
+  return (float)( x>>8 )*5.9604644775390625e-8f;
+}
+
+KOKKOS_INLINE_FUNCTION float
+philox_u01_open( const uint32_t x ) {
+  return (float)( ( x>>8 ) + 1 )*5.9604644775390625e-8f;
+}
+
+/* Operator tags of the stream.  Most operators default to seed 0, so
+   without these two operators on the same species would draw the same
+   deviates.  Give every new caller its own tag. */
+
+enum philox_stream_tag {
+  philox_langevin = 0x10000000u,
+  philox_unary    = 0x20000000u,
+  philox_coulomb  = 0x30000000u,
+  philox_boundary = 0x40000000u,
+  philox_inject   = 0x50000000u,
+  philox_emitter  = 0x60000000u
+};
+
+KOKKOS_INLINE_FUNCTION uint32_t
+philox_stream( const uint32_t tag, const uint32_t bits ) {
+  return tag | ( bits & 0x0fffffffu );
+}
+
+struct counter_rng {
+
+  KOKKOS_INLINE_FUNCTION
+  counter_rng( const uint32_t seed,
+               const uint32_t rank,
+               const uint32_t stream,
+               const uint32_t index,
+               const int64_t step ) : n_left(0), has_normal(0), spare(0) {
+    key[0] = seed;
+    key[1] = rank;
+    ctr[0] = 0;
+    ctr[1] = index;
+    ctr[2] = (uint32_t)step;
+    ctr[3] = stream;
+  }
+
+  uint32_t key[2];
+  uint32_t ctr[4];
+  uint32_t buf[4];
+  int n_left;
+  int has_normal;
+  float spare;
+
+  /* Next block of 4 random words */
+
+  KOKKOS_INLINE_FUNCTION void
+  next4( uint32_t out[4] ) {
+    philox4x32( ctr, key, out );
+    ctr[0]++;
+  }
+
+  KOKKOS_INLINE_FUNCTION uint32_t
+  urand32() {
+    if( !n_left ) { next4( buf ); n_left = 4; }
+    return buf[ --n_left ];
+  }
+
+  /* Uniform on [0,n) (n>0).  The multiply-shift has a bias of at most
+     n/2^32, far below anything a particle code can resolve. */
+
+  KOKKOS_INLINE_FUNCTION uint32_t
+  urand( const uint32_t n ) {
+    return (uint32_t)( ( (uint64_t)urand32()*(uint64_t)n )>>32 );
+  }
+
+  /* Uniform on [0,1) */
+
+  KOKKOS_INLINE_FUNCTION float
+  frand() { return philox_u01( urand32() ); }
+
+  /* Uniform on (0,1] */
+
+  KOKKOS_INLINE_FUNCTION float
+  frand_c1() { return philox_u01_open( urand32() ); }
+
+  /* Standard normal (Box-Muller, the second deviate is kept for the
+     next call) */
+
+  KOKKOS_INLINE_FUNCTION float
+  normal() {
+    if( has_normal ) { has_normal = 0; return spare; }
+    const float r = sqrtf( -2*logf( frand_c1() ) );
+    const float t = 6.28318530717958647692f*frand();
+    spare = r*sinf( t );
+    has_normal = 1;
+    return r*cosf( t );
+  }
+
+  /* Exponential of unit mean */
+
+  KOKKOS_INLINE_FUNCTION float
+  exponential() { return -logf( frand_c1() ); }
+
+  /* Vectorized variants: four deviates from one Philox block.  These
+     don't touch the scalar buffer. */
+
+  KOKKOS_INLINE_FUNCTION void
+  frand4( float u[4] ) {
+    uint32_t x[4];
+    next4( x );
+    for( int k=0; k<4; k++ ) u[k] = philox_u01( x[k] );
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  normal4( float n[4] ) {
+    uint32_t x[4];
+    next4( x );
+    for( int k=0; k<4; k+=2 ) {
+      const float r = sqrtf( -2*logf( philox_u01_open( x[k] ) ) );
+      const float t = 6.28318530717958647692f*philox_u01( x[k+1] );
+      n[k]   = r*cosf( t );
+      n[k+1] = r*sinf( t );
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION void
+  exponential4( float e[4] ) {
+    uint32_t x[4];
+    next4( x );
+    for( int k=0; k<4; k++ ) e[k] = -logf( philox_u01_open( x[k] ) );
+  }
+
+}; // struct counter_rng
+
+#endif // _philox_h_
@@ -0,0 +1,120 @@
+/*~--------------------------------------------------------------------------~*
+ *~--------------------------------------------------------------------------~*/
+
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+
+#include "src/util/rng/philox.h"
+
+/* Known answers of Philox-4x32-10 from the Random123 distribution */
+
+static void check_kat( const uint32_t ctr[4], const uint32_t key[2],
+                       const uint32_t expect[4] ) {
+  uint32_t out[4];
+  philox4x32( ctr, key, out );
+  for( int k=0; k<4; k++ ) REQUIRE( out[k]==expect[k] );
+}
+
+TEST_CASE( "philox4x32 known answers", "[rng]" ) {
+
+  SECTION( "zero" ) {
+    const uint32_t ctr[4] = { 0, 0, 0, 0 }, key[2] = { 0, 0 };
+    const uint32_t expect[4] = { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 };
+    check_kat( ctr, key, expect );
+  }
+
+  SECTION( "ones" ) {
+    const uint32_t ctr[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+    const uint32_t key[2] = { 0xffffffff, 0xffffffff };
+    const uint32_t expect[4] = { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd };
+    check_kat( ctr, key, expect );
+  }
+
+  SECTION( "pi" ) {
+    const uint32_t ctr[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+    const uint32_t key[2] = { 0xa4093822, 0x299f31d0 };
+    const uint32_t expect[4] = { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 };
+    check_kat( ctr, key, expect );
+  }
+
+} // TEST
+
+TEST_CASE( "counter_rng draws depend only on their key", "[rng]" ) {
+
+  // The same key gives the same sequence however many other generators
+  // were used in between
+  counter_rng a( 1234, 3, 7, 42, 100 );
+  float first[16];
+  for( int n=0; n<16; n++ ) first[n] = a.frand();
+
+  for( int index=0; index<1000; index++ ) {
+    counter_rng other( 1234, 3, 7, index, 100 );
+    other.frand();
+  }
+
+  counter_rng b( 1234, 3, 7, 42, 100 );
+  for( int n=0; n<16; n++ ) REQUIRE( b.frand()==first[n] );
+
+  // Changing any part of the key changes the sequence
+  counter_rng c( 1234, 3, 7, 42, 101 );
+  counter_rng d( 1234, 4, 7, 42, 100 );
+  counter_rng e( 1234, 3, 8, 42, 100 );
+  REQUIRE( c.urand32()!=counter_rng( 1234, 3, 7, 42, 100 ).urand32() );
+  REQUIRE( d.urand32()!=counter_rng( 1234, 3, 7, 42, 100 ).urand32() );
+  REQUIRE( e.urand32()!=counter_rng( 1234, 3, 7, 42, 100 ).urand32() );
+
+  // Operators drawing for the same species get different streams
+  const uint32_t tag[] = { philox_langevin, philox_unary, philox_coulomb,
+                           philox_boundary, philox_inject, philox_emitter };
+  for( int a=0; a<6; a++ )
+    for( int b=0; b<a; b++ ) {
+      REQUIRE( philox_stream( tag[a], 0 )!=philox_stream( tag[b], 0 ) );
+      REQUIRE( counter_rng( 1234, 3, philox_stream( tag[a], 7 ), 42, 100 ).urand32()!=
+               counter_rng( 1234, 3, philox_stream( tag[b], 7 ), 42, 100 ).urand32() );
+    }
+
+} // TEST
+
+TEST_CASE( "counter_rng distributions", "[rng]" ) {
+
+  const int N = 1<<20;
+  double s_u = 0, s_n = 0, s_nn = 0, s_e = 0, s_u4 = 0, s_n4 = 0, s_e4 = 0;
+  float lo = 1, hi = 0;
+
+  for( int i=0; i<N/4; i++ ) {
+    counter_rng r( 99, 0, 1, i, 5 );
+    for( int k=0; k<4; k++ ) {
+      const float u = r.frand();
+      lo = u<lo ? u : lo;
+      hi = u>hi ? u : hi;
+      s_u += u;
+      const float n = r.normal();
+      s_n += n; s_nn += n*n;
+      const float e = r.exponential();
+      REQUIRE( e>=0 );
+      s_e += e;
+    }
+    float v[4];
+    r.frand4( v );       for( int k=0; k<4; k++ ) s_u4 += v[k];
+    r.normal4( v );      for( int k=0; k<4; k++ ) s_n4 += v[k];
+    r.exponential4( v ); for( int k=0; k<4; k++ ) s_e4 += v[k];
+  }
+
+  REQUIRE( lo>=0 );
+  REQUIRE( hi<1 );
+  REQUIRE( std::fabs( s_u/N - 0.5 ) < 2e-3 );
+  REQUIRE( std::fabs( s_n/N ) < 5e-3 );
+  REQUIRE( std::fabs( s_nn/N - 1 ) < 5e-3 );
+  REQUIRE( std::fabs( s_e/N - 1 ) < 5e-3 );
+  REQUIRE( std::fabs( s_u4/N - 0.5 ) < 2e-3 );
+  REQUIRE( std::fabs( s_n4/N ) < 5e-3 );
+  REQUIRE( std::fabs( s_e4/N - 1 ) < 5e-3 );
+
+  for( int n=1; n<100; n++ ) {
+    counter_rng r( 7, 0, 0, n, 0 );
+    for( int k=0; k<100; k++ ) REQUIRE( r.urand( n )<(uint32_t)n );
+  }
+
+} // TEST
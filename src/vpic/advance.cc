@@ -21,6 +21,15 @@ int vpic_simulation::advance(void)
   // Determine if we are done ... see note below why this is done here
   if( num_step>0 && step()>=num_step ) return 0;
 
+  // Count the messages of the step apart from those of the setup and the
+  // diagnostics (see COMM_STATS)
+  comm_stat_now = comm_stat;
+
+  // Rebalance while the particles are all in the local domain and the
+  // movers are empty (i.e. before anything below touches them)
+  if( rebalance_interval>0 && (step() % rebalance_interval)==0 )
+    rebalance();
+
   KOKKOS_TIC();
 
   // Sort the particles for performance if desired.
@@ -29,7 +38,10 @@ int vpic_simulation::advance(void)
       if( (sp->sort_interval>0) && ((step() % sp->sort_interval)==0) )
       {
           if( rank()==0 ) MESSAGE(( "Performance sorting \"%s\"", sp->name ));
-          sorter.sort( sp->k_p_d, sp->k_p_i_d, sp->np, grid->nv);
+          sorter.sort( sp->k_p_d, sp->k_p_i_d, sp->k_p_id_d, sp->np, grid->nv);
+#if defined(SORT_BY_VOXEL) && !defined(SORT_TILE_SIZE)
+          sp->last_sorted = step();
+#endif
       }
   }
 
@@ -58,7 +70,6 @@ int vpic_simulation::advance(void)
   //printf("Cleared jf\n");
   if( collision_op_list )
   {
-      Kokkos::abort("Collision is not supported");
       TIC apply_collision_op_list( collision_op_list ); TOC( collision_model, 1 );
   }
 
@@ -66,11 +77,13 @@ int vpic_simulation::advance(void)
   //TIC user_particle_collisions(); TOC( user_particle_collisions, 1 );
 
   // DEVICE function - Touches particles, particle movers, accumulators, interpolators
+  const double push_tic = wallclock();
   LIST_FOR_EACH( sp, species_list )
   {
       // Now Times internally
       advance_p( sp, interpolator_array, field_array );
   }
+  rebalance_push_time += wallclock() - push_tic; // advance_p fences
   //printf("Pushed\n");
 
   // Reduce accumulator contributions into the device array
@@ -84,42 +97,54 @@ int vpic_simulation::advance(void)
   //field_array->k_field_sa_d.reset();
   KOKKOS_TOC( field_sa_contributions, 1);
 
-  // Copy particle movers back to host
-  KOKKOS_TIC();
-  LIST_FOR_EACH( sp, species_list ) {
-    sp->copy_outbound_to_host();
-  }
-  KOKKOS_TOC( PARTICLE_DATA_MOVEMENT, 1);
-
   // Because the partial position push when injecting aged particles might
   // place those particles onto the guard list (boundary interaction) and
   // because advance_p requires an empty guard list, particle injection must
   // be done after advance_p and before guard list processing. Note:
   // user_particle_injection should be a stub if species_list is empty.
 
-  // Probably needs to be on host due to user particle injection
-  // May not touch memory?
+  // Device injection appends to the device movers, so it runs before they
+  // are processed.
+  const int inject_particles_now = (particle_injection_interval>0) &&
+                                   ((step() % particle_injection_interval)==0);
+  if( inject_particles_now && kokkos_particle_injection ) {
+      TIC user_particle_injection(); TOC( user_particle_injection, 1 );
+  }
+
+  // Emitters run on the device and append to the particles and movers
+  // left by advance_p, so they come before the movers are processed.
   if( emitter_list )
   {
     TIC apply_emitter_list( emitter_list ); TOC( emission_model, 1 );
   }
 
-  if((particle_injection_interval>0) && ((step() % particle_injection_interval)==0)) {
-      if(!kokkos_particle_injection) {
-          KOKKOS_TIC();
-          LIST_FOR_EACH( sp, species_list ) {
-            sp->copy_to_host();
-          }
-          KOKKOS_TOC(PARTICLE_DATA_MOVEMENT, 1);
+  // Apply the custom particle boundary conditions that can run on the
+  // device while the movers are still there
+  if( particle_bc_list )
+  {
+    TIC boundary_p_device( particle_bc_list, species_list, field_array ); TOC( boundary_p_device, 1 );
+  }
+
+  // Copy particle movers back to host
+  KOKKOS_TIC();
+  LIST_FOR_EACH( sp, species_list ) {
+    sp->copy_outbound_to_host();
+  }
+  KOKKOS_TOC( PARTICLE_DATA_MOVEMENT, 1);
+
+  // Host injection needs a full copy of the particles
+  if( inject_particles_now && !kokkos_particle_injection ) {
+      KOKKOS_TIC();
+      LIST_FOR_EACH( sp, species_list ) {
+        sp->copy_to_host();
       }
+      KOKKOS_TOC(PARTICLE_DATA_MOVEMENT, 1);
       TIC user_particle_injection(); TOC( user_particle_injection, 1 );
-      if(!kokkos_particle_injection) {
-          KOKKOS_TIC();
-          LIST_FOR_EACH( sp, species_list ) {
-            sp->copy_to_device();
-          }
-          KOKKOS_TOC(PARTICLE_DATA_MOVEMENT, 1);
+      KOKKOS_TIC();
+      LIST_FOR_EACH( sp, species_list ) {
+        sp->copy_to_device();
       }
+      KOKKOS_TOC(PARTICLE_DATA_MOVEMENT, 1);
   }
 
   //bool accumulate_in_place = false; // This has to be outside the scoped timing block
@@ -153,13 +178,22 @@ int vpic_simulation::advance(void)
 
   // HOST - Touches particle copies, particle_movers, particle_injectors,
   // accumulators (move_p), neighbors
+  //
+  // In the diagonal exchange, movers crossing an edge or corner go straight
+  // to their final rank, so one round normally suffices.  A second
+  // (straggler) round picks up particles that crossed more than one
+  // domain in a step.  The round count is fixed so no rank has to ask the
+  // others whether anything is still in flight.
+  const int n_comm_round = diagonal_particle_exchange ?
+                           std::min( 2, num_comm_round ) : num_comm_round;
   TIC
-    for( int round=0; round<num_comm_round; round++ )
+    for( int round=0; round<n_comm_round; round++ )
     {
       //boundary_p( particle_bc_list, species_list, field_array, accumulator_array );
-      boundary_p_kokkos( particle_bc_list, species_list, field_array );
+      boundary_p_kokkos( particle_bc_list, species_list, field_array,
+                         diagonal_particle_exchange );
     }
-  TOC( boundary_p, num_comm_round );
+  TOC( boundary_p, n_comm_round );
 
   // Clean_up once boundary p is done
   // Copy back the right data to GPU
@@ -217,7 +251,17 @@ int vpic_simulation::advance(void)
   FAK->k_reduce_jf(field_array);
   KOKKOS_TOC( JF_ACCUM_DATA_MOVEMENT, 1);
   //  TIC FAK->synchronize_jf( field_array ); TOC( synchronize_jf, 1 );
-  TIC FAK->k_synchronize_jf( field_array ); TOC( synchronize_jf, 1 );
+  // With fuse_field_exchange, the first half advance of the magnetic field
+  // (which does not need the current) comes first, so its ghost
+  // tangential values for advance_e travel with the current in one round.
+  if( fuse_field_exchange ) {
+    KOKKOS_TIC();
+    FAK->advance_b( field_array, 0.5 );
+    KOKKOS_TOC( advance_b, 1 );
+    TIC FAK->k_synchronize_jf_tang_b( field_array ); TOC( synchronize_jf, 1 );
+  } else {
+    TIC FAK->k_synchronize_jf( field_array ); TOC( synchronize_jf, 1 );
+  }
 
   // At this point, the particle currents are known at jf_{1/2}.
   // Let the user add their own current contributions. It is the users
@@ -229,22 +273,24 @@ int vpic_simulation::advance(void)
   if((current_injection_interval>0) && ((step() % current_injection_interval)==0)) {
       if(!kokkos_current_injection) {
           KOKKOS_TIC();
-          field_array->copy_to_host();
+          copy_injection_region_to_host();
           KOKKOS_TOC(FIELD_DATA_MOVEMENT, 1);
       }
       TIC user_current_injection(); TOC( user_current_injection, 1 );
       if(!kokkos_current_injection) {
           KOKKOS_TIC();
-          field_array->copy_to_device();
+          copy_injection_region_to_device();
           KOKKOS_TOC(FIELD_DATA_MOVEMENT, 1);
       }
   }
 
   // DEVICE -- Touches fields
   // Half advance the magnetic field from B_0 to B_{1/2}
-  KOKKOS_TIC();
-  FAK->advance_b( field_array, 0.5 );
-  KOKKOS_TOC( advance_b, 1 );
+  if( !fuse_field_exchange ) {
+    KOKKOS_TIC();
+    FAK->advance_b( field_array, 0.5 );
+    KOKKOS_TOC( advance_b, 1 );
+  }
 
   // Advance the electric field from E_0 to E_1
 
@@ -259,13 +305,13 @@ int vpic_simulation::advance(void)
   if ((field_injection_interval>0) && ((step() % field_injection_interval)==0)) {
       if (!kokkos_field_injection) {
           KOKKOS_TIC();
-          field_array->copy_to_host();
+          copy_injection_region_to_host();
           KOKKOS_TOC(FIELD_DATA_MOVEMENT, 1);
       }
       TIC user_field_injection(); TOC( user_field_injection, 1 );
       if (!kokkos_field_injection) {
           KOKKOS_TIC();
-          field_array->copy_to_device();
+          copy_injection_region_to_device();
           KOKKOS_TOC(FIELD_DATA_MOVEMENT, 1);
       }
   }
@@ -359,13 +405,24 @@ int vpic_simulation::advance(void)
 
   step()++;
 
+  // Sample the tracer particles, now the interpolator is current
+  LIST_FOR_EACH( sp, species_list )
+  {
+      if( sp->tracer && (step() % sp->tracer->interval)==0 )
+      {
+          TIC record_tracers( sp->tracer, interpolator_array, step() ); TOC( record_tracers, 1 );
+      }
+  }
+
   // Print out status
   if( (status_interval>0) && ((step() % status_interval)==0) ) {
       if( rank()==0 ) MESSAGE(( "Completed step %i of %i", step(), num_step ));
+      report_comm_stats( status_interval, comm_report_ranks );
       update_profile( rank()==0 );
   }
 
   // Let the user compute diagnostics
+  comm_stat_now = comm_stat_other;
   TIC user_diagnostics(); TOC( user_diagnostics, 1 );
 
   // "return step()!=num_step" is more intuitive. But if a checkpt
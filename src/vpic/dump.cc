@@ -32,6 +32,21 @@ int vpic_simulation::dump_cwd(char * dname, size_t size) {
 	return FileUtils::getCurrentWorkingDirectory(dname, size);
 } // dump_mkdir
 
+// Returns the settings to write with.  Unless the deck asked for a
+// thread count, the encoder gets the threads of this rank's pipeline
+// dispatcher rather than every core on the node.
+
+static FileIOCompression
+check_compression( const FileIOCompression & c ) {
+  if( c.codec!=codec_none && c.codec!=codec_lossless && c.codec!=codec_quantize )
+    ERROR(( "Unknown dump compression codec %d", int(c.codec) ));
+  if( c.codec==codec_quantize && !( c.abs_tolerance>0 || c.rel_tolerance>0 ) )
+    ERROR(( "Quantized dumps need a positive abs_tolerance or rel_tolerance" ));
+  FileIOCompression r = c;
+  if( r.threads<=0 ) r.threads = thread.n_pipeline>0 ? thread.n_pipeline : 1;
+  return r;
+} // check_compression
+
 /*****************************************************************************
  * ASCII dump IO
  *****************************************************************************/
@@ -136,6 +151,8 @@ namespace dump_type {
   const int particle_dump = 3;
   const int restart_dump = 4;
   const int history_dump = 5;
+  const int selected_particle_dump = 6;
+  const int histogram_dump = 7;
 } // namespace
 
 void
@@ -295,21 +312,14 @@ vpic_simulation::dump_particles( const char *sp_name,
     species_t *sp;
     char fname[max_filename_bytes];
     FileIO fileIO;
-    int dim[1], buf_start;
-    static particle_t * ALIGNED(128) p_buf = NULL;
-# define PBUF_SIZE 32768 // 1MB of particles
+    int dim[1];
+# define PBUF_SIZE 1048576 // 32MB of particles per staging buffer
 
     sp = find_species_name( sp_name, species_list );
     if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
 
     if( !fbase ) ERROR(( "Invalid filename" ));
 
-    // Update the particles on the host only if they haven't been recently
-    if (step() > sp->last_copied)
-      sp->copy_to_host();
-
-    if( !p_buf ) MALLOC_ALIGNED( p_buf, PBUF_SIZE, 128 );
-
     if( rank()==0 )
         MESSAGE(("Dumping \"%s\" particles to \"%s\"",sp->name,fbase));
 
@@ -333,33 +343,149 @@ vpic_simulation::dump_particles( const char *sp_name,
 
     WRITE_HEADER_V0( dump_type::particle_dump, sp->id, sp->q/sp->m, fileIO );
 
-    dim[0] = sp->np;
-    WRITE_ARRAY_HEADER( p_buf, 1, dim, fileIO );
-
-    // Copy a PBUF_SIZE hunk of the particle list into the particle
-    // buffer, timecenter it and write it out. This is done this way to
-    // guarantee the particle list unchanged while not requiring too
-    // much memory.
-
-    // FIXME: WITH A PIPELINED CENTER_P, PBUF NOMINALLY SHOULD BE QUITE
-    // LARGE.
-
-    particle_t * sp_p = sp->p;      sp->p      = p_buf;
-    int sp_np         = sp->np;     sp->np     = 0;
-    int sp_max_np     = sp->max_np; sp->max_np = PBUF_SIZE;
-    for( buf_start=0; buf_start<sp_np; buf_start += PBUF_SIZE ) {
-        sp->np = sp_np-buf_start; if( sp->np > PBUF_SIZE ) sp->np = PBUF_SIZE;
-        COPY( sp->p, &sp_p[buf_start], sp->np );
-        center_p( sp, interpolator_array );
-        fileIO.write( sp->p, sp->np );
+    const int np = sp->np;
+    dim[0] = np;
+    WRITE_ARRAY_HEADER( sp->p, 1, dim, fileIO );
+
+    // Stream the species through the device: each chunk is time-centered
+    // on the device into a staging buffer and copied to one of two pinned
+    // host buffers.  The kernel and transfer of chunk k+1 are in flight
+    // while chunk k is written, and the particles on the device are left
+    // unchanged.
+
+    const int chunk = std::min( np, PBUF_SIZE );
+    const int n_chunk = chunk ? (np + chunk - 1)/chunk : 0;
+    const float qdt_2mc = (sp->q*grid->dt)/(2*sp->m*grid->cvac);
+
+    Kokkos::DefaultExecutionSpace exec;
+    k_particle_dump_t k_buf( Kokkos::ViewAllocateWithoutInitializing("particle dump"), chunk );
+    Kokkos::View<particle_t*, KOKKOS_PINNED_SPACE> h_buf[2] = {
+      Kokkos::View<particle_t*, KOKKOS_PINNED_SPACE>( Kokkos::ViewAllocateWithoutInitializing("particle dump 0"), chunk ),
+      Kokkos::View<particle_t*, KOKKOS_PINNED_SPACE>( Kokkos::ViewAllocateWithoutInitializing("particle dump 1"), n_chunk>1 ? chunk : 0 )
+    };
+
+    auto stage = [&]( int c ) {
+      const int first = c*chunk;
+      const int n = std::min( chunk, np - first );
+      auto range = std::make_pair( 0, n );
+      center_p_kokkos( exec, sp->k_p_d, sp->k_p_i_d, interpolator_array->k_i_d,
+                       k_buf, first, n, qdt_2mc );
+      Kokkos::deep_copy( exec, Kokkos::subview( h_buf[c&1], range ),
+                         Kokkos::subview( k_buf, range ) );
+    };
+
+    if( n_chunk ) stage( 0 );
+    for( int c=0; c<n_chunk; c++ ) {
+      exec.fence(); // chunk c is on the host
+      if( c+1<n_chunk ) stage( c+1 );
+      fileIO.write( h_buf[c&1].data(), std::min( chunk, np - c*chunk ) );
     }
-    sp->p      = sp_p;
-    sp->np     = sp_np;
-    sp->max_np = sp_max_np;
+# undef PBUF_SIZE
 
     if( fileIO.close() ) ERROR(("File close failed on dump particles!!!"));
 }
 
+void
+vpic_simulation::write_selected_particles( const species_t *sp,
+                                           const char *fbase,
+                                           int ftag,
+                                           const selected_particle_t *p,
+                                           int n )
+{
+    char fname[max_filename_bytes];
+    FileIO fileIO;
+    int dim[1];
+
+    if( rank()==0 )
+        MESSAGE(("Dumping selected \"%s\" particles to \"%s\"",sp->name,fbase));
+
+    if( ftag ) {
+        snprintf( fname, max_filename_bytes, "%s.%li.%i", fbase, (long)step(), rank() );
+    }
+    else {
+        snprintf( fname, max_filename_bytes, "%s.%i", fbase, rank() );
+    }
+
+    FileIOStatus status = fileIO.open(fname, io_write);
+    if( status==fail ) ERROR(( "Could not open \"%s\"", fname ));
+
+    /* IMPORTANT: these values are written in WRITE_HEADER_V0 */
+    nxout = grid->nx;
+    nyout = grid->ny;
+    nzout = grid->nz;
+    dxout = grid->dx;
+    dyout = grid->dy;
+    dzout = grid->dz;
+
+    WRITE_HEADER_V0( dump_type::selected_particle_dump, sp->id, sp->q/sp->m, fileIO );
+
+    dim[0] = n;
+    WRITE_ARRAY_HEADER( p, 1, dim, fileIO );
+    fileIO.write( p, n );
+
+    if( fileIO.close() ) ERROR(("File close failed on dump selected particles!!!"));
+}
+
+// Histogram dumps hold the standard header, then for each axis the int
+// quantity, int log flag, float min and float max (see
+// particle_histogram.h), then the double bin array (axis 0 fastest).
+
+void
+vpic_simulation::dump_histogram( const char *sp_name,
+                                 const char *fbase,
+                                 const ParticleHistogram & hist,
+                                 int ftag )
+{
+    char fname[max_filename_bytes];
+    FileIO fileIO;
+    int dim[2];
+
+    species_t * sp = find_species_name( sp_name, species_list );
+    if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
+    if( !fbase ) ERROR(( "Invalid filename" ));
+
+    // Only the bins cross to the host
+    auto k_hist = histogram_particles( sp, interpolator_array, hist );
+    auto h_hist = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), k_hist );
+
+    const int nbins = hist.nbins();
+    std::vector<double> global( nbins );
+    mp_allsum_d( h_hist.data(), global.data(), nbins );
+
+    if( rank() ) return;
+
+    MESSAGE(("Dumping \"%s\" histogram to \"%s\"",sp->name,fbase));
+
+    if( ftag ) snprintf( fname, max_filename_bytes, "%s.%li", fbase, (long)step() );
+    else       snprintf( fname, max_filename_bytes, "%s", fbase );
+
+    FileIOStatus status = fileIO.open(fname, io_write);
+    if( status==fail ) ERROR(( "Could not open \"%s\"", fname ));
+
+    /* IMPORTANT: these values are written in WRITE_HEADER_V0 */
+    nxout = grid->nx;
+    nyout = grid->ny;
+    nzout = grid->nz;
+    dxout = grid->dx;
+    dyout = grid->dy;
+    dzout = grid->dz;
+
+    WRITE_HEADER_V0( dump_type::histogram_dump, sp->id, sp->q/sp->m, fileIO );
+
+    for( int d=0; d<hist.ndim; d++ ) {
+        WRITE( int,   hist.axis[d].quantity, fileIO );
+        WRITE( int,   hist.axis[d].log,      fileIO );
+        WRITE( float, hist.axis[d].min,      fileIO );
+        WRITE( float, hist.axis[d].max,      fileIO );
+        dim[d] = hist.axis[d].nbins;
+    }
+
+    WRITE_ARRAY_HEADER( global, hist.ndim, dim, fileIO );
+    fileIO.write( global.data(), nbins );
+
+    if( fileIO.close() ) ERROR(("File close failed on dump histogram!!!"));
+}
+
 /*------------------------------------------------------------------------------
  * New dump logic
  *---------------------------------------------------------------------------*/
@@ -598,6 +724,9 @@ vpic_simulation::field_dump( DumpParameters & dumpParams ) {
   if(remainder(grid->nz, kstride) != 0)
     ERROR(("z stride must be an integer factor of nz"));
 
+  const FileIOCompression compression = check_compression(dumpParams.compression);
+  const int header_version = compression.codec != codec_none ? 1 : 0;
+
   int dim[3];
 
   /* define to do C-style indexing */
@@ -621,7 +750,7 @@ vpic_simulation::field_dump( DumpParameters & dumpParams ) {
 
   if(dumpParams.format == band) {
 
-    WRITE_HEADER_V0(dump_type::field_dump, -1, 0, fileIO);
+    WRITE_HEADER_VERSION(header_version, dump_type::field_dump, -1, 0, fileIO);
 
     dim[0] = nxout+2;
     dim[1] = nyout+2;
@@ -648,8 +777,28 @@ vpic_simulation::field_dump( DumpParameters & dumpParams ) {
 
     if( rank()==VERBOSE_rank ) printf("\nBEGIN_OUTPUT\n");
 
+    // compressed output gathers each variable into one block first
+    if(compression.codec != codec_none) {
+      std::vector<uint32_t> block(size_t(dim[0])*dim[1]*dim[2]);
+      for(size_t v(0); v<numvars; v++) {
+        size_t n(0);
+        for(size_t k(0); k<nzout+2; k++) { const size_t koff = (k == 0) ? 0 : (k == nzout+1) ? grid->nz+1 : k*kstride;
+        for(size_t j(0); j<nyout+2; j++) { const size_t joff = (j == 0) ? 0 : (j == nyout+1) ? grid->ny+1 : j*jstride;
+        for(size_t i(0); i<nxout+2; i++) { const size_t ioff = (i == 0) ? 0 : (i == nxout+1) ? grid->nx+1 : i*istride;
+              const uint32_t * fref = reinterpret_cast<uint32_t *>(&field_array->f(ioff,joff,koff));
+              block[n++] = fref[varlist[v]];
+        }
+        }
+        }
+        if(varlist[v] < float_field_variables)
+          fileIO.write_compressed(reinterpret_cast<float *>(block.data()), n, compression);
+        else
+          fileIO.write_compressed(block.data(), n, compression);
+      }
+    }
+
     // more efficient for standard case
-    if(istride == 1 && jstride == 1 && kstride == 1)
+    else if(istride == 1 && jstride == 1 && kstride == 1)
       for(size_t v(0); v<numvars; v++) {
       for(size_t k(0); k<nzout+2; k++) {
       for(size_t j(0); j<nyout+2; j++) {
@@ -682,7 +831,7 @@ vpic_simulation::field_dump( DumpParameters & dumpParams ) {
 
   } else { // band_interleave
 
-    WRITE_HEADER_V0(dump_type::field_dump, -1, 0, fileIO);
+    WRITE_HEADER_VERSION(header_version, dump_type::field_dump, -1, 0, fileIO);
 
     dim[0] = nxout+2;
     dim[1] = nyout+2;
@@ -690,7 +839,24 @@ vpic_simulation::field_dump( DumpParameters & dumpParams ) {
 
     WRITE_ARRAY_HEADER(field_array->f, 3, dim, fileIO);
 
-    if(istride == 1 && jstride == 1 && kstride == 1)
+    if(compression.codec != codec_none) {
+      // field_t carries material ids, so the interleaved layout is
+      // always compressed losslessly
+      std::vector<field_t> block;
+      if(istride != 1 || jstride != 1 || kstride != 1) {
+        block.reserve(size_t(dim[0])*dim[1]*dim[2]);
+        for(size_t k(0); k<nzout+2; k++) { const size_t koff = (k == 0) ? 0 : (k == nzout+1) ? grid->nz+1 : k*kstride;
+        for(size_t j(0); j<nyout+2; j++) { const size_t joff = (j == 0) ? 0 : (j == nyout+1) ? grid->ny+1 : j*jstride;
+        for(size_t i(0); i<nxout+2; i++) { const size_t ioff = (i == 0) ? 0 : (i == nxout+1) ? grid->nx+1 : i*istride;
+              block.push_back(field_array->f(ioff,joff,koff));
+        }
+        }
+        }
+      }
+      fileIO.write_compressed(block.empty() ? field_array->f : block.data(),
+                              size_t(dim[0])*dim[1]*dim[2], compression);
+    }
+    else if(istride == 1 && jstride == 1 && kstride == 1)
       fileIO.write(field_array->f, dim[0]*dim[1]*dim[2]);
     else
       for(size_t k(0); k<nzout+2; k++) { const size_t koff = (k == 0) ? 0 : (k == nzout+1) ? grid->nz+1 : k*kstride;
@@ -766,6 +932,9 @@ vpic_simulation::hydro_dump( const char * speciesname,
   if(remainder(grid->nz, kstride) != 0)
     ERROR(("z stride must be an integer factor of nz"));
 
+  const FileIOCompression compression = check_compression(dumpParams.compression);
+  const int header_version = compression.codec != codec_none ? 1 : 0;
+
   int dim[3];
 
   /* define to do C-style indexing */
@@ -789,7 +958,7 @@ vpic_simulation::hydro_dump( const char * speciesname,
    */
   if(dumpParams.format == band) {
 
-    WRITE_HEADER_V0(dump_type::hydro_dump, sp->id, sp->q/sp->m, fileIO);
+    WRITE_HEADER_VERSION(header_version, dump_type::hydro_dump, sp->id, sp->q/sp->m, fileIO);
 
     dim[0] = nxout+2;
     dim[1] = nyout+2;
@@ -806,8 +975,25 @@ vpic_simulation::hydro_dump( const char * speciesname,
     for(size_t i(0), c(0); i<total_hydro_variables; i++)
       if( dumpParams.output_vars.bitset(i) ) varlist[c++] = i;
 
+    // compressed output gathers each variable into one block first
+    if(compression.codec != codec_none) {
+      std::vector<float> block(size_t(dim[0])*dim[1]*dim[2]);
+      for(size_t v(0); v<numvars; v++) {
+        size_t n(0);
+        for(size_t k(0); k<nzout+2; k++) { const size_t koff = (k == 0) ? 0 : (k == nzout+1) ? grid->nz+1 : k*kstride;
+        for(size_t j(0); j<nyout+2; j++) { const size_t joff = (j == 0) ? 0 : (j == nyout+1) ? grid->ny+1 : j*jstride;
+        for(size_t i(0); i<nxout+2; i++) { const size_t ioff = (i == 0) ? 0 : (i == nxout+1) ? grid->nx+1 : i*istride;
+              const float * href = reinterpret_cast<float *>(&hydro(ioff,joff,koff));
+              block[n++] = href[varlist[v]];
+        }
+        }
+        }
+        fileIO.write_compressed(block.data(), n, compression);
+      }
+    }
+
     // More efficient for standard case
-    if(istride == 1 && jstride == 1 && kstride == 1)
+    else if(istride == 1 && jstride == 1 && kstride == 1)
 
       for(size_t v(0); v<numvars; v++)
       for(size_t k(0); k<nzout+2; k++)
@@ -833,7 +1019,7 @@ vpic_simulation::hydro_dump( const char * speciesname,
 
   } else { // band_interleave
 
-    WRITE_HEADER_V0(dump_type::hydro_dump, sp->id, sp->q/sp->m, fileIO);
+    WRITE_HEADER_VERSION(header_version, dump_type::hydro_dump, sp->id, sp->q/sp->m, fileIO);
 
     dim[0] = nxout;
     dim[1] = nyout;
@@ -841,7 +1027,23 @@ vpic_simulation::hydro_dump( const char * speciesname,
 
     WRITE_ARRAY_HEADER(hydro_array->h, 3, dim, fileIO);
 
-    if(istride == 1 && jstride == 1 && kstride == 1)
+    if(compression.codec != codec_none) {
+      // hydro_t is all floats but interleaved, so it goes lossless
+      std::vector<hydro_t> block;
+      if(istride != 1 || jstride != 1 || kstride != 1) {
+        block.reserve(size_t(dim[0])*dim[1]*dim[2]);
+        for(size_t k(0); k<nzout; k++) { const size_t koff = (k == 0) ? 0 : (k == nzout+1) ? grid->nz+1 : k*kstride;
+        for(size_t j(0); j<nyout; j++) { const size_t joff = (j == 0) ? 0 : (j == nyout+1) ? grid->ny+1 : j*jstride;
+        for(size_t i(0); i<nxout; i++) { const size_t ioff = (i == 0) ? 0 : (i == nxout+1) ? grid->nx+1 : i*istride;
+              block.push_back(hydro(ioff,joff,koff));
+        }
+        }
+        }
+      }
+      fileIO.write_compressed(block.empty() ? hydro_array->h : block.data(),
+                              size_t(dim[0])*dim[1]*dim[2], compression);
+    }
+    else if(istride == 1 && jstride == 1 && kstride == 1)
 
       fileIO.write(hydro_array->h, dim[0]*dim[1]*dim[2]);
 
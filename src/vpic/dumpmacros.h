@@ -6,7 +6,13 @@
 /* FIXME: WHEN THESE MACROS WERE HOISTED AND VARIOUS HACKS DONE TO THEm
    THEY BECAME _VERY_ _DANGEROUS. */
 
-#define WRITE_HEADER_V0(dump_type,sp_id,q_m,fileIO) do { \
+// Header format versions: 0 has raw array payloads, 1 has array
+// payloads stored as CompressedIOPolicy frames.
+
+#define WRITE_HEADER_V0(dump_type,sp_id,q_m,fileIO) \
+    WRITE_HEADER_VERSION(0,dump_type,sp_id,q_m,fileIO)
+
+#define WRITE_HEADER_VERSION(version,dump_type,sp_id,q_m,fileIO) do { \
     /* Binary compatibility information */               \
     WRITE( char,      CHAR_BIT,               fileIO );  \
     WRITE( char,      sizeof(short int),      fileIO );  \
@@ -18,7 +24,7 @@
     WRITE( float,     1.0,                    fileIO );  \
     WRITE( double,    1.0,                    fileIO );  \
     /* Dump type and header format version */            \
-    WRITE( int,       0 /* Version */,        fileIO );  \
+    WRITE( int,       version,                fileIO );  \
     WRITE( int,       dump_type,              fileIO );  \
     /* High level information */                         \
     WRITE( int,       step(),                 fileIO );  \
@@ -54,6 +54,33 @@ vpic_simulation::initialize( int argc,
   TIC err = FAK->synchronize_tang_e_norm_b( field_array ); TOC( synchronize_tang_e_norm_b, 1 );
   if( rank()==0 ) MESSAGE(( "Error = %e (arb units)", err ));
 
+  copy_initial_state_to_device();
+
+  if( species_list && rank()==0 ) MESSAGE(( "Uncentering particles" ));
+  LIST_FOR_EACH( sp, species_list ) {
+      KOKKOS_TIC();
+      uncenter_p( sp, interpolator_array );
+      KOKKOS_TOC( uncenter_p, 1 );
+  }
+
+  if( rank()==0 ) MESSAGE(( "Performing initial diagnostics" ));
+
+  // Let the user to perform diagnostics on the initial condition
+  // field(i,j,k).jfx, jfy, jfz will not be valid at this point.
+  TIC user_diagnostics(); TOC( user_diagnostics, 1 );
+
+  if( rank()==0 ) MESSAGE(( "Initialization complete" ));
+  update_profile( rank()==0 ); // Let the user know how initialization went
+}
+
+
+// Set up the device grid and move the host state set up by the deck (or
+// a restart) to the device, leaving the interpolators loaded
+
+void
+vpic_simulation::copy_initial_state_to_device( void ) {
+  species_t * sp;
+
   // We want to call this once the neighbor is done
   auto g = species_list->g;
   auto nfaces_per_voxel = 6;
@@ -78,28 +105,13 @@ vpic_simulation::initialize( int argc,
     field_array->copy_to_device();
     KOKKOS_TOCN( FIELD_DATA_MOVEMENT, 1);
 
-    if( rank()==0 ) MESSAGE(( "Uncentering particles" ));
     TIC load_interpolator_array( interpolator_array, field_array ); TOC( load_interpolator, 1 );
   }
-  LIST_FOR_EACH( sp, species_list ) {
-      KOKKOS_TIC();
-      uncenter_p( sp, interpolator_array );
-      KOKKOS_TOC( uncenter_p, 1 );
-  }
-
-  if( rank()==0 ) MESSAGE(( "Performing initial diagnostics" ));
-
-  // Let the user to perform diagnostics on the initial condition
-  // field(i,j,k).jfx, jfy, jfz will not be valid at this point.
-  TIC user_diagnostics(); TOC( user_diagnostics, 1 );
-
-  if( rank()==0 ) MESSAGE(( "Initialization complete" ));
-  update_profile( rank()==0 ); // Let the user know how initialization went
 }
 
-
 void
 vpic_simulation::finalize( void ) {
+  flush_tracers();
   barrier();
   //Kokkos::finalize();
   update_profile( rank()==0 );
@@ -30,6 +30,22 @@
   #define KOKKOS_LAYOUT Kokkos::LayoutRight
 #endif
 
+// Page-locked host memory for staging device to host transfers
+#if defined(KOKKOS_ENABLE_CUDA)
+  #define KOKKOS_PINNED_SPACE Kokkos::CudaHostPinnedSpace
+#elif defined(KOKKOS_ENABLE_HIP)
+  #define KOKKOS_PINNED_SPACE Kokkos::Experimental::HIPHostPinnedSpace
+#else
+  #define KOKKOS_PINNED_SPACE Kokkos::HostSpace
+#endif
+
+// Device memory is host memory (no GPU backend)
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP) || defined(KOKKOS_ENABLE_SYCL)
+  #define KOKKOS_DEVICE_IS_HOST 0
+#else
+  #define KOKKOS_DEVICE_IS_HOST 1
+#endif
+
 typedef int16_t material_id;
 
 // TODO: we dont need the [1] here
@@ -48,6 +64,9 @@ using k_jf_accum_t = Kokkos::View<float *[NUM_J_DIMS]>;
 using k_particles_t = Kokkos::View<float *[PARTICLE_VAR_COUNT], Kokkos::LayoutLeft>;
 using k_particles_i_t = Kokkos::View<int*>;
 
+// Optional per particle tracer ids (see tracer.h).  Zero is untracked.
+using k_particle_ids_t = Kokkos::View<int64_t*>;
+
 // TODO: think about the layout here
 using k_particle_copy_t = Kokkos::View<float *[PARTICLE_VAR_COUNT], Kokkos::LayoutRight>;
 using k_particle_i_copy_t = Kokkos::View<int*>;
@@ -73,6 +92,29 @@ using k_hydro_sv_t = Kokkos::Experimental::ScatterView<float* [HYDRO_VAR_COUNT]>
 using static_sched = Kokkos::Schedule<Kokkos::Static>;
 using host_execution_policy = Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace, static_sched, int>;
 
+// NUMA first touch.  A page of host memory lands on the NUMA domain of
+// the thread that first writes it.  The views the kernels stream
+// through (particles, fields, interpolators) are therefore not zeroed
+// when allocated (by one thread) but by a loop over their first index
+// with the static schedule of the kernels (host_execution_policy, the
+// advance_p range), so each thread finds its share local.
+
+template<class View>
+View
+first_touch_view( const std::string & label,
+                  const int n ) {
+  typedef typename View::non_const_value_type T;
+  View v( Kokkos::view_alloc( Kokkos::WithoutInitializing, label ), n );
+  Kokkos::parallel_for( "first touch " + label,
+    Kokkos::RangePolicy<typename View::execution_space, static_sched, int>( 0, n ),
+    KOKKOS_LAMBDA( const int i ) {
+      if constexpr( View::rank==1 ) v(i) = T();
+      else for( int j=0; j<int( v.extent(1) ); j++ ) v(i,j) = T();
+    });
+  Kokkos::fence();
+  return v;
+}
+
 using k_material_coefficient_t = Kokkos::View<float* [MATERIAL_COEFFICIENT_VAR_COUNT]>;
 
 
@@ -66,12 +66,17 @@
   // Check if using team reduction optimization
   #if defined(VPIC_ENABLE_TEAM_REDUCTION) || defined(VPIC_ENABLE_HIERARCHICAL)
     #define SORT standard_sort
+    #define SORT_BY_VOXEL
   #else
     #define SORT strided_sort
   #endif
 #else
   #define SORT standard_sort
+  #define SORT_BY_VOXEL
 #endif
 
+// SORT_BY_VOXEL: the performance sort leaves the particles of each voxel
+// contiguous (tiled sorts don't), so the collision operators can reuse it
+
 #endif // _kokkos_tuning_h_
 
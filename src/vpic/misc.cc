@@ -106,7 +106,10 @@ vpic_simulation::inject_particle( species_t * sp,
 // ASCII format with each field in the form: field val [newline].
 //
 // Allowable values of field variables are: num_steps, quota,
-// checkpt_interval, hydro_interval, field_interval, particle_interval
+// num_comm_round, diagonal_particle_exchange, fuse_field_exchange,
+// comm_report_ranks,
+// checkpt_interval, checkpt_async, rebalance_interval, rebalance_threshold,
+// hydro_interval, field_interval, particle_interval
 // ndfld, ndhyd, ndpar, ndhis, ndgrd, head_option,
 // istride, jstride, kstride, stride_option, pstride
 //
@@ -145,7 +148,14 @@ vpic_simulation::modify( const char *fname ) {
   while( fgets( line, 127, handle ) ) {
     DTEST( quota,             "quota",             darg );
     ITEST( num_step,          "num_step",          iarg );
+    ITEST( num_comm_round,    "num_comm_round",    (iarg<1 ? 1 : iarg) );
+    ITEST( diagonal_particle_exchange, "diagonal_particle_exchange", (iarg!=0) );
+    ITEST( fuse_field_exchange, "fuse_field_exchange", (iarg!=0) );
+    ITEST( comm_report_ranks, "comm_report_ranks", (iarg<0 ? 0 : iarg) );
     ITEST( checkpt_interval,  "checkpt_interval",  (iarg<0 ? 0 : iarg) );
+    ITEST( checkpt_async,     "checkpt_async",     (iarg!=0) );
+    ITEST( rebalance_interval, "rebalance_interval", (iarg<0 ? 0 : iarg) );
+    DTEST( rebalance_threshold, "rebalance_threshold", (darg<1 ? 1 : darg) );
     ITEST( hydro_interval,    "hydro_interval",    (iarg<0 ? 0 : iarg) );
     ITEST( field_interval,    "field_interval",    (iarg<0 ? 0 : iarg) );
     ITEST( particle_interval, "particle_interval", (iarg<0 ? 0 : iarg) );
@@ -279,3 +289,19 @@ void vpic_simulation::output_checksum_species(const char * species) {
 } // vpic_simulation::output_checksum_species
 
 #endif // ENABLE_OPENSSL
+
+void
+vpic_simulation::define_tracers( const char *sp_name,
+                                 const char *fbase,
+                                 int interval,
+                                 size_t buffer_records ) {
+  species_t * sp = find_species_name( sp_name, species_list );
+  if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
+  new_tracer( sp, fbase, interval, buffer_records );
+}
+
+void
+vpic_simulation::flush_tracers( void ) {
+  species_t * sp;
+  LIST_FOR_EACH( sp, species_list ) ::flush_tracers( sp->tracer );
+}
@@ -0,0 +1,283 @@
+/*
+ * Decomposition independent restart dumps.
+ *
+ * A checkpt (checkpt_objects) is a memory image of each rank and can
+ * only be restored on the same number of ranks with the same domain
+ * decomposition.  A portable restart dump holds only the state that
+ * cannot be regenerated by the input deck, in global coordinates:
+ *
+ *   fbase.index   Written by rank 0: the number of ranks that wrote
+ *                 the dump and the global box of each.
+ *   fbase.<rank>  The step, the fields of the nodes of the local box
+ *                 (local indices 1:n+1 along each axis, so shared
+ *                 faces are written by both sides) and, for each
+ *                 species, its particles with their global cell
+ *                 (and tracer ids, if the species has them).
+ *
+ * A restart reruns user_initialization, which may decompose the same
+ * global grid over any number of ranks, discards the particles it
+ * created and loads the dump.  Each rank reads only the dump files of
+ * the old boxes that overlap its own, keeps the field values and
+ * particles in its box and drops the rest, so the particles are
+ * redistributed by position without communication.  Everything else
+ * (materials, boundary conditions, the deck's globals, random number
+ * generator states) comes from the deck.
+ *
+ * The global box of a rank is found from the cut planes of the grid
+ * (see partition.cc), so the deck must build its grid with one of the
+ * define_*_grid helpers.
+ */
+
+#include "vpic.h"
+
+static const int max_filename_bytes = 256;
+
+#define PORTABLE_RESTART_MAGIC   0x9057AB1E
+#define PORTABLE_RESTART_VERSION 1
+
+// Particle in global coordinates
+
+typedef struct portable_particle {
+  int32_t gx, gy, gz;   // Global cell, 0:gn-1
+  float dx, dy, dz;     // Offset in the cell
+  float ux, uy, uz, w;
+} portable_particle_t;
+
+// Global cell offset of the local box (ox,oy,oz) and local size
+
+static void
+local_box( const vpic_simulation * sim, const grid_t * g, int box[6] ) {
+  if( grid_rank_box( g, world_rank, box ) ) return; // Possibly uneven cuts
+  if( !sim->px || !sim->py || !sim->pz )
+    ERROR(( "Portable restarts need a grid built by define_*_grid" ));
+  const int px = int(sim->px), py = int(sim->py);
+  int ix = world_rank, iy, iz;
+  iy  = ix/px;
+  ix -= iy*px;
+  iz  = iy/py;
+  iy -= iz*py;
+  box[0] = ix*g->nx; box[1] = iy*g->ny; box[2] = iz*g->nz;
+  box[3] = g->nx;    box[4] = g->ny;    box[5] = g->nz;
+}
+
+void
+vpic_simulation::dump_portable_restart( const char * fbase ) {
+  char fname[max_filename_bytes];
+  FileIO fileIO;
+  species_t * sp;
+
+  if( !fbase ) ERROR(( "Invalid filename" ));
+  if( rank()==0 ) MESSAGE(( "Dumping portable restart to \"%s\"", fbase ));
+
+  int box[6];
+  local_box( this, grid, box );
+
+  // Index of the boxes of every rank
+
+  int * boxes = new int[ 6*nproc() ];
+  mp_allgather_i( box, boxes, 6 );
+  if( rank()==0 ) {
+    snprintf( fname, max_filename_bytes, "%s.index", fbase );
+    if( fileIO.open( fname, io_write )==fail ) ERROR(( "Could not open \"%s\"", fname ));
+    const int32_t head[3] = { PORTABLE_RESTART_MAGIC, PORTABLE_RESTART_VERSION, nproc() };
+    fileIO.write( head, 3 );
+    fileIO.write( boxes, 6*nproc() );
+    if( fileIO.close() ) ERROR(( "File close failed on \"%s\"", fname ));
+  }
+  delete[] boxes;
+
+  // Pull the state back from the device
+
+  LIST_FOR_EACH( sp, species_list )
+    if( step() > sp->last_copied ) sp->copy_to_host();
+  field_array->copy_to_host();
+
+  snprintf( fname, max_filename_bytes, "%s.%i", fbase, rank() );
+  if( fileIO.open( fname, io_write )==fail ) ERROR(( "Could not open \"%s\"", fname ));
+
+  const int32_t head[3] = { PORTABLE_RESTART_MAGIC, PORTABLE_RESTART_VERSION,
+                            num_species( species_list ) };
+  const int64_t s = step();
+  fileIO.write( head, 3 );
+  fileIO.write( &s, 1 );
+  fileIO.write( box, 6 );
+
+  // Fields of the nodes 1:n+1 (edge materials come from the deck)
+
+  const int nx = grid->nx, ny = grid->ny, nz = grid->nz;
+  for( int iz=1; iz<=nz+1; iz++ )
+    for( int iy=1; iy<=ny+1; iy++ )
+      for( int ix=1; ix<=nx+1; ix++ )
+        fileIO.write( &field( ix, iy, iz ).ex, FIELD_VAR_COUNT );
+
+  // Particles with their global cells
+
+  LIST_FOR_EACH( sp, species_list ) {
+    const int32_t len = strlen( sp->name ), has_ids = sp->has_particle_ids();
+    const int32_t np = sp->np;
+    fileIO.write( &len, 1 );
+    fileIO.write( sp->name, len );
+    fileIO.write( &np, 1 );
+    fileIO.write( &has_ids, 1 );
+
+    const particle_t * RESTRICT p = sp->p;
+    std::vector<portable_particle_t> buf( std::min( np, 1<<16 ) );
+    for( int n0=0; n0<np; n0+=int(buf.size()) ) {
+      const int n1 = std::min( np, n0 + int(buf.size()) );
+      for( int n=n0; n<n1; n++ ) {
+        portable_particle_t & q = buf[n-n0];
+        int v = p[n].i, ix, iy, iz;
+        ix = v % (nx+2); v /= (nx+2);
+        iy = v % (ny+2);
+        iz = v / (ny+2);
+        q.gx = box[0] + ix-1; q.gy = box[1] + iy-1; q.gz = box[2] + iz-1;
+        q.dx = p[n].dx; q.dy = p[n].dy; q.dz = p[n].dz;
+        q.ux = p[n].ux; q.uy = p[n].uy; q.uz = p[n].uz; q.w = p[n].w;
+      }
+      fileIO.write( buf.data(), n1-n0 );
+    }
+    if( has_ids ) fileIO.write( sp->k_p_id_h.data(), np );
+  }
+
+  if( fileIO.close() ) ERROR(( "File close failed on \"%s\"", fname ));
+}
+
+void
+vpic_simulation::restore_portable_restart( int argc, char ** argv,
+                                           const char * fbase ) {
+  char fname[max_filename_bytes];
+  FileIO fileIO;
+  species_t * sp;
+  int32_t head[3];
+
+  if( !fbase ) ERROR(( "Invalid filename" ));
+
+  // Let the deck build the new decomposition, then drop its particles
+
+  TIC user_initialization( argc, argv ); TOC( user_initialization, 1 );
+  LIST_FOR_EACH( sp, species_list ) sp->np = 0;
+
+  int box[6];
+  local_box( this, grid, box );
+  const int nx = grid->nx, ny = grid->ny, nz = grid->nz;
+
+  // Find the old boxes overlapping this one
+
+  snprintf( fname, max_filename_bytes, "%s.index", fbase );
+  if( fileIO.open( fname, io_read )==fail ) ERROR(( "Could not open \"%s\"", fname ));
+  fileIO.read( head, 3 );
+  if( head[0]!=int32_t(PORTABLE_RESTART_MAGIC) || head[1]!=PORTABLE_RESTART_VERSION )
+    ERROR(( "\"%s\" is not a portable restart index", fname ));
+  const int n_old = head[2];
+  std::vector<int> boxes( 6*n_old );
+  fileIO.read( boxes.data(), 6*n_old );
+  fileIO.close();
+
+  if( rank()==0 )
+    MESSAGE(( "Restoring portable restart \"%s\" written by %i ranks on %i ranks",
+              fbase, n_old, nproc() ));
+
+  // Node (field) and cell (particle) ranges of this box in global indices
+
+  int lo[3], hi[3];
+  for( int a=0; a<3; a++ ) lo[a] = box[a], hi[a] = box[a] + box[3+a];
+
+  int64_t old_step = -1;
+  for( int r=0; r<n_old; r++ ) {
+    const int * ob = &boxes[6*r];
+    int a;
+    for( a=0; a<3; a++ )
+      if( ob[a] > hi[a] || ob[a]+ob[3+a] < lo[a] ) break;
+    if( a<3 ) continue; // No node in common
+
+    snprintf( fname, max_filename_bytes, "%s.%i", fbase, r );
+    if( fileIO.open( fname, io_read )==fail ) ERROR(( "Could not open \"%s\"", fname ));
+    int64_t s;
+    int ofile[6];
+    fileIO.read( head, 3 );
+    fileIO.read( &s, 1 );
+    fileIO.read( ofile, 6 );
+    if( head[0]!=int32_t(PORTABLE_RESTART_MAGIC) || head[1]!=PORTABLE_RESTART_VERSION )
+      ERROR(( "\"%s\" is not a portable restart dump", fname ));
+    if( old_step>=0 && s!=old_step ) ERROR(( "\"%s\" is from another step", fname ));
+    old_step = s;
+    const int onx = ofile[3], ony = ofile[4], onz = ofile[5];
+
+    // Fields of the common nodes
+
+    std::vector<float> f( size_t(FIELD_VAR_COUNT)*(onx+1)*(ony+1)*(onz+1) );
+    fileIO.read( f.data(), f.size() );
+    for( int iz=1; iz<=nz+1; iz++ ) {
+      const int oz = box[2] + iz - ofile[2];
+      if( oz<1 || oz>onz+1 ) continue;
+      for( int iy=1; iy<=ny+1; iy++ ) {
+        const int oy = box[1] + iy - ofile[1];
+        if( oy<1 || oy>ony+1 ) continue;
+        for( int ix=1; ix<=nx+1; ix++ ) {
+          const int ox = box[0] + ix - ofile[0];
+          if( ox<1 || ox>onx+1 ) continue;
+          const float * src = &f[ size_t(FIELD_VAR_COUNT)*
+                                  ( (ox-1) + (onx+1)*( (oy-1) + (ony+1)*(oz-1) ) ) ];
+          memcpy( &field( ix, iy, iz ).ex, src, FIELD_VAR_COUNT*sizeof(float) );
+        }
+      }
+    }
+
+    // Particles in this box
+
+    for( int n_sp=0; n_sp<head[2]; n_sp++ ) {
+      int32_t len, np, has_ids;
+      char name[512];
+      fileIO.read( &len, 1 );
+      if( len<0 || len>=int32_t(sizeof(name)) ) ERROR(( "Malformed \"%s\"", fname ));
+      fileIO.read( name, len );
+      name[len] = '\0';
+      fileIO.read( &np, 1 );
+      fileIO.read( &has_ids, 1 );
+      sp = find_species_name( name, species_list );
+      if( !sp ) ERROR(( "Species \"%s\" of \"%s\" is not defined by the deck", name, fbase ));
+
+      std::vector<portable_particle_t> q( np );
+      std::vector<int64_t> ids( has_ids ? np : 0 );
+      fileIO.read( q.data(), np );
+      if( has_ids ) fileIO.read( ids.data(), np );
+
+      const bool keep_ids = has_ids && sp->has_particle_ids();
+      for( int n=0; n<np; n++ ) {
+        const int ix = q[n].gx - box[0] + 1;
+        const int iy = q[n].gy - box[1] + 1;
+        const int iz = q[n].gz - box[2] + 1;
+        if( ix<1 || ix>nx || iy<1 || iy>ny || iz<1 || iz>nz ) continue;
+        if( sp->np>=sp->max_np )
+          ERROR(( "Species \"%s\" has too little local storage (%i) for the "
+                  "restored particles", sp->name, sp->max_np ));
+        particle_t * p = sp->p + sp->np;
+        p->dx = q[n].dx; p->dy = q[n].dy; p->dz = q[n].dz;
+        p->i  = voxel( ix, iy, iz );
+        p->ux = q[n].ux; p->uy = q[n].uy; p->uz = q[n].uz; p->w = q[n].w;
+        if( keep_ids ) sp->k_p_id_h( sp->np ) = ids[n];
+        sp->np++;
+      }
+    }
+
+    fileIO.close();
+  }
+
+  if( old_step<0 ) ERROR(( "No dump file of \"%s\" overlaps rank %i", fbase, rank() ));
+  grid->step = old_step;
+
+  LIST_FOR_EACH( sp, species_list )
+    if( sp->tracer ) resume_tracer_ids( sp->tracer );
+
+  // The dump has tca, rhob and the particles as they were at the end of
+  // a step (uncentered), so only the ghosts need filling.
+
+  double err;
+  TIC err = FAK->synchronize_tang_e_norm_b( field_array ); TOC( synchronize_tang_e_norm_b, 1 );
+  if( rank()==0 ) MESSAGE(( "Interdomain synchronization error = %e (arb units)", err ));
+
+  copy_initial_state_to_device();
+
+  if( rank()==0 ) MESSAGE(( "Portable restart complete at step %li", (long)step() ));
+  update_profile( rank()==0 );
+}
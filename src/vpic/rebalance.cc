@@ -0,0 +1,532 @@
+/*
+ * Dynamic load balancing.
+ *
+ * A grid built by a partition_*_box function (i.e. by the define_*_grid
+ * helpers) is cut by rectilinear planes: every rank in a column of the
+ * topology shares the same x cuts, and similarly for y and z.  The cuts
+ * need not be even, so the work of a rank can be shrunk by moving them.
+ *
+ * Every rebalance_interval steps, each rank reports the time it spent
+ * in advance_p since the last check (P), its wall time over the same
+ * window (T), its particle count (N) and its voxel count (V).  A rank
+ * is modeled to cost
+ *
+ *   C = P + b V
+ *
+ * where b, the per voxel cost of the rest of the step, is taken from
+ * the rank that waited least ((T-P)/V is smallest there, as the others
+ * also spend time waiting for it).  If max C exceeds the average by
+ * rebalance_threshold, the cost is profiled along each axis (the
+ * particles of each voxel plane weighted by the push cost per particle
+ * of their rank, plus b for each voxel of the plane) and each axis is
+ * cut at equal shares of its cumulative cost.
+ *
+ * The state is then moved to the new decomposition on the host: each
+ * rank sends the fields (whole field_t, ghosts included) and particles
+ * it owns to the ranks that store them under the new cuts and the
+ * local arrays are resized.  Only ranks whose boxes overlap exchange
+ * messages.  Interpolators are reloaded from the fields; hydro is
+ * recomputed whenever it is dumped.
+ *
+ * Decks that keep local voxel indices (emitters, injection regions in
+ * local coordinates, per voxel user arrays) cannot be rebalanced.
+ */
+
+#include "vpic.h"
+#include <climits>
+
+#define REBALANCE_TAG_HEAD 0x7eb0
+#define REBALANCE_TAG_DATA 0x7eb1
+
+// Particle in global coordinates
+
+typedef struct migrant_particle {
+  int32_t gx, gy, gz;   // Global cell, 0:gn-1
+  float dx, dy, dz;     // Offset in the cell
+  float ux, uy, uz, w;
+} migrant_particle_t;
+
+// Global voxel range [lo,hi) of a rank's interior along each axis
+
+static void
+cut_range( const grid_t * g,
+           const int * cut,
+           int rank,
+           int lo[3],
+           int hi[3] ) {
+  const int gp[3] = { g->gpx, g->gpy, g->gpz };
+  int p[3];
+  p[0] = rank % gp[0]; rank /= gp[0];
+  p[1] = rank % gp[1];
+  p[2] = rank / gp[1];
+  for( int a=0; a<3; a++ ) {
+    lo[a] = cut[p[a]], hi[a] = cut[p[a]+1];
+    cut += gp[a]+1;
+  }
+}
+
+// Voxels whose values a rank owns: its interior plus the ghosts on the
+// global boundary (ghosts are at global index -1 and gn).  Every voxel
+// is owned by exactly one rank.
+
+static void
+owned_range( const grid_t * g,
+             const int * cut,
+             int rank,
+             int lo[3],
+             int hi[3] ) {
+  const int gn[3] = { g->gnx, g->gny, g->gnz };
+  cut_range( g, cut, rank, lo, hi );
+  for( int a=0; a<3; a++ ) {
+    if( lo[a]==0     ) lo[a] = -1;
+    if( hi[a]==gn[a] ) hi[a] = gn[a]+1;
+  }
+}
+
+// Voxels a rank stores: its interior and ghosts
+
+static void
+stored_range( const grid_t * g,
+              const int * cut,
+              int rank,
+              int lo[3],
+              int hi[3] ) {
+  cut_range( g, cut, rank, lo, hi );
+  for( int a=0; a<3; a++ ) lo[a]--, hi[a]++;
+}
+
+// Intersection of two ranges; returns the number of voxels in it
+
+static int64_t
+overlap( const int alo[3], const int ahi[3],
+         const int blo[3], const int bhi[3],
+         int lo[3], int hi[3] ) {
+  int64_t n = 1;
+  for( int a=0; a<3; a++ ) {
+    lo[a] = std::max( alo[a], blo[a] );
+    hi[a] = std::min( ahi[a], bhi[a] );
+    if( hi[a]<=lo[a] ) return 0;
+    n *= hi[a]-lo[a];
+  }
+  return n;
+}
+
+// Place the cut planes of an axis at equal shares of the cumulative
+// cost, keeping every domain at least one voxel wide
+
+static void
+balance_cuts( const double * cost,
+              int gn,
+              int gp,
+              int * cut ) {
+  double total = 0, sum = 0;
+  int i, k;
+
+  for( i=0; i<gn; i++ ) total += cost[i];
+  if( !(total>0) ) return; // Nothing to balance, keep the cuts
+
+  cut[0] = 0, cut[gp] = gn;
+  for( i=0, k=1; k<gp; k++ ) {
+    const double target = total*k/gp;
+    while( i<gn && sum+cost[i]<=target ) sum += cost[i++];
+    if( i<gn && sum+cost[i]-target < target-sum ) sum += cost[i++];
+    const int c = std::min( std::max( i, cut[k-1]+1 ), gn-(gp-k) );
+    while( i<c ) sum += cost[i++];
+    while( i>c ) sum -= cost[--i];
+    cut[k] = c;
+  }
+}
+
+int
+vpic_simulation::rebalance( int force ) {
+  species_t * sp;
+  int a, n, r;
+
+  const double now = wallclock();
+  if( rebalance_tic<0 ) {
+    // Open the first measurement window
+    rebalance_tic = now, rebalance_push_time = 0;
+    return 0;
+  }
+
+  if( !grid->cut ) ERROR(( "Load balancing needs a grid built by define_*_grid" ));
+  if( emitter_list ) ERROR(( "Load balancing does not support emitters" ));
+  if( !species_list ) return 0;
+
+  const int nproc = world_size, me = world_rank, n_sp = num_species( species_list );
+  const int nx = grid->nx, ny = grid->ny, nz = grid->nz, sy = grid->sy, sz = grid->sz;
+  const int gn[3] = { grid->gnx, grid->gny, grid->gnz };
+  const int gp[3] = { grid->gpx, grid->gpy, grid->gpz };
+  const int n_cut = gp[0] + gp[1] + gp[2] + 3;
+
+  // Measure (P,T,N,V) of every rank over the window
+
+  std::vector<double> local( 4*nproc, 0. ), all( 4*nproc );
+  int64_t np_local = 0;
+  LIST_FOR_EACH( sp, species_list ) np_local += sp->np;
+  local[4*me+0] = rebalance_push_time;
+  local[4*me+1] = now - rebalance_tic;
+  local[4*me+2] = double( np_local );
+  local[4*me+3] = double( nx )*double( ny )*double( nz );
+  mp_allsum_d( local.data(), all.data(), 4*nproc );
+
+  rebalance_tic = now, rebalance_push_time = 0;
+
+  double P = 0, N = 0, b = -1, c_max = 0, c_sum = 0;
+  for( r=0; r<nproc; r++ ) {
+    const double * m = &all[4*r];
+    const double br = std::max( m[1]-m[0], 0. )/m[3];
+    if( b<0 || br<b ) b = br;
+    P += m[0], N += m[2];
+  }
+  for( r=0; r<nproc; r++ ) {
+    const double c = all[4*r+0] + b*all[4*r+3];
+    c_max = std::max( c_max, c ), c_sum += c;
+  }
+  if( !(c_sum>0) ) return 0;
+  const double imbalance = c_max*nproc/c_sum;
+  if( !force && imbalance<rebalance_threshold ) return 0;
+
+  // Cost profile along each axis: the particles of each voxel plane
+  // (counted on the device) at this rank's push cost, plus b for each
+  // voxel of the plane
+
+  const double cost_p = np_local ? all[4*me]/double( np_local ) : ( N>0 ? P/N : 0 );
+
+  Kokkos::View<int*> k_hx( "rebalance x profile", nx+2 );
+  Kokkos::View<int*> k_hy( "rebalance y profile", ny+2 );
+  Kokkos::View<int*> k_hz( "rebalance z profile", nz+2 );
+  LIST_FOR_EACH( sp, species_list ) {
+    auto k_p_i = sp->k_p_i_d;
+    Kokkos::parallel_for( "rebalance profile", Kokkos::RangePolicy<>( 0, sp->np ),
+      KOKKOS_LAMBDA( const int i ) {
+        int v = k_p_i( i );
+        const int iz = v/sz; v -= iz*sz;
+        const int iy = v/sy;
+        const int ix = v - iy*sy;
+        Kokkos::atomic_increment( &k_hx( ix ) );
+        Kokkos::atomic_increment( &k_hy( iy ) );
+        Kokkos::atomic_increment( &k_hz( iz ) );
+      });
+  }
+  auto hx = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), k_hx );
+  auto hy = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), k_hy );
+  auto hz = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), k_hz );
+
+  int olo[3], ohi[3];
+  cut_range( grid, grid->cut, me, olo, ohi );
+
+  std::vector<double> lprof( gn[0]+gn[1]+gn[2], 0. ), prof( lprof.size() );
+  double * lx = lprof.data(), * ly = lx + gn[0], * lz = ly + gn[1];
+  for( n=1; n<=nx; n++ ) lx[olo[0]+n-1] = cost_p*hx( n ) + b*double( ny )*double( nz );
+  for( n=1; n<=ny; n++ ) ly[olo[1]+n-1] = cost_p*hy( n ) + b*double( nz )*double( nx );
+  for( n=1; n<=nz; n++ ) lz[olo[2]+n-1] = cost_p*hz( n ) + b*double( nx )*double( ny );
+  mp_allsum_d( lprof.data(), prof.data(), int( prof.size() ) );
+
+  // New cut planes (the same on every rank)
+
+  std::vector<int> ocut( grid->cut, grid->cut + n_cut ), ncut( ocut );
+  const double * cost = prof.data();
+  int * c = ncut.data();
+  for( a=0; a<3; a++ ) {
+    balance_cuts( cost, gn[a], gp[a], c );
+    cost += gn[a], c += gp[a]+1;
+  }
+  if( ncut==ocut ) return 0;
+
+  if( rank()==0 )
+    MESSAGE(( "Rebalancing at step %li (imbalance %.3f)", (long)step(), imbalance ));
+
+  // Pull the state back from the device
+
+  LIST_FOR_EACH( sp, species_list ) sp->copy_to_host();
+  field_array->copy_to_host();
+
+  // Ranks this one sends to (that store voxels it owns under the new
+  // cuts) and receives from (that own voxels it stores)
+
+  int lo[3], hi[3], alo[3], ahi[3], blo[3], bhi[3];
+  std::vector<int> send_rank, recv_rank, send_slot( nproc, -1 );
+  std::vector<int64_t> send_vox;
+  owned_range( grid, ocut.data(), me, alo, ahi );
+  stored_range( grid, ncut.data(), me, blo, bhi );
+  for( r=0; r<nproc; r++ ) {
+    int rlo[3], rhi[3];
+    stored_range( grid, ncut.data(), r, rlo, rhi );
+    const int64_t n_vox = overlap( alo, ahi, rlo, rhi, lo, hi );
+    if( n_vox ) {
+      send_slot[r] = int( send_rank.size() );
+      send_rank.push_back( r );
+      send_vox.push_back( n_vox );
+    }
+    owned_range( grid, ocut.data(), r, rlo, rhi );
+    if( overlap( rlo, rhi, blo, bhi, lo, hi ) ) recv_rank.push_back( r );
+  }
+  const int ns = int( send_rank.size() ), nr = int( recv_rank.size() );
+
+  // Bucket the particles of each species by destination
+
+  std::vector<int> new_owner[3];
+  for( a=0, c=ncut.data(); a<3; c += gp[a]+1, a++ ) {
+    new_owner[a].resize( gn[a] );
+    for( int p=0; p<gp[a]; p++ )
+      for( n=c[p]; n<c[p+1]; n++ ) new_owner[a][n] = p;
+  }
+
+  std::vector< std::vector<int> > order( n_sp ), count( n_sp );
+  a = 0;
+  LIST_FOR_EACH( sp, species_list ) {
+    const particle_t * RESTRICT p = sp->p;
+    std::vector<int> & cnt = count[a], & ord = order[a];
+    std::vector<int> slot( sp->np ), off( ns+1, 0 );
+    cnt.assign( ns, 0 );
+    for( n=0; n<sp->np; n++ ) {
+      int v = p[n].i;
+      const int iz = v/sz; v -= iz*sz;
+      const int iy = v/sy;
+      const int ix = v - iy*sy;
+      if( ix<1 || ix>nx || iy<1 || iy>ny || iz<1 || iz>nz )
+        ERROR(( "Species \"%s\" has a particle outside the local domain", sp->name ));
+      r = new_owner[0][olo[0]+ix-1] +
+          gp[0]*( new_owner[1][olo[1]+iy-1] + gp[1]*new_owner[2][olo[2]+iz-1] );
+      slot[n] = send_slot[r];
+      if( slot[n]<0 ) ERROR(( "Rank %i is not a neighbor under the new cuts", r ));
+      cnt[ slot[n] ]++;
+    }
+    for( int j=0; j<ns; j++ ) off[j+1] = off[j] + cnt[j];
+    ord.resize( sp->np );
+    for( n=0; n<sp->np; n++ ) ord[ off[ slot[n] ]++ ] = n;
+    a++;
+  }
+
+  // Exchange the headers: the message size and the particle count of
+  // each species
+
+  const int head_sz = ( n_sp+1 )*sizeof(int64_t);
+  std::vector<int64_t> send_head( size_t( ns )*( n_sp+1 ) ), recv_head( size_t( nr )*( n_sp+1 ) );
+  for( int j=0; j<ns; j++ ) {
+    int64_t * h = &send_head[ size_t( j )*( n_sp+1 ) ];
+    h[0] = send_vox[j]*int64_t( sizeof(field_t) );
+    a = 0;
+    LIST_FOR_EACH( sp, species_list ) {
+      h[a+1] = count[a][j];
+      h[0] += h[a+1]*int64_t( sizeof(migrant_particle_t) +
+                              ( sp->has_particle_ids() ? sizeof(int64_t) : 0 ) );
+      a++;
+    }
+  }
+
+  mp_t * mp = new_mp( ns+nr );
+  for( int j=0; j<nr; j++ ) {
+    if( recv_rank[j]==me ) continue;
+    mp_size_recv_buffer( mp, ns+j, head_sz );
+    mp_begin_recv( mp, ns+j, head_sz, recv_rank[j], REBALANCE_TAG_HEAD );
+  }
+  for( int j=0; j<ns; j++ ) {
+    if( send_rank[j]==me ) continue;
+    mp_size_send_buffer( mp, j, head_sz );
+    memcpy( mp_send_buffer( mp, j ), &send_head[ size_t( j )*( n_sp+1 ) ], head_sz );
+    mp_begin_send( mp, j, head_sz, send_rank[j], REBALANCE_TAG_HEAD );
+  }
+  for( int j=0; j<nr; j++ ) {
+    int64_t * h = &recv_head[ size_t( j )*( n_sp+1 ) ];
+    if( recv_rank[j]==me ) {
+      memcpy( h, &send_head[ size_t( send_slot[me] )*( n_sp+1 ) ], head_sz );
+      continue;
+    }
+    mp_end_recv( mp, ns+j );
+    memcpy( h, mp_recv_buffer( mp, ns+j ), head_sz );
+  }
+  for( int j=0; j<ns; j++ ) if( send_rank[j]!=me ) mp_end_send( mp, j );
+
+  // Give up, with nothing changed, if any rank would overflow
+
+  int fail = 0, any_fail;
+  a = 0;
+  LIST_FOR_EACH( sp, species_list ) {
+    int64_t np_new = 0;
+    for( int j=0; j<nr; j++ ) np_new += recv_head[ size_t( j )*( n_sp+1 ) + a+1 ];
+    if( np_new>sp->max_np ) fail = 1;
+    a++;
+  }
+  for( int j=0; j<ns; j++ )
+    if( send_head[ size_t( j )*( n_sp+1 ) ]>INT_MAX )
+      ERROR(( "Rebalance message to rank %i is too large", send_rank[j] ));
+  for( int j=0; j<nr; j++ )
+    if( recv_head[ size_t( j )*( n_sp+1 ) ]>INT_MAX )
+      ERROR(( "Rebalance message from rank %i is too large", recv_rank[j] ));
+  mp_allsum_i( &fail, &any_fail, 1 );
+  if( any_fail ) {
+    if( rank()==0 )
+      WARNING(( "Rebalance skipped: a species has too little local storage "
+                "for the new decomposition" ));
+    delete_mp( mp );
+    return 0;
+  }
+
+  // Pack the fields and particles this rank owns for each destination
+
+  std::vector<char> self;
+  for( int j=0; j<ns; j++ ) {
+    const int bytes = int( send_head[ size_t( j )*( n_sp+1 ) ] );
+    char * buf;
+    if( send_rank[j]==me ) {
+      self.resize( std::max( bytes, 1 ) );
+      buf = self.data();
+    } else {
+      if( !bytes ) continue;
+      mp_size_send_buffer( mp, j, bytes );
+      buf = (char *)mp_send_buffer( mp, j );
+    }
+
+    int rlo[3], rhi[3];
+    stored_range( grid, ncut.data(), send_rank[j], rlo, rhi );
+    overlap( alo, ahi, rlo, rhi, lo, hi );
+    for( int gz=lo[2]; gz<hi[2]; gz++ )
+      for( int gy=lo[1]; gy<hi[1]; gy++ )
+        for( int gx=lo[0]; gx<hi[0]; gx++ ) {
+          memcpy( buf, &field( gx-olo[0]+1, gy-olo[1]+1, gz-olo[2]+1 ), sizeof(field_t) );
+          buf += sizeof(field_t);
+        }
+
+    a = 0;
+    LIST_FOR_EACH( sp, species_list ) {
+      const particle_t * RESTRICT p = sp->p;
+      const int n1 = count[a][j], * ord = order[a].data();
+      int n0 = 0;
+      for( int k=0; k<j; k++ ) n0 += count[a][k];
+      migrant_particle_t * q = (migrant_particle_t *)buf;
+      for( int k=0; k<n1; k++ ) {
+        const int i = ord[n0+k];
+        int v = p[i].i;
+        const int iz = v/sz; v -= iz*sz;
+        const int iy = v/sy;
+        const int ix = v - iy*sy;
+        q[k].gx = olo[0]+ix-1; q[k].gy = olo[1]+iy-1; q[k].gz = olo[2]+iz-1;
+        q[k].dx = p[i].dx; q[k].dy = p[i].dy; q[k].dz = p[i].dz;
+        q[k].ux = p[i].ux; q[k].uy = p[i].uy; q[k].uz = p[i].uz; q[k].w = p[i].w;
+      }
+      buf += n1*sizeof(migrant_particle_t);
+      if( sp->has_particle_ids() ) {
+        int64_t * id = (int64_t *)buf;
+        for( int k=0; k<n1; k++ ) id[k] = sp->k_p_id_h( ord[n0+k] );
+        buf += n1*sizeof(int64_t);
+      }
+      a++;
+    }
+  }
+
+  // Exchange
+
+  for( int j=0; j<nr; j++ ) {
+    const int bytes = int( recv_head[ size_t( j )*( n_sp+1 ) ] );
+    if( recv_rank[j]==me || !bytes ) continue;
+    mp_size_recv_buffer( mp, ns+j, bytes );
+    mp_begin_recv( mp, ns+j, bytes, recv_rank[j], REBALANCE_TAG_DATA );
+  }
+  for( int j=0; j<ns; j++ ) {
+    const int bytes = int( send_head[ size_t( j )*( n_sp+1 ) ] );
+    if( send_rank[j]==me || !bytes ) continue;
+    mp_begin_send( mp, j, bytes, send_rank[j], REBALANCE_TAG_DATA );
+  }
+  for( int j=0; j<nr; j++ )
+    if( recv_rank[j]!=me && recv_head[ size_t( j )*( n_sp+1 ) ] ) mp_end_recv( mp, ns+j );
+  for( int j=0; j<ns; j++ )
+    if( send_rank[j]!=me && send_head[ size_t( j )*( n_sp+1 ) ] ) mp_end_send( mp, j );
+
+  // Move the grid to the new cuts and resize the local arrays
+
+  repartition_grid( grid, ncut.data(), ncut.data()+gp[0]+1, ncut.data()+gp[0]+gp[1]+2 );
+
+  const int nv = grid->nv;
+  int nlo[3], nhi[3];
+  cut_range( grid, ncut.data(), me, nlo, nhi );
+
+  field_array_t * fa = field_array;
+  FREE_ALIGNED( fa->f );
+  MALLOC_ALIGNED( fa->f, nv, 128 );
+  CLEAR( fa->f, nv );
+  delete fa->fb;
+  fa->init_kokkos_fields( nv,
+    2*grid->ny*(grid->nz+1) + 2*grid->nz*(grid->ny+1) + grid->ny*grid->nz,
+    2*grid->nz*(grid->nx+1) + 2*grid->nx*(grid->nz+1) + grid->nz*grid->nx,
+    2*grid->nx*(grid->ny+1) + 2*grid->ny*(grid->nx+1) + grid->nx*grid->ny );
+
+  if( interpolator_array ) {
+    FREE_ALIGNED( interpolator_array->i );
+    MALLOC_ALIGNED( interpolator_array->i, nv, 128 );
+    CLEAR( interpolator_array->i, nv );
+    interpolator_array->init_kokkos_interp( nv );
+  }
+
+  if( hydro_array ) {
+    FREE_ALIGNED( hydro_array->h );
+    MALLOC_ALIGNED( hydro_array->h, nv, 128 );
+    CLEAR( hydro_array->h, nv );
+    hydro_array->k_h_d = k_hydro_d_t( "k_hydro", nv );
+    hydro_array->k_h_h = Kokkos::create_mirror_view( hydro_array->k_h_d );
+  }
+
+  LIST_FOR_EACH( sp, species_list ) {
+    FREE_ALIGNED( sp->partition );
+    MALLOC_ALIGNED( sp->partition, nv+1, 128 );
+    sp->np = 0, sp->nm = 0;
+  }
+
+  // Unpack, in rank order
+
+  for( int j=0; j<nr; j++ ) {
+    const char * buf;
+    if( recv_rank[j]==me ) buf = self.data();
+    else if( recv_head[ size_t( j )*( n_sp+1 ) ] ) buf = (const char *)mp_recv_buffer( mp, ns+j );
+    else continue;
+
+    int rlo[3], rhi[3];
+    owned_range( grid, ocut.data(), recv_rank[j], rlo, rhi );
+    overlap( rlo, rhi, blo, bhi, lo, hi );
+    for( int gz=lo[2]; gz<hi[2]; gz++ )
+      for( int gy=lo[1]; gy<hi[1]; gy++ )
+        for( int gx=lo[0]; gx<hi[0]; gx++ ) {
+          memcpy( &field( gx-nlo[0]+1, gy-nlo[1]+1, gz-nlo[2]+1 ), buf, sizeof(field_t) );
+          buf += sizeof(field_t);
+        }
+
+    a = 0;
+    LIST_FOR_EACH( sp, species_list ) {
+      const int n1 = int( recv_head[ size_t( j )*( n_sp+1 ) + a+1 ] );
+      const migrant_particle_t * q = (const migrant_particle_t *)buf;
+      particle_t * RESTRICT p = sp->p + sp->np;
+      for( int k=0; k<n1; k++ ) {
+        p[k].dx = q[k].dx; p[k].dy = q[k].dy; p[k].dz = q[k].dz;
+        p[k].i  = voxel( q[k].gx-nlo[0]+1, q[k].gy-nlo[1]+1, q[k].gz-nlo[2]+1 );
+        p[k].ux = q[k].ux; p[k].uy = q[k].uy; p[k].uz = q[k].uz; p[k].w = q[k].w;
+      }
+      buf += n1*sizeof(migrant_particle_t);
+      if( sp->has_particle_ids() ) {
+        const int64_t * id = (const int64_t *)buf;
+        for( int k=0; k<n1; k++ ) sp->k_p_id_h( sp->np+k ) = id[k];
+        buf += n1*sizeof(int64_t);
+      }
+      sp->np += n1;
+      a++;
+    }
+  }
+
+  delete_mp( mp );
+
+  // Back to the device (this also reloads the interpolators)
+
+  LIST_FOR_EACH( sp, species_list ) {
+    sp->last_copied = step();
+    sp->last_sorted = INT64_MIN;
+  }
+  field_array->last_copied = step();
+  copy_initial_state_to_device();
+
+  if( rank()==0 )
+    MESSAGE(( "Rebalanced to local domains of %ix%ix%i voxels on rank 0",
+              grid->nx, grid->ny, grid->nz ));
+
+  rebalance_tic = wallclock();
+  return 1;
+}
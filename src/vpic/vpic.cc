@@ -41,6 +41,7 @@ vpic_simulation *
 restore_vpic_simulation( void ) {
   vpic_simulation * vpic;
   RESTORE( vpic );
+  vpic->rebalance_tic = -1; // Wallclocks do not carry over between runs
   RESTORE_PTR( vpic->entropy );
   RESTORE_PTR( vpic->sync_entropy );
   RESTORE_PTR( vpic->grid );
@@ -76,6 +77,9 @@ vpic_simulation::vpic_simulation() {
   num_comm_round = 3;
   num_div_e_round = 2;
   num_div_b_round = 2;
+  rebalance_threshold = 1.2;
+  rebalance_tic = -1;
+  set_injection_region( 0, -1, 0, -1, 0, -1 );
 
   int                           n_rng = serial.n_pipeline;
   if( n_rng<thread.n_pipeline ) n_rng = thread.n_pipeline;
@@ -195,7 +199,14 @@ void restore_kokkos(vpic_simulation& simulation)
         new(&sp->clean_up_from) Kokkos::View<int*>();
         new(&sp->clean_up_to) Kokkos::View<int*>();
 
+        new(&sp->k_p_id_d) k_particle_ids_t();
+        new(&sp->k_p_id_h) k_particle_ids_t::HostMirror();
+        new(&sp->k_pc_id_d) k_particle_ids_t();
+        new(&sp->k_pc_id_h) k_particle_ids_t::HostMirror();
+        new(&sp->k_pr_id_h) k_particle_ids_t::HostMirror();
+
         sp->init_kokkos_particles();
+        if( sp->tracer ) restore_tracer_kokkos( sp->tracer );
 
         sp->copy_to_device();
     }
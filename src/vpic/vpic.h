@@ -18,7 +18,13 @@
 
 #include "../boundary/boundary.h"
 #include "../collision/collision.h"
+#include "../collision/unary_device.h"
 #include "../emitter/emitter.h"
+#include "../field_advance/field_inject.h"
+#include "../species_advance/particle_select.h"
+#include "../species_advance/tracer.h"
+#include "../species_advance/particle_histogram.h"
+#include "../species_advance/particle_inject.h"
 // FIXME: INCLUDES ONCE ALL IS CLEANED UP
 #include "../util/io/FileIO.h"
 #include "../util/bitfield.h"
@@ -50,6 +56,7 @@ const uint32_t fmat			(1<<20 | 1<<21 | 1<<22);
 const uint32_t cmat			(1<<23);
 
 const size_t total_field_variables(24);
+const size_t float_field_variables(16); // ex ... rhof, the rest are material ids
 const size_t total_field_groups(12); // this counts vectors, tensors etc...
 // These bits will be tested to determine which variables to output
 const size_t field_indeces[12] = { 0, 3, 4, 7, 8, 11, 12, 15, 16, 19, 20, 23 };
@@ -110,6 +117,11 @@ struct DumpParameters {
 
   DumpFormat format;
 
+  // Optional compression of the array payload (codec_none by default).
+  // codec_quantize also needs compression.abs_tolerance or
+  // compression.rel_tolerance.
+  FileIOCompression compression;
+
   char name[128];
   char baseDir[128];
   char baseFileName[128];
@@ -121,8 +133,11 @@ public:
   vpic_simulation();
   ~vpic_simulation();
   void initialize( int argc, char **argv );
+  void restore_portable_restart( int argc, char **argv, const char *fbase );
+  void copy_initial_state_to_device( void );
   void modify( const char *fname );
   int advance( void );
+  int rebalance( int force = 0 );
   void finalize( void );
   void print_run_details( void );
 
@@ -131,27 +146,48 @@ public:
   int verbose;              // Should system be verbose
   int num_step;             // Number of steps to take
   int num_comm_round;       // Num comm round
+  int diagonal_particle_exchange; // Send movers straight to edge / corner neighbors
+  int fuse_field_exchange;  // Send the ghost tang b with the current
   int status_interval;      // How often to print status messages
+  int comm_report_ranks;    // How many of the busiest ranks to list in them
   int clean_div_e_interval; // How often to clean div e
   int num_div_e_round;      // How many clean div e rounds per div e interval
   int clean_div_b_interval; // How often to clean div b
   int num_div_b_round;      // How many clean div b rounds per div b interval
   int sync_shared_interval; // How often to synchronize shared faces
 
+  // Dynamic load balancing (see rebalance.cc).  Every rebalance_interval
+  // steps (0 disables), if the slowest rank costs more than
+  // rebalance_threshold times the average, the cut planes of the grid
+  // are moved to even out the measured particle push cost.
+  int rebalance_interval;
+  double rebalance_threshold;
+  double rebalance_push_time; // Local push time since the last check
+  double rebalance_tic;       // Wallclock of the last check (<0 if none)
+
   // Track whether injection functions necessary
   int field_injection_interval = -1;
   int current_injection_interval = -1;
   int particle_injection_interval = -1;
-  // Track whether injection functions are ported to Kokkos
+  // Track whether injection functions are ported to Kokkos.  A ported
+  // user_particle_injection (e.g. one using inject_particles) is called
+  // while the movers are still on the device.
   bool kokkos_field_injection = false;
   bool kokkos_current_injection = false;
   bool kokkos_particle_injection = false;
+  // Box of voxels (ix0,ix1,iy0,iy1,iz0,iz1, ghost indexing, inclusive)
+  // a host user_field_injection or user_current_injection touches.  When
+  // set, only it is copied around those calls instead of the whole grid
+  // (an empty box, the default, copies the whole grid).
+  int injection_region[6];
 
   // FIXME: THESE INTERVALS SHOULDN'T BE PART OF vpic_simulation
   // THE BIG LIST FOLLOWING IT SHOULD BE CLEANED UP TOO
 
   double quota;
   int checkpt_interval;
+  int checkpt_async = 0; // checkpt() snapshots to host memory and writes
+                         // in the background (see checkpt_objects_async)
   int hydro_interval;
   int field_interval;
   int particle_interval;
@@ -245,6 +281,48 @@ public:
   void dump_particles( const char *sp_name, const char *fbase,
                        int fname_tag = 1 );
 
+  // Selective particle dumps: particles passing selection (and the
+  // optional device predicate, see particle_select.h) are compacted on
+  // the device and written time-centered with global positions.
+  template<class Predicate>
+  void dump_particles_selected( const char *sp_name, const char *fbase,
+                                const ParticleSelection & selection,
+                                const Predicate & predicate,
+                                int fname_tag = 1 );
+  void dump_particles_selected( const char *sp_name, const char *fbase,
+                                const ParticleSelection & selection,
+                                int fname_tag = 1 ) {
+    dump_particles_selected( sp_name, fbase, selection,
+                             select_all_particles(), fname_tag );
+  }
+  void write_selected_particles( const species_t *sp, const char *fbase,
+                                 int fname_tag,
+                                 const selected_particle_t *p, int n );
+
+  // In-situ particle histograms (see particle_histogram.h), summed over
+  // all ranks and written by rank 0.
+  void dump_histogram( const char *sp_name, const char *fbase,
+                       const ParticleHistogram & hist,
+                       int fname_tag = 1 );
+
+  // Tracer particles (see tracer.h).  define_tracers must be called on
+  // every rank, typically in user_initialization.  tag_tracers picks the
+  // particles to follow with the same criteria as selective particle
+  // dumps; the particles must be on the device (e.g. call it from
+  // user_diagnostics at step 0).  Samples are taken every interval steps
+  // and buffered on the device.
+  void define_tracers( const char *sp_name, const char *fbase,
+                       int interval, size_t buffer_records = 1<<20 );
+  template<class Predicate>
+  int tag_tracers( const char *sp_name,
+                   const ParticleSelection & selection,
+                   const Predicate & predicate );
+  int tag_tracers( const char *sp_name,
+                   const ParticleSelection & selection = ParticleSelection() ) {
+    return tag_tracers( sp_name, selection, select_all_particles() );
+  }
+  void flush_tracers( void );
+
   // convenience functions for simlog output
   void create_field_list(char * strlist, DumpParameters & dumpParams);
   void create_hydro_list(char * strlist, DumpParameters & dumpParams);
@@ -258,6 +336,10 @@ public:
     DumpParameters & dumpParams);
 
   void field_dump(DumpParameters & dumpParams);
+
+  // Decomposition independent restart dump (see portable_restart.cc),
+  // restored with --restart fbase on any number of ranks
+  void dump_portable_restart( const char *fbase );
   void hydro_dump(const char * speciesname, DumpParameters & dumpParams);
 
   ///////////////////
@@ -358,43 +440,53 @@ public:
   }
 
   // The below functions automatically create partition simple grids with
-  // simple boundary conditions on the edges.
+  // simple boundary conditions on the edges.  The optional cx, cy and cz
+  // give the cut planes of a non-uniform decomposition (see
+  // partition_periodic_box).
 
   inline void
   define_periodic_grid( double xl,  double yl,  double zl,
                         double xh,  double yh,  double zh,
                         double gnx, double gny, double gnz,
-                        double gpx, double gpy, double gpz )
+                        double gpx, double gpy, double gpz,
+                        const int * cx = NULL, const int * cy = NULL,
+                        const int * cz = NULL )
   {
       px = size_t(gpx); py = size_t(gpy); pz = size_t(gpz);
       partition_periodic_box( grid, xl, yl, zl, xh, yh, zh,
               (int)gnx, (int)gny, (int)gnz,
-              (int)gpx, (int)gpy, (int)gpz );
+              (int)gpx, (int)gpy, (int)gpz,
+              cx, cy, cz );
   }
 
   inline void
   define_absorbing_grid( double xl,  double yl,  double zl,
                          double xh,  double yh,  double zh,
                          double gnx, double gny, double gnz,
-                         double gpx, double gpy, double gpz, int pbc )
+                         double gpx, double gpy, double gpz, int pbc,
+                         const int * cx = NULL, const int * cy = NULL,
+                         const int * cz = NULL )
   {
       px = size_t(gpx); py = size_t(gpy); pz = size_t(gpz);
       partition_absorbing_box( grid, xl, yl, zl, xh, yh, zh,
               (int)gnx, (int)gny, (int)gnz,
               (int)gpx, (int)gpy, (int)gpz,
-              pbc );
+              pbc, cx, cy, cz );
   }
 
   inline void
   define_reflecting_grid( double xl,  double yl,  double zl,
                           double xh,  double yh,  double zh,
                           double gnx, double gny, double gnz,
-                          double gpx, double gpy, double gpz )
+                          double gpx, double gpy, double gpz,
+                          const int * cx = NULL, const int * cy = NULL,
+                          const int * cz = NULL )
   {
       px = size_t(gpx); py = size_t(gpy); pz = size_t(gpz);
       partition_metal_box( grid, xl, yl, zl, xh, yh, zh,
               (int)gnx, (int)gny, (int)gnz,
-              (int)gpx, (int)gpy, (int)gpz );
+              (int)gpx, (int)gpy, (int)gpz,
+              cx, cy, cz );
   }
 
   // The below macros allow custom domains to be created
@@ -584,6 +676,64 @@ public:
     sp->nm += move_p( sp->p, pm, field_array->k_jf_accum_h, grid, sp->q );
   }
 
+  // Device injection of particles from a density and a momentum
+  // functor (see particle_inject.h).  Returns the number of particles
+  // injected locally.
+
+  template<class Density, class Momentum>
+  inline int
+  inject_particles( species_t * sp,
+                    const Density & density,
+                    const Momentum & momentum,
+                    double w, double age = 0, int update_rhob = 1,
+                    int seed = 0 ) {
+    return inject_particles_device( sp, field_array, density, momentum,
+                                    (float)w, (float)age, update_rhob,
+                                    (uint32_t)seed );
+  }
+
+  // Device field and current sources (see field_inject.h).  t is
+  // passed to the profile; time() is the time at the start of the step.
+
+  template<class Profile>
+  inline void
+  inject_field_plane( field_var::f_v c, int axis, int i,
+                      const Profile & profile, double t, int add = 1 ) {
+    ::inject_field_plane( field_array, c, axis, i, profile, t, add );
+  }
+
+  template<class Profile>
+  inline void
+  inject_field_box( field_var::f_v c,
+                    int ix0, int ix1, int iy0, int iy1, int iz0, int iz1,
+                    const Profile & profile, double t, int add = 1 ) {
+    ::inject_field_box( field_array, c, ix0, ix1, iy0, iy1, iz0, iz1,
+                        profile, t, add );
+  }
+
+  inline void
+  set_injection_region( int ix0, int ix1, int iy0, int iy1, int iz0, int iz1 ) {
+    injection_region[0] = ix0; injection_region[1] = ix1;
+    injection_region[2] = iy0; injection_region[3] = iy1;
+    injection_region[4] = iz0; injection_region[5] = iz1;
+  }
+
+  // Copies around host field and current injection
+
+  inline void
+  copy_injection_region_to_host() {
+    const int * r = injection_region;
+    if( r[0]>r[1] ) field_array->copy_to_host();
+    else field_array->copy_to_host( r[0], r[1], r[2], r[3], r[4], r[5] );
+  }
+
+  inline void
+  copy_injection_region_to_device() {
+    const int * r = injection_region;
+    if( r[0]>r[1] ) field_array->copy_to_device();
+    else field_array->copy_to_device( r[0], r[1], r[2], r[3], r[4], r[5] );
+  }
+
   //////////////////////////////////
   // Random number generator helpers
 
@@ -749,6 +899,39 @@ public:
 };
 
 
+template<class Predicate>
+void
+vpic_simulation::dump_particles_selected( const char *sp_name,
+                                          const char *fbase,
+                                          const ParticleSelection & selection,
+                                          const Predicate & predicate,
+                                          int fname_tag )
+{
+  species_t * sp = find_species_name( sp_name, species_list );
+  if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
+  if( !fbase ) ERROR(( "Invalid filename" ));
+
+  // Only the selected particles cross to the host
+  auto k_selected = select_particles( sp, interpolator_array, selection, predicate );
+  auto h_selected = Kokkos::create_mirror_view_and_copy( KOKKOS_PINNED_SPACE(), k_selected );
+
+  write_selected_particles( sp, fbase, fname_tag, h_selected.data(),
+                            int( h_selected.extent(0) ) );
+}
+
+template<class Predicate>
+int
+vpic_simulation::tag_tracers( const char *sp_name,
+                              const ParticleSelection & selection,
+                              const Predicate & predicate )
+{
+  species_t * sp = find_species_name( sp_name, species_list );
+  if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
+  if( !sp->tracer ) ERROR(( "Species \"%s\" has no tracers defined", sp_name ));
+
+  return ::tag_tracers( sp->tracer, interpolator_array, selection, predicate );
+}
+
 /**
  * @brief After a checkpoint restore, we must move the data back over to the
  * Kokkos objects. This currently must be done for all views
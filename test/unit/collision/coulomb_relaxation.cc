@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+
+#include "src/vpic/vpic.h"
+
+// Temperature relaxation between two species by coulomb_collision_model
+// against the rate for Maxwellians,
+//
+//   dTa/dt = nu_ab ( Tb - Ta ),
+//   nu_ab  = qa^2 qb^2 nb lnL / ( 3 (2 pi)^3/2 eps0^2 ma mb ) ( Ta/ma + Tb/mb )^-3/2
+//
+// The more numerous species has the heavier particle weights, so its
+// particles are updated only part of the time and the other species'
+// particles are the partners that are reused.  Only the collisions
+// run (the particles are not pushed).
+
+static const int n_a = 8000, n_b = 4000, n_step = 50;
+static const double w_a = 4e-6, w_b = 1e-6, T_a0 = 2e-4, T_b0 = 1e-4;
+static const double coulomb_log = 10, dt = 7e-6;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( dt );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        1, 1, 1,   // Grid high corner
+                        1, 1, 1,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  species_t * a = define_species( "a", 1, 1, n_a, -1, 0, 0 );
+  species_t * b = define_species( "b", 1, 1, n_b, -1, 0, 0 );
+  define_collision_op( coulomb_collision_model( "ab", a, b, coulomb_log,
+                                                coulomb_takizuka_abe, 7, 1 ) );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+// Weighted temperature (m = c = 1) about the mean momentum
+
+static double
+temperature( species_t * sp ) {
+  auto p = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), sp->k_p_d );
+  double w = 0, u[3] = { 0, 0, 0 }, u2 = 0;
+  for( int n=0; n<sp->np; n++ ) {
+    const double pw = p(n, particle_var::w);
+    w += pw;
+    for( int c=0; c<3; c++ ) {
+      const double uc = p(n, particle_var::ux + c);
+      u[c] += pw*uc, u2 += pw*uc*uc;
+    }
+  }
+  return ( u2 - ( u[0]*u[0] + u[1]*u[1] + u[2]*u[2] )/w )/( 3*w );
+}
+
+TEST_CASE( "coulomb temperature relaxation", "[collision]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  species_t * a = simulation->find_species( "a" );
+  species_t * b = simulation->find_species( "b" );
+  const double vth_a = sqrt( T_a0 ), vth_b = sqrt( T_b0 );
+  for( int n=0; n<n_a; n++ )
+    simulation->inject_particle( a, simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, vth_a ),
+                                 simulation->normal( simulation->rng(0), 0, vth_a ),
+                                 simulation->normal( simulation->rng(0), 0, vth_a ),
+                                 w_a, 0, 0 );
+  for( int n=0; n<n_b; n++ )
+    simulation->inject_particle( b, simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->uniform( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, vth_b ),
+                                 simulation->normal( simulation->rng(0), 0, vth_b ),
+                                 simulation->normal( simulation->rng(0), 0, vth_b ),
+                                 w_b, 0, 0 );
+  a->copy_to_device();
+  b->copy_to_device();
+
+  // The rate equations from the sampled temperatures
+  const double dens_a = n_a*w_a, dens_b = n_b*w_b; // The volume is 1
+  const double C = coulomb_log/( 3*pow( 2*M_PI, 1.5 ) );
+  double Ta = temperature( a ), Tb = temperature( b );
+  const double dT0 = Ta - Tb, Tb_start = Tb;
+  for( int s=0; s<n_step; s++ ) {
+    const double f = C*pow( Ta + Tb, -1.5 )*dt;
+    const double dTa = f*dens_b*( Tb - Ta ), dTb = f*dens_a*( Ta - Tb );
+    Ta += dTa, Tb += dTb;
+  }
+
+  for( int s=0; s<n_step; s++ ) {
+    apply_collision_op_list( simulation->collision_op_list );
+    simulation->grid->step++;
+  }
+  const double Ta_end = temperature( a ), Tb_end = temperature( b );
+
+  // The difference decays by about half; b takes nearly all of it
+  const double predicted = ( Ta - Tb )/dT0, measured = ( Ta_end - Tb_end )/dT0;
+  REQUIRE( predicted<0.7 );
+  REQUIRE( std::fabs( measured - predicted )<0.08 );
+  REQUIRE( std::fabs( ( Tb_end - Tb_start ) - ( Tb - Tb_start ) )<0.15*( Tb - Tb_start ) );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
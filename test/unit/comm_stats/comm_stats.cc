@@ -0,0 +1,115 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "src/vpic/vpic.h"
+
+// The communication counters on two ranks.  A known exchange (three
+// messages of 100, 200 and 300 bytes each way) made outside a step, in
+// the current injection of a step and in the diagnostics after it must
+// add exactly its messages and bytes to the counters of the steps
+// (comm_stat) or of the rest (comm_stat_other).  Nothing in the deck
+// depends on the step, so every step after the first makes the same
+// exchanges of its own.
+
+static const int n_msg = 3;
+static int exchange_in_step = 0, exchange_in_diagnostics = 0;
+
+static void
+known_exchange( void ) {
+  const int partner = world_rank ^ 1;
+  mp_t * mp = new_mp( n_msg );
+  int m;
+  for( m=0; m<n_msg; m++ ) {
+    mp_size_recv_buffer( mp, m, 100*(m+1) );
+    mp_size_send_buffer( mp, m, 100*(m+1) );
+  }
+  for( m=0; m<n_msg; m++ ) mp_begin_recv( mp, m, 100*(m+1), partner, m );
+  for( m=0; m<n_msg; m++ ) mp_begin_send( mp, m, 100*(m+1), partner, m );
+  for( m=0; m<n_msg; m++ ) mp_end_recv( mp, m );
+  for( m=0; m<n_msg; m++ ) mp_end_send( mp, m );
+  delete_mp( mp );
+}
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 4, 4,   // Grid high corner
+                        8, 4, 4,   // Grid resolution
+                        2, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "electron", -1, 1, 100, -1, 0, 0 );
+  current_injection_interval = 1;
+}
+
+void vpic_simulation::user_diagnostics() {
+  if( exchange_in_diagnostics ) known_exchange();
+}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {
+  if( exchange_in_step ) known_exchange();
+}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+static void
+clear_stats( void ) {
+  for( int s=0; s<n_comm_stat; s++ ) comm_stat[s] = 0, comm_stat_other[s] = 0;
+}
+
+TEST_CASE( "communication counters", "[profile]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  static const int counted[4] = { comm_stat_msg_sent, comm_stat_byte_sent,
+                                  comm_stat_msg_recv, comm_stat_byte_recv };
+  const double known[4] = { n_msg, 600, n_msg, 600 };
+  int c;
+
+  // Outside any step
+  clear_stats();
+  known_exchange();
+  for( c=0; c<4; c++ ) {
+    REQUIRE( comm_stat_other[ counted[c] ]==known[c] );
+    REQUIRE( comm_stat[ counted[c] ]==0 );
+  }
+
+  // A step of its own exchanges only (after a first one, which may set
+  // up the exchanges)
+  simulation->advance();
+  clear_stats();
+  simulation->advance();
+  double base[4];
+  for( c=0; c<4; c++ ) {
+    base[c] = comm_stat[ counted[c] ];
+    REQUIRE( comm_stat_other[ counted[c] ]==0 );
+  }
+  REQUIRE( base[0]>0 );
+
+  // The same step with the known exchange in it and in the diagnostics
+  clear_stats();
+  exchange_in_step = exchange_in_diagnostics = 1;
+  simulation->advance();
+  for( c=0; c<4; c++ ) {
+    REQUIRE( comm_stat[ counted[c] ]==base[c] + known[c] );
+    REQUIRE( comm_stat_other[ counted[c] ]==known[c] );
+  }
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,138 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// A Child-Langmuir emitter on the -x faces of the first column of cells
+// and the +x faces of the last one.  Only faces whose cell-average E
+// pulls electrons off the surface emit; each emits n_emit particles of
+// weight norm |E|^(3/2) moving away from the face, and body components
+// never emit.
+
+static const int n_emit = 20;
+static const float ut_para = 0.05, thresh = 0.05;
+
+static emitter_t * emitter;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  species_t * sp = define_species( "electron", -1, 1, 4*n_emit*grid->ny*grid->nz, -1, 0, 0 );
+
+  // No perpendicular momentum, so the particles stay in their cell
+  emitter = define_emitter( child_langmuir( sp, interpolator_array, field_array,
+                                            new_accumulator_array( grid ), entropy,
+                                            n_emit, ut_para, 0, thresh,
+                                            CHILD_LANGMUIR ) );
+  int32_t * c = size_emitter( emitter, 2*grid->ny*grid->nz + 1 );
+  int n = 0;
+  for( int k=1; k<=grid->nz; k++ )
+    for( int j=1; j<=grid->ny; j++ ) {
+      c[n++] = COMPONENT_ID( voxel( 1,        j, k ), BOUNDARY(-1,0,0) );
+      c[n++] = COMPONENT_ID( voxel( grid->nx, j, k ), BOUNDARY( 1,0,0) );
+    }
+  c[n++] = COMPONENT_ID( voxel( 2, 2, 2 ), BOUNDARY(0,0,0) );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "child langmuir emission", "[emitter]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "electron" );
+
+  // First column: every face emits.  Last column: only the lower half
+  // in z has E of the right sign.  The body component sees a strong
+  // field but is not a face.
+  interpolator_array_t * ia = simulation->interpolator_array;
+  std::vector<float> ex( g->nv, 0 );
+  for( int k=1; k<=g->nz; k++ )
+    for( int j=1; j<=g->ny; j++ ) {
+      ex[ simulation->voxel( 1, j, k ) ]     = -( 0.1 + 0.02*j + 0.05*k );
+      ex[ simulation->voxel( g->nx, j, k ) ] = k<=2 ? 0.2 + 0.01*j : -0.2;
+    }
+  ex[ simulation->voxel( 2, 2, 2 ) ] = -1;
+  for( int v=0; v<g->nv; v++ ) {
+    CLEAR( &ia->i[v], 1 );
+    ia->i[v].ex = ex[v];
+  }
+  ia->copy_to_device();
+
+  apply_emitter_list( simulation->emitter_list );
+
+  const int n_face = g->ny*g->nz + g->ny*g->nz/2;
+  REQUIRE( sp->np==n_face*n_emit );
+  REQUIRE( sp->k_nm_h(0)==0 );
+
+  k_particles_t::HostMirror p = Kokkos::create_mirror( sp->k_p_d );
+  k_particles_i_t::HostMirror pi = Kokkos::create_mirror( sp->k_p_i_d );
+  Kokkos::deep_copy( p, sp->k_p_d );
+  Kokkos::deep_copy( pi, sp->k_p_i_d );
+
+  const float norm = ( (float)CHILD_LANGMUIR*g->eps0*g->dt ) /
+                     ( sqrtf( fabsf( sp->q*sp->m ) )*(float)n_emit );
+  const float norm_x = norm*sqrtf( g->rdx )*g->dy*g->dz;
+
+  std::vector<int> count( g->nv, 0 );
+  int n_bad = 0;
+  double sum_para = 0;
+  for( int n=0; n<sp->np; n++ ) {
+    const int v = pi(n), ix = v % g->sy;
+    const float dir = ix==1 ? 1 : -1;
+    const float e = fabsf( ex[v] );
+    const float w = norm_x*sqrtf( e*e*e );
+    count[v]++;
+    if( ix!=1 && ix!=g->nx ) n_bad++;
+    if( !( dir*p(n, particle_var::ux)>0 ) ) n_bad++;
+    if( p(n, particle_var::uy)!=0 || p(n, particle_var::uz)!=0 ) n_bad++;
+    if( fabsf( p(n, particle_var::w) - w )>1e-5f*w ) n_bad++;
+    if( fabsf( p(n, particle_var::dx) )>1 ||
+        fabsf( p(n, particle_var::dy) )>1 ||
+        fabsf( p(n, particle_var::dz) )>1 ) n_bad++;
+    sum_para += dir*p(n, particle_var::ux);
+  }
+  REQUIRE( n_bad==0 );
+
+  int n_miscount = 0;
+  for( int k=1; k<=g->nz; k++ )
+    for( int j=1; j<=g->ny; j++ ) {
+      if( count[ simulation->voxel( 1, j, k ) ]!=n_emit ) n_miscount++;
+      if( count[ simulation->voxel( g->nx, j, k ) ]!=( k<=2 ? n_emit : 0 ) ) n_miscount++;
+    }
+  REQUIRE( n_miscount==0 );
+
+  // Half-Maxwellian: the normal momentum averages sqrt(pi/2) ut_para
+  REQUIRE( fabs( sum_para/sp->np/( sqrt( 0.5*M_PI )*ut_para ) - 1 )<0.1 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
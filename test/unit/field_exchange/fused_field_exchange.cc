@@ -0,0 +1,126 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstring>
+
+#include "src/vpic/vpic.h"
+
+// Sending the ghost tang b with the current (fuse_field_exchange) gives
+// bitwise the same fields as exchanging them separately.  Both runs
+// start from the same fields (a magnetic wave) and the same charged
+// particles on a 2x2 decomposition; nothing in the deck depends on the
+// step number.
+
+static const int n_part = 2000, n_step = 4;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 8, 4,   // Grid high corner
+                        8, 8, 4,   // Grid resolution
+                        2, 2, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "electron", -1, 1, 4*n_part, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+// The same particles on every call
+
+static void
+load_particles( vpic_simulation * s,
+                species_t * sp ) {
+  const grid_t * g = s->grid;
+  s->seed_entropy( 1 );
+  sp->np = 0;
+  for( int n=0; n<n_part; n++ ) {
+    const double x = s->uniform( s->rng(0), g->x0, g->x1 );
+    const double y = s->uniform( s->rng(0), g->y0, g->y1 );
+    const double z = s->uniform( s->rng(0), g->z0, g->z1 );
+    s->inject_particle( sp, x, y, z,
+                        s->normal( s->rng(0), 0, 0.3 ),
+                        s->normal( s->rng(0), 0, 0.3 ),
+                        s->normal( s->rng(0), 0, 0.3 ), 1, 0, 0 );
+  }
+  sp->copy_to_device();
+}
+
+// The fields after n_step steps from f0
+
+static k_field_t::HostMirror
+run( vpic_simulation * s,
+     const k_field_t::HostMirror & f0,
+     int fuse ) {
+  k_field_t & f = s->field_array->k_f_d;
+  Kokkos::deep_copy( f, f0 );
+  load_interpolator_array( s->interpolator_array, s->field_array );
+  load_particles( s, s->find_species( "electron" ) );
+  s->fuse_field_exchange = fuse;
+  for( int n=0; n<n_step; n++ ) s->advance();
+  k_field_t::HostMirror r = Kokkos::create_mirror( f ); // Never f itself
+  Kokkos::deep_copy( r, f );
+  return r;
+}
+
+TEST_CASE( "fused field exchange", "[field_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+
+  // A magnetic wave along x (in global coordinates, so it is continuous
+  // across the domains)
+  k_field_t::HostMirror f0 = Kokkos::create_mirror( simulation->field_array->k_f_d );
+  Kokkos::deep_copy( f0, simulation->field_array->k_f_d );
+  for( int z=1; z<=nz+1; z++ )
+    for( int y=1; y<=ny+1; y++ )
+      for( int x=1; x<=nx+1; x++ ) {
+        const double gx = g->x0 + ( x-0.5 )*g->dx;
+        f0( VOXEL(x,y,z, nx,ny,nz), field_var::cbz ) = 0.2*sin( 2*M_PI*gx/8 );
+      }
+
+  const k_field_t::HostMirror split = run( simulation, f0, 0 );
+  const k_field_t::HostMirror fused = run( simulation, f0, 1 );
+
+  // E and B of the local domain (the ghosts are left as they are)
+  const int var[] = { field_var::ex,  field_var::ey,  field_var::ez,
+                      field_var::cbx, field_var::cby, field_var::cbz };
+  int local[2] = { 0, 0 }, total[2]; // Bitwise differences, nonzero E
+  for( int z=1; z<=nz; z++ )
+    for( int y=1; y<=ny; y++ )
+      for( int x=1; x<=nx; x++ ) {
+        const int v = VOXEL(x,y,z, nx,ny,nz);
+        for( int c=0; c<6; c++ ) {
+          if( memcmp( &split( v, var[c] ), &fused( v, var[c] ), sizeof(float) ) ) local[0]++;
+          if( c<3 && split( v, var[c] )!=0 ) local[1]++;
+        }
+      }
+  mp_allsum_i( local, total, 2 );
+  REQUIRE( total[1]>0 ); // The particles did make a current
+  REQUIRE( total[0]==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
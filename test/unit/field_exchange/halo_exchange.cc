@@ -0,0 +1,164 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "src/vpic/vpic.h"
+
+// The single round halo exchange on the device (halo.h) against the
+// axis by axis exchange of the host kernels on a 2x2x2 decomposition.
+// Both start from the same small integer fields, so the shared sums and
+// averages are exact and must agree bitwise.  The ghosts start at a
+// sentinel; every ghost the axis by axis exchange fills must get the same
+// value from the single round one (which may fill the edge ghosts too).
+
+static const float sentinel = -1;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 8, 8,   // Grid high corner
+                        8, 8, 8,   // Grid resolution
+                        2, 2, 2 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+// The same fields on the host (fa->f) and on the device
+
+static void
+fill( vpic_simulation * s,
+      k_field_t::HostMirror & m ) {
+  const grid_t * g = s->grid;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  const int ox = (int)( g->x0/g->dx + 0.5 );
+  const int oy = (int)( g->y0/g->dy + 0.5 );
+  const int oz = (int)( g->z0/g->dz + 0.5 );
+  for( int z=0; z<=nz+1; z++ )
+    for( int y=0; y<=ny+1; y++ )
+      for( int x=0; x<=nx+1; x++ ) {
+        const int v = VOXEL(x,y,z, nx,ny,nz);
+        const int ghost = x==0 || y==0 || z==0 || x==nx+1 || y==ny+1 || z==nz+1;
+        float * h = &s->field_array->f[v].ex;
+        for( int c=0; c<16; c++ ) {
+          h[c] = ghost ? sentinel : 1 + ( (ox+x) + 3*(oy+y) + 7*(oz+z) + 11*c ) % 17;
+          m(v, c) = h[c];
+        }
+      }
+  Kokkos::deep_copy( s->field_array->k_f_d, m );
+}
+
+// Compare the components comp of the device fields (d) with the host
+// ones, skipping the entries the host run left at the sentinel.  count
+// gets the mismatches and the ghost entries the host run filled.
+
+static void
+compare( vpic_simulation * s,
+         const k_field_t::HostMirror & d,
+         const int * comp,
+         int n_comp,
+         int count[2] ) {
+  const grid_t * g = s->grid;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  for( int z=0; z<=nz+1; z++ )
+    for( int y=0; y<=ny+1; y++ )
+      for( int x=0; x<=nx+1; x++ ) {
+        const int v = VOXEL(x,y,z, nx,ny,nz);
+        const int ghost = x==0 || y==0 || z==0 || x==nx+1 || y==ny+1 || z==nz+1;
+        const float * h = &s->field_array->f[v].ex;
+        for( int n=0; n<n_comp; n++ ) {
+          const int c = comp[n];
+          if( h[c]==sentinel ) continue;
+          if( d(v, c)!=h[c] ) count[0]++;
+          if( ghost ) count[1]++;
+        }
+      }
+}
+
+typedef void (*exchange_t)( field_array_t * fa );
+
+static void advance_e_host  ( field_array_t * fa ) { fa->kernel->advance_e( fa, 1 ); }
+static void advance_e_device( field_array_t * fa ) { fa->kernel->advance_e_kokkos( fa, 1 ); }
+
+// Run the device and the host version of an operation from the same
+// fields and compare the components comp.  total gets the mismatch and
+// filled ghost counts summed over the ranks.
+
+static void
+check( vpic_simulation * s,
+       exchange_t device,
+       exchange_t host,
+       const int * comp,
+       int n_comp,
+       int total[2] ) {
+  field_array_t * fa = s->field_array;
+  k_field_t::HostMirror m = Kokkos::create_mirror( fa->k_f_d );
+  k_field_t::HostMirror d = Kokkos::create_mirror( fa->k_f_d );
+
+  fill( s, m );
+  device( fa );
+  Kokkos::deep_copy( d, fa->k_f_d );
+  host( fa );
+
+  int local[2] = { 0, 0 };
+  compare( s, d, comp, n_comp, local );
+  mp_allsum_i( local, total, 2 );
+}
+
+TEST_CASE( "single round halo exchange", "[field_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  field_advance_kernels_t * k = simulation->field_array->kernel;
+  REQUIRE( simulation->grid->cut!=NULL ); // Else jf and rho go axis by axis too
+
+  int count[2];
+
+  // Shared current, free and bound charge on the faces, edges and corners
+  static const int jf[3] = { field_var::jfx, field_var::jfy, field_var::jfz };
+  check( simulation, k->k_synchronize_jf, k->synchronize_jf, jf, 3, count );
+  REQUIRE( count[0]==0 );
+
+  static const int rho[2] = { field_var::rhof, field_var::rhob };
+  check( simulation, k->k_synchronize_rho, k->synchronize_rho, rho, 2, count );
+  REQUIRE( count[0]==0 );
+
+  // Ghost tangential B (advance_e), normal E (compute_div_e_err) and
+  // div B error (clean_div_b)
+  static const int tang_b[3] = { field_var::cbx, field_var::cby, field_var::cbz };
+  check( simulation, advance_e_device, advance_e_host, tang_b, 3, count );
+  REQUIRE( count[1]>0 );
+  REQUIRE( count[0]==0 );
+
+  static const int norm_e[3] = { field_var::ex, field_var::ey, field_var::ez };
+  check( simulation, k->compute_div_e_err_kokkos, k->compute_div_e_err, norm_e, 3, count );
+  REQUIRE( count[1]>0 );
+  REQUIRE( count[0]==0 );
+
+  static const int div_b[1] = { field_var::div_b_err };
+  check( simulation, k->clean_div_b_kokkos, k->clean_div_b, div_b, 1, count );
+  REQUIRE( count[1]>0 );
+  REQUIRE( count[0]==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,68 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include "src/vpic/vpic.h"
+
+// A host user_field_injection must reach the device fields, both with
+// the default (whole grid) copies and with an injection region set.
+
+static float injected = 0;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  num_step = 2;
+  field_injection_interval = 1;
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {
+  field( 2, 3, 2 ).ex = injected;
+}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "host field injection", "[field_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const int v = simulation->voxel( 2, 3, 2 );
+  k_field_t::HostMirror f = Kokkos::create_mirror_view( simulation->field_array->k_f_d );
+
+  // Whole grid
+  injected = 1;
+  simulation->advance();
+  Kokkos::deep_copy( f, simulation->field_array->k_f_d );
+  REQUIRE( f( v, field_var::ex )==1 );
+
+  // Only the voxel injected into
+  injected = 2;
+  simulation->set_injection_region( 2, 2, 3, 3, 2, 2 );
+  simulation->advance();
+  Kokkos::deep_copy( f, simulation->field_array->k_f_d );
+  REQUIRE( f( v, field_var::ex )==2 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// Histograms of particles with known momenta.  Each rank puts k+1
+// particles of weight 2 at ux in the middle of bin k of [-1,1) (8
+// bins), at the middle of its domain, and one more at ux = 5 (out of
+// range).  The fields are zero, so centering leaves the momenta alone.
+
+static const int n_bin = 8;
+static const float w = 2;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 4, 4,   // Grid high corner
+                        8, 4, 4,   // Grid resolution
+                        nproc(), 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "electron", -1, 1, 100, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+static double
+kinetic( double ux ) {
+  return ux*ux/( 1 + sqrt( 1 + ux*ux ) );
+}
+
+// The histogram summed over the ranks
+
+static std::vector<double>
+global_histogram( vpic_simulation * s,
+                  const ParticleHistogram & hist ) {
+  auto k_hist = histogram_particles( s->find_species( "electron" ),
+                                     s->interpolator_array, hist );
+  auto h_hist = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), k_hist );
+  std::vector<double> global( hist.nbins() );
+  mp_allsum_d( h_hist.data(), global.data(), hist.nbins() );
+  return global;
+}
+
+TEST_CASE( "particle histograms", "[species_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "electron" );
+  const double xc = 0.5*( g->x0 + g->x1 ), yc = 2, zc = 2;
+  double energy = 0; // Of the particles of this rank
+  for( int k=0; k<n_bin; k++ ) {
+    const double ux = -1 + ( k + 0.5 )*( 2./n_bin );
+    for( int n=0; n<=k; n++ ) simulation->inject_particle( sp, xc, yc, zc, ux, 0, 0, w, 0, 0 );
+    energy += ( k + 1 )*w*kinetic( ux );
+  }
+  simulation->inject_particle( sp, xc, yc, zc, 5, 0, 0, w, 0, 0 );
+  energy += w*kinetic( 5 );
+  sp->copy_to_device();
+
+  const int n = world_size;
+  const HistogramAxis ux_axis( hist_ux, n_bin, -1, 1 );
+
+  {
+    // The dumped spectrum drops the particle out of range
+    simulation->dump_histogram( "electron", "histogram_ux", ParticleHistogram( ux_axis ), 0 );
+    if( world_rank==0 ) {
+      std::vector<double> dumped( n_bin );
+      FILE * file = fopen( "histogram_ux", "rb" );
+      REQUIRE( file );
+      REQUIRE( fseek( file, -long( n_bin*sizeof(double) ), SEEK_END )==0 );
+      REQUIRE( fread( dumped.data(), sizeof(double), n_bin, file )==size_t( n_bin ) );
+      fclose( file );
+      remove( "histogram_ux" );
+      for( int k=0; k<n_bin; k++ ) REQUIRE( dumped[k]==n*w*( k + 1 ) );
+    }
+  }
+
+  {
+    // Clamped, it lands in the last bin; counted as macro particles
+    const std::vector<double> h =
+      global_histogram( simulation, ParticleHistogram( HistogramAxis( hist_ux, n_bin, -1, 1, 0, 1 ),
+                                                       hist_weight_macro ) );
+    for( int k=0; k<n_bin-1; k++ ) REQUIRE( h[k]==n*( k + 1 ) );
+    REQUIRE( h[n_bin-1]==n*( n_bin + 1 ) );
+  }
+
+  {
+    // x-ux phase space: one x bin per rank
+    const std::vector<double> h =
+      global_histogram( simulation, ParticleHistogram( ux_axis, HistogramAxis( hist_x, n, 0, 8 ) ) );
+    for( int r=0; r<n; r++ )
+      for( int k=0; k<n_bin; k++ ) REQUIRE( h[k + n_bin*r]==w*( k + 1 ) );
+  }
+
+  {
+    // Energy weighted, in one bin: the kinetic energy of all of them
+    const std::vector<double> h =
+      global_histogram( simulation, ParticleHistogram( HistogramAxis( hist_ke, 1, 0, 10 ),
+                                                       hist_weight_energy ) );
+    double total;
+    mp_allsum_d( &energy, &total, 1 );
+    REQUIRE( std::fabs( h[0] - total )<=1e-5*total );
+  }
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,128 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+
+#include "src/vpic/vpic.h"
+
+// Particles leaving through -x hit an absorb_tally boundary and those
+// leaving through +x a maxwellian_reflux one, both applied on the
+// device.  After one step the absorbed ones are gone and tallied, the
+// refluxed ones are back in the last cell moving inward with the
+// reflux temperature, and the particles at rest are untouched.
+
+static const int n_absorb = 400, n_reflux = 600, n_rest = 200;
+static const float ut_para = 0.1, ut_perp = 0.05;
+
+static particle_bc_t * tally;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 2, 2,   // Grid high corner
+                        8, 2, 2,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  species_t * sp = define_species( "electron", -1, 1, n_absorb + n_reflux + n_rest, -1, 0, 0 );
+
+  tally = define_particle_bc( absorb_tally( species_list, field_array ) );
+  particle_bc_t * reflux = define_particle_bc( maxwellian_reflux( species_list, entropy ) );
+  set_reflux_temp( reflux, sp, ut_para, ut_perp );
+
+  set_domain_field_bc( BOUNDARY(-1,0,0), pec_fields );
+  set_domain_field_bc( BOUNDARY( 1,0,0), pec_fields );
+  set_domain_particle_bc( BOUNDARY(-1,0,0), get_particle_bc_id( tally ) );
+  set_domain_particle_bc( BOUNDARY( 1,0,0), get_particle_bc_id( reflux ) );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "device particle boundaries", "[boundary]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  // At ux = 0.9, a particle covers 0.33 cells in a step, so the ones
+  // within 0.25 of an x face all leave through it
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "electron" );
+  for( int n=0; n<n_absorb; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), 0.05, 0.25 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 -0.9, 0, 0, 1, 0, 0 );
+  for( int n=0; n<n_reflux; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), 7.75, 7.95 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 0.9, 0, 0, 1, 0, 0 );
+  for( int n=0; n<n_rest; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), 3, 5 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 0, 0, 0, 1, 0, 0 );
+  sp->copy_to_device();
+
+  simulation->advance();
+
+  REQUIRE( get_absorb_tally( tally )[ sp->id ]==n_absorb );
+  REQUIRE( sp->np==n_reflux + n_rest );
+
+  k_particles_t::HostMirror p = Kokkos::create_mirror( sp->k_p_d );
+  k_particles_i_t::HostMirror pi = Kokkos::create_mirror( sp->k_p_i_d );
+  Kokkos::deep_copy( p, sp->k_p_d );
+  Kokkos::deep_copy( pi, sp->k_p_i_d );
+
+  int n_in = 0, n_at_rest = 0, n_stray = 0;
+  double sum_para = 0, sum_perp2 = 0;
+  for( int n=0; n<sp->np; n++ ) {
+    const int ix = pi(n) % g->sy;
+    const float ux = p(n, particle_var::ux);
+    const float uy = p(n, particle_var::uy);
+    const float uz = p(n, particle_var::uz);
+    if( ux==0 && uy==0 && uz==0 ) {
+      if( ix<4 || ix>5 ) n_stray++;
+      n_at_rest++;
+    } else {
+      if( ix!=g->nx || !( ux<0 ) ) n_stray++;
+      sum_para  += -ux;
+      sum_perp2 += 0.5*( uy*uy + uz*uz );
+      n_in++;
+    }
+  }
+  REQUIRE( n_stray==0 );
+  REQUIRE( n_in==n_reflux );
+  REQUIRE( n_at_rest==n_rest );
+
+  // The normal momentum of a flux-weighted Maxwellian averages
+  // sqrt(pi/2) ut_para; the tangential ones have variance ut_perp^2
+  const double mean_para = sum_para/n_in;
+  const double rms_perp  = std::sqrt( sum_perp2/n_in );
+  REQUIRE( std::fabs( mean_para/( std::sqrt( 0.5*M_PI )*ut_para ) - 1 )<0.1 );
+  REQUIRE( std::fabs( rms_perp/ut_perp - 1 )<0.1 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
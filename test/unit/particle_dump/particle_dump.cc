@@ -0,0 +1,118 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// dump_particles streams the particles through the device centering
+// kernel.  The records in the file must be the particles centered by
+// the host center_p, and the particles on the device must be left as
+// they were.
+
+static const int n_part = 3000;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "ion", 1, 2, n_part, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+static int
+agree( float a, float b ) {
+  return std::fabs( a-b )<=1e-5f*( 1 + std::fabs( b ) );
+}
+
+TEST_CASE( "streamed particle dump", "[species_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "ion" );
+  for( int n=0; n<n_part; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), g->x0, g->x1 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 1 + n%7, 0, 0 );
+  sp->copy_to_device();
+
+  // Fields that differ from voxel to voxel, so a wrong voxel index shows
+  interpolator_array_t * ia = simulation->interpolator_array;
+  for( int v=0; v<g->nv; v++ ) {
+    interpolator_t & f = ia->i[v];
+    CLEAR( &f, 1 );
+    f.ex  = 0.01*( v%5 ), f.dexdy = 0.02, f.ey = -0.03, f.deydx = 0.01;
+    f.ez  = 0.02*( v%3 ), f.dezdy = -0.01;
+    f.cbx = 0.2, f.dcbxdx = 0.05, f.cby = -0.1*( v%4 ), f.cbz = 0.3;
+  }
+  ia->copy_to_device();
+
+  k_particles_t::HostMirror before = Kokkos::create_mirror( sp->k_p_d );
+  Kokkos::deep_copy( before, sp->k_p_d );
+
+  simulation->dump_particles( "ion", "particle_dump", 0 );
+
+  // The dump ends with the particle records
+  std::vector<particle_t> dumped( n_part );
+  FILE * file = fopen( "particle_dump.0", "rb" );
+  REQUIRE( file );
+  REQUIRE( fseek( file, -long( n_part*sizeof(particle_t) ), SEEK_END )==0 );
+  REQUIRE( fread( dumped.data(), sizeof(particle_t), n_part, file )==size_t( n_part ) );
+  fclose( file );
+  remove( "particle_dump.0" );
+
+  // The device particles are untouched
+  k_particles_t::HostMirror after = Kokkos::create_mirror( sp->k_p_d );
+  Kokkos::deep_copy( after, sp->k_p_d );
+  int changed = 0;
+  for( int n=0; n<n_part; n++ )
+    for( int c=0; c<PARTICLE_VAR_COUNT; c++ )
+      if( after(n,c)!=before(n,c) ) changed++;
+  REQUIRE( changed==0 );
+
+  // What the host centers them to
+  sp->copy_to_host();
+  center_p( sp, ia );
+  int bad = 0;
+  for( int n=0; n<n_part; n++ ) {
+    const particle_t & d = dumped[n], & p = sp->p[n];
+    if( d.dx!=p.dx || d.dy!=p.dy || d.dz!=p.dz || d.i!=p.i || d.w!=p.w ) bad++;
+    if( !agree( d.ux, p.ux ) || !agree( d.uy, p.uy ) || !agree( d.uz, p.uz ) ) bad++;
+  }
+  REQUIRE( bad==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,121 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// dump_particles_selected writes, in order, the particles passing the
+// selection and the predicate, with their global positions.  The fields
+// are zero, so the centered momenta are the momenta themselves (the
+// centering is checked by the particle_dump test).
+
+static const int n_part = 3000;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "ion", 1, 1, n_part, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+struct heavy_particles {
+  KOKKOS_INLINE_FUNCTION bool
+  operator()( const selected_particle_t & p ) const { return p.w>3; }
+};
+
+static int
+agree( float a, float b ) {
+  return std::fabs( a-b )<=1e-5f*( 1 + std::fabs( b ) );
+}
+
+TEST_CASE( "selected particle dump", "[species_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "ion" );
+  for( int n=0; n<n_part; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), g->x0, g->x1 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 simulation->normal( simulation->rng(0), 0, 1 ),
+                                 1 + n%7, 0, 0 );
+  sp->copy_to_device();
+
+  ParticleSelection sel;
+  sel.stride = 2;
+  sel.ke_min = 0.2, sel.ke_max = 1.5;
+  sel.x0 = 0, sel.x1 = 2.5;
+  sel.z0 = 1, sel.z1 = 4;
+  simulation->dump_particles_selected( "ion", "selected_dump", sel, heavy_particles(), 0 );
+
+  // What should have been selected
+  std::vector<selected_particle_t> expected;
+  for( int n=0; n<n_part; n+=sel.stride ) {
+    const particle_t & p = sp->p[n];
+    const int iz = p.i/g->sz, iy = ( p.i - iz*g->sz )/g->sy, ix = p.i - iz*g->sz - iy*g->sy;
+    selected_particle_t s;
+    s.x  = g->x0 + ( ( ix - 1 ) + 0.5f*( p.dx + 1 ) )*g->dx;
+    s.y  = g->y0 + ( ( iy - 1 ) + 0.5f*( p.dy + 1 ) )*g->dy;
+    s.z  = g->z0 + ( ( iz - 1 ) + 0.5f*( p.dz + 1 ) )*g->dz;
+    s.ux = p.ux, s.uy = p.uy, s.uz = p.uz, s.w = p.w;
+    if( sel.accepts( s ) && s.w>3 ) expected.push_back( s );
+  }
+  const int n = expected.size();
+  REQUIRE( n>0 );
+  REQUIRE( n<n_part/2 );
+
+  // The file ends with the count and the records
+  std::vector<selected_particle_t> dumped( n );
+  int count = -1;
+  FILE * file = fopen( "selected_dump.0", "rb" );
+  REQUIRE( file );
+  REQUIRE( fseek( file, -long( sizeof(int) + n*sizeof(selected_particle_t) ), SEEK_END )==0 );
+  REQUIRE( fread( &count, sizeof(int), 1, file )==1 );
+  REQUIRE( fread( dumped.data(), sizeof(selected_particle_t), n, file )==size_t( n ) );
+  fclose( file );
+  remove( "selected_dump.0" );
+  REQUIRE( count==n );
+
+  int bad = 0;
+  for( int k=0; k<n; k++ ) {
+    const selected_particle_t & d = dumped[k], & e = expected[k];
+    if( !agree( d.x, e.x ) || !agree( d.y, e.y ) || !agree( d.z, e.z ) ) bad++;
+    if( d.ux!=e.ux || d.uy!=e.uy || d.uz!=e.uz || d.w!=e.w ) bad++;
+  }
+  REQUIRE( bad==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
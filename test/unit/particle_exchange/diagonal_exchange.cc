@@ -0,0 +1,138 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// The diagonal particle exchange gives the same particles and fields as
+// the face by face exchange.  The particles are charged and fast, so
+// many cross the edges of the 2x2 decomposition each step and the ranks
+// they pass through only get a deposit only copy of them; their current
+// must still land where the face by face exchange puts it.  The
+// currents are summed in a different order, so the fields agree to
+// rounding.
+
+static const int n_part = 4000, n_step = 8;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 8, 4,   // Grid high corner
+                        8, 8, 4,   // Grid resolution
+                        2, 2, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "electron", -1, 1, 4*n_part, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+// The same particles on every call
+
+static void
+load_particles( vpic_simulation * s,
+                species_t * sp ) {
+  const grid_t * g = s->grid;
+  s->seed_entropy( 1 );
+  sp->np = 0;
+  for( int n=0; n<n_part; n++ ) {
+    const double x = s->uniform( s->rng(0), g->x0, g->x1 );
+    const double y = s->uniform( s->rng(0), g->y0, g->y1 );
+    const double z = s->uniform( s->rng(0), g->z0, g->z1 );
+    s->inject_particle( sp, x, y, z,
+                        s->normal( s->rng(0), 0, 2 ),
+                        s->normal( s->rng(0), 0, 2 ),
+                        s->normal( s->rng(0), 0, 2 ), 1, 0, 0 );
+  }
+  sp->copy_to_device();
+}
+
+// The fields and the particles on each rank after n_step steps from
+// zero fields
+
+static std::vector<int>
+run( vpic_simulation * s,
+     const k_field_t::HostMirror & f0,
+     int diagonal,
+     k_field_t::HostMirror & f ) {
+  species_t * sp = s->find_species( "electron" );
+  Kokkos::deep_copy( s->field_array->k_f_d, f0 );
+  load_interpolator_array( s->interpolator_array, s->field_array );
+  load_particles( s, sp );
+  s->diagonal_particle_exchange = diagonal;
+  for( int n=0; n<n_step; n++ ) s->advance();
+  f = Kokkos::create_mirror( s->field_array->k_f_d ); // Never k_f_d itself
+  Kokkos::deep_copy( f, s->field_array->k_f_d );
+  std::vector<int> np( world_size );
+  int local = sp->np;
+  mp_allgather_i( &local, np.data(), 1 );
+  return np;
+}
+
+TEST_CASE( "diagonal particle exchange", "[boundary]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+
+  k_field_t::HostMirror f0 = Kokkos::create_mirror( simulation->field_array->k_f_d );
+  Kokkos::deep_copy( f0, simulation->field_array->k_f_d );
+
+  k_field_t::HostMirror ff, fd;
+  const std::vector<int> face     = run( simulation, f0, 0, ff );
+  const std::vector<int> diagonal = run( simulation, f0, 1, fd );
+
+  int total = 0;
+  for( int r=0; r<world_size; r++ ) total += diagonal[r];
+  REQUIRE( total==world_size*n_part );
+  REQUIRE( diagonal==face );
+
+  // The current of the last step and E and B of the local domain, to
+  // rounding of the largest value of each
+  const int var[] = { field_var::jfx, field_var::jfy, field_var::jfz,
+                      field_var::ex,  field_var::ey,  field_var::ez,
+                      field_var::cbx, field_var::cby, field_var::cbz };
+  double big[9], diff[9];
+  for( int c=0; c<9; c++ ) big[c] = 0, diff[c] = 0;
+  for( int z=1; z<=nz; z++ )
+    for( int y=1; y<=ny; y++ )
+      for( int x=1; x<=nx; x++ ) {
+        const int v = VOXEL(x,y,z, nx,ny,nz);
+        for( int c=0; c<9; c++ ) {
+          big[c]  = std::max( big[c],  (double)std::fabs( ff( v, var[c] ) ) );
+          diff[c] = std::max( diff[c], (double)std::fabs( ff( v, var[c] ) - fd( v, var[c] ) ) );
+        }
+      }
+  int local[2] = { 0, 0 }, count[2]; // Differing components, current
+  for( int c=0; c<9; c++ ) if( diff[c]>1e-4*big[c] ) local[0]++;
+  if( big[0]>0 && big[1]>0 && big[2]>0 ) local[1] = 1;
+  mp_allsum_i( local, count, 2 );
+  REQUIRE( count[1]==world_size ); // Every rank saw a current
+  REQUIRE( count[0]==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
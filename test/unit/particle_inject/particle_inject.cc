@@ -0,0 +1,132 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// Device particle injection (inject_particles_device).  Aged particles
+// are injected fast enough that far more of them stop on a face than
+// there are movers, which used to overrun max_nm when several threads
+// aged at once.
+
+static const int max_np = 4096, max_nm = 32;
+
+struct uniform_density {
+  float n;
+  KOKKOS_INLINE_FUNCTION float
+  operator()( float x, float y, float z ) const { return n; }
+};
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        4, 4, 4,   // Grid high corner
+                        4, 4, 4,   // Grid resolution
+                        1, 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "ion", 1, 1, max_np, max_nm, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "inject_particles_device", "[species_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  species_t * sp = simulation->find_species( "ion" );
+  const grid_t * g = simulation->grid;
+  const int nx = g->nx, ny = g->ny, nz = g->nz, nc = nx*ny*nz;
+
+  {
+    // Counts and placement
+    const int n = simulation->inject_particles( sp, uniform_density{ 10.5f },
+                                                drifting_maxwellian( 0.1f ), 1 );
+    REQUIRE( sp->np==n );
+    REQUIRE( n>=10*nc );
+    REQUIRE( n<=11*nc );
+    REQUIRE( sp->k_nm_h(0)==0 );
+
+    // Copies, not views, as the reinjection below overwrites k_p_d
+    k_particles_t::HostMirror p = Kokkos::create_mirror( sp->k_p_d );
+    k_particles_i_t::HostMirror p_i = Kokkos::create_mirror( sp->k_p_i_d );
+    Kokkos::deep_copy( p, sp->k_p_d );
+    Kokkos::deep_copy( p_i, sp->k_p_i_d );
+    int bad = 0;
+    for( int k=0; k<n; k++ ) {
+      const int v = p_i(k);
+      const int ix = v%(nx+2), iy = ( v/(nx+2) )%(ny+2), iz = v/( (nx+2)*(ny+2) );
+      if( ix<1 || ix>nx || iy<1 || iy>ny || iz<1 || iz>nz ) bad++;
+      for( int d=particle_var::dx; d<=particle_var::dz; d++ )
+        if( !( p(k,d)>=-1 && p(k,d)<=1 ) ) bad++;
+      if( p(k,particle_var::w)!=1 ) bad++;
+    }
+    REQUIRE( bad==0 );
+
+    // The draws depend only on the seed, species, voxel and step
+    sp->np = 0;
+    REQUIRE( simulation->inject_particles( sp, uniform_density{ 10.5f },
+                                           drifting_maxwellian( 0.1f ), 1 )==n );
+
+    k_particles_t::HostMirror q = Kokkos::create_mirror( sp->k_p_d );
+    k_particles_i_t::HostMirror q_i = Kokkos::create_mirror( sp->k_p_i_d );
+    Kokkos::deep_copy( q, sp->k_p_d );
+    Kokkos::deep_copy( q_i, sp->k_p_i_d );
+    int differ = 0;
+    for( int k=0; k<n; k++ ) {
+      if( q_i(k)!=p_i(k) ) differ++;
+      for( int d=0; d<PARTICLE_VAR_COUNT; d++ )
+        if( q(k,d)!=p(k,d) ) differ++;
+    }
+    REQUIRE( differ==0 );
+  }
+
+  {
+    // Aged particles never overrun the movers
+    sp->np = 0;
+    for( int pass=0; pass<3; pass++ ) {
+      const int np0 = sp->np;
+      const int n = simulation->inject_particles( sp, uniform_density{ 8 },
+                                                  drifting_maxwellian( 5 ), 1,
+                                                  -1, 1, pass );
+      REQUIRE( sp->np==np0 + n );
+      const int nm = sp->k_nm_h(0);
+      REQUIRE( nm>0 );
+      REQUIRE( nm<=max_nm );
+
+      // Every mover is a distinct injected particle
+      auto pm_i = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), sp->k_pm_i_d );
+      std::vector<int> seen( sp->np, 0 );
+      int bad = 0;
+      for( int k=0; k<nm; k++ ) {
+        const int i = pm_i(k);
+        if( i<0 || i>=sp->np || seen[i]++ ) bad++;
+      }
+      REQUIRE( bad==0 );
+    }
+    REQUIRE( sp->k_nm_h(0)==max_nm );
+  }
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
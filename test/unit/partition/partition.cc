@@ -0,0 +1,73 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <vector>
+
+#include "src/grid/grid.h"
+
+// Uneven cut planes (partition_periodic_box with cx) and moving them
+// (repartition_grid).  The box has unit cells, so the local domain
+// bounds are the cut planes themselves.
+
+static void
+check_local_domain( const grid_t * g,
+                    const std::vector<int> & cx ) {
+  const int r = world_rank;
+  REQUIRE( g->nx==cx[r+1]-cx[r] );
+  REQUIRE( g->ny==2 );
+  REQUIRE( g->nz==2 );
+  REQUIRE( g->x0==cx[r] );
+  REQUIRE( g->x1==cx[r+1] );
+  REQUIRE( g->dx==1 );
+  for( int rank=0; rank<world_size; rank++ ) {
+    int box[6];
+    REQUIRE( grid_rank_box( g, rank, box ) );
+    REQUIRE( box[0]==cx[rank] );
+    REQUIRE( box[3]==cx[rank+1]-cx[rank] );
+    REQUIRE( ( box[1]==0 && box[4]==2 && box[2]==0 && box[5]==2 ) );
+  }
+}
+
+TEST_CASE( "partition", "[grid]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  // Uneven cuts (5 and 6 cells on 2 ranks) and the same moved by a cell
+  const int n = world_size;
+  std::vector<int> cx( n+1 ), moved( n+1 );
+  for( int i=0; i<n; i++ ) cx[i] = 4*i + ( i<3 ? i : 3 );
+  const int gnx = cx[n] = 4*n + 3;
+  for( int i=0; i<=n; i++ ) moved[i] = cx[i] + ( i>0 && i<n ? 1 : 0 );
+
+  grid_t * g = new_grid();
+  partition_periodic_box( g, 0, 0, 0, gnx, 2, 2, gnx, 2, 2, n, 1, 1,
+                          cx.data(), NULL, NULL );
+  check_local_domain( g, cx );
+
+  // The periodic neighbors of the uneven decomposition
+  const std::vector<int64_t> neighbor( g->neighbor, g->neighbor + 6*g->nv );
+  const std::vector<int> bc( g->bc, g->bc + 27 );
+  const int64_t rangel = g->rangel, rangeh = g->rangeh;
+
+  // Move the cuts, then back: the grid is as it was
+  repartition_grid( g, moved.data(), NULL, NULL );
+  check_local_domain( g, moved );
+
+  repartition_grid( g, cx.data(), NULL, NULL );
+  check_local_domain( g, cx );
+  REQUIRE( g->rangel==rangel );
+  REQUIRE( g->rangeh==rangeh );
+  REQUIRE( std::vector<int>( g->bc, g->bc + 27 )==bc );
+  REQUIRE( std::vector<int64_t>( g->neighbor, g->neighbor + 6*g->nv )==neighbor );
+
+  // NULL keeps the cuts of an axis
+  repartition_grid( g, NULL, NULL, NULL );
+  check_local_domain( g, cx );
+
+  delete_grid( g );
+  halt_services();
+} // TEST
@@ -0,0 +1,164 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// Rebalance a 2x2x1 decomposition with every particle in the lowest
+// quarter of x.  The x cut must move toward the particles, and every
+// particle (global cell, offset, momentum, weight) and every stored
+// voxel of the fields must come through unchanged.
+
+static const int n_part = 2000;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,    // Grid low corner
+                        16, 16, 2,  // Grid high corner
+                        16, 16, 2,  // Grid resolution
+                        2, 2, 1 );  // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "ion", 1, 1, n_part, -1, 0, 0 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+// Global index of the first interior voxel of this rank along each axis
+
+static void
+origin( const grid_t * g, int o[3] ) {
+  o[0] = (int)lround( g->x0/g->dx );
+  o[1] = (int)lround( g->y0/g->dy );
+  o[2] = (int)lround( g->z0/g->dz );
+}
+
+static float
+field_value( int gx, int gy, int gz ) {
+  return gx + 100*gy + 10000*gz;
+}
+
+// Count the fields that do not hold field_value of their global voxel
+
+static int
+field_mismatch( vpic_simulation * s ) {
+  const grid_t * g = s->grid;
+  int o[3], bad = 0;
+  origin( g, o );
+  for( int iz=0; iz<=g->nz+1; iz++ )
+    for( int iy=0; iy<=g->ny+1; iy++ )
+      for( int ix=0; ix<=g->nx+1; ix++ ) {
+        const field_t & f = s->field( ix, iy, iz );
+        const float v = field_value( o[0]+ix-1, o[1]+iy-1, o[2]+iz-1 );
+        if( f.ex!=v || f.ey!=-v || f.cbz!=0.5f*v ) bad++;
+      }
+  return bad;
+}
+
+// Global table of the particles, one row per particle (w is its row
+// plus one), summed over the ranks.  Column 0 counts the copies.
+
+static std::vector<double>
+particle_table( species_t * sp ) {
+  const grid_t * g = sp->g;
+  int o[3];
+  origin( g, o );
+
+  k_particles_t::HostMirror p = Kokkos::create_mirror( sp->k_p_d );
+  k_particles_i_t::HostMirror pi = Kokkos::create_mirror( sp->k_p_i_d );
+  Kokkos::deep_copy( p, sp->k_p_d );
+  Kokkos::deep_copy( pi, sp->k_p_i_d );
+
+  std::vector<double> local( 11*n_part, 0. ), all( 11*n_part );
+  for( int n=0; n<sp->np; n++ ) {
+    const int row = (int)p(n, particle_var::w) - 1;
+    if( row<0 || row>=n_part ) continue;
+    int v = pi(n);
+    const int iz = v/g->sz; v -= iz*g->sz;
+    const int iy = v/g->sy;
+    const int ix = v - iy*g->sy;
+    double * r = &local[ 11*row ];
+    r[0] += 1;
+    r[1] = o[0]+ix-1, r[2] = o[1]+iy-1, r[3] = o[2]+iz-1;
+    for( int d=0; d<PARTICLE_VAR_COUNT; d++ ) r[4+d] = p(n, d);
+  }
+  mp_allsum_d( local.data(), all.data(), 11*n_part );
+  return all;
+}
+
+TEST_CASE( "rebalance a skewed load", "[vpic]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "ion" );
+
+  // Every rank offers every particle; each keeps the ones in its domain
+  for( int n=0; n<n_part; n++ ) {
+    const double a = std::fmod( 0.6180339887*n, 1. );
+    const double b = std::fmod( 0.4142135624*n, 1. );
+    const double c = std::fmod( 0.7320508076*n, 1. );
+    simulation->inject_particle( sp, 0.1 + 3.8*a, 0.05 + 15.9*b, 0.05 + 1.9*c,
+                                 a - 0.5, b - 0.5, c - 0.5, n+1, 0, 0 );
+  }
+  sp->copy_to_device();
+
+  int o[3];
+  origin( g, o );
+  for( int iz=0; iz<=g->nz+1; iz++ )
+    for( int iy=0; iy<=g->ny+1; iy++ )
+      for( int ix=0; ix<=g->nx+1; ix++ ) {
+        field_t & f = simulation->field( ix, iy, iz );
+        const float v = field_value( o[0]+ix-1, o[1]+iy-1, o[2]+iz-1 );
+        f.ex = v, f.ey = -v, f.cbz = 0.5f*v;
+      }
+  simulation->field_array->copy_to_device();
+
+  const std::vector<double> before = particle_table( sp );
+  int missing = 0;
+  for( int n=0; n<n_part; n++ ) if( before[11*n]!=1 ) missing++;
+  REQUIRE( missing==0 );
+
+  // Open the measurement window, then report a push time proportional
+  // to the local particle count
+  REQUIRE( simulation->rebalance()==0 );
+  simulation->rebalance_push_time = 1e-3*sp->np;
+  REQUIRE( simulation->rebalance( 1 )==1 );
+
+  // The x cut moved into the loaded quarter
+  REQUIRE( g->cut[1]>0 );
+  REQUIRE( g->cut[1]<4 );
+
+  const std::vector<double> after = particle_table( sp );
+  int changed = 0;
+  for( size_t k=0; k<after.size(); k++ ) if( after[k]!=before[k] ) changed++;
+  REQUIRE( changed==0 );
+
+  int local = field_mismatch( simulation ), total;
+  mp_allsum_i( &local, &total, 1 );
+  REQUIRE( total==0 );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST
@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main()
+#include "catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "src/vpic/vpic.h"
+
+// tag_tracers hands out ids without gaps, even when some of the
+// particles it selects are tracked already, and no id is handed out
+// twice on any rank.
+
+static const int n_part = 1000;
+
+void
+vpic_simulation::user_initialization( int num_cmdline_arguments,
+                                      char ** cmdline_argument ) {
+  define_units( 1, 1 );
+  define_timestep( 0.5 );
+  define_periodic_grid( 0, 0, 0,   // Grid low corner
+                        8, 4, 4,   // Grid high corner
+                        8, 4, 4,   // Grid resolution
+                        nproc(), 1, 1 ); // Processor configuration
+  define_material( "vacuum", 1.0, 1.0, 0.0 );
+  define_field_array();
+  define_species( "electron", -1, 1, n_part, -1, 0, 0 );
+  define_tracers( "electron", "tracer_ids", 1000 );
+}
+
+void vpic_simulation::user_diagnostics() {}
+
+void vpic_simulation::user_particle_injection() {}
+
+void vpic_simulation::user_current_injection() {}
+
+void vpic_simulation::user_field_injection() {}
+
+void vpic_simulation::user_particle_collisions() {}
+
+TEST_CASE( "tracer ids", "[species_advance]" ) {
+
+  int pargc = 0;
+  char str[] = "bin/vpic";
+  char * args[] = { str, NULL };
+  char ** pargv = args;
+  boot_services( &pargc, &pargv );
+
+  vpic_simulation * simulation = new vpic_simulation;
+  simulation->initialize( pargc, pargv );
+
+  const grid_t * g = simulation->grid;
+  species_t * sp = simulation->find_species( "electron" );
+  for( int n=0; n<n_part; n++ )
+    simulation->inject_particle( sp,
+                                 simulation->uniform( simulation->rng(0), g->x0, g->x1 ),
+                                 simulation->uniform( simulation->rng(0), g->y0, g->y1 ),
+                                 simulation->uniform( simulation->rng(0), g->z0, g->z1 ),
+                                 0, 0, 0, 1, 0, 0 );
+  sp->copy_to_device();
+
+  // Every third particle, then all of them: the second call only tags
+  // the ones left
+  ParticleSelection every_third;
+  every_third.stride = 3;
+  const int n_first  = simulation->tag_tracers( "electron", every_third );
+  const int n_second = simulation->tag_tracers( "electron" );
+  REQUIRE( n_first==( n_part + 2 )/3 );
+  REQUIRE( n_first + n_second==n_part );
+  REQUIRE( simulation->tag_tracers( "electron" )==0 );
+
+  // The ids of this rank are 1, 2, ... n_part past the start of its range
+  k_particle_ids_t::HostMirror ids = Kokkos::create_mirror( sp->k_p_id_d );
+  Kokkos::deep_copy( ids, sp->k_p_id_d );
+  std::vector<int64_t> local( ids.data(), ids.data() + n_part );
+  std::sort( local.begin(), local.end() );
+  const int64_t base = world_rank*( (int64_t)1 << 40 );
+  int gap = 0;
+  for( int n=0; n<n_part; n++ ) if( local[n]!=base + n + 1 ) gap++;
+  REQUIRE( gap==0 );
+
+  // And no two ranks share one
+  std::vector<int64_t> all( n_part*world_size );
+  mp_allgather_i64( local.data(), all.data(), n_part );
+  std::sort( all.begin(), all.end() );
+  REQUIRE( std::adjacent_find( all.begin(), all.end() )==all.end() );
+
+  simulation->finalize();
+  delete simulation;
+  halt_services();
+} // TEST